@@ -454,6 +454,10 @@ static uint32_t Interval_Offset_Minutes;
 /* Max_Info_Frames - rely on MS/TP subsystem, if there is one */
 /* Device_Address_Binding - required, but relies on binding cache */
 static uint32_t Database_Revision = 0;
+/* WritePropertyMultiple batch, where the revision increment is deferred */
+static bool Write_Property_Batch;
+static unsigned Write_Property_Batch_Count;
+static bool Database_Revision_Deferred;
 /* Configuration_Files */
 /* Last_Restore_Time */
 /* Backup_Failure_Timeout */
@@ -833,7 +837,12 @@ void Device_Set_Database_Revision(uint32_t revision)
  */
 void Device_Inc_Database_Revision(void)
 {
-    Database_Revision++;
+    if (Write_Property_Batch) {
+        /* incremented once at the end of the batch */
+        Database_Revision_Deferred = true;
+    } else {
+        Database_Revision++;
+    }
 }
 
 /** Get the total count of objects supported by this Device Object.
@@ -1747,6 +1756,48 @@ static bool Device_Write_Property_Object_Name(
     return status;
 }
 
+/**
+ * @brief Begin a batch of WriteProperty operations, such as the writes
+ *  of one WritePropertyMultiple request, deferring the increment of the
+ *  database revision until the batch ends.
+ */
+void Device_Write_Property_Batch_Begin(void)
+{
+    Write_Property_Batch = true;
+    Write_Property_Batch_Count = 0;
+    Database_Revision_Deferred = false;
+}
+
+/**
+ * @brief Store the value of a property written during the batch
+ * @param wp_data [in] Structure with the written Object and Property info
+ * @return true always, so that it can be used as a write_property_function
+ */
+bool Device_Write_Property_Batch_Store(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    (void)wp_data;
+    return true;
+}
+
+/**
+ * @brief End a batch of WriteProperty operations, incrementing the
+ *  database revision once.
+ * @return number of successful writes during the batch
+ */
+unsigned Device_Write_Property_Batch_End(void)
+{
+    unsigned count = Write_Property_Batch_Count;
+
+    Write_Property_Batch = false;
+    if (Database_Revision_Deferred) {
+        Database_Revision_Deferred = false;
+        Device_Inc_Database_Revision();
+    }
+    Write_Property_Batch_Count = 0;
+
+    return count;
+}
+
 /** Looks up the requested Object and Property, and set the new Value in it,
  *  if allowed.
  * If the Object or Property can't be found, sets the error class and code.
@@ -1782,6 +1833,9 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 } else {
                     status = pObject->Object_Write_Property(wp_data);
                 }
+                if (status && Write_Property_Batch) {
+                    Write_Property_Batch_Count++;
+                }
             } else {
                 if (Device_Objects_Property_List_Member(
                         wp_data->object_type, wp_data->object_instance,
@@ -28,6 +28,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/datalink/dlenv.h"
 /* include the device object */
@@ -49,6 +50,14 @@
 
 /** Buffer used for receiving */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+/* all the routed devices answer a global Who-Is, so spread the replies */
+#ifndef GATEWAY_IAM_WINDOW_MS
+#define GATEWAY_IAM_WINDOW_MS 2000
+#endif
+#ifndef GATEWAY_IAM_RATE
+#define GATEWAY_IAM_RATE 10
+#endif
+static struct mstimer I_Am_Timer;
 
 /** The list of DNETs that our router can reach.
  *  Only one entry since we don't support downstream routers.
@@ -101,6 +110,7 @@ static void Initialize_Device_Addresses(void)
     int i = 0; /* First entry is Gateway Device */
     uint32_t virtual_mac = 0;
     BACNET_ADDRESS virtual_address = { 0 };
+    BACNET_ADDRESS routed_address = { 0 };
     DEVICE_OBJECT_DATA *pDev = NULL;
     /* Setup info for the main gateway device first */
     pDev = Get_Routed_Device_Object(i);
@@ -121,7 +131,7 @@ static void Initialize_Device_Addresses(void)
 #else
 #error "No support for this Data Link Layer type "
 #endif
-    bacnet_address_copy(&pDev->bacDevAddr, &virtual_address);
+    Routed_Device_Address_Set(i, &virtual_address);
     /* broadcast an I-Am on startup */
     Send_I_Am(&Handler_Transmit_Buffer[0]);
 
@@ -131,13 +141,15 @@ static void Initialize_Device_Addresses(void)
             continue;
         }
         /* start with the router address */
-        bacnet_address_copy(&pDev->bacDevAddr, &virtual_address);
+        bacnet_address_copy(&routed_address, &virtual_address);
         /* add the network number to each gateway device */
-        pDev->bacDevAddr.net = VIRTUAL_DNET;
+        routed_address.net = VIRTUAL_DNET;
         /* use a virtual MAC for each gateway device */
         virtual_mac = pDev->bacObj.Object_Instance_Number;
-        encode_unsigned24(&pDev->bacDevAddr.adr[0], virtual_mac);
-        pDev->bacDevAddr.len = 3;
+        encode_unsigned24(&routed_address.adr[0], virtual_mac);
+        routed_address.len = 3;
+        /* indexed so that requests find the device directly */
+        Routed_Device_Address_Set(i, &routed_address);
     }
 }
 
@@ -157,6 +169,8 @@ static void Init_Service_Handlers(uint32_t first_object_instance)
      */
     apdu_set_unconfirmed_handler(
         SERVICE_UNCONFIRMED_WHO_IS, handler_who_is_unicast);
+    Send_I_Am_Window_Set(GATEWAY_IAM_WINDOW_MS);
+    Send_I_Am_Rate_Set(GATEWAY_IAM_RATE, GATEWAY_IAM_RATE);
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_HAS, handler_who_has);
     /* set the handler for all the services we don't implement */
     /* It is required to send the proper reject message... */
@@ -248,6 +262,7 @@ int main(int argc, char *argv[])
 #endif
     /* configure the timeout values */
     last_seconds = time(NULL);
+    mstimer_set(&I_Am_Timer, 50UL);
 
     /* broadcast an I-am-router-to-network on startup */
     printf("Remote Network DNET Number %d \n", DNET_list[0]);
@@ -276,6 +291,11 @@ int main(int argc, char *argv[])
             tsm_timer_milliseconds(elapsed_milliseconds);
             Device_Timer(elapsed_milliseconds);
         }
+        if (mstimer_expired(&I_Am_Timer)) {
+            elapsed_milliseconds = mstimer_elapsed(&I_Am_Timer);
+            mstimer_restart(&I_Am_Timer);
+            Send_I_Am_Timer((uint16_t)elapsed_milliseconds);
+        }
         handler_cov_task();
         if (Routed_Device_Index < MAX_NUM_DEVICES) {
             Routed_Device_Index++;
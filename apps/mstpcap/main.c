@@ -764,7 +764,6 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
     uint8_t header[8] = { 0 }; /* MS/TP header */
     struct timeval tv;
     size_t count = 0;
-    unsigned i = 0;
 
     if (File_Handle) {
         count = fread(&ts_sec, sizeof(ts_sec), 1, File_Handle);
@@ -804,11 +803,7 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
         mstp_port->SourceAddress = header[4];
         mstp_port->DataLength = MAKE_WORD(header[6], header[5]);
         mstp_port->HeaderCRCActual = header[7];
-        mstp_port->HeaderCRC = 0xFF;
-        for (i = 2; i < 8; i++) {
-            mstp_port->HeaderCRC =
-                CRC_Calc_Header(header[i], mstp_port->HeaderCRC);
-        }
+        mstp_port->HeaderCRC = CRC_Calc_Header_Block(&header[2], 6, 0xFF);
         if (mstp_port->HeaderCRC == 0x55) {
             mstp_port->ReceivedValidFrame = true;
             mstp_port->ReceivedInvalidFrame = false;
@@ -843,11 +838,8 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
                 File_Handle = NULL;
                 return false;
             }
-            mstp_port->DataCRC = 0xFFFF;
-            for (i = 0; i < mstp_port->DataLength; i++) {
-                mstp_port->DataCRC = CRC_Calc_Data(
-                    mstp_port->InputBuffer[i], mstp_port->DataCRC);
-            }
+            mstp_port->DataCRC = CRC_Calc_Data_Block(
+                mstp_port->InputBuffer, mstp_port->DataLength, 0xFFFF);
             mstp_port->DataCRC =
                 CRC_Calc_Data(mstp_port->DataCRCActualMSB, mstp_port->DataCRC);
             mstp_port->DataCRC =
@@ -61,6 +61,10 @@
 /** @addtogroup ServerDemo */
 /*@{*/
 
+/* window in milliseconds for the I-Am replies to Who-Is, 0 is immediate */
+#ifndef SERVER_IAM_WINDOW_MS
+#define SERVER_IAM_WINDOW_MS 0
+#endif
 /* current version of the BACnet stack */
 static const char *BACnet_Version = BACNET_VERSION_TEXT;
 /* task timer for various BACnet timeouts */
@@ -178,6 +182,16 @@ static void Init_Service_Handlers(void)
     apdu_set_unconfirmed_handler(
         SERVICE_UNCONFIRMED_WHO_IS, handler_who_is_who_am_i_unicast);
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_HAS, handler_who_has);
+    /* we are the only device here, so drop Who-Is and Who-Has for
+       other device ranges before decoding them */
+    npdu_filter_rule_enable(NPDU_FILTER_WHO_IS_RANGE, true);
+    npdu_filter_rule_enable(NPDU_FILTER_WHO_HAS_RANGE, true);
+    /* drop unconfirmed services without a handler before decoding them */
+    npdu_filter_unconfirmed_handled_set(apdu_unconfirmed_service_handled);
+    npdu_filter_rule_enable(NPDU_FILTER_UNCONFIRMED_UNHANDLED, true);
+    /* replies are immediate unless a window is given at build time,
+       to spread the I-Am of many devices answering a global Who-Is */
+    Send_I_Am_Window_Set(SERVER_IAM_WINDOW_MS);
     /* set the handler for all the services we don't implement */
     /* It is required to send the proper reject message... */
     apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
@@ -347,6 +361,8 @@ int main(int argc, char *argv[])
         "BACnet Device ID: %u\n"
         "Max APDU: %d\n",
         BACnet_Version, Device_Object_Instance_Number(), MAX_APDU);
+    /* index the text lists before the lookups */
+    bactext_init();
     /* load any static address bindings to show up
        in our device bindings list */
     address_init();
@@ -429,6 +445,7 @@ int main(int argc, char *argv[])
             mstimer_reset(&BACnet_TSM_Timer);
             elapsed_milliseconds = mstimer_interval(&BACnet_TSM_Timer);
             tsm_timer_milliseconds(elapsed_milliseconds);
+            Send_I_Am_Timer(elapsed_milliseconds);
         }
         if (mstimer_expired(&BACnet_Address_Timer)) {
             mstimer_reset(&BACnet_Address_Timer);
@@ -448,6 +448,20 @@ bool bip_get_addr_by_name(const char *host_name, BACNET_IP_ADDRESS *addr)
     return true;
 }
 
+/**
+ * @brief gets an IP address by hostname (or string of numbers) without
+ *  waiting on the name resolver.
+ * @note This port has no background resolver, so the lookup is done
+ *  in place by bip_get_addr_by_name().
+ * @param host_name - the host name
+ * @param addr - IPv4 address
+ * @return true if the address was retrieved
+ */
+bool bip_get_addr_by_name_async(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    return bip_get_addr_by_name(host_name, addr);
+}
+
 static void *get_addr_ptr(struct sockaddr *sockaddr_ptr)
 {
     void *addr_ptr = NULL;
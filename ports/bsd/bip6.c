@@ -281,6 +281,38 @@ int bip6_send_mpdu(
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
 }
 
+/**
+ * The send function for BACnet/IPv6 driver layer, sending the same MPDU
+ * to a list of destinations, e.g. the BDT or FDT of a BBMD.
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return Upon successful completion, returns the number of destinations
+ *  the MPDU was sent to. Otherwise, -1 shall be returned to indicate
+ *  the error.
+ */
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+    int sent = 0;
+
+    for (i = 0; i < dest_count; i++) {
+        if (bip6_send_mpdu(&dest[i], mtu, mtu_len) < 0) {
+            return (sent > 0) ? sent : -1;
+        }
+        sent++;
+    }
+
+    return sent;
+}
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -15,6 +15,9 @@
 #include <linux/rtnetlink.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <time.h>
 /* standard C */
 #include <stdint.h> /* for standard integer types uint8_t etc. */
 #include <stdbool.h> /* for the standard bool type. */
@@ -52,6 +55,48 @@ static struct in_addr BIP_Broadcast_Binding_Address;
 static bool BIP_Debug = false;
 /* interface name */
 static char BIP_Interface_Name[IF_NAMESIZE] = { 0 };
+/* interface was picked from the default route */
+static bool BIP_Interface_Default;
+/* netlink socket watching the interface for address and route changes */
+static int BIP_Netlink_Socket = -1;
+/* sockets are wanted, i.e. between bip_init() and bip_cleanup() */
+static bool BIP_Running;
+
+/* host names resolved in the background by bip_get_addr_by_name_async() */
+#ifndef BIP_RESOLVE_CACHE_SIZE
+#define BIP_RESOLVE_CACHE_SIZE 8
+#endif
+#ifndef BIP_RESOLVE_NAME_MAX
+#define BIP_RESOLVE_NAME_MAX 256
+#endif
+/* seconds an answer is served before it is refreshed */
+#ifndef BIP_RESOLVE_TTL_SECONDS
+#define BIP_RESOLVE_TTL_SECONDS 300
+#endif
+/* seconds before a failed lookup is tried again */
+#ifndef BIP_RESOLVE_RETRY_SECONDS
+#define BIP_RESOLVE_RETRY_SECONDS 10
+#endif
+enum bip_resolve_state {
+    BIP_RESOLVE_EMPTY = 0,
+    BIP_RESOLVE_QUEUED,
+    BIP_RESOLVE_BUSY,
+    BIP_RESOLVE_DONE
+};
+struct bip_resolve_entry {
+    char name[BIP_RESOLVE_NAME_MAX];
+    uint8_t addr[4];
+    bool valid;
+    enum bip_resolve_state state;
+    time_t expires;
+};
+static struct bip_resolve_entry BIP_Resolve_Cache[BIP_RESOLVE_CACHE_SIZE];
+static pthread_mutex_t BIP_Resolve_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t BIP_Resolve_Cond = PTHREAD_COND_INITIALIZER;
+static bool BIP_Resolve_Thread_Running;
+
+static void bip_sockets_reopen(void);
+static void bip_netlink_handler(void);
 
 /**
  * @brief Print the IPv4 address with debug info
@@ -174,15 +219,26 @@ void bip_get_broadcast_address(BACNET_ADDRESS *dest)
 }
 
 /**
- * Set the BACnet/IP address
+ * Set the BACnet/IP address, and rebind the sockets to it when the
+ * datalink is running.
  *
  * @param addr - network IPv4 address
+ * @return true if the address was set
  */
 bool bip_set_addr(const BACNET_IP_ADDRESS *addr)
 {
-    /* not something we do within this driver */
-    (void)addr;
-    return false;
+    struct in_addr address;
+
+    if (!addr) {
+        return false;
+    }
+    memcpy(&address.s_addr, &addr->address[0], 4);
+    if (address.s_addr != BIP_Address.s_addr) {
+        BIP_Address = address;
+        bip_sockets_reopen();
+    }
+
+    return true;
 }
 
 /**
@@ -207,9 +263,18 @@ bool bip_get_addr(BACNET_IP_ADDRESS *addr)
  */
 bool bip_set_broadcast_addr(const BACNET_IP_ADDRESS *addr)
 {
-    /* not something we do within this driver */
-    (void)addr;
-    return false;
+    struct in_addr broadcast;
+
+    if (!addr) {
+        return false;
+    }
+    memcpy(&broadcast.s_addr, &addr->address[0], 4);
+    if (broadcast.s_addr != BIP_Broadcast_Addr.s_addr) {
+        BIP_Broadcast_Addr = broadcast;
+        bip_sockets_reopen();
+    }
+
+    return true;
 }
 
 /**
@@ -323,8 +388,8 @@ uint16_t bip_receive(
     uint16_t i = 0;
     int socket;
 
-    /* Make sure the socket is open */
-    if (BIP_Socket < 0) {
+    /* Make sure a socket is open */
+    if ((BIP_Socket < 0) && (BIP_Netlink_Socket < 0)) {
         return 0;
     }
     /* we could just use a non-blocking socket, but that consumes all
@@ -339,13 +404,28 @@ uint16_t bip_receive(
         select_timeout.tv_usec = 1000 * timeout;
     }
     FD_ZERO(&read_fds);
-    FD_SET(BIP_Socket, &read_fds);
-    FD_SET(BIP_Broadcast_Socket, &read_fds);
-
-    max = BIP_Socket > BIP_Broadcast_Socket ? BIP_Socket : BIP_Broadcast_Socket;
+    max = -1;
+    if (BIP_Socket >= 0) {
+        FD_SET(BIP_Socket, &read_fds);
+        FD_SET(BIP_Broadcast_Socket, &read_fds);
+        max = BIP_Socket > BIP_Broadcast_Socket ? BIP_Socket
+                                                : BIP_Broadcast_Socket;
+    }
+    /* interface changes are handled between packets */
+    if (BIP_Netlink_Socket >= 0) {
+        FD_SET(BIP_Netlink_Socket, &read_fds);
+        if (BIP_Netlink_Socket > max) {
+            max = BIP_Netlink_Socket;
+        }
+    }
 
     /* see if there is a packet for us */
     if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
+        if ((BIP_Netlink_Socket >= 0) &&
+            FD_ISSET(BIP_Netlink_Socket, &read_fds)) {
+            bip_netlink_handler();
+            return 0;
+        }
         socket =
             FD_ISSET(BIP_Socket, &read_fds) ? BIP_Socket : BIP_Broadcast_Socket;
         received_bytes = recvfrom(
@@ -434,6 +514,53 @@ int bip_send_pdu(
     return bvlc_send_pdu(dest, npdu_data, pdu, pdu_len);
 }
 
+/**
+ * @brief Resolve a dotted IPv4 address without asking the resolver
+ * @param host_name - the host name
+ * @param addr - IPv4 address, or NULL
+ * @return true if the host name is a numeric IPv4 address
+ */
+static bool bip_addr_numeric(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    struct in_addr in = { 0 };
+
+    if (inet_pton(AF_INET, host_name, &in) != 1) {
+        return false;
+    }
+    if (addr) {
+        memcpy(&addr->address[0], &in.s_addr, 4);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Resolve a host name with the system resolver, which may block
+ * @param host_name - the host name
+ * @param addr - IPv4 address, or NULL
+ * @return true if the address was retrieved
+ */
+static bool bip_addr_lookup(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    struct addrinfo hints = { 0 };
+    struct addrinfo *result = NULL;
+    const struct sockaddr_in *sin;
+
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host_name, NULL, &hints, &result) != 0) {
+        return false;
+    }
+    if (addr) {
+        /* addresses in a struct addrinfo are in network byte order */
+        sin = (const struct sockaddr_in *)result->ai_addr;
+        memcpy(&addr->address[0], &sin->sin_addr.s_addr, 4);
+    }
+    freeaddrinfo(result);
+
+    return true;
+}
+
 /**
  * @brief gets an IP address by hostname (or string of numbers)
  *
@@ -445,21 +572,189 @@ int bip_send_pdu(
  */
 bool bip_get_addr_by_name(const char *host_name, BACNET_IP_ADDRESS *addr)
 {
-    struct hostent *host_ent;
-
-    if ((host_ent = gethostbyname(host_name)) == NULL) {
+    if (!host_name) {
         return false;
     }
+    if (bip_addr_numeric(host_name, addr)) {
+        return true;
+    }
 
-    if (addr) {
-        /* Host addresses in a struct hostent structure are always
-           given in network byte order */
-        /* h_addr: This is a synonym for h_addr_list[0];
-           in other words, it is the first host address.*/
-        memcpy(&addr->address[0], host_ent->h_addr, 4);
+    return bip_addr_lookup(host_name, addr);
+}
+
+/**
+ * @brief Get the monotonic time in seconds for the resolver cache
+ * @return seconds since some unspecified starting point
+ */
+static time_t bip_resolve_clock(void)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec;
+}
+
+/**
+ * @brief Find the cache entry of a host name, or claim the oldest one
+ * @param host_name - the host name
+ * @return the cache entry, which is empty if the name was not cached
+ * @note called with BIP_Resolve_Mutex held
+ */
+static struct bip_resolve_entry *bip_resolve_entry(const char *host_name)
+{
+    struct bip_resolve_entry *entry;
+    struct bip_resolve_entry *oldest = NULL;
+    unsigned i;
+
+    for (i = 0; i < BIP_RESOLVE_CACHE_SIZE; i++) {
+        entry = &BIP_Resolve_Cache[i];
+        if ((entry->state != BIP_RESOLVE_EMPTY) &&
+            (strcmp(entry->name, host_name) == 0)) {
+            return entry;
+        }
+        /* never recycle a name the worker is looking up right now */
+        if ((entry->state != BIP_RESOLVE_BUSY) &&
+            ((oldest == NULL) || (entry->state == BIP_RESOLVE_EMPTY) ||
+             ((oldest->state != BIP_RESOLVE_EMPTY) &&
+              (entry->expires < oldest->expires)))) {
+            oldest = entry;
+        }
+    }
+    if (oldest) {
+        snprintf(oldest->name, sizeof(oldest->name), "%s", host_name);
+        oldest->state = BIP_RESOLVE_EMPTY;
+        oldest->valid = false;
+        oldest->expires = 0;
     }
 
-    return true;
+    return oldest;
+}
+
+/**
+ * @brief Resolver thread: looks up the queued host names one at a time
+ *  so that a slow or absent DNS server only ever stalls this thread.
+ * @param arg - unused
+ * @return never
+ */
+static void *bip_resolve_thread(void *arg)
+{
+    struct bip_resolve_entry *entry;
+    char name[BIP_RESOLVE_NAME_MAX];
+    BACNET_IP_ADDRESS addr = { 0 };
+    bool valid;
+    unsigned i;
+
+    (void)arg;
+    pthread_mutex_lock(&BIP_Resolve_Mutex);
+    for (;;) {
+        entry = NULL;
+        for (i = 0; i < BIP_RESOLVE_CACHE_SIZE; i++) {
+            if (BIP_Resolve_Cache[i].state == BIP_RESOLVE_QUEUED) {
+                entry = &BIP_Resolve_Cache[i];
+                break;
+            }
+        }
+        if (!entry) {
+            pthread_cond_wait(&BIP_Resolve_Cond, &BIP_Resolve_Mutex);
+            continue;
+        }
+        entry->state = BIP_RESOLVE_BUSY;
+        memcpy(name, entry->name, sizeof(name));
+        pthread_mutex_unlock(&BIP_Resolve_Mutex);
+        valid = bip_addr_lookup(name, &addr);
+        pthread_mutex_lock(&BIP_Resolve_Mutex);
+        if (valid) {
+            memcpy(entry->addr, &addr.address[0], 4);
+            entry->valid = true;
+            entry->expires = bip_resolve_clock() + BIP_RESOLVE_TTL_SECONDS;
+        } else {
+            /* keep a stale answer, it is better than none at all */
+            entry->expires =
+                bip_resolve_clock() + BIP_RESOLVE_RETRY_SECONDS;
+        }
+        entry->state = BIP_RESOLVE_DONE;
+        if (BIP_Debug) {
+            fprintf(
+                stderr, "BIP: %s %s\n",
+                valid ? "resolved" : "failed to resolve", name);
+            fflush(stderr);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Start the resolver thread once
+ */
+static void bip_resolve_thread_start(void)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, bip_resolve_thread, NULL) == 0) {
+        BIP_Resolve_Thread_Running = true;
+    } else {
+        perror("BIP: resolver thread");
+    }
+    pthread_attr_destroy(&attr);
+}
+
+/**
+ * @brief gets an IP address by hostname (or string of numbers) without
+ *  waiting on the name resolver.
+ *
+ * Dotted addresses are converted immediately. Domain names are looked up
+ * by a resolver thread and the answers are cached: this returns false
+ * while the first lookup of a name is still outstanding, so callers try
+ * again later. Cached answers are refreshed in the background after
+ * #BIP_RESOLVE_TTL_SECONDS and served meanwhile, even if a refresh fails.
+ *
+ * @param host_name - the host name
+ * @param addr - IPv4 address, or NULL
+ * @return true if the address was retrieved
+ */
+bool bip_get_addr_by_name_async(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    struct bip_resolve_entry *entry;
+    bool status = false;
+
+    if (!host_name) {
+        return false;
+    }
+    if (bip_addr_numeric(host_name, addr)) {
+        return true;
+    }
+    if (strlen(host_name) >= BIP_RESOLVE_NAME_MAX) {
+        return bip_addr_lookup(host_name, addr);
+    }
+    pthread_once(&once, bip_resolve_thread_start);
+    if (!BIP_Resolve_Thread_Running) {
+        return bip_addr_lookup(host_name, addr);
+    }
+    pthread_mutex_lock(&BIP_Resolve_Mutex);
+    entry = bip_resolve_entry(host_name);
+    if (entry) {
+        if (entry->valid) {
+            if (addr) {
+                memcpy(&addr->address[0], entry->addr, 4);
+            }
+            status = true;
+        }
+        if ((entry->state == BIP_RESOLVE_EMPTY) ||
+            ((entry->state == BIP_RESOLVE_DONE) &&
+             (bip_resolve_clock() >= entry->expires))) {
+            entry->state = BIP_RESOLVE_QUEUED;
+            pthread_cond_signal(&BIP_Resolve_Cond);
+        }
+    }
+    pthread_mutex_unlock(&BIP_Resolve_Mutex);
+
+    return status;
 }
 
 /**
@@ -869,44 +1164,17 @@ static int createSocket(const struct sockaddr_in *sin)
     return sock_fd;
 }
 
-/** Initialize the BACnet/IP services at the given interface.
- * @ingroup DLBIP
- * -# Gets the local IP address and local broadcast address from the system,
- *  and saves it into the BACnet/IP data structures.
- * -# Opens a UDP socket
- * -# Configures the socket for sending and receiving
- * -# Configures the socket so it can send broadcasts
- * -# Binds the socket to the local IP address at the specified port for
- *    BACnet/IP (by default, 0xBAC0 = 47808).
- *
- * @note For Linux, ifname is eth0, ath0, arc0, and others.
- *
- * @param ifname [in] The named interface to use for the network layer.
- *        If NULL, the default interface is assigned.
- * @return True if the socket is successfully opened for BACnet/IP,
- *         else False if the socket functions fail.
+/**
+ * @brief Open the unicast and broadcast sockets at the current address
+ * @return true if the sockets were opened
  */
-bool bip_init(char *ifname)
+static bool bip_sockets_open(void)
 {
     struct sockaddr_in sin;
     int sock_fd = -1;
     struct sockaddr_in broadcast_sin_config;
     int broadcast_sock_fd;
 
-    if (ifname) {
-        snprintf(BIP_Interface_Name, sizeof(BIP_Interface_Name), "%s", ifname);
-        bip_set_interface(ifname);
-    } else {
-        bip_set_interface(ifname_default());
-    }
-    if (BIP_Address.s_addr == 0) {
-        fprintf(
-            stderr, "BIP: Failed to get an IP address from %s!\n",
-            BIP_Interface_Name);
-        fflush(stderr);
-        return false;
-    }
-
     sin.sin_family = AF_INET;
     sin.sin_port = BIP_Port;
     memset(&(sin.sin_zero), '\0', sizeof(sin.sin_zero));
@@ -944,11 +1212,209 @@ bool bip_init(char *ifname)
         broadcast_sock_fd = createSocket(&broadcast_sin_config);
         BIP_Broadcast_Socket = broadcast_sock_fd;
         if (broadcast_sock_fd < 0) {
-            bip_cleanup();
+            close(BIP_Socket);
+            BIP_Socket = -1;
             return false;
         }
     }
 
+    return true;
+}
+
+/**
+ * @brief Close the unicast and broadcast sockets
+ */
+static void bip_sockets_close(void)
+{
+    if ((BIP_Broadcast_Socket != -1) && (BIP_Broadcast_Socket != BIP_Socket)) {
+        close(BIP_Broadcast_Socket);
+    }
+    BIP_Broadcast_Socket = -1;
+    if (BIP_Socket != -1) {
+        close(BIP_Socket);
+    }
+    BIP_Socket = -1;
+}
+
+/**
+ * @brief Rebind the sockets after the address or broadcast address changed.
+ *  While the interface has no address the sockets stay closed, and they
+ *  are opened again once an address is assigned.
+ */
+static void bip_sockets_reopen(void)
+{
+    if (!BIP_Running) {
+        return;
+    }
+    bip_sockets_close();
+    if (BIP_Address.s_addr == 0) {
+        if (BIP_Debug) {
+            fprintf(
+                stderr, "BIP: %s lost its address, waiting...\n",
+                BIP_Interface_Name);
+            fflush(stderr);
+        }
+        return;
+    }
+    if (!bip_sockets_open()) {
+        fprintf(
+            stderr, "BIP: Failed to rebind to %s!\n", inet_ntoa(BIP_Address));
+        fflush(stderr);
+    }
+}
+
+/**
+ * @brief Open a netlink socket that reports address, link and route
+ *  changes, so that a DHCP renewal or a new default route reconfigures
+ *  the datalink without a restart.
+ */
+static void bip_netlink_open(void)
+{
+    struct sockaddr_nl snl = { 0 };
+    int sock;
+
+    sock = socket(
+        PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (sock < 0) {
+        if (BIP_Debug) {
+            perror("BIP: netlink socket");
+        }
+        return;
+    }
+    snl.nl_family = AF_NETLINK;
+    snl.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV4_ROUTE;
+    if (bind(sock, (struct sockaddr *)&snl, sizeof(snl)) < 0) {
+        if (BIP_Debug) {
+            perror("BIP: netlink bind");
+        }
+        close(sock);
+        return;
+    }
+    BIP_Netlink_Socket = sock;
+}
+
+/**
+ * @brief Drain the netlink socket and reconfigure the datalink when the
+ *  interface address, the interface itself or the default route changed.
+ */
+static void bip_netlink_handler(void)
+{
+    char buffer[4096];
+    struct nlmsghdr *nlh;
+    const struct ifaddrmsg *ifa;
+    const struct ifinfomsg *ifi;
+    char ifname[IF_NAMESIZE];
+    struct in_addr address;
+    struct in_addr broadcast;
+    unsigned ifindex;
+    bool changed = false;
+    bool route_changed = false;
+    int len;
+
+    ifindex = if_nametoindex(BIP_Interface_Name);
+    while ((len = recv(
+                BIP_Netlink_Socket, buffer, sizeof(buffer), MSG_DONTWAIT)) >
+           0) {
+        for (nlh = (struct nlmsghdr *)buffer; NLMSG_OK(nlh, len);
+             nlh = NLMSG_NEXT(nlh, len)) {
+            switch (nlh->nlmsg_type) {
+                case RTM_NEWADDR:
+                case RTM_DELADDR:
+                    ifa = (const struct ifaddrmsg *)NLMSG_DATA(nlh);
+                    if ((ifa->ifa_family == AF_INET) &&
+                        ((ifindex == 0) || (ifa->ifa_index == ifindex))) {
+                        changed = true;
+                    }
+                    break;
+                case RTM_NEWLINK:
+                case RTM_DELLINK:
+                    ifi = (const struct ifinfomsg *)NLMSG_DATA(nlh);
+                    if ((ifindex == 0) || (ifi->ifi_index == (int)ifindex)) {
+                        changed = true;
+                    }
+                    break;
+                case RTM_NEWROUTE:
+                case RTM_DELROUTE:
+                    route_changed = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    if (route_changed && BIP_Interface_Default) {
+        /* the default route may have moved to another interface */
+        memcpy(ifname, BIP_Interface_Name, sizeof(ifname));
+        BIP_Interface_Name[0] = 0;
+        ifname_default();
+        if (BIP_Interface_Name[0] == 0) {
+            memcpy(BIP_Interface_Name, ifname, sizeof(ifname));
+        } else if (strcmp(ifname, BIP_Interface_Name) != 0) {
+            changed = true;
+        }
+    }
+    if (!changed) {
+        return;
+    }
+    address = BIP_Address;
+    broadcast = BIP_Broadcast_Addr;
+    bip_set_interface(BIP_Interface_Name);
+    if ((address.s_addr != BIP_Address.s_addr) ||
+        (broadcast.s_addr != BIP_Broadcast_Addr.s_addr) ||
+        (BIP_Socket == -1)) {
+        if (BIP_Debug) {
+            fprintf(
+                stderr, "BIP: %s changed to %s\n", BIP_Interface_Name,
+                inet_ntoa(BIP_Address));
+            fflush(stderr);
+        }
+        bip_sockets_reopen();
+    }
+}
+
+/** Initialize the BACnet/IP services at the given interface.
+ * @ingroup DLBIP
+ * -# Gets the local IP address and local broadcast address from the system,
+ *  and saves it into the BACnet/IP data structures.
+ * -# Opens a UDP socket
+ * -# Configures the socket for sending and receiving
+ * -# Configures the socket so it can send broadcasts
+ * -# Binds the socket to the local IP address at the specified port for
+ *    BACnet/IP (by default, 0xBAC0 = 47808).
+ * -# Watches the interface, so that address changes rebind the sockets.
+ *
+ * @note For Linux, ifname is eth0, ath0, arc0, and others.
+ *
+ * @param ifname [in] The named interface to use for the network layer.
+ *        If NULL, the default interface is assigned.
+ * @return True if the socket is successfully opened for BACnet/IP,
+ *         else False if the socket functions fail.
+ */
+bool bip_init(char *ifname)
+{
+    if (ifname) {
+        snprintf(BIP_Interface_Name, sizeof(BIP_Interface_Name), "%s", ifname);
+        BIP_Interface_Default = false;
+        bip_set_interface(ifname);
+    } else {
+        BIP_Interface_Default = true;
+        bip_set_interface(ifname_default());
+    }
+    if (BIP_Address.s_addr == 0) {
+        fprintf(
+            stderr, "BIP: Failed to get an IP address from %s!\n",
+            BIP_Interface_Name);
+        fflush(stderr);
+        return false;
+    }
+    if (!bip_sockets_open()) {
+        return false;
+    }
+    BIP_Running = true;
+    if (BIP_Netlink_Socket == -1) {
+        bip_netlink_open();
+    }
+
     bvlc_init();
 
     return true;
@@ -968,15 +1434,12 @@ bool bip_valid(void)
  */
 void bip_cleanup(void)
 {
-    if (BIP_Socket != -1) {
-        close(BIP_Socket);
-    }
-    BIP_Socket = -1;
-
-    if (BIP_Broadcast_Socket != -1) {
-        close(BIP_Broadcast_Socket);
+    BIP_Running = false;
+    bip_sockets_close();
+    if (BIP_Netlink_Socket != -1) {
+        close(BIP_Netlink_Socket);
     }
-    BIP_Broadcast_Socket = -1;
+    BIP_Netlink_Socket = -1;
     /* these were set non-zero during interface configuration */
     BIP_Address.s_addr = 0;
     BIP_Broadcast_Addr.s_addr = 0;
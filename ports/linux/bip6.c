@@ -5,6 +5,7 @@
  * @date 2016
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
+#define _GNU_SOURCE
 #include <ifaddrs.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -82,6 +83,10 @@ void bip6_debug_enable(void)
 
 /* unix socket */
 static int BIP6_Socket = -1;
+/* largest number of datagrams handed to one sendmmsg() call */
+#ifndef BIP6_SEND_BATCH_MAX
+#define BIP6_SEND_BATCH_MAX 32
+#endif
 static int BIP6_Socket_Scope_Id = 0;
 /* local address - filled by init functions */
 static BACNET_IP6_ADDRESS BIP6_Addr;
@@ -227,6 +232,34 @@ bool bip6_get_broadcast_addr(BACNET_IP6_ADDRESS *addr)
     return bvlc6_address_copy(addr, &BIP6_Broadcast_Addr);
 }
 
+/**
+ * Load a socket address from a BACnet/IPv6 address
+ *
+ * @param bvlc_dest - socket address to fill
+ * @param dest - BACnet/IPv6 address
+ */
+static void bip6_sockaddr_set(
+    struct sockaddr_in6 *bvlc_dest, const BACNET_IP6_ADDRESS *dest)
+{
+    uint16_t addr16[8];
+
+    memset(bvlc_dest, 0, sizeof(*bvlc_dest));
+    bvlc_dest->sin6_family = AF_INET6;
+    bvlc6_address_get(
+        dest, &addr16[0], &addr16[1], &addr16[2], &addr16[3], &addr16[4],
+        &addr16[5], &addr16[6], &addr16[7]);
+    bvlc_dest->sin6_addr.s6_addr16[0] = htons(addr16[0]);
+    bvlc_dest->sin6_addr.s6_addr16[1] = htons(addr16[1]);
+    bvlc_dest->sin6_addr.s6_addr16[2] = htons(addr16[2]);
+    bvlc_dest->sin6_addr.s6_addr16[3] = htons(addr16[3]);
+    bvlc_dest->sin6_addr.s6_addr16[4] = htons(addr16[4]);
+    bvlc_dest->sin6_addr.s6_addr16[5] = htons(addr16[5]);
+    bvlc_dest->sin6_addr.s6_addr16[6] = htons(addr16[6]);
+    bvlc_dest->sin6_addr.s6_addr16[7] = htons(addr16[7]);
+    bvlc_dest->sin6_port = htons(dest->port);
+    bvlc_dest->sin6_scope_id = BIP6_Socket_Scope_Id;
+}
+
 /**
  * The send function for BACnet/IPv6 driver layer
  *
@@ -242,27 +275,13 @@ int bip6_send_mpdu(
     const BACNET_IP6_ADDRESS *dest, const uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in6 bvlc_dest = { 0 };
-    uint16_t addr16[8];
 
     /* assumes that the driver has already been initialized */
     if (BIP6_Socket < 0) {
         return 0;
     }
     /* load destination IP address */
-    bvlc_dest.sin6_family = AF_INET6;
-    bvlc6_address_get(
-        dest, &addr16[0], &addr16[1], &addr16[2], &addr16[3], &addr16[4],
-        &addr16[5], &addr16[6], &addr16[7]);
-    bvlc_dest.sin6_addr.s6_addr16[0] = htons(addr16[0]);
-    bvlc_dest.sin6_addr.s6_addr16[1] = htons(addr16[1]);
-    bvlc_dest.sin6_addr.s6_addr16[2] = htons(addr16[2]);
-    bvlc_dest.sin6_addr.s6_addr16[3] = htons(addr16[3]);
-    bvlc_dest.sin6_addr.s6_addr16[4] = htons(addr16[4]);
-    bvlc_dest.sin6_addr.s6_addr16[5] = htons(addr16[5]);
-    bvlc_dest.sin6_addr.s6_addr16[6] = htons(addr16[6]);
-    bvlc_dest.sin6_addr.s6_addr16[7] = htons(addr16[7]);
-    bvlc_dest.sin6_port = htons(dest->port);
-    bvlc_dest.sin6_scope_id = BIP6_Socket_Scope_Id;
+    bip6_sockaddr_set(&bvlc_dest, dest);
     debug_print_ipv6("Sending MPDU->", &bvlc_dest.sin6_addr);
     /* Send the packet */
     return sendto(
@@ -270,6 +289,70 @@ int bip6_send_mpdu(
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
 }
 
+/**
+ * The send function for BACnet/IPv6 driver layer, sending the same MPDU
+ * to a list of destinations, e.g. the BDT or FDT of a BBMD. The datagrams
+ * are handed to the kernel in batches with one sendmmsg() call each.
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return Upon successful completion, returns the number of destinations
+ *  the MPDU was sent to. Otherwise, -1 shall be returned to indicate
+ *  the error.
+ */
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    struct sockaddr_in6 bvlc_dest[BIP6_SEND_BATCH_MAX];
+    struct mmsghdr msg[BIP6_SEND_BATCH_MAX];
+    struct iovec iov;
+    unsigned sent = 0;
+    unsigned count;
+    unsigned i;
+    int rv;
+
+    /* assumes that the driver has already been initialized */
+    if (BIP6_Socket < 0) {
+        return 0;
+    }
+    iov.iov_base = (void *)mtu;
+    iov.iov_len = mtu_len;
+    while (sent < dest_count) {
+        count = dest_count - sent;
+        if (count > BIP6_SEND_BATCH_MAX) {
+            count = BIP6_SEND_BATCH_MAX;
+        }
+        memset(msg, 0, sizeof(msg[0]) * count);
+        for (i = 0; i < count; i++) {
+            bip6_sockaddr_set(&bvlc_dest[i], &dest[sent + i]);
+            debug_print_ipv6("Sending MPDU->", &bvlc_dest[i].sin6_addr);
+            msg[i].msg_hdr.msg_name = &bvlc_dest[i];
+            msg[i].msg_hdr.msg_namelen = sizeof(bvlc_dest[i]);
+            msg[i].msg_hdr.msg_iov = &iov;
+            msg[i].msg_hdr.msg_iovlen = 1;
+        }
+        rv = sendmmsg(BIP6_Socket, msg, count, 0);
+        if (rv < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (sent > 0) ? (int)sent : -1;
+        }
+        if (rv == 0) {
+            break;
+        }
+        sent += (unsigned)rv;
+    }
+
+    return (int)sent;
+}
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -74,6 +74,8 @@ static dlmstp_hook_frame_rx_complete_cb Valid_Frame_Rx_Callback;
 static dlmstp_hook_frame_rx_complete_cb Valid_Frame_Not_For_Us_Rx_Callback;
 static dlmstp_hook_frame_rx_complete_cb Invalid_Frame_Rx_Callback;
 static DLMSTP_STATISTICS DLMSTP_Statistics;
+/* local timer for tracking the token rotation time */
+static struct mstimer Token_Rotation_Timer;
 static bool DLMSTP_Initialized;
 
 /**
@@ -423,6 +425,27 @@ void MSTP_Send_Frame(
 {
     RS485_Send_Frame(mstp_port, buffer, nbytes);
     DLMSTP_Statistics.transmit_frame_counter++;
+    if ((nbytes > 2) && (buffer[2] == FRAME_TYPE_REPLY_POSTPONED)) {
+        DLMSTP_Statistics.reply_postponed_counter++;
+    }
+}
+
+/**
+ * @brief Track the time between tokens received by this node
+ */
+static void dlmstp_token_received(void)
+{
+    uint32_t milliseconds;
+
+    if (DLMSTP_Statistics.token_received_counter > 0) {
+        milliseconds = mstimer_elapsed(&Token_Rotation_Timer);
+        DLMSTP_Statistics.token_rotation_milliseconds = milliseconds;
+        if (milliseconds > DLMSTP_Statistics.token_rotation_max_milliseconds) {
+            DLMSTP_Statistics.token_rotation_max_milliseconds = milliseconds;
+        }
+    }
+    mstimer_restart(&Token_Rotation_Timer);
+    DLMSTP_Statistics.token_received_counter++;
 }
 
 /**
@@ -609,6 +632,11 @@ static void *dlmstp_thread(void *pArg)
                         if (MSTP_Port.master_state ==
                             MSTP_MASTER_STATE_NO_TOKEN) {
                             DLMSTP_Statistics.lost_token_counter++;
+                        } else if (
+                            (master_state == MSTP_MASTER_STATE_IDLE) &&
+                            (MSTP_Port.master_state ==
+                             MSTP_MASTER_STATE_USE_TOKEN)) {
+                            dlmstp_token_received();
                         }
                         master_state = MSTP_Port.master_state;
                     }
@@ -1119,6 +1147,8 @@ bool dlmstp_init(char *ifname)
     MSTP_Port.BaudRate = dlmstp_baud_rate;
     MSTP_Port.BaudRateSet = dlmstp_set_baud_rate;
     MSTP_Init(&MSTP_Port);
+    /* RS485_Send_Frame() drains the UART before it returns */
+    MSTP_Port.TokenBurstEnabled = true;
 #if PRINT_ENABLED
     fprintf(stderr, "MS/TP MAC: %02X\n", MSTP_Port.This_Station);
     fprintf(stderr, "MS/TP Max_Master: %02X\n", MSTP_Port.Nmax_master);
@@ -96,6 +96,11 @@ void dlmstp_cleanup(void *poPort)
         return;
     }
 
+    /* stop the state machine before the port goes away */
+    if (poSharedData->Thread_Run) {
+        poSharedData->Thread_Run = false;
+        pthread_join(poSharedData->Thread, NULL);
+    }
     /* restore the old port settings */
     termios2_tcsetattr(
         poSharedData->RS485_Handle, TCSANOW, &poSharedData->RS485_oldtio2);
@@ -155,6 +160,7 @@ uint16_t dlmstp_receive(
     uint16_t pdu_len = 0;
     struct timespec abstime;
     int rv = 0;
+    DLMSTP_PACKET *pkt;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
     if (!mstp_port) {
@@ -164,28 +170,24 @@ uint16_t dlmstp_receive(
     if (!poSharedData) {
         return 0;
     }
-    (void)max_pdu;
     /* see if there is a packet available, and a place
        to put the reply (if necessary) and process it */
     get_abstime(&abstime, timeout);
     rv = sem_timedwait(&poSharedData->Receive_Packet_Flag, &abstime);
     if (rv == 0) {
-        if (poSharedData->Receive_Packet.ready) {
-            if (poSharedData->Receive_Packet.pdu_len) {
+        pkt = (DLMSTP_PACKET *)Ringbuf_Peek(&poSharedData->Receive_Queue);
+        if (pkt) {
+            if (pkt->pdu_len && (pkt->pdu_len <= max_pdu)) {
                 poSharedData->MSTP_Packets++;
                 if (src) {
-                    memmove(
-                        src, &poSharedData->Receive_Packet.address,
-                        sizeof(poSharedData->Receive_Packet.address));
+                    memmove(src, &pkt->address, sizeof(pkt->address));
                 }
                 if (pdu) {
-                    memmove(
-                        pdu, &poSharedData->Receive_Packet.pdu,
-                        sizeof(poSharedData->Receive_Packet.pdu));
+                    memmove(pdu, &pkt->pdu[0], pkt->pdu_len);
                 }
-                pdu_len = poSharedData->Receive_Packet.pdu_len;
+                pdu_len = pkt->pdu_len;
             }
-            poSharedData->Receive_Packet.ready = false;
+            (void)Ringbuf_Pop(&poSharedData->Receive_Queue, NULL);
         }
     }
 
@@ -245,7 +247,7 @@ static void *dlmstp_master_fsm_task(void *pArg)
         return NULL;
     }
 
-    for (;;) {
+    while (poSharedData->Thread_Run) {
         if (mstp_port->ReceivedValidFrame == false &&
             mstp_port->ReceivedValidFrameNotForUs == false &&
             mstp_port->ReceivedInvalidFrame == false) {
@@ -292,6 +294,39 @@ static void *dlmstp_master_fsm_task(void *pArg)
     return NULL;
 }
 
+/**
+ * @brief Start the state machine thread for one port
+ * @details Each trunk gets its own thread so that the token timing on
+ *  one trunk is not held up by another.  The thread is given a realtime
+ *  priority when the process is allowed one, and an ordinary priority
+ *  otherwise.
+ * @param thread - [out] handle of the created thread
+ * @param mstp_port - port specific data
+ * @return 0 on success, or an error number from pthread_create()
+ */
+static int
+dlmstp_thread_create(pthread_t *thread, struct mstp_port_struct_t *mstp_port)
+{
+    pthread_attr_t attr;
+    struct sched_param param;
+    int rv;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+    rv = pthread_create(thread, &attr, dlmstp_master_fsm_task, mstp_port);
+    pthread_attr_destroy(&attr);
+    if (rv == EPERM) {
+        /* not privileged: fall back to the default scheduler */
+        rv = pthread_create(thread, NULL, dlmstp_master_fsm_task, mstp_port);
+    }
+
+    return rv;
+}
+
 void dlmstp_fill_bacnet_address(BACNET_ADDRESS *src, uint8_t mstp_address)
 {
     int i = 0;
@@ -319,26 +354,30 @@ void dlmstp_fill_bacnet_address(BACNET_ADDRESS *src, uint8_t mstp_address)
 uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
 {
     uint16_t pdu_len = 0;
+    DLMSTP_PACKET *pkt;
     SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
 
     if (!poSharedData) {
         return 0;
     }
-
-    if (!poSharedData->Receive_Packet.ready) {
+    /* a full queue drops the frame rather than stalling the token */
+    pkt = (DLMSTP_PACKET *)Ringbuf_Data_Peek(&poSharedData->Receive_Queue);
+    if (pkt) {
         /* bounds check - maybe this should send an abort? */
         pdu_len = mstp_port->DataLength;
-        if (pdu_len > sizeof(poSharedData->Receive_Packet.pdu)) {
-            pdu_len = sizeof(poSharedData->Receive_Packet.pdu);
+        if (pdu_len > sizeof(pkt->pdu)) {
+            pdu_len = sizeof(pkt->pdu);
         }
         memmove(
-            (void *)&poSharedData->Receive_Packet.pdu[0],
-            (void *)&mstp_port->InputBuffer[0], pdu_len);
-        dlmstp_fill_bacnet_address(
-            &poSharedData->Receive_Packet.address, mstp_port->SourceAddress);
-        poSharedData->Receive_Packet.pdu_len = mstp_port->DataLength;
-        poSharedData->Receive_Packet.ready = true;
-        sem_post(&poSharedData->Receive_Packet_Flag);
+            (void *)&pkt->pdu[0], (void *)&mstp_port->InputBuffer[0], pdu_len);
+        dlmstp_fill_bacnet_address(&pkt->address, mstp_port->SourceAddress);
+        pkt->pdu_len = pdu_len;
+        pkt->ready = true;
+        if (Ringbuf_Data_Put(&poSharedData->Receive_Queue, (uint8_t *)pkt)) {
+            sem_post(&poSharedData->Receive_Packet_Flag);
+        } else {
+            pdu_len = 0;
+        }
     }
 
     return pdu_len;
@@ -770,7 +809,6 @@ void dlmstp_get_broadcast_address(BACNET_ADDRESS *dest)
 
 bool dlmstp_init(void *poPort, char *ifname)
 {
-    unsigned long hThread = 0;
     int rv = 0;
     SHARED_MSTP_DATA *poSharedData;
     struct termios2 newtio;
@@ -791,8 +829,9 @@ bool dlmstp_init(void *poPort, char *ifname)
         &poSharedData->PDU_Queue, (uint8_t *)&poSharedData->PDU_Buffer,
         sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
     /* initialize packet queue */
-    poSharedData->Receive_Packet.ready = false;
-    poSharedData->Receive_Packet.pdu_len = 0;
+    Ringbuf_Init(
+        &poSharedData->Receive_Queue, (uint8_t *)&poSharedData->Receive_Buffer,
+        sizeof(DLMSTP_PACKET), MSTP_RECEIVE_PACKET_COUNT);
     rv = sem_init(&poSharedData->Receive_Packet_Flag, 0, 0);
     if (rv != 0) {
         fprintf(
@@ -862,12 +901,16 @@ bool dlmstp_init(void *poPort, char *ifname)
     mstp_port->SilenceTimer = Timer_Silence;
     mstp_port->SilenceTimerReset = Timer_Silence_Reset;
     MSTP_Init(mstp_port);
+    /* RS485_Send_Frame() drains the UART before it returns */
+    mstp_port->TokenBurstEnabled = true;
     debug_fprintf(stderr, "MS/TP MAC: %02X\n", mstp_port->This_Station);
     debug_fprintf(stderr, "MS/TP Max_Master: %02X\n", mstp_port->Nmax_master);
     debug_fprintf(
         stderr, "MS/TP Max_Info_Frames: %u\n", mstp_port->Nmax_info_frames);
-    rv = pthread_create(&hThread, NULL, dlmstp_master_fsm_task, mstp_port);
+    poSharedData->Thread_Run = true;
+    rv = dlmstp_thread_create(&poSharedData->Thread, mstp_port);
     if (rv != 0) {
+        poSharedData->Thread_Run = false;
         fprintf(stderr, "Failed to start Master Node FSM task\n");
     }
 
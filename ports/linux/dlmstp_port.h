@@ -12,6 +12,7 @@
 /*#include "bacnet/datalink/dlmstp.h" */
 #include <sys/types.h>
 #include <semaphore.h>
+#include <pthread.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -32,6 +33,10 @@
 #ifndef MSTP_PDU_PACKET_COUNT
 #define MSTP_PDU_PACKET_COUNT 8
 #endif
+/* count must be a power of 2 for ringbuf library */
+#ifndef MSTP_RECEIVE_PACKET_COUNT
+#define MSTP_RECEIVE_PACKET_COUNT 8
+#endif
 
 typedef struct dlmstp_packet {
     bool ready; /* true if ready to be sent or received */
@@ -54,11 +59,12 @@ typedef struct shared_mstp_data {
     uint16_t MSTP_Packets;
 
     /* packet queues */
-    DLMSTP_PACKET Receive_Packet;
     DLMSTP_PACKET Transmit_Packet;
-    /*
-       RT_SEM Receive_Packet_Flag;
-     */
+    /* received frames: the port thread is the only producer and
+       dlmstp_receive() the only consumer, so no lock is needed */
+    RING_BUFFER Receive_Queue;
+    DLMSTP_PACKET Receive_Buffer[MSTP_RECEIVE_PACKET_COUNT];
+    /* counts the frames waiting in the Receive_Queue */
     sem_t Receive_Packet_Flag;
     /* mechanism to wait for a frame in state machine */
     /*
@@ -96,6 +102,9 @@ typedef struct shared_mstp_data {
 
     struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
 
+    /* one state machine thread per port */
+    pthread_t Thread;
+    volatile bool Thread_Run;
 } SHARED_MSTP_DATA;
 
 #ifdef __cplusplus
@@ -9,6 +9,10 @@
 #include <stdbool.h> /* for the standard bool type. */
 
 #include "bacport.h"
+#include <poll.h>
+#include <sys/mman.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/datalink/ethernet.h"
 #include "bacnet/bacint.h"
@@ -16,6 +20,23 @@
 /** @file linux/ethernet.c  Provides Linux-specific functions for
  * BACnet/Ethernet. */
 
+/* TPACKET_V3 receive ring shared with the kernel.  Frames are read in
+   place, a block at a time, instead of one read() and copy per frame.
+   Set ETHERNET_RX_RING_BLOCK_COUNT to 0 to use plain reads. */
+#ifndef ETHERNET_RX_RING_BLOCK_SIZE
+#define ETHERNET_RX_RING_BLOCK_SIZE (1 << 16)
+#endif
+#ifndef ETHERNET_RX_RING_BLOCK_COUNT
+#define ETHERNET_RX_RING_BLOCK_COUNT 8
+#endif
+#ifndef ETHERNET_RX_RING_FRAME_SIZE
+#define ETHERNET_RX_RING_FRAME_SIZE 2048
+#endif
+/* milliseconds before the kernel hands over a partly filled block */
+#ifndef ETHERNET_RX_RING_BLOCK_TIMEOUT
+#define ETHERNET_RX_RING_BLOCK_TIMEOUT 10
+#endif
+
 /* commonly used comparison address for ethernet */
 uint8_t Ethernet_Broadcast[MAX_MAC_LEN] = {
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
@@ -27,7 +48,34 @@ uint8_t Ethernet_Empty_MAC[MAX_MAC_LEN] = { 0, 0, 0, 0, 0, 0 };
 uint8_t Ethernet_MAC_Address[MAX_MAC_LEN] = { 0 };
 
 static int eth802_sockfd = -1; /* 802.2 file handle */
-static struct sockaddr eth_addr = { 0 }; /* used for binding 802.2 */
+static struct sockaddr_ll eth_addr = { 0 }; /* used for binding 802.2 */
+
+/* receive ring state */
+static struct {
+    uint8_t *map;
+    size_t map_len;
+    unsigned block;
+    struct tpacket_block_desc *desc;
+    struct tpacket3_hdr *frame;
+    unsigned frames;
+} Rx_Ring;
+
+/* kernel filter: keep only frames addressed to the BACnet LSAP (0x82),
+   and not the copies of our own transmitted frames */
+static struct sock_filter BACnet_LSAP_Filter[] = {
+    /* ld pkttype */
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_AD_OFF + SKF_AD_PKTTYPE),
+    /* jeq #PACKET_OUTGOING, drop */
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, PACKET_OUTGOING, 3, 0),
+    /* ldb [14] - DSAP */
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 14),
+    /* jeq #0x82, keep, drop */
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x82, 0, 1),
+    /* keep: ret #ETHERNET_MPDU_MAX */
+    BPF_STMT(BPF_RET | BPF_K, ETHERNET_MPDU_MAX),
+    /* drop: ret #0 */
+    BPF_STMT(BPF_RET | BPF_K, 0),
+};
 
 bool ethernet_valid(void)
 {
@@ -36,6 +84,10 @@ bool ethernet_valid(void)
 
 void ethernet_cleanup(void)
 {
+    if (Rx_Ring.map) {
+        munmap(Rx_Ring.map, Rx_Ring.map_len);
+    }
+    memset(&Rx_Ring, 0, sizeof(Rx_Ring));
     if (ethernet_valid()) {
         close(eth802_sockfd);
     }
@@ -65,14 +117,63 @@ int setNonblocking(
 }
 #endif
 
+/**
+ * @brief Set up the TPACKET_V3 receive ring on the socket
+ * @param sock_fd - packet socket
+ * @return true if the ring is mapped, false to use plain reads
+ */
+static bool ethernet_rx_ring_init(int sock_fd)
+{
+    struct tpacket_req3 req = { 0 };
+    int version = TPACKET_V3;
+    void *map;
+
+    memset(&Rx_Ring, 0, sizeof(Rx_Ring));
+    if (ETHERNET_RX_RING_BLOCK_COUNT == 0) {
+        return false;
+    }
+    if (setsockopt(
+            sock_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) !=
+        0) {
+        return false;
+    }
+    req.tp_block_size = ETHERNET_RX_RING_BLOCK_SIZE;
+    req.tp_block_nr = ETHERNET_RX_RING_BLOCK_COUNT;
+    req.tp_frame_size = ETHERNET_RX_RING_FRAME_SIZE;
+    req.tp_frame_nr = (ETHERNET_RX_RING_BLOCK_SIZE /
+                       ETHERNET_RX_RING_FRAME_SIZE) *
+        ETHERNET_RX_RING_BLOCK_COUNT;
+    req.tp_retire_blk_tov = ETHERNET_RX_RING_BLOCK_TIMEOUT;
+    if (setsockopt(sock_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) !=
+        0) {
+        return false;
+    }
+    Rx_Ring.map_len = (size_t)req.tp_block_size * req.tp_block_nr;
+    map = mmap(
+        NULL, Rx_Ring.map_len, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_LOCKED, sock_fd, 0);
+    if (map == MAP_FAILED) {
+        /* MAP_LOCKED can fail under RLIMIT_MEMLOCK, so try without */
+        map = mmap(
+            NULL, Rx_Ring.map_len, PROT_READ | PROT_WRITE, MAP_SHARED, sock_fd,
+            0);
+    }
+    if (map == MAP_FAILED) {
+        Rx_Ring.map_len = 0;
+        return false;
+    }
+    Rx_Ring.map = map;
+
+    return true;
+}
+
 /* opens an 802.2 socket to receive and send packets */
-static int ethernet_bind(struct sockaddr *eth_addr, const char *interface_name)
+static int
+ethernet_bind(struct sockaddr_ll *eth_addr, const char *interface_name)
 {
     int sock_fd = -1; /* return value */
-#if 0
-    int sockopt = 0;
-#endif
     int uid = 0;
+    struct sock_fprog filter = { 0 };
 
     fprintf(stderr, "ethernet: opening \"%s\"\n", interface_name);
     /* check to see if we are being run as root */
@@ -88,11 +189,9 @@ static int ethernet_bind(struct sockaddr *eth_addr, const char *interface_name)
     /* modules.conf (or in modutils/alias on Debian with update-modules) */
     /* alias net-pf-17 af_packet */
     /* Then follow it by: # modprobe af_packet */
-    /* Note: PF_INET/SOCK_PACKET has been replaced with
-       PF_PACKET/(SOCK_PACKET, SOCK_DGRAM, SOCK_RAW). */
 
     /* Attempt to open the socket for 802.2 ethernet frames */
-    if ((sock_fd = socket(PF_INET, SOCK_PACKET, htons(ETH_P_802_2))) < 0) {
+    if ((sock_fd = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_802_2))) < 0) {
         /* Error occured */
         fprintf(
             stderr, "ethernet: Error opening socket: %s\n", strerror(errno));
@@ -106,25 +205,32 @@ static int ethernet_bind(struct sockaddr *eth_addr, const char *interface_name)
             "# modprobe af_packet\n");
         exit(-1);
     }
-#if 0
-    /* It is very advisable to do a IP_HDRINCL call, to make sure
-       that the kernel knows the header is included in the data,
-       and doesn't insert its own header into the packet before our data */
-    if (setsockopt(sock_fd, IPPROTO_IP, IP_HDRINCL, &sockopt,
-            sizeof(sockopt)) < 0) {
-        printf("Warning: Cannot set HDRINCL!\n");
+    /* drop non-BACnet frames in the kernel, before they are queued */
+    filter.len = sizeof(BACnet_LSAP_Filter) / sizeof(BACnet_LSAP_Filter[0]);
+    filter.filter = BACnet_LSAP_Filter;
+    if (setsockopt(
+            sock_fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) !=
+        0) {
+        fprintf(
+            stderr, "ethernet: Unable to attach LSAP filter: %s\n",
+            strerror(errno));
+    }
+    if (ethernet_rx_ring_init(sock_fd)) {
+        fprintf(
+            stderr, "ethernet: receive ring %u x %u bytes\n",
+            (unsigned)ETHERNET_RX_RING_BLOCK_COUNT,
+            (unsigned)ETHERNET_RX_RING_BLOCK_SIZE);
     }
-#endif
     /* Bind the socket to an address */
-    eth_addr->sa_family = PF_INET;
-    /* Clear the memory before copying */
-    memset(eth_addr->sa_data, '\0', sizeof(eth_addr->sa_data));
-    /* Strcpy the interface name into the address */
-    snprintf(
-        eth_addr->sa_data, sizeof(eth_addr->sa_data), "%s", interface_name);
-    fprintf(stderr, "ethernet: binding \"%s\"\n", eth_addr->sa_data);
+    memset(eth_addr, 0, sizeof(*eth_addr));
+    eth_addr->sll_family = AF_PACKET;
+    eth_addr->sll_protocol = htons(ETH_P_802_2);
+    eth_addr->sll_ifindex = (int)if_nametoindex(interface_name);
+    fprintf(stderr, "ethernet: binding \"%s\"\n", interface_name);
     /* Attempt to bind the socket to the interface */
-    if (bind(sock_fd, eth_addr, sizeof(struct sockaddr)) != 0) {
+    if ((eth_addr->sll_ifindex == 0) ||
+        (bind(sock_fd, (struct sockaddr *)eth_addr, sizeof(*eth_addr)) !=
+         0)) {
         /* Bind problem, close socket and return */
         fprintf(
             stderr, "ethernet: Unable to bind 802.2 socket : %s\n",
@@ -188,8 +294,8 @@ int ethernet_send(uint8_t *mtu, int mtu_len)
 
     /* Send the packet */
     bytes = sendto(
-        eth802_sockfd, &mtu, mtu_len, 0, (struct sockaddr *)&eth_addr,
-        sizeof(struct sockaddr));
+        eth802_sockfd, mtu, mtu_len, 0, (struct sockaddr *)&eth_addr,
+        sizeof(eth_addr));
     /* did it get sent? */
     if (bytes < 0) {
         fprintf(
@@ -261,7 +367,7 @@ int ethernet_send_pdu(
     /* Send the packet */
     bytes = sendto(
         eth802_sockfd, &mtu, mtu_len, 0, (struct sockaddr *)&eth_addr,
-        sizeof(struct sockaddr));
+        sizeof(eth_addr));
     /* did it get sent? */
     if (bytes < 0) {
         fprintf(
@@ -271,6 +377,127 @@ int ethernet_send_pdu(
     return bytes;
 }
 
+/**
+ * @brief Decode a received 802.2 frame into the PDU
+ * @param buf - the frame, starting with the destination MAC address
+ * @param buf_len - number of bytes in the frame
+ * @param src - source address
+ * @param pdu - PDU data
+ * @param max_pdu - amount of space available in the PDU
+ * @return the number of octets in the PDU, or zero if not for us
+ */
+static uint16_t ethernet_frame_decode(
+    const uint8_t *buf,
+    unsigned buf_len,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu)
+{
+    uint16_t pdu_len = 0; /* return value */
+
+    if (buf_len < ETHERNET_HEADER_MAX) {
+        return 0;
+    }
+    /* the signature of an 802.2 BACnet packet */
+    if ((buf[14] != 0x82) && (buf[15] != 0x82)) {
+        /*fprintf(stderr,"ethernet: Non-BACnet packet\n"); */
+        return 0;
+    }
+    /* check destination address for when */
+    /* the Ethernet card is in promiscious mode */
+    if ((memcmp(&buf[0], Ethernet_MAC_Address, 6) != 0) &&
+        (memcmp(&buf[0], Ethernet_Broadcast, 6) != 0)) {
+        /*fprintf(stderr, "ethernet: This packet isn't for us\n"); */
+        return 0;
+    }
+    /* copy the source address */
+    src->mac_len = 6;
+    memmove(src->mac, &buf[6], 6);
+    (void)decode_unsigned16(&buf[12], &pdu_len);
+    if ((pdu_len < 3) || ((pdu_len - 3U) > (buf_len - ETHERNET_HEADER_MAX))) {
+        return 0;
+    }
+    pdu_len -= 3 /* DSAP, SSAP, LLC Control */;
+    /* copy the buffer into the PDU */
+    if (pdu_len < max_pdu) {
+        memmove(&pdu[0], &buf[17], pdu_len);
+    }
+    /* ignore packets that are too large */
+    else {
+        pdu_len = 0;
+    }
+
+    return pdu_len;
+}
+
+/**
+ * @brief Receive the next BACnet frame from the receive ring
+ * @details Frames are decoded in place.  A block is handed back to the
+ *  kernel once all of its frames have been read.
+ * @param src - source address
+ * @param pdu - PDU data
+ * @param max_pdu - amount of space available in the PDU
+ * @param timeout - number of milliseconds to wait for a block
+ * @return the number of octets in the PDU, or zero on failure
+ */
+static uint16_t ethernet_rx_ring_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    struct tpacket_block_desc *desc;
+    struct tpacket3_hdr *frame;
+    struct pollfd pfd;
+    uint16_t pdu_len = 0;
+    bool waited = false;
+
+    for (;;) {
+        if (Rx_Ring.frames == 0) {
+            if (Rx_Ring.desc) {
+                /* done with this block - give it back to the kernel */
+                __sync_synchronize();
+                Rx_Ring.desc->hdr.bh1.block_status = TP_STATUS_KERNEL;
+                Rx_Ring.desc = NULL;
+                Rx_Ring.block =
+                    (Rx_Ring.block + 1) % ETHERNET_RX_RING_BLOCK_COUNT;
+            }
+            desc = (struct tpacket_block_desc *)(Rx_Ring.map +
+                                                 ((size_t)Rx_Ring.block *
+                                                  ETHERNET_RX_RING_BLOCK_SIZE));
+            if ((desc->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+                if (waited) {
+                    break;
+                }
+                waited = true;
+                pfd.fd = eth802_sockfd;
+                pfd.events = POLLIN | POLLERR;
+                pfd.revents = 0;
+                if (poll(&pfd, 1, (int)timeout) <= 0) {
+                    break;
+                }
+                continue;
+            }
+            __sync_synchronize();
+            Rx_Ring.desc = desc;
+            Rx_Ring.frames = desc->hdr.bh1.num_pkts;
+            Rx_Ring.frame =
+                (struct tpacket3_hdr *)((uint8_t *)desc +
+                                        desc->hdr.bh1.offset_to_first_pkt);
+            continue;
+        }
+        frame = Rx_Ring.frame;
+        Rx_Ring.frames--;
+        Rx_Ring.frame =
+            (struct tpacket3_hdr *)((uint8_t *)frame + frame->tp_next_offset);
+        pdu_len = ethernet_frame_decode(
+            (uint8_t *)frame + frame->tp_mac, frame->tp_snaplen, src, pdu,
+            max_pdu);
+        if (pdu_len > 0) {
+            break;
+        }
+    }
+
+    return pdu_len;
+}
+
 /* receives an 802.2 framed packet */
 /* returns the number of octets in the PDU, or zero on failure */
 uint16_t ethernet_receive(
@@ -281,7 +508,6 @@ uint16_t ethernet_receive(
 { /* number of milliseconds to wait for a packet */
     int received_bytes;
     uint8_t buf[ETHERNET_MPDU_MAX] = { 0 }; /* data */
-    uint16_t pdu_len = 0; /* return value */
     fd_set read_fds;
     int max;
     struct timeval select_timeout;
@@ -290,6 +516,9 @@ uint16_t ethernet_receive(
     if (eth802_sockfd <= 0) {
         return 0;
     }
+    if (Rx_Ring.map) {
+        return ethernet_rx_ring_receive(src, pdu, max_pdu, timeout);
+    }
 
     /* we could just use a non-blocking socket, but that consumes all
        the CPU time.  We can use a timeout; it is only supported as
@@ -329,35 +558,8 @@ uint16_t ethernet_receive(
         return 0;
     }
 
-    /* the signature of an 802.2 BACnet packet */
-    if ((buf[14] != 0x82) && (buf[15] != 0x82)) {
-        /*fprintf(stderr,"ethernet: Non-BACnet packet\n"); */
-        return 0;
-    }
-    /* copy the source address */
-    src->mac_len = 6;
-    memmove(src->mac, &buf[6], 6);
-
-    /* check destination address for when */
-    /* the Ethernet card is in promiscious mode */
-    if ((memcmp(&buf[0], Ethernet_MAC_Address, 6) != 0) &&
-        (memcmp(&buf[0], Ethernet_Broadcast, 6) != 0)) {
-        /*fprintf(stderr, "ethernet: This packet isn't for us\n"); */
-        return 0;
-    }
-
-    (void)decode_unsigned16(&buf[12], &pdu_len);
-    pdu_len -= 3 /* DSAP, SSAP, LLC Control */;
-    /* copy the buffer into the PDU */
-    if (pdu_len < max_pdu) {
-        memmove(&pdu[0], &buf[17], pdu_len);
-    }
-    /* ignore packets that are too large */
-    else {
-        pdu_len = 0;
-    }
-
-    return pdu_len;
+    return ethernet_frame_decode(
+        &buf[0], (unsigned)received_bytes, src, pdu, max_pdu);
 }
 
 void ethernet_set_my_address(const BACNET_ADDRESS *my_address)
@@ -28,6 +28,15 @@
 
 #define BSC_RX_BUFFER_LEN BSC_WEBSOCKET_RX_BUFFER_LEN
 
+/* libwebsockets can run at most LWS_MAX_SMP service threads per context */
+#if BSC_WEBSOCKET_SERVER_THREADS_NUM < 1
+#error "BSC_CONF_WEBSOCKET_SERVER_THREADS_NUM must be >= 1"
+#elif BSC_WEBSOCKET_SERVER_THREADS_NUM > LWS_MAX_SMP
+#define BSC_SRV_THREADS_NUM LWS_MAX_SMP
+#else
+#define BSC_SRV_THREADS_NUM BSC_WEBSOCKET_SERVER_THREADS_NUM
+#endif
+
 #ifndef LWS_PROTOCOL_LIST_TERM
 #define LWS_PROTOCOL_LIST_TERM       \
     {                                \
@@ -87,6 +96,15 @@ static BSC_WEBSOCKET_CONNECTION
 static BSC_WEBSOCKET_CONNECTION bws_direct_conn[1][1] = { 0 };
 #endif
 
+struct BACNetWebsocketServerContext;
+
+/* one libwebsockets service thread, identified by its tsi */
+typedef struct {
+    struct BACNetWebsocketServerContext *ctx;
+    int tsi;
+    pthread_t thread_id;
+} BSC_WEBSOCKET_SERVICE;
+
 typedef struct BACNetWebsocketServerContext {
     bool used;
     struct lws_context *wsctx;
@@ -96,6 +114,9 @@ typedef struct BACNetWebsocketServerContext {
     BSC_WEBSOCKET_SRV_DISPATCH dispatch_func;
     void *user_param;
     bool stop_worker;
+    /* service[0] is run by bws_srv_worker(), the others are started by it */
+    BSC_WEBSOCKET_SERVICE service[BSC_SRV_THREADS_NUM];
+    int service_num;
 } BSC_WEBSOCKET_CONTEXT;
 
 static BSC_WEBSOCKET_CONTEXT bws_hub_ctx[BSC_CONF_WEBSOCKET_SERVERS_NUM] = {
@@ -312,15 +333,20 @@ bws_srv_free_connection(BSC_WEBSOCKET_CONTEXT *ctx, BSC_WEBSOCKET_HANDLE h)
     DEBUG_PRINTF("bws_srv_free_connection() <<<\n");
 }
 
+/* The per-session data of each wsi holds its connection handle + 1, */
+/* so that the zeroed data of a new wsi does not match handle 0 */
 static BSC_WEBSOCKET_HANDLE
-bws_find_connnection(BSC_WEBSOCKET_CONTEXT *ctx, struct lws *ws)
+bws_find_connnection(BSC_WEBSOCKET_CONTEXT *ctx, struct lws *ws, void *user)
 {
-    int i;
-    for (i = 0; i < bws_srv_get_max_sockets(ctx->proto); i++) {
-        if (ctx->conn[i].ws == ws &&
-            ctx->conn[i].state != BSC_WEBSOCKET_STATE_IDLE) {
-            return i;
-        }
+    BSC_WEBSOCKET_HANDLE h = BSC_WEBSOCKET_INVALID_HANDLE;
+
+    if (user) {
+        h = *((BSC_WEBSOCKET_HANDLE *)user) - 1;
+    }
+    if (h >= 0 && h < bws_srv_get_max_sockets(ctx->proto) &&
+        ctx->conn[h].ws == ws &&
+        ctx->conn[h].state != BSC_WEBSOCKET_STATE_IDLE) {
+        return h;
     }
     return BSC_WEBSOCKET_INVALID_HANDLE;
 }
@@ -341,7 +367,6 @@ static int bws_srv_websocket_event(
     bool stop_worker;
     uint8_t err_code[2];
     uint16_t err;
-    (void)user;
 
     DEBUG_PRINTF(
         "bws_srv_websocket_event() >>> ctx = %p, user_param = %p, "
@@ -367,6 +392,9 @@ static int bws_srv_websocket_event(
             ctx->conn[h].ws = wsi;
             ctx->conn[h].state = BSC_WEBSOCKET_STATE_CONNECTED;
             ctx->conn[h].err_code = ERROR_CODE_SUCCESS;
+            if (user) {
+                *((BSC_WEBSOCKET_HANDLE *)user) = h + 1;
+            }
             dispatch_func = ctx->dispatch_func;
             user_param = ctx->user_param;
             pthread_mutex_unlock(ctx->mutex);
@@ -380,7 +408,7 @@ static int bws_srv_websocket_event(
         case LWS_CALLBACK_CLOSED: {
             DEBUG_PRINTF("bws_srv_websocket_event() closed connection\n");
             pthread_mutex_lock(ctx->mutex);
-            h = bws_find_connnection(ctx, wsi);
+            h = bws_find_connnection(ctx, wsi, user);
             if (h == BSC_WEBSOCKET_INVALID_HANDLE) {
                 pthread_mutex_unlock(ctx->mutex);
             } else {
@@ -406,7 +434,7 @@ static int bws_srv_websocket_event(
         }
         case LWS_CALLBACK_WS_PEER_INITIATED_CLOSE: {
             pthread_mutex_lock(ctx->mutex);
-            h = bws_find_connnection(ctx, wsi);
+            h = bws_find_connnection(ctx, wsi, user);
             if (h != BSC_WEBSOCKET_INVALID_HANDLE && len >= 2) {
                 err_code[0] = ((uint8_t *)in)[1];
                 err_code[1] = ((uint8_t *)in)[0];
@@ -417,7 +445,7 @@ static int bws_srv_websocket_event(
         }
         case LWS_CALLBACK_RECEIVE: {
             pthread_mutex_lock(ctx->mutex);
-            h = bws_find_connnection(ctx, wsi);
+            h = bws_find_connnection(ctx, wsi, user);
             if (h == BSC_WEBSOCKET_INVALID_HANDLE) {
                 pthread_mutex_unlock(ctx->mutex);
             } else {
@@ -522,7 +550,7 @@ static int bws_srv_websocket_event(
             DEBUG_PRINTF(
                 "bws_srv_websocket_event() ctx %p proto %d can write\n", ctx,
                 ctx->proto);
-            h = bws_find_connnection(ctx, wsi);
+            h = bws_find_connnection(ctx, wsi, user);
             if (h == BSC_WEBSOCKET_INVALID_HANDLE) {
                 pthread_mutex_unlock(ctx->mutex);
             } else {
@@ -571,10 +599,86 @@ static int bws_srv_websocket_event(
     return ret;
 }
 
+/**
+ * @brief Ask libwebsockets for writeable callbacks on the connections
+ *        which are served by a service thread. Must be called with
+ *        ctx->mutex locked.
+ * @param ctx - websocket server context
+ * @param tsi - service thread index
+ */
+static void bws_srv_service_connections(BSC_WEBSOCKET_CONTEXT *ctx, int tsi)
+{
+    int i;
+
+    for (i = 0; i < bws_srv_get_max_sockets(ctx->proto); i++) {
+        DEBUG_PRINTF(
+            "bws_srv_worker() ctx %p user_param %p proto %d "
+            "socket %d(%p) state = %d\n",
+            ctx, ctx->user_param, ctx->proto, i, &ctx->conn[i],
+            ctx->conn[i].state);
+        if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_IDLE) {
+            continue;
+        }
+        /* a wsi may only be asked for writeable callbacks from
+           the service thread which owns it */
+        if (ctx->service_num > 1 && lws_get_tsi(ctx->conn[i].ws) != tsi) {
+            continue;
+        }
+        if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_CONNECTED) {
+            if (ctx->conn[i].want_send_data) {
+                DEBUG_PRINTF(
+                    "bws_srv_worker() process request for sending "
+                    "data on socket %d\n",
+                    i);
+                lws_callback_on_writable(ctx->conn[i].ws);
+            }
+        } else if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_DISCONNECTING) {
+            DEBUG_PRINTF(
+                "bws_srv_worker() process disconnecting event on "
+                "socket %d\n",
+                i);
+            lws_callback_on_writable(ctx->conn[i].ws);
+        }
+    }
+}
+
+/**
+ * @brief Additional service thread of a websocket server, used when
+ *        libwebsockets runs in multi-service-thread mode. It stops when
+ *        the server is stopped and is joined by bws_srv_worker().
+ * @param arg - pointer to BSC_WEBSOCKET_SERVICE
+ */
+static void *bws_srv_service_worker(void *arg)
+{
+    BSC_WEBSOCKET_SERVICE *service = (BSC_WEBSOCKET_SERVICE *)arg;
+    BSC_WEBSOCKET_CONTEXT *ctx = service->ctx;
+
+    DEBUG_PRINTF(
+        "bws_srv_service_worker() started for ctx %p tsi %d\n", ctx,
+        service->tsi);
+
+    while (1) {
+        pthread_mutex_lock(ctx->mutex);
+        if (ctx->stop_worker) {
+            pthread_mutex_unlock(ctx->mutex);
+            break;
+        }
+        bws_srv_service_connections(ctx, service->tsi);
+        pthread_mutex_unlock(ctx->mutex);
+        lws_service_tsi(ctx->wsctx, 0, service->tsi);
+    }
+
+    DEBUG_PRINTF(
+        "bws_srv_service_worker() ctx %p tsi %d stopped\n", ctx,
+        service->tsi);
+    return NULL;
+}
+
 static void *bws_srv_worker(void *arg)
 {
     BSC_WEBSOCKET_CONTEXT *ctx = (BSC_WEBSOCKET_CONTEXT *)arg;
     int i;
+    int started = 1;
     BSC_WEBSOCKET_SRV_DISPATCH dispatch_func;
     void *user_param;
 
@@ -591,6 +695,26 @@ static void *bws_srv_worker(void *arg)
         (BSC_WEBSOCKET_SRV_HANDLE)ctx, 0, BSC_WEBSOCKET_SERVER_STARTED, 0, NULL,
         NULL, 0, user_param);
 
+    for (i = 1; i < ctx->service_num; i++) {
+        ctx->service[i].ctx = ctx;
+        ctx->service[i].tsi = i;
+        if (pthread_create(
+                &ctx->service[i].thread_id, NULL, &bws_srv_service_worker,
+                &ctx->service[i]) != 0) {
+            /* connections of this tsi would never be serviced */
+            DEBUG_PRINTF(
+                "bws_srv_worker() ctx %p can not start service thread %d, "
+                "stopping\n",
+                ctx, i);
+            pthread_mutex_lock(ctx->mutex);
+            ctx->stop_worker = true;
+            pthread_mutex_unlock(ctx->mutex);
+            lws_cancel_service(ctx->wsctx);
+            break;
+        }
+        started++;
+    }
+
     while (1) {
         DEBUG_PRINTF(
             "bws_srv_worker() ctx %p proto %d blocked user_param %p\n", ctx,
@@ -622,6 +746,11 @@ static void *bws_srv_worker(void *arg)
                        protected by global websocket mutex.
             */
             pthread_mutex_unlock(ctx->mutex);
+            /* the other service threads see stop_worker once they are
+               woken up by lws_cancel_service() in bws_srv_stop() */
+            for (i = 1; i < started; i++) {
+                pthread_join(ctx->service[i].thread_id, NULL);
+            }
             bsc_websocket_global_lock();
             lws_context_destroy(ctx->wsctx);
             bsc_websocket_global_unlock();
@@ -646,29 +775,7 @@ static void *bws_srv_worker(void *arg)
             return NULL;
         }
 
-        for (i = 0; i < bws_srv_get_max_sockets(ctx->proto); i++) {
-            DEBUG_PRINTF(
-                "bws_srv_worker() ctx %p user_param %p proto %d "
-                "socket %d(%p) state = %d\n",
-                ctx, ctx->user_param, ctx->proto, i, &ctx->conn[i],
-                ctx->conn[i].state);
-            if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_CONNECTED) {
-                if (ctx->conn[i].want_send_data) {
-                    DEBUG_PRINTF(
-                        "bws_srv_worker() process request for sending "
-                        "data on socket %d\n",
-                        i);
-                    lws_callback_on_writable(ctx->conn[i].ws);
-                }
-            } else if (
-                ctx->conn[i].state == BSC_WEBSOCKET_STATE_DISCONNECTING) {
-                DEBUG_PRINTF(
-                    "bws_srv_worker() process disconnecting event on "
-                    "socket %d\n",
-                    i);
-                lws_callback_on_writable(ctx->conn[i].ws);
-            }
-        }
+        bws_srv_service_connections(ctx, 0);
 
         DEBUG_PRINTF(
             "bws_srv_worker() ctx %p proto %d unblocked\n", ctx, ctx->proto);
@@ -704,7 +811,8 @@ BSC_WEBSOCKET_RET bws_srv_start(
     BSC_WEBSOCKET_CONTEXT *ctx;
     pthread_attr_t attr;
     int r;
-    struct lws_protocols protos[] = { { NULL, bws_srv_websocket_event, 0, 0, 0,
+    struct lws_protocols protos[] = { { NULL, bws_srv_websocket_event,
+                                        sizeof(BSC_WEBSOCKET_HANDLE), 0, 0,
                                         NULL, 0 },
                                       LWS_PROTOCOL_LIST_TERM };
     protos[0].name = (proto == BSC_WEBSOCKET_HUB_PROTOCOL)
@@ -763,6 +871,10 @@ BSC_WEBSOCKET_RET bws_srv_start(
     info.timeout_secs = timeout_s;
     info.connect_timeout_secs = timeout_s;
     info.user = ctx;
+    /* each service thread owns a share of the connections, including
+       their TLS handshakes and encryption */
+    info.count_threads = BSC_SRV_THREADS_NUM;
+    ctx->service_num = BSC_SRV_THREADS_NUM;
 
     /* TRICKY: check comments related to lws_context_destroy() call */
 
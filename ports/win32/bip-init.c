@@ -603,6 +603,20 @@ bool bip_get_addr_by_name(const char *host_name, BACNET_IP_ADDRESS *addr)
     return true;
 }
 
+/**
+ * @brief gets an IP address by hostname (or string of numbers) without
+ *  waiting on the name resolver.
+ * @note This port has no background resolver, so the lookup is done
+ *  in place by bip_get_addr_by_name().
+ * @param host_name - the host name
+ * @param addr - IPv4 address
+ * @return true if the address was retrieved
+ */
+bool bip_get_addr_by_name_async(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    return bip_get_addr_by_name(host_name, addr);
+}
+
 /* To fill a need, we invent the gethostaddr() function. */
 static long gethostaddr(void)
 {
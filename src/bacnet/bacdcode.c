@@ -798,6 +798,65 @@ int bacnet_application_data_length(uint8_t tag_number, uint32_t len_value_type)
     return len;
 }
 
+/**
+ * @brief Scan one tag and step over its value, without decoding either.
+ *  The first octet of most tags holds their number and length, so that
+ *  case is handled without branches into the full tag decoder.
+ * @param apdu Pointer to the tag
+ * @param apdu_size Bytes valid in the buffer, at least one
+ * @param nesting [out] 1 for an opening tag, -1 for a closing tag, else 0
+ * @param tag_number [out] the tag number
+ * @return length of the tag and its value, which may exceed apdu_size,
+ *  or 0 if the tag is malformed.
+ */
+static uint32_t bacnet_tag_scan(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    int *nesting,
+    uint8_t *tag_number)
+{
+    uint8_t octet = apdu[0];
+    uint32_t lvt = octet & 0x07;
+    BACNET_TAG tag = { 0 };
+    int len;
+
+    *nesting = 0;
+    if (!IS_EXTENDED_TAG_NUMBER(octet) && (lvt < 5)) {
+        *tag_number = octet >> 4;
+        if (!IS_CONTEXT_SPECIFIC(octet) &&
+            ((*tag_number <= BACNET_APPLICATION_TAG_BOOLEAN) ||
+             (*tag_number > BACNET_APPLICATION_TAG_OBJECT_ID))) {
+            /* NULL and BOOLEAN have no value after the tag */
+            lvt = 0;
+        }
+        return 1 + lvt;
+    }
+    len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if (len <= 0) {
+        return 0;
+    }
+    *tag_number = tag.number;
+    if (tag.opening) {
+        *nesting = 1;
+        return (uint32_t)len;
+    }
+    if (tag.closing) {
+        *nesting = -1;
+        return (uint32_t)len;
+    }
+    if (tag.application) {
+        lvt = (uint32_t)bacnet_application_data_length(
+            tag.number, tag.len_value_type);
+    } else {
+        lvt = tag.len_value_type;
+    }
+    if (lvt > (UINT32_MAX - (uint32_t)len)) {
+        return 0;
+    }
+
+    return (uint32_t)len + lvt;
+}
+
 /**
  * @brief Returns the length of data between an opening tag and a closing tag.
  * @note Expects that the first octet contain the opening tag.
@@ -809,84 +868,44 @@ int bacnet_application_data_length(uint8_t tag_number, uint32_t len_value_type)
  */
 int bacnet_enclosed_data_length(const uint8_t *apdu, size_t apdu_size)
 {
-    int len = 0;
-    int total_len = 0;
-    int apdu_len = 0;
-    BACNET_TAG tag = { 0 };
-    uint8_t opening_tag_number = 0;
-    uint8_t opening_tag_number_counter = 0;
-    bool total_len_enable = false;
+    uint32_t size, offset, start, len;
+    unsigned depth = 1;
+    int nesting = 0;
+    uint8_t tag_number = 0;
 
-    if (!apdu) {
-        return BACNET_STATUS_ERROR;
-    }
-    if (apdu_size <= apdu_len) {
-        /* error: exceeding our buffer limit */
+    if (!apdu || (apdu_size == 0) || (apdu_size > INT_MAX)) {
         return BACNET_STATUS_ERROR;
     }
     if (!bacnet_is_opening_tag(apdu, apdu_size)) {
         /* error: opening tag is missing */
         return BACNET_STATUS_ERROR;
     }
-    do {
-        len = bacnet_tag_decode(apdu, apdu_size - apdu_len, &tag);
-        if (len == 0) {
+    size = (uint32_t)apdu_size;
+    start = bacnet_tag_scan(apdu, size, &nesting, &tag_number);
+    if ((start == 0) || (start >= size)) {
+        return BACNET_STATUS_ERROR;
+    }
+    offset = start;
+    while (offset < size) {
+        len = bacnet_tag_scan(&apdu[offset], size - offset, &nesting,
+            &tag_number);
+        if ((len == 0) || (len > (size - offset))) {
+            /* error: malformed, or exceeding our buffer limit */
             return BACNET_STATUS_ERROR;
         }
-        if (tag.opening) {
-            if (opening_tag_number_counter == 0) {
-                opening_tag_number = tag.number;
-                opening_tag_number_counter = 1;
-                total_len_enable = false;
-            } else if (tag.number == opening_tag_number) {
-                total_len_enable = true;
-                opening_tag_number_counter++;
-            } else {
-                total_len_enable = true;
-            }
-        } else if (tag.closing) {
-            if (tag.number == opening_tag_number) {
-                if (opening_tag_number_counter > 0) {
-                    opening_tag_number_counter--;
-                }
-            }
-            total_len_enable = true;
-        } else if (tag.context) {
-            if (tag.len_value_type > INT_MAX) {
-                /* error: length is out of range */
-                return BACNET_STATUS_ERROR;
-            }
-            len += tag.len_value_type;
-            total_len_enable = true;
-        } else {
-            if (tag.len_value_type > INT_MAX) {
-                /* error: length is out of range */
-                return BACNET_STATUS_ERROR;
-            }
-            /* application tagged data */
-            len +=
-                bacnet_application_data_length(tag.number, tag.len_value_type);
-            total_len_enable = true;
-        }
-        if (opening_tag_number_counter > 0) {
-            if (len > 0) {
-                if (total_len_enable) {
-                    total_len += len;
-                }
-            } else {
-                /* error: len is not incrementing */
-                return BACNET_STATUS_ERROR;
-            }
-            apdu_len += len;
-            if (apdu_size <= apdu_len) {
-                /* error: exceeding our buffer limit */
-                return BACNET_STATUS_ERROR;
+        if (nesting < 0) {
+            depth--;
+            if (depth == 0) {
+                return (int)(offset - start);
             }
-            apdu += len;
+        } else if (nesting > 0) {
+            depth++;
         }
-    } while (opening_tag_number_counter > 0);
+        offset += len;
+    }
 
-    return total_len;
+    /* error: closing tag is missing */
+    return BACNET_STATUS_ERROR;
 }
 
 /**
@@ -2264,15 +2283,12 @@ int bacnet_octet_string_decode(
     uint32_t len_value,
     BACNET_OCTET_STRING *value)
 {
-    int len = BACNET_STATUS_ERROR;
+    BACNET_OCTET_STRING_VIEW view = { 0 };
+    int len;
 
-    if (len_value <= apdu_size) {
-        if (len_value > 0) {
-            (void)octetstring_init(value, &apdu[0], len_value);
-        } else {
-            (void)octetstring_init(value, NULL, 0);
-        }
-        len = (int)len_value;
+    len = bacnet_octet_string_view_decode(apdu, apdu_size, len_value, &view);
+    if (len >= 0) {
+        (void)octetstring_view_copy(value, &view);
     }
 
     return len;
@@ -2451,6 +2467,76 @@ int bacnet_octet_string_context_decode(
 
     return apdu_len;
 }
+
+/**
+ * @brief Decode the BACnet Octet String Value into a view of the octets
+ * in the buffer, without copying them
+ * from clause 20.2.8 Encoding of an Octet String Value
+ *
+ * @param apdu - buffer to hold the bytes
+ * @param apdu_size - number of bytes in the buffer to decode
+ * @param len_value - number of bytes in the value encoding, may be zero
+ * @param value - the view of the value decoded, or NULL for length
+ *
+ * @return  number of bytes decoded (0..N), or BACNET_STATUS_ERROR on error
+ */
+int bacnet_octet_string_view_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint32_t len_value,
+    BACNET_OCTET_STRING_VIEW *value)
+{
+    int len = BACNET_STATUS_ERROR;
+
+    if (len_value <= apdu_size) {
+        (void)octetstring_view_init(value, apdu, len_value);
+        len = (int)len_value;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Decodes from bytes into a view of a BACnet Octet String
+ * application encoding, without copying the octets
+ * from clause 20.2.8 Encoding of an Octet String Value
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - view of the decoded value, if decoded, or NULL for length
+ *
+ * @return number of bytes decoded, zero if tag mismatch,
+ * or #BACNET_STATUS_ERROR (-1) if malformed
+ */
+int bacnet_octet_string_view_application_decode(
+    const uint8_t *apdu, uint32_t apdu_size, BACNET_OCTET_STRING_VIEW *value)
+{
+    int apdu_len = BACNET_STATUS_ERROR;
+    int len = 0;
+    BACNET_TAG tag = { 0 };
+
+    if (apdu_size == 0) {
+        return 0;
+    }
+    len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if (len > 0) {
+        if (tag.application &&
+            (tag.number == BACNET_APPLICATION_TAG_OCTET_STRING)) {
+            apdu_len = len;
+            len = bacnet_octet_string_view_decode(
+                &apdu[len], apdu_size - apdu_len, tag.len_value_type, value);
+            if (len >= 0) {
+                apdu_len += len;
+            } else {
+                apdu_len = BACNET_STATUS_ERROR;
+            }
+        } else {
+            apdu_len = 0;
+        }
+    }
+
+    return apdu_len;
+}
 #endif
 
 /**
@@ -2505,22 +2591,88 @@ uint32_t encode_bacnet_character_string_safe(
 int encode_bacnet_character_string(
     uint8_t *apdu, const BACNET_CHARACTER_STRING *char_string)
 {
-    uint32_t apdu_len = 1 /*encoding */;
-    uint32_t i;
-    size_t length;
-    const char *value;
+    BACNET_CHARACTER_STRING_VIEW view = { 0 };
+
+    (void)characterstring_view_from_string(&view, char_string);
 
-    length = characterstring_length(char_string);
+    return encode_bacnet_character_string_view(apdu, &view);
+}
+
+/**
+ * @brief Encode the BACnet Character String Value from a view
+ *  from 20.2.9 Encoding of a Character String Value
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param view - view of the characters to be encoded
+ *
+ * @return returns the number of apdu bytes consumed
+ */
+int encode_bacnet_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *view)
+{
     if (apdu) {
-        apdu[0] = characterstring_encoding(char_string);
-        value = characterstring_value(char_string);
-        for (i = 0; i < length; i++) {
-            apdu[1 + i] = (uint8_t)value[i];
+        apdu[0] = view->encoding;
+        if (view->length > 0) {
+            memcpy(&apdu[1], view->value, view->length);
         }
     }
-    apdu_len += length;
 
-    return apdu_len;
+    return 1 /*encoding */ + (int)view->length;
+}
+
+/**
+ * @brief Encode the BACnet Character String Value from a view as
+ *  application tagged
+ *  from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param view - view of the characters to be encoded
+ *
+ * @return returns the number of apdu bytes consumed
+ */
+int encode_application_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *view)
+{
+    int len;
+
+    len = encode_tag(
+        apdu, BACNET_APPLICATION_TAG_CHARACTER_STRING, false,
+        (uint32_t)encode_bacnet_character_string_view(NULL, view));
+    if (apdu) {
+        apdu += len;
+    }
+    len += encode_bacnet_character_string_view(apdu, view);
+
+    return len;
+}
+
+/**
+ * @brief Encode the BACnet Character String Value from a view as
+ *  context tagged
+ *  from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param tag_number - context tag number to encode
+ * @param view - view of the characters to be encoded
+ *
+ * @return returns the number of apdu bytes consumed
+ */
+int encode_context_character_string_view(
+    uint8_t *apdu, uint8_t tag_number, const BACNET_CHARACTER_STRING_VIEW *view)
+{
+    int len;
+
+    len = encode_tag(
+        apdu, tag_number, true,
+        (uint32_t)encode_bacnet_character_string_view(NULL, view));
+    if (apdu) {
+        apdu += len;
+    }
+    len += encode_bacnet_character_string_view(apdu, view);
+
+    return len;
 }
 
 /**
@@ -2602,23 +2754,43 @@ int bacnet_character_string_decode(
     uint32_t len_value,
     BACNET_CHARACTER_STRING *char_string)
 {
-    const char *string_value = NULL;
+    BACNET_CHARACTER_STRING_VIEW view = { 0 };
+    int len;
+
+    len = bacnet_character_string_view_decode(
+        apdu, apdu_size, len_value, &view);
+    if (len > 0) {
+        (void)characterstring_view_copy(char_string, &view);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Decodes from bytes into a view of a BACnet Character String
+ * value, without copying the characters
+ * from clause 20.2.9 Encoding of a Character String Value
+ *
+ * @param apdu - buffer to hold the bytes
+ * @param apdu_size - number of bytes in the buffer to decode
+ * @param len_value - number of bytes in the value encoding
+ * @param view - view of the value decoded, if decoded
+ *
+ * @return  number of bytes decoded, or zero if errors occur
+ */
+int bacnet_character_string_view_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint32_t len_value,
+    BACNET_CHARACTER_STRING_VIEW *view)
+{
     int len = 0;
-    uint8_t encoding;
 
     /* check to see if the APDU is long enough */
-    if (len_value <= apdu_size) {
-        if (len_value > 0) {
-            encoding = apdu[0];
-            if (len_value > 1) {
-                string_value = (const char *)&apdu[1];
-                (void)characterstring_init(
-                    char_string, encoding, string_value, len_value - 1);
-            } else {
-                (void)characterstring_init(char_string, encoding, NULL, 0);
-            }
-            len = (int)len_value;
-        }
+    if ((len_value > 0) && (len_value <= apdu_size)) {
+        (void)characterstring_view_init(
+            view, apdu[0], (const char *)&apdu[1], len_value - 1);
+        len = (int)len_value;
     }
 
     return len;
@@ -2759,6 +2931,98 @@ int bacnet_character_string_context_decode(
     return apdu_len;
 }
 
+/**
+ * @brief Decodes from bytes into a view of an application tagged
+ * BACnet Character String value, without copying the characters
+ * from clause 20.2.9 Encoding of a Character String Value
+ * and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param view - view of the decoded value, if decoded
+ *
+ * @return number of bytes decoded, zero if tag mismatch,
+ * or #BACNET_STATUS_ERROR (-1) if malformed
+ */
+int bacnet_character_string_view_application_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_CHARACTER_STRING_VIEW *view)
+{
+    int apdu_len = BACNET_STATUS_ERROR;
+    int len = 0;
+    BACNET_TAG tag = { 0 };
+
+    if (apdu_size == 0) {
+        return 0;
+    }
+    len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if (len > 0) {
+        if (tag.application &&
+            (tag.number == BACNET_APPLICATION_TAG_CHARACTER_STRING)) {
+            apdu_len = len;
+            len = bacnet_character_string_view_decode(
+                &apdu[len], apdu_size - apdu_len, tag.len_value_type, view);
+            if (len > 0) {
+                apdu_len += len;
+            } else {
+                apdu_len = BACNET_STATUS_ERROR;
+            }
+        } else {
+            apdu_len = 0;
+        }
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decodes from bytes into a view of a context tagged
+ * BACnet Character String value, without copying the characters
+ * from clause 20.2.9 Encoding of a Character String Value
+ * and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes
+ * @param apdu_size - number of bytes in the buffer to decode
+ * @param tag_value - context tag number expected
+ * @param view - view of the value decoded, if decoded
+ *
+ * @return  number of bytes decoded, or zero if tag mismatch, or
+ * #BACNET_STATUS_ERROR (-1) if malformed
+ */
+int bacnet_character_string_view_context_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint8_t tag_value,
+    BACNET_CHARACTER_STRING_VIEW *view)
+{
+    int apdu_len = BACNET_STATUS_ERROR;
+    int len = 0;
+    BACNET_TAG tag = { 0 };
+
+    if (apdu_size == 0) {
+        return 0;
+    }
+    len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if (len > 0) {
+        if (tag.context && (tag.number == tag_value)) {
+            apdu_len = len;
+            len = bacnet_character_string_view_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, tag.len_value_type,
+                view);
+            if (len > 0) {
+                apdu_len += len;
+            } else {
+                apdu_len = BACNET_STATUS_ERROR;
+            }
+        } else {
+            apdu_len = 0;
+        }
+    }
+
+    return apdu_len;
+}
+
 /**
  * @brief Decodes from bytes into a BACnet Character String value
  * from clause 20.2.9 Encoding of a Character String Value
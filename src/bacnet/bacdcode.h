@@ -387,6 +387,15 @@ int bacnet_octet_string_context_decode(
     uint32_t apdu_len_max,
     uint8_t tag_value,
     BACNET_OCTET_STRING *value);
+BACNET_STACK_EXPORT
+int bacnet_octet_string_view_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint32_t len_value,
+    BACNET_OCTET_STRING_VIEW *value);
+BACNET_STACK_EXPORT
+int bacnet_octet_string_view_application_decode(
+    const uint8_t *apdu, uint32_t apdu_size, BACNET_OCTET_STRING_VIEW *value);
 
 BACNET_STACK_EXPORT
 uint32_t encode_bacnet_character_string_safe(
@@ -438,6 +447,35 @@ int bacnet_character_string_context_decode(
     uint8_t tag_value,
     BACNET_CHARACTER_STRING *value);
 
+BACNET_STACK_EXPORT
+int encode_bacnet_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *view);
+BACNET_STACK_EXPORT
+int encode_application_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *view);
+BACNET_STACK_EXPORT
+int encode_context_character_string_view(
+    uint8_t *apdu,
+    uint8_t tag_number,
+    const BACNET_CHARACTER_STRING_VIEW *view);
+BACNET_STACK_EXPORT
+int bacnet_character_string_view_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint32_t len_value,
+    BACNET_CHARACTER_STRING_VIEW *view);
+BACNET_STACK_EXPORT
+int bacnet_character_string_view_application_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_CHARACTER_STRING_VIEW *view);
+BACNET_STACK_EXPORT
+int bacnet_character_string_view_context_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint8_t tag_value,
+    BACNET_CHARACTER_STRING_VIEW *view);
+
 BACNET_STACK_EXPORT
 int encode_bacnet_unsigned(uint8_t *apdu, BACNET_UNSIGNED_INTEGER value);
 BACNET_STACK_EXPORT
@@ -395,14 +395,13 @@ bool characterstring_init(
            note: assumes printable characters */
         if (length <= CHARACTER_STRING_CAPACITY) {
             if (value) {
-                for (i = 0; i < MAX_CHARACTER_STRING_BYTES; i++) {
-                    if (i < length) {
-                        char_string->value[char_string->length] = value[i];
-                        char_string->length++;
-                    } else {
-                        char_string->value[i] = 0;
-                    }
+                /* copy only what is used, so the cost follows the length
+                   of the string and not its capacity */
+                for (i = 0; i < length; i++) {
+                    char_string->value[i] = value[i];
                 }
+                char_string->value[length] = 0;
+                char_string->length = length;
             } else {
                 for (i = 0; i < MAX_CHARACTER_STRING_BYTES; i++) {
                     char_string->value[i] = 0;
@@ -660,6 +659,7 @@ bool characterstring_append(
                 char_string->value[char_string->length] = value[i];
                 char_string->length++;
             }
+            char_string->value[char_string->length] = 0;
             status = true;
         }
     }
@@ -993,6 +993,175 @@ bool characterstring_valid(const BACNET_CHARACTER_STRING *char_string)
     return valid;
 }
 
+/**
+ * @brief Initialize a view of a character string held elsewhere.
+ *  The view does not copy the characters; they must stay in place
+ *  while the view is used.
+ * @param view  Pointer to the character string view
+ * @param encoding  Encoding of the characters, like CHARACTER_UTF8
+ * @param value  Pointer to the characters, need not be null terminated
+ * @param length  Number of bytes of characters
+ * @return true on success, false if a NULL view or characters
+ * @note A view may be longer than a BACNET_CHARACTER_STRING can hold.
+ */
+bool characterstring_view_init(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    uint8_t encoding,
+    const char *value,
+    size_t length)
+{
+    if (!view) {
+        return false;
+    }
+    if (!value && (length > 0)) {
+        return false;
+    }
+    view->value = value;
+    view->length = length;
+    view->encoding = encoding;
+
+    return true;
+}
+
+/**
+ * @brief Initialize a view of a C-string as an ANSI X3.4 character string
+ * @param view  Pointer to the character string view
+ * @param value  C-string, or NULL for an empty string
+ * @return true on success, false if the view is NULL
+ */
+bool characterstring_view_init_ansi(
+    BACNET_CHARACTER_STRING_VIEW *view, const char *value)
+{
+    return characterstring_view_init(
+        view, CHARACTER_ANSI_X34, value, value ? strlen(value) : 0);
+}
+
+/**
+ * @brief Initialize a view of a BACnet character string
+ * @param view  Pointer to the character string view
+ * @param char_string  Pointer to the BACnet character string
+ * @return true on success, false if either argument is NULL
+ */
+bool characterstring_view_from_string(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string)
+{
+    if (!char_string) {
+        return false;
+    }
+
+    return characterstring_view_init(
+        view, characterstring_encoding(char_string),
+        characterstring_value(char_string),
+        characterstring_length(char_string));
+}
+
+/**
+ * @brief Copy the characters of a view into a BACnet character string
+ * @param dest  Pointer to the BACnet character string
+ * @param view  Pointer to the character string view
+ * @return true on success, false if the string exceeds capacity
+ */
+bool characterstring_view_copy(
+    BACNET_CHARACTER_STRING *dest, const BACNET_CHARACTER_STRING_VIEW *view)
+{
+    if (!view) {
+        return false;
+    }
+    if (!view->value) {
+        /* an empty view */
+        return characterstring_init(dest, view->encoding, "", 0);
+    }
+
+    return characterstring_init(
+        dest, view->encoding, view->value, view->length);
+}
+
+/**
+ * @brief Compare two character string views
+ * @param view1  Pointer to the first view
+ * @param view2  Pointer to the second view
+ * @return true if the encoding and the characters are the same
+ */
+bool characterstring_view_same(
+    const BACNET_CHARACTER_STRING_VIEW *view1,
+    const BACNET_CHARACTER_STRING_VIEW *view2)
+{
+    if (!view1 || !view2) {
+        return false;
+    }
+    if ((view1->encoding != view2->encoding) ||
+        (view1->length != view2->length)) {
+        return false;
+    }
+    if (view1->length == 0) {
+        return true;
+    }
+
+    return memcmp(view1->value, view2->value, view1->length) == 0;
+}
+
+/**
+ * @brief Compare a character string view with a BACnet character string
+ * @param view  Pointer to the view
+ * @param char_string  Pointer to the BACnet character string
+ * @return true if the encoding and the characters are the same
+ */
+bool characterstring_view_string_same(
+    const BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string)
+{
+    BACNET_CHARACTER_STRING_VIEW view2;
+
+    if (!characterstring_view_from_string(&view2, char_string)) {
+        return false;
+    }
+
+    return characterstring_view_same(view, &view2);
+}
+
+/**
+ * @brief Check that an ANSI X3.4 character string view is printable
+ * @param view  Pointer to the view
+ * @return true if the characters are printable, or the view is not
+ *  ANSI X3.4
+ */
+bool characterstring_view_printable(const BACNET_CHARACTER_STRING_VIEW *view)
+{
+    size_t i;
+
+    if (!view) {
+        return false;
+    }
+    if (view->encoding == CHARACTER_ANSI_X34) {
+        for (i = 0; i < view->length; i++) {
+            if ((view->value[i] < 0x20) || (view->value[i] > 0x7E)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compare a character string view with an ANSI X3.4 C-string
+ * @param view  Pointer to the view
+ * @param value  C-string, or NULL for an empty string
+ * @return true if the view is ANSI X3.4 with the same characters
+ */
+bool characterstring_view_ansi_same(
+    const BACNET_CHARACTER_STRING_VIEW *view, const char *value)
+{
+    BACNET_CHARACTER_STRING_VIEW view2;
+
+    if (!characterstring_view_init_ansi(&view2, value)) {
+        return false;
+    }
+
+    return characterstring_view_same(view, &view2);
+}
+
 #if BACNET_USE_OCTETSTRING
 /**
  * @brief Initialize an octet string with the given bytes or
@@ -1016,12 +1185,8 @@ bool octetstring_init(
         octet_string->length = 0;
         if (value) {
             pb = octet_string->value;
-            for (i = 0; i < MAX_OCTET_STRING_BYTES; i++) {
-                if (i < length) {
-                    *pb = value[i];
-                } else {
-                    *pb = 0;
-                }
+            for (i = 0; i < length; i++) {
+                *pb = value[i];
                 pb++;
             }
             octet_string->length = length;
@@ -1271,6 +1436,88 @@ bool octetstring_value_same(
 
     return false;
 }
+
+/**
+ * @brief Initialize a view of octets held elsewhere. The view does not
+ *  copy the octets; they must stay in place while the view is used.
+ * @param view  Pointer to the octet string view
+ * @param value  Pointer to the octets
+ * @param length  Number of octets
+ * @return true on success, false if a NULL view or octets
+ */
+bool octetstring_view_init(
+    BACNET_OCTET_STRING_VIEW *view, const uint8_t *value, size_t length)
+{
+    if (!view) {
+        return false;
+    }
+    if (!value && (length > 0)) {
+        return false;
+    }
+    view->value = value;
+    view->length = length;
+
+    return true;
+}
+
+/**
+ * @brief Initialize a view of a BACnet octet string
+ * @param view  Pointer to the octet string view
+ * @param octet_string  Pointer to the BACnet octet string
+ * @return true on success, false if either argument is NULL
+ */
+bool octetstring_view_from_string(
+    BACNET_OCTET_STRING_VIEW *view, const BACNET_OCTET_STRING *octet_string)
+{
+    if (!octet_string) {
+        return false;
+    }
+
+    return octetstring_view_init(
+        view, octet_string->value, octetstring_length(octet_string));
+}
+
+/**
+ * @brief Copy the octets of a view into a BACnet octet string
+ * @param dest  Pointer to the BACnet octet string
+ * @param view  Pointer to the octet string view
+ * @return true on success, false if the octets exceed capacity
+ */
+bool octetstring_view_copy(
+    BACNET_OCTET_STRING *dest, const BACNET_OCTET_STRING_VIEW *view)
+{
+    static const uint8_t empty[1] = { 0 };
+
+    if (!view) {
+        return false;
+    }
+
+    return octetstring_init(
+        dest, view->value ? view->value : empty, view->length);
+}
+
+/**
+ * @brief Compare two octet string views
+ * @param view1  Pointer to the first view
+ * @param view2  Pointer to the second view
+ * @return true if the octets are the same
+ */
+bool octetstring_view_same(
+    const BACNET_OCTET_STRING_VIEW *view1,
+    const BACNET_OCTET_STRING_VIEW *view2)
+{
+    if (!view1 || !view2) {
+        return false;
+    }
+    if (view1->length != view2->length) {
+        return false;
+    }
+    if (view1->length == 0) {
+        return true;
+    }
+
+    return memcmp(view1->value, view2->value, view1->length) == 0;
+}
 #endif
 
 /**
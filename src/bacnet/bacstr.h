@@ -32,6 +32,21 @@ typedef struct BACnet_Octet_String {
     uint8_t value[MAX_OCTET_STRING_BYTES];
 } BACNET_OCTET_STRING;
 
+/* A view of a character string held elsewhere, such as in an APDU or in
+   an object. It does not own or copy the characters, so its cost follows
+   the length of the string rather than MAX_CHARACTER_STRING_BYTES. */
+typedef struct BACnet_Character_String_View {
+    const char *value;
+    size_t length;
+    uint8_t encoding;
+} BACNET_CHARACTER_STRING_VIEW;
+
+/* A view of an octet string held elsewhere */
+typedef struct BACnet_Octet_String_View {
+    const uint8_t *value;
+    size_t length;
+} BACNET_OCTET_STRING_VIEW;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -133,6 +148,36 @@ bool characterstring_valid(const BACNET_CHARACTER_STRING *char_string);
 BACNET_STACK_EXPORT
 bool utf8_isvalid(const char *str, size_t length);
 
+BACNET_STACK_EXPORT
+bool characterstring_view_init(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    uint8_t encoding,
+    const char *value,
+    size_t length);
+BACNET_STACK_EXPORT
+bool characterstring_view_init_ansi(
+    BACNET_CHARACTER_STRING_VIEW *view, const char *value);
+BACNET_STACK_EXPORT
+bool characterstring_view_from_string(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string);
+BACNET_STACK_EXPORT
+bool characterstring_view_copy(
+    BACNET_CHARACTER_STRING *dest, const BACNET_CHARACTER_STRING_VIEW *view);
+BACNET_STACK_EXPORT
+bool characterstring_view_same(
+    const BACNET_CHARACTER_STRING_VIEW *view1,
+    const BACNET_CHARACTER_STRING_VIEW *view2);
+BACNET_STACK_EXPORT
+bool characterstring_view_string_same(
+    const BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string);
+BACNET_STACK_EXPORT
+bool characterstring_view_ansi_same(
+    const BACNET_CHARACTER_STRING_VIEW *view, const char *value);
+BACNET_STACK_EXPORT
+bool characterstring_view_printable(const BACNET_CHARACTER_STRING_VIEW *view);
+
 /* returns false if the string exceeds capacity
    initialize by using length=0 */
 BACNET_STACK_EXPORT
@@ -172,6 +217,20 @@ bool octetstring_value_same(
     const BACNET_OCTET_STRING *octet_string1,
     const BACNET_OCTET_STRING *octet_string2);
 
+BACNET_STACK_EXPORT
+bool octetstring_view_init(
+    BACNET_OCTET_STRING_VIEW *view, const uint8_t *value, size_t length);
+BACNET_STACK_EXPORT
+bool octetstring_view_from_string(
+    BACNET_OCTET_STRING_VIEW *view, const BACNET_OCTET_STRING *octet_string);
+BACNET_STACK_EXPORT
+bool octetstring_view_copy(
+    BACNET_OCTET_STRING *dest, const BACNET_OCTET_STRING_VIEW *view);
+BACNET_STACK_EXPORT
+bool octetstring_view_same(
+    const BACNET_OCTET_STRING_VIEW *view1,
+    const BACNET_OCTET_STRING_VIEW *view2);
+
 BACNET_STACK_EXPORT
 int bacnet_stricmp(const char *a, const char *b);
 BACNET_STACK_EXPORT
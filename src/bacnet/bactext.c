@@ -2778,3 +2778,72 @@ bool bactext_object_property_strtoul(
 
     return status;
 }
+
+/**
+ * @brief Register the text lists, so that their lookups use the index and
+ *  text hash tables where they are available. Call once at startup,
+ *  before other threads make lookups. Lookups made before are scans.
+ */
+void bactext_init(void)
+{
+    static INDTEXT_DATA *const lists[] = {
+        bacnet_confirmed_service_names,
+        bacnet_unconfirmed_service_names,
+        bacnet_application_tag_names,
+        bacnet_object_type_names,
+        bacnet_property_names,
+        bacnet_engineering_unit_names,
+        bacnet_reject_reason_names,
+        bacnet_abort_reason_names,
+        bacnet_error_class_names,
+        bacnet_error_code_names,
+        bacnet_month_names,
+        bacnet_week_of_month_names,
+        bacnet_day_of_week_names,
+        bacnet_days_of_week_names,
+        bacnet_notify_type_names,
+        bacnet_event_transition_names,
+        bacnet_event_state_names,
+        bacnet_event_type_names,
+        bacnet_binary_present_value_names,
+        bacnet_binary_polarity_names,
+        bacnet_reliability_names,
+        bacnet_device_status_names,
+        bacnet_segmentation_names,
+        bacnet_node_type_names,
+        network_layer_msg_names,
+        bactext_life_safety_mode_names,
+        bactext_life_safety_operation_names,
+        bactext_life_safety_state_names,
+        bactext_silenced_state_names,
+        bacnet_lighting_in_progress_names,
+        bacnet_lighting_transition_names,
+        bacnet_lighting_operation_names,
+        bacnet_binary_lighting_pv_names,
+        bacnet_color_operation_names,
+        bacnet_device_communications_names,
+        bacnet_shed_state_names,
+        bacnet_shed_level_type_names,
+        bacnet_log_datum_names,
+        bactext_restart_reason_names,
+        bactext_network_port_type_names,
+        bactext_network_number_quality_names,
+        bactext_protocol_level_names,
+        bactext_network_port_command_names,
+        bactext_authentication_decision_names,
+        bactext_authorization_posture_names,
+        bactext_fault_type_names,
+        bacnet_priority_filter_names,
+        bactext_result_flags_names,
+        bactext_success_filter_names,
+        bactext_logging_type_names,
+        bactext_program_request_names,
+        bactext_program_state_names,
+        bactext_program_error_names,
+    };
+    unsigned i;
+
+    for (i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+        (void)indtext_index_register(lists[i]);
+    }
+}
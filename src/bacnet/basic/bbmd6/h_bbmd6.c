@@ -167,7 +167,6 @@ static void bbmd6_add_vmac(uint32_t device_id, const BACNET_IP6_ADDRESS *addr)
 {
     bool found = false;
     uint32_t list_device_id = 0;
-    struct vmac_data *vmac;
     struct vmac_data new_vmac;
     unsigned i = 0;
 
@@ -192,10 +191,8 @@ static void bbmd6_add_vmac(uint32_t device_id, const BACNET_IP6_ADDRESS *addr)
             }
         }
         if (!found) {
-            vmac = VMAC_Find_By_Key(device_id);
-            if (vmac) {
-                /* device ID already exists. Update MAC. */
-                memmove(vmac, &new_vmac, sizeof(struct vmac_data));
+            if (VMAC_Update(device_id, &new_vmac)) {
+                /* device ID already exists. MAC updated. */
                 PRINTF("BVLC6: VMAC for %u [", (unsigned int)device_id);
                 for (i = 0; i < new_vmac.mac_len; i++) {
                     PRINTF("%02X", new_vmac.mac[i]);
@@ -360,18 +357,24 @@ int bvlc6_send_pdu(
 static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
 {
     BACNET_IP6_ADDRESS my_addr = { 0 };
+    static BACNET_IP6_ADDRESS dest[MAX_BBMD6_ENTRIES];
+    unsigned dest_count = 0;
     unsigned i = 0; /* loop counter */
 
     if (mtu) {
         bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
+        for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
             if (BBMD_Table[i].valid) {
                 if (bvlc6_address_different(
                         &my_addr, &BBMD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&BBMD_Table[i].bip6_address, mtu, mtu_len);
+                    bvlc6_address_copy(
+                        &dest[dest_count], &BBMD_Table[i].bip6_address);
+                    dest_count++;
                 }
             }
         }
+        /* same MPDU to every peer BBMD, so hand the port one batch */
+        bip6_send_mpdu_multiple(dest, dest_count, mtu, mtu_len);
     }
 }
 
@@ -387,18 +390,23 @@ static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
 static void bbmd6_send_pdu_fdt(uint8_t *mtu, unsigned int mtu_len)
 {
     BACNET_IP6_ADDRESS my_addr = { 0 };
+    static BACNET_IP6_ADDRESS dest[MAX_FD6_ENTRIES];
+    unsigned dest_count = 0;
     unsigned i = 0; /* loop counter */
 
     if (mtu) {
         bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_FD_ENTRIES; i++) {
+        for (i = 0; i < MAX_FD6_ENTRIES; i++) {
             if (FD_Table[i].valid) {
                 if (bvlc6_address_different(
                         &my_addr, &FD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
+                    bvlc6_address_copy(
+                        &dest[dest_count], &FD_Table[i].bip6_address);
+                    dest_count++;
                 }
             }
         }
+        bip6_send_mpdu_multiple(dest, dest_count, mtu, mtu_len);
     }
 }
 
@@ -421,7 +429,7 @@ static void bbmd6_send_forward_npdu(
     uint16_t mtu_len = 0;
     unsigned i = 0; /* loop counter */
 
-    for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
+    for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
         if (BBMD_Table[i].valid) {
             if (bbmd6_address_match_self(&BBMD_Table[i].bip6_address)) {
                 /* don't forward to our selves */
@@ -430,7 +438,7 @@ static void bbmd6_send_forward_npdu(
             }
         }
     }
-    for (i = 0; i < MAX_FD_ENTRIES; i++) {
+    for (i = 0; i < MAX_FD6_ENTRIES; i++) {
         if (FD_Table[i].valid) {
             if (bbmd6_address_match_self(&FD_Table[i].bip6_address)) {
                 /* don't forward to our selves */
@@ -855,6 +863,7 @@ int bvlc6_bbmd_enabled_handler(
     bool send_result = false;
     uint16_t offset = 0;
     BACNET_IP6_ADDRESS fwd_address = { 0 };
+    BACNET_IP6_ADDRESS bvlc_dest = { 0 };
 
     header_len =
         bvlc6_decode_header(mtu, mtu_len, &message_type, &message_length);
@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/keylist.h"
@@ -33,8 +34,159 @@ void VMAC_Debug_Enable(void)
 /* This module is used to handle the virtual MAC address binding that */
 /* occurs in BACnet for ZigBee or IPv6. */
 
+/* number of buckets in each of the hash indexes, a power of two */
+#ifndef VMAC_HASH_SIZE
+#define VMAC_HASH_SIZE 256
+#endif
+#if (VMAC_HASH_SIZE & (VMAC_HASH_SIZE - 1)) != 0
+#error "VMAC_HASH_SIZE must be a power of two"
+#endif
+
+/* The list stores vmac_entry, which starts with the public vmac_data, */
+/* so that the list data can be handed out as struct vmac_data. */
+/* Each entry is also chained into a hash index by device ID and into */
+/* a hash index by MAC, so that both directions of the binding are */
+/* found without walking the list. */
+struct vmac_entry {
+    struct vmac_data vmac;
+    uint32_t device_id;
+    struct vmac_entry *device_next;
+    struct vmac_entry *mac_next;
+};
+
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist VMAC_List;
+static struct vmac_entry *VMAC_Device_Hash[VMAC_HASH_SIZE];
+static struct vmac_entry *VMAC_MAC_Hash[VMAC_HASH_SIZE];
+
+/**
+ * @brief Hash a VMAC address (FNV-1a)
+ * @param vmac - VMAC address
+ * @return bucket index
+ */
+static unsigned int VMAC_MAC_Hash_Index(const struct vmac_data *vmac)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned int i;
+
+    for (i = 0; (i < vmac->mac_len) && (i < VMAC_MAC_MAX); i++) {
+        hash ^= vmac->mac[i];
+        hash *= 16777619UL;
+    }
+
+    return (unsigned int)(hash & (VMAC_HASH_SIZE - 1));
+}
+
+/**
+ * @brief Hash a device ID
+ * @param device_id - BACnet device object instance number
+ * @return bucket index
+ */
+static unsigned int VMAC_Device_Hash_Index(uint32_t device_id)
+{
+    return (unsigned int)(device_id & (VMAC_HASH_SIZE - 1));
+}
+
+/**
+ * @brief Link an entry into the MAC hash index
+ * @param entry - entry with the MAC already set
+ */
+static void VMAC_MAC_Link(struct vmac_entry *entry)
+{
+    unsigned int index = VMAC_MAC_Hash_Index(&entry->vmac);
+
+    entry->mac_next = VMAC_MAC_Hash[index];
+    VMAC_MAC_Hash[index] = entry;
+}
+
+/**
+ * @brief Unlink an entry from the MAC hash index
+ * @param entry - entry with the MAC it was linked with
+ */
+static void VMAC_MAC_Unlink(const struct vmac_entry *entry)
+{
+    struct vmac_entry **link;
+
+    link = &VMAC_MAC_Hash[VMAC_MAC_Hash_Index(&entry->vmac)];
+    while (*link) {
+        if (*link == entry) {
+            *link = entry->mac_next;
+            break;
+        }
+        link = &(*link)->mac_next;
+    }
+}
+
+/**
+ * @brief Link an entry into both hash indexes
+ * @param entry - entry with the device ID and MAC set
+ */
+static void VMAC_Hash_Link(struct vmac_entry *entry)
+{
+    unsigned int index = VMAC_Device_Hash_Index(entry->device_id);
+
+    entry->device_next = VMAC_Device_Hash[index];
+    VMAC_Device_Hash[index] = entry;
+    VMAC_MAC_Link(entry);
+}
+
+/**
+ * @brief Unlink an entry from both hash indexes
+ * @param entry - entry to unlink
+ */
+static void VMAC_Hash_Unlink(const struct vmac_entry *entry)
+{
+    struct vmac_entry **link;
+
+    link = &VMAC_Device_Hash[VMAC_Device_Hash_Index(entry->device_id)];
+    while (*link) {
+        if (*link == entry) {
+            *link = entry->device_next;
+            break;
+        }
+        link = &(*link)->device_next;
+    }
+    VMAC_MAC_Unlink(entry);
+}
+
+/**
+ * @brief Find an entry by device ID using the hash index
+ * @param device_id - BACnet device object instance number
+ * @return entry, or NULL if not found
+ */
+static struct vmac_entry *VMAC_Entry_Find(uint32_t device_id)
+{
+    struct vmac_entry *entry;
+
+    entry = VMAC_Device_Hash[VMAC_Device_Hash_Index(device_id)];
+    while (entry) {
+        if (entry->device_id == device_id) {
+            break;
+        }
+        entry = entry->device_next;
+    }
+
+    return entry;
+}
+
+/**
+ * @brief Copy a VMAC address, limited to the size of the storage
+ * @param dst - destination VMAC address
+ * @param src - source VMAC address
+ */
+static void VMAC_Copy(struct vmac_data *dst, const struct vmac_data *src)
+{
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(dst->mac); i++) {
+        if (i < src->mac_len) {
+            dst->mac[i] = src->mac[i];
+        } else {
+            break;
+        }
+    }
+    dst->mac_len = src->mac_len;
+}
 
 /**
  * Returns the number of VMAC in the list
@@ -55,30 +207,26 @@ unsigned int VMAC_Count(void)
 bool VMAC_Add(uint32_t device_id, const struct vmac_data *src)
 {
     bool status = false;
-    struct vmac_data *pVMAC = NULL;
+    struct vmac_entry *pEntry = NULL;
     int index = 0;
-    size_t i = 0;
 
-    pVMAC = Keylist_Data(VMAC_List, device_id);
-    if (!pVMAC) {
-        pVMAC = calloc(1, sizeof(struct vmac_data));
-        if (pVMAC) {
+    pEntry = VMAC_Entry_Find(device_id);
+    if (!pEntry) {
+        pEntry = calloc(1, sizeof(struct vmac_entry));
+        if (pEntry) {
             /* copy the MAC into the data store */
-            for (i = 0; i < sizeof(pVMAC->mac); i++) {
-                if (i < src->mac_len) {
-                    pVMAC->mac[i] = src->mac[i];
-                } else {
-                    break;
-                }
-            }
-            pVMAC->mac_len = src->mac_len;
-            index = Keylist_Data_Add(VMAC_List, device_id, pVMAC);
+            VMAC_Copy(&pEntry->vmac, src);
+            pEntry->device_id = device_id;
+            index = Keylist_Data_Add(VMAC_List, device_id, pEntry);
             if (index >= 0) {
+                VMAC_Hash_Link(pEntry);
                 status = true;
                 if (VMAC_Debug) {
                     debug_fprintf(
                         stderr, "VMAC %u added.\n", (unsigned int)device_id);
                 }
+            } else {
+                free(pEntry);
             }
         }
     }
@@ -86,6 +234,32 @@ bool VMAC_Add(uint32_t device_id, const struct vmac_data *src)
     return status;
 }
 
+/**
+ * Changes the VMAC of a device already in the list. The MAC of an
+ * entry must only be changed here, because the entry is also indexed
+ * by its MAC.
+ *
+ * @param device_id - BACnet device object instance number
+ * @param src - new BACnet/IPv6 address
+ *
+ * @return true if the device ID was found and its MAC updated
+ */
+bool VMAC_Update(uint32_t device_id, const struct vmac_data *src)
+{
+    bool status = false;
+    struct vmac_entry *pEntry;
+
+    pEntry = VMAC_Entry_Find(device_id);
+    if (pEntry && src) {
+        VMAC_MAC_Unlink(pEntry);
+        VMAC_Copy(&pEntry->vmac, src);
+        VMAC_MAC_Link(pEntry);
+        status = true;
+    }
+
+    return status;
+}
+
 /**
  * Finds a VMAC in the list by seeking the Device ID, and deletes it.
  *
@@ -96,11 +270,12 @@ bool VMAC_Add(uint32_t device_id, const struct vmac_data *src)
 bool VMAC_Delete(uint32_t device_id)
 {
     bool status = false;
-    struct vmac_data *pVMAC;
+    struct vmac_entry *pEntry;
 
-    pVMAC = Keylist_Data_Delete(VMAC_List, device_id);
-    if (pVMAC) {
-        free(pVMAC);
+    pEntry = Keylist_Data_Delete(VMAC_List, device_id);
+    if (pEntry) {
+        VMAC_Hash_Unlink(pEntry);
+        free(pEntry);
         status = true;
     }
 
@@ -112,11 +287,19 @@ bool VMAC_Delete(uint32_t device_id)
  *
  * @param device_id - BACnet device object instance number
  *
- * @return pointer to the VMAC data from the list
+ * @return pointer to the VMAC data from the list. Use VMAC_Update()
+ *  to change the MAC.
  */
 struct vmac_data *VMAC_Find_By_Key(uint32_t device_id)
 {
-    return Keylist_Data(VMAC_List, device_id);
+    struct vmac_entry *pEntry;
+
+    pEntry = VMAC_Entry_Find(device_id);
+    if (pEntry) {
+        return &pEntry->vmac;
+    }
+
+    return NULL;
 }
 
 /**
@@ -233,21 +416,21 @@ bool VMAC_Match(const struct vmac_data *vmac1, const struct vmac_data *vmac2)
 bool VMAC_Find_By_Data(const struct vmac_data *vmac, uint32_t *device_id)
 {
     bool status = false;
-    struct vmac_data *list_vmac;
-    int count = 0;
-    int index = 0;
+    struct vmac_entry *pEntry;
 
-    count = Keylist_Count(VMAC_List);
-    while (count) {
-        index = count - 1;
-        list_vmac = Keylist_Data_Index(VMAC_List, index);
-        if (list_vmac) {
-            if (VMAC_Match(vmac, list_vmac)) {
-                status = Keylist_Index_Key(VMAC_List, index, device_id);
-                break;
+    if (!vmac) {
+        return false;
+    }
+    pEntry = VMAC_MAC_Hash[VMAC_MAC_Hash_Index(vmac)];
+    while (pEntry) {
+        if (VMAC_Match(vmac, &pEntry->vmac)) {
+            if (device_id) {
+                *device_id = pEntry->device_id;
             }
+            status = true;
+            break;
         }
-        count--;
+        pEntry = pEntry->mac_next;
     }
 
     return status;
@@ -258,7 +441,7 @@ bool VMAC_Find_By_Data(const struct vmac_data *vmac, uint32_t *device_id)
  */
 void VMAC_Cleanup(void)
 {
-    struct vmac_data *pVMAC;
+    struct vmac_entry *pVMAC;
     const int index = 0;
     unsigned i = 0;
 
@@ -274,8 +457,8 @@ void VMAC_Cleanup(void)
                     debug_fprintf(
                         stderr, "VMAC List: %lu [", (unsigned long)device_id);
                     /* print the MAC */
-                    for (i = 0; i < pVMAC->mac_len; i++) {
-                        debug_fprintf(stderr, "%02X", pVMAC->mac[i]);
+                    for (i = 0; i < pVMAC->vmac.mac_len; i++) {
+                        debug_fprintf(stderr, "%02X", pVMAC->vmac.mac[i]);
                     }
                     debug_fprintf(stderr, "]\n");
                 }
@@ -285,6 +468,8 @@ void VMAC_Cleanup(void)
         Keylist_Delete(VMAC_List);
         VMAC_List = NULL;
     }
+    memset(VMAC_Device_Hash, 0, sizeof(VMAC_Device_Hash));
+    memset(VMAC_MAC_Hash, 0, sizeof(VMAC_MAC_Hash));
 }
 
 /**
@@ -292,6 +477,8 @@ void VMAC_Cleanup(void)
  */
 void VMAC_Init(void)
 {
+    memset(VMAC_Device_Hash, 0, sizeof(VMAC_Device_Hash));
+    memset(VMAC_MAC_Hash, 0, sizeof(VMAC_MAC_Hash));
     VMAC_List = Keylist_Create();
     if (VMAC_List) {
         atexit(VMAC_Cleanup);
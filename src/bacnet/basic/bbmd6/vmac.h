@@ -42,6 +42,8 @@ bool VMAC_Find_By_Data(const struct vmac_data *vmac, uint32_t *device_id);
 BACNET_STACK_EXPORT
 bool VMAC_Add(uint32_t device_id, const struct vmac_data *pVMAC);
 BACNET_STACK_EXPORT
+bool VMAC_Update(uint32_t device_id, const struct vmac_data *pVMAC);
+BACNET_STACK_EXPORT
 bool VMAC_Delete(uint32_t device_id);
 BACNET_STACK_EXPORT
 bool VMAC_Different(
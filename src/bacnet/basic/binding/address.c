@@ -41,6 +41,27 @@ static uint32_t Own_Device_ID = 0xFFFFFFFF;
 #define MAX_ADDRESS_CACHE 255
 #endif
 
+/* Number of buckets in each of the device-id and address hash indexes. */
+#if !defined(ADDRESS_CACHE_HASH_SIZE)
+#define ADDRESS_CACHE_HASH_SIZE MAX_ADDRESS_CACHE
+#endif
+
+/* Number of slots in each level of the time-to-live timer wheel: the
+   first level has one-second slots, the second level has slots of one
+   lap of the first level. Entries due later wait on an overflow list.
+   Should be a power of two. */
+#if !defined(ADDRESS_CACHE_WHEEL_SIZE)
+#define ADDRESS_CACHE_WHEEL_SIZE 64
+#endif
+
+#if (MAX_ADDRESS_CACHE < UINT16_MAX)
+typedef uint16_t ADDRESS_CACHE_INDEX;
+#define ADDRESS_CACHE_NONE UINT16_MAX
+#else
+typedef uint32_t ADDRESS_CACHE_INDEX;
+#define ADDRESS_CACHE_NONE UINT32_MAX
+#endif
+
 static struct Address_Cache_Entry {
     uint8_t Flags;
     uint32_t device_id;
@@ -50,7 +71,18 @@ static struct Address_Cache_Entry {
     uint16_t maxsegments;
 #endif
     BACNET_ADDRESS address;
-    uint32_t TimeToLive;
+    /* last second of Address_Cache_Clock that a timed entry is valid */
+    uint32_t Expires;
+    /* which of the Address_Cache_List the entry is linked into */
+    uint8_t List;
+    ADDRESS_CACHE_INDEX list_prev;
+    ADDRESS_CACHE_INDEX list_next;
+    ADDRESS_CACHE_INDEX device_next;
+    ADDRESS_CACHE_INDEX address_next;
+    ADDRESS_CACHE_INDEX wheel_prev;
+    ADDRESS_CACHE_INDEX wheel_next;
+    /* which of the Timer_Wheel lists the entry is linked into */
+    uint16_t Wheel;
 } Address_Cache[MAX_ADDRESS_CACHE];
 
 /* State flags for cache entries */
@@ -63,6 +95,8 @@ static struct Address_Cache_Entry {
 #define BAC_ADDR_STATIC BIT(2)
 /* Opportunistically added address with short TTL */
 #define BAC_ADDR_SHORT_TTL BIT(3)
+/* Time to live is counting down on the timer wheel */
+#define BAC_ADDR_TIMED BIT(4)
 /* Freed up but held for caller to fill */
 #define BAC_ADDR_RESERVED BIT(7)
 
@@ -72,6 +106,470 @@ static struct Address_Cache_Entry {
 #define BAC_ADDR_LONG_TIME BAC_ADDR_SECS_1DAY
 #define BAC_ADDR_SHORT_TIME BAC_ADDR_SECS_1HOUR
 #define BAC_ADDR_FOREVER 0xFFFFFFFF /* Permanent entry */
+/* longest time to live that fits the signed timer wheel comparison */
+#define BAC_ADDR_TTL_MAX 0x7FFFFFFE
+
+/* Each entry is on exactly one of these lists, most recently used first.
+   Eviction takes from the tail of the bound list, then the bind list. */
+enum {
+    ADDRESS_LIST_FREE = 0,
+    ADDRESS_LIST_BOUND,
+    ADDRESS_LIST_BIND_REQ,
+    ADDRESS_LIST_STATIC,
+    ADDRESS_LIST_MAX,
+    ADDRESS_LIST_NONE = ADDRESS_LIST_MAX
+};
+static struct Address_Cache_List {
+    ADDRESS_CACHE_INDEX head;
+    ADDRESS_CACHE_INDEX tail;
+    unsigned count;
+} Address_Cache_List[ADDRESS_LIST_MAX];
+
+static ADDRESS_CACHE_INDEX Device_Hash[ADDRESS_CACHE_HASH_SIZE];
+static ADDRESS_CACHE_INDEX Address_Hash[ADDRESS_CACHE_HASH_SIZE];
+/* the one-second slots, the slots of one lap, then the overflow list */
+#define ADDRESS_WHEEL_LAP ADDRESS_CACHE_WHEEL_SIZE
+#define ADDRESS_WHEEL_OVERFLOW (2 * ADDRESS_CACHE_WHEEL_SIZE)
+#define ADDRESS_WHEEL_LISTS (ADDRESS_WHEEL_OVERFLOW + 1)
+static ADDRESS_CACHE_INDEX Timer_Wheel[ADDRESS_WHEEL_LISTS];
+/* seconds accumulated by address_cache_timer() */
+static uint32_t Address_Cache_Clock;
+/* the indexes are built on first use, for callers that skip address_init() */
+static bool Address_Cache_Indexed;
+
+/**
+ * @brief Compute the hash bucket for a device instance
+ * @param device_id  Device-Id
+ * @return bucket index
+ */
+static unsigned address_device_hash(uint32_t device_id)
+{
+    uint32_t hash = device_id;
+
+    /* mix the bits so that strided instance numbers spread out */
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bUL;
+    hash ^= hash >> 16;
+
+    return (unsigned)(hash % ADDRESS_CACHE_HASH_SIZE);
+}
+
+/**
+ * @brief Compute the hash bucket for a BACnet address. Only the fields
+ *  compared by bacnet_address_same() are included.
+ * @param src  BACnet address
+ * @return bucket index
+ */
+static unsigned address_mac_hash(const BACNET_ADDRESS *src)
+{
+    uint32_t hash = 2166136261UL; /* FNV-1a */
+    uint8_t i;
+
+    hash = (hash ^ src->mac_len) * 16777619UL;
+    for (i = 0; (i < src->mac_len) && (i < MAX_MAC_LEN); i++) {
+        hash = (hash ^ src->mac[i]) * 16777619UL;
+    }
+    hash = (hash ^ (src->net & 0xFF)) * 16777619UL;
+    hash = (hash ^ (src->net >> 8)) * 16777619UL;
+    if (src->net) {
+        hash = (hash ^ src->len) * 16777619UL;
+        for (i = 0; (i < src->len) && (i < MAX_MAC_LEN); i++) {
+            hash = (hash ^ src->adr[i]) * 16777619UL;
+        }
+    }
+
+    return (unsigned)(hash % ADDRESS_CACHE_HASH_SIZE);
+}
+
+/**
+ * @brief Get the list an entry belongs on from its flags
+ * @param flags  entry state flags
+ * @return list identifier
+ */
+static uint8_t address_list_from_flags(uint8_t flags)
+{
+    if ((flags & BAC_ADDR_IN_USE) == 0) {
+        if (flags & BAC_ADDR_RESERVED) {
+            return ADDRESS_LIST_NONE;
+        }
+        return ADDRESS_LIST_FREE;
+    }
+    if (flags & BAC_ADDR_STATIC) {
+        return ADDRESS_LIST_STATIC;
+    }
+    if (flags & BAC_ADDR_BIND_REQ) {
+        return ADDRESS_LIST_BIND_REQ;
+    }
+
+    return ADDRESS_LIST_BOUND;
+}
+
+/**
+ * @brief Unlink an entry from whichever list it is on
+ * @param index  Table index [0..MAX_ADDRESS_CACHE-1]
+ */
+static void address_list_remove(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+    struct Address_Cache_List *pList;
+
+    if (pMatch->List >= ADDRESS_LIST_MAX) {
+        return;
+    }
+    pList = &Address_Cache_List[pMatch->List];
+    if (pMatch->list_prev != ADDRESS_CACHE_NONE) {
+        Address_Cache[pMatch->list_prev].list_next = pMatch->list_next;
+    } else {
+        pList->head = pMatch->list_next;
+    }
+    if (pMatch->list_next != ADDRESS_CACHE_NONE) {
+        Address_Cache[pMatch->list_next].list_prev = pMatch->list_prev;
+    } else {
+        pList->tail = pMatch->list_prev;
+    }
+    pList->count--;
+    pMatch->List = ADDRESS_LIST_NONE;
+    pMatch->list_prev = ADDRESS_CACHE_NONE;
+    pMatch->list_next = ADDRESS_CACHE_NONE;
+}
+
+/**
+ * @brief Link an entry into the list matching its flags, either as the
+ *  most recently used (head) or least recently used (tail) member.
+ * @param index  Table index [0..MAX_ADDRESS_CACHE-1]
+ * @param tail  true to append at the tail
+ */
+static void address_list_insert(ADDRESS_CACHE_INDEX index, bool tail)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+    struct Address_Cache_List *pList;
+    uint8_t list;
+
+    list = address_list_from_flags(pMatch->Flags);
+    pMatch->List = list;
+    pMatch->list_prev = ADDRESS_CACHE_NONE;
+    pMatch->list_next = ADDRESS_CACHE_NONE;
+    if (list >= ADDRESS_LIST_MAX) {
+        return;
+    }
+    pList = &Address_Cache_List[list];
+    if (tail) {
+        pMatch->list_prev = pList->tail;
+        if (pList->tail != ADDRESS_CACHE_NONE) {
+            Address_Cache[pList->tail].list_next = index;
+        } else {
+            pList->head = index;
+        }
+        pList->tail = index;
+    } else {
+        pMatch->list_next = pList->head;
+        if (pList->head != ADDRESS_CACHE_NONE) {
+            Address_Cache[pList->head].list_prev = index;
+        } else {
+            pList->tail = index;
+        }
+        pList->head = index;
+    }
+    pList->count++;
+}
+
+/**
+ * @brief Mark an entry as most recently used, and move it to the list
+ *  matching its (possibly changed) flags.
+ * @param pMatch  entry in the address cache
+ */
+static void address_entry_touch(struct Address_Cache_Entry *pMatch)
+{
+    ADDRESS_CACHE_INDEX index = (ADDRESS_CACHE_INDEX)(pMatch - Address_Cache);
+
+    address_list_remove(index);
+    address_list_insert(index, false);
+}
+
+/**
+ * @brief Add an in-use entry to the device-id and address hash indexes
+ * @param index  Table index [0..MAX_ADDRESS_CACHE-1]
+ */
+static void address_hash_insert(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+    unsigned bucket;
+
+    bucket = address_device_hash(pMatch->device_id);
+    pMatch->device_next = Device_Hash[bucket];
+    Device_Hash[bucket] = index;
+    bucket = address_mac_hash(&pMatch->address);
+    pMatch->address_next = Address_Hash[bucket];
+    Address_Hash[bucket] = index;
+}
+
+/**
+ * @brief Remove an entry from the address hash index
+ * @param index  Table index [0..MAX_ADDRESS_CACHE-1]
+ */
+static void address_mac_hash_remove(ADDRESS_CACHE_INDEX index)
+{
+    ADDRESS_CACHE_INDEX *pLink;
+
+    pLink = &Address_Hash[address_mac_hash(&Address_Cache[index].address)];
+    while (*pLink != ADDRESS_CACHE_NONE) {
+        if (*pLink == index) {
+            *pLink = Address_Cache[index].address_next;
+            break;
+        }
+        pLink = &Address_Cache[*pLink].address_next;
+    }
+}
+
+/**
+ * @brief Remove an entry from the device-id and address hash indexes
+ * @param index  Table index [0..MAX_ADDRESS_CACHE-1]
+ */
+static void address_hash_remove(ADDRESS_CACHE_INDEX index)
+{
+    ADDRESS_CACHE_INDEX *pLink;
+
+    pLink = &Device_Hash[address_device_hash(Address_Cache[index].device_id)];
+    while (*pLink != ADDRESS_CACHE_NONE) {
+        if (*pLink == index) {
+            *pLink = Address_Cache[index].device_next;
+            break;
+        }
+        pLink = &Address_Cache[*pLink].device_next;
+    }
+    address_mac_hash_remove(index);
+}
+
+/**
+ * @brief Change the address of an entry and keep the address index current
+ * @param pMatch  entry in the address cache
+ * @param src  new BACnet address
+ */
+static void
+address_entry_address_set(struct Address_Cache_Entry *pMatch,
+    const BACNET_ADDRESS *src)
+{
+    ADDRESS_CACHE_INDEX index = (ADDRESS_CACHE_INDEX)(pMatch - Address_Cache);
+    unsigned bucket;
+
+    address_mac_hash_remove(index);
+    bacnet_address_copy(&pMatch->address, src);
+    bucket = address_mac_hash(&pMatch->address);
+    pMatch->address_next = Address_Hash[bucket];
+    Address_Hash[bucket] = index;
+}
+
+/**
+ * @brief Get the timer wheel list in which an entry waits. An entry is
+ *  due on the first second of the clock after it Expires. Entries due
+ *  within one lap wait in the one-second slot of that second, entries
+ *  due within the next laps wait in the slot of their lap, and the
+ *  others wait on the overflow list.
+ * @param pMatch  entry in the address cache
+ * @return list index
+ */
+static unsigned address_wheel_slot(const struct Address_Cache_Entry *pMatch)
+{
+    uint32_t due = pMatch->Expires + 1;
+    uint32_t laps;
+
+    if ((due - Address_Cache_Clock) <= ADDRESS_CACHE_WHEEL_SIZE) {
+        return (unsigned)(due % ADDRESS_CACHE_WHEEL_SIZE);
+    }
+    laps = (due / ADDRESS_CACHE_WHEEL_SIZE) -
+        (Address_Cache_Clock / ADDRESS_CACHE_WHEEL_SIZE);
+    if (laps <= ADDRESS_CACHE_WHEEL_SIZE) {
+        return ADDRESS_WHEEL_LAP +
+            (unsigned)((due / ADDRESS_CACHE_WHEEL_SIZE) %
+                       ADDRESS_CACHE_WHEEL_SIZE);
+    }
+
+    return ADDRESS_WHEEL_OVERFLOW;
+}
+
+/**
+ * @brief Link a timed entry into the timer wheel
+ * @param index  Table index [0..MAX_ADDRESS_CACHE-1]
+ */
+static void address_wheel_insert(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+    unsigned slot = address_wheel_slot(pMatch);
+
+    pMatch->Wheel = (uint16_t)slot;
+    pMatch->wheel_prev = ADDRESS_CACHE_NONE;
+    pMatch->wheel_next = Timer_Wheel[slot];
+    if (Timer_Wheel[slot] != ADDRESS_CACHE_NONE) {
+        Address_Cache[Timer_Wheel[slot]].wheel_prev = index;
+    }
+    Timer_Wheel[slot] = index;
+}
+
+/**
+ * @brief Unlink a timed entry from the timer wheel
+ * @param index  Table index [0..MAX_ADDRESS_CACHE-1]
+ */
+static void address_wheel_remove(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+
+    if ((pMatch->Flags & BAC_ADDR_TIMED) == 0) {
+        return;
+    }
+    if (pMatch->wheel_prev != ADDRESS_CACHE_NONE) {
+        Address_Cache[pMatch->wheel_prev].wheel_next = pMatch->wheel_next;
+    } else {
+        Timer_Wheel[pMatch->Wheel] = pMatch->wheel_next;
+    }
+    if (pMatch->wheel_next != ADDRESS_CACHE_NONE) {
+        Address_Cache[pMatch->wheel_next].wheel_prev = pMatch->wheel_prev;
+    }
+    pMatch->Flags &= ~BAC_ADDR_TIMED;
+}
+
+/**
+ * @brief Move the entries of a timer wheel list to the lists in which
+ *  they wait now, which are nearer the one-second slots
+ * @param slot  list index
+ */
+static void address_wheel_cascade(unsigned slot)
+{
+    ADDRESS_CACHE_INDEX index, next;
+
+    index = Timer_Wheel[slot];
+    Timer_Wheel[slot] = ADDRESS_CACHE_NONE;
+    while (index != ADDRESS_CACHE_NONE) {
+        next = Address_Cache[index].wheel_next;
+        address_wheel_insert(index);
+        index = next;
+    }
+}
+
+/**
+ * @brief Set the time to live of an entry. BAC_ADDR_FOREVER never expires.
+ * @param pMatch  entry in the address cache
+ * @param TimeOut  time to live in seconds
+ */
+static void
+address_entry_ttl_set(struct Address_Cache_Entry *pMatch, uint32_t TimeOut)
+{
+    ADDRESS_CACHE_INDEX index = (ADDRESS_CACHE_INDEX)(pMatch - Address_Cache);
+
+    address_wheel_remove(index);
+    if (TimeOut != BAC_ADDR_FOREVER) {
+        if (TimeOut > BAC_ADDR_TTL_MAX) {
+            TimeOut = BAC_ADDR_TTL_MAX;
+        }
+        pMatch->Expires = Address_Cache_Clock + TimeOut;
+        pMatch->Flags |= BAC_ADDR_TIMED;
+        address_wheel_insert(index);
+    }
+}
+
+/**
+ * @brief Get the remaining time to live of an entry
+ * @param pMatch  entry in the address cache
+ * @return time to live in seconds, or BAC_ADDR_FOREVER
+ */
+static uint32_t address_entry_ttl(const struct Address_Cache_Entry *pMatch)
+{
+    if (pMatch->Flags & BAC_ADDR_TIMED) {
+        return pMatch->Expires - Address_Cache_Clock;
+    }
+
+    return BAC_ADDR_FOREVER;
+}
+
+/**
+ * @brief Remove an entry from every index and mark it with the given flags
+ * @param pMatch  entry in the address cache
+ * @param flags  new flags: 0 to free the entry, BAC_ADDR_RESERVED to keep
+ *  it for the caller.
+ */
+static void
+address_entry_release(struct Address_Cache_Entry *pMatch, uint8_t flags)
+{
+    ADDRESS_CACHE_INDEX index = (ADDRESS_CACHE_INDEX)(pMatch - Address_Cache);
+
+    if (pMatch->Flags & BAC_ADDR_IN_USE) {
+        address_hash_remove(index);
+    }
+    address_wheel_remove(index);
+    address_list_remove(index);
+    pMatch->Flags = flags;
+    /* freed entries are reused least recently freed first */
+    address_list_insert(index, true);
+}
+
+/**
+ * @brief Rebuild the hash indexes, lists and timer wheel from the entry
+ *  flags, device-ids, addresses and expiry times.
+ */
+static void address_cache_index_rebuild(void)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+    unsigned i;
+
+    for (i = 0; i < ADDRESS_CACHE_HASH_SIZE; i++) {
+        Device_Hash[i] = ADDRESS_CACHE_NONE;
+        Address_Hash[i] = ADDRESS_CACHE_NONE;
+    }
+    for (i = 0; i < ADDRESS_WHEEL_LISTS; i++) {
+        Timer_Wheel[i] = ADDRESS_CACHE_NONE;
+    }
+    for (i = 0; i < ADDRESS_LIST_MAX; i++) {
+        Address_Cache_List[i].head = ADDRESS_CACHE_NONE;
+        Address_Cache_List[i].tail = ADDRESS_CACHE_NONE;
+        Address_Cache_List[i].count = 0;
+    }
+    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+        pMatch = &Address_Cache[index];
+        if (pMatch->Flags & BAC_ADDR_IN_USE) {
+            address_hash_insert(index);
+            if (pMatch->Flags & BAC_ADDR_TIMED) {
+                address_wheel_insert(index);
+            }
+        } else {
+            pMatch->Flags = 0;
+        }
+        address_list_insert(index, true);
+    }
+    Address_Cache_Indexed = true;
+}
+
+/**
+ * @brief Build the indexes if they have not been built yet
+ */
+static void address_cache_index_check(void)
+{
+    if (!Address_Cache_Indexed) {
+        address_cache_index_rebuild();
+    }
+}
+
+/**
+ * @brief Find the in-use entry, bound or not, for a device instance
+ * @param device_id  Device-Id
+ * @return entry, or NULL if not found
+ */
+static struct Address_Cache_Entry *address_entry_find(uint32_t device_id)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+
+    address_cache_index_check();
+    index = Device_Hash[address_device_hash(device_id)];
+    while (index != ADDRESS_CACHE_NONE) {
+        pMatch = &Address_Cache[index];
+        if (pMatch->device_id == device_id) {
+            return pMatch;
+        }
+        index = pMatch->device_next;
+    }
+
+    return NULL;
+}
 
 /**
  * @brief Set the index of the first (top) address being protected.
@@ -103,90 +601,100 @@ void address_own_device_id_set(uint32_t own_id)
 void address_remove_device(uint32_t device_id)
 {
     struct Address_Cache_Entry *pMatch;
-    uint32_t index = 0;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            pMatch->Flags = 0;
-            if (index < Top_Protected_Entry) {
-                Top_Protected_Entry--;
-            }
-            break;
+    pMatch = address_entry_find(device_id);
+    if (pMatch) {
+        if ((uint32_t)(pMatch - Address_Cache) < Top_Protected_Entry) {
+            Top_Protected_Entry--;
         }
+        address_entry_release(pMatch, 0);
     }
 
     return;
 }
 
 /**
- * @brief Search the cache for the entry nearest expiry and delete it. Mark the
- * entry as reserved with a 1 hour TTL and return a pointer to the reserved
- * entry. Will not delete a static entry and returns NULL pointer if no
- * entry available to free up. Does not check for free entries as it is
- * assumed we are calling this due to the lack of those.
+ * @brief Take the least recently used entry and delete it. Mark the
+ * entry as reserved and return a pointer to the reserved entry.
+ * Bound entries outside the protected range are taken first, then
+ * entries with a bind request outstanding. Will not delete a static entry
+ * and returns NULL pointer if no entry available to free up. Does not check
+ * for free entries as it is assumed we are calling this due to the lack
+ * of those.
  *
  * @return Pointer to the entry that has been removed or NULL.
  */
 static struct Address_Cache_Entry *address_remove_oldest(void)
 {
-    struct Address_Cache_Entry *pMatch;
     struct Address_Cache_Entry *pCandidate;
-    uint32_t ulTime;
-    unsigned index;
+    ADDRESS_CACHE_INDEX index;
 
     pCandidate = NULL;
     if (Top_Protected_Entry > (MAX_ADDRESS_CACHE - 1)) {
         return pCandidate;
     }
-    /* Longest possible non static time to live */
-    ulTime = BAC_ADDR_FOREVER - 1;
-
     /* First pass - try only in use and bound entries */
-
-    for (index = Top_Protected_Entry; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags &
-             (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
-            BAC_ADDR_IN_USE) {
-            if (pMatch->TimeToLive <= ulTime) {
-                /* Shorter lived entry found */
-                ulTime = pMatch->TimeToLive;
-                pCandidate = pMatch;
-            }
+    index = Address_Cache_List[ADDRESS_LIST_BOUND].tail;
+    while (index != ADDRESS_CACHE_NONE) {
+        if (index >= Top_Protected_Entry) {
+            pCandidate = &Address_Cache[index];
+            break;
+        }
+        index = Address_Cache[index].list_prev;
+    }
+    /* Second pass - try in use and un bound as last resort */
+    if (pCandidate == NULL) {
+        index = Address_Cache_List[ADDRESS_LIST_BIND_REQ].tail;
+        if (index != ADDRESS_CACHE_NONE) {
+            pCandidate = &Address_Cache[index];
         }
     }
-
     if (pCandidate != NULL) {
         /* Found something to free up */
-        pCandidate->Flags = BAC_ADDR_RESERVED;
-        /* only reserve it for a short while */
-        pCandidate->TimeToLive = BAC_ADDR_SHORT_TIME;
-        return (pCandidate);
+        address_entry_release(pCandidate, BAC_ADDR_RESERVED);
     }
 
-    /* Second pass - try in use and un bound as last resort */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+    return (pCandidate);
+}
+
+/**
+ * @brief Get an unused entry, or free up the least recently used one, and
+ *  put it in use for a device. The caller sets the address and TTL.
+ * @param device_id  Device-Id
+ * @param flags  initial flags, which include BAC_ADDR_IN_USE
+ * @return entry, or NULL if the cache is full of static entries
+ */
+static struct Address_Cache_Entry *
+address_entry_new(uint32_t device_id, uint8_t flags)
+{
+    struct Address_Cache_Entry *pMatch = NULL;
+    ADDRESS_CACHE_INDEX index;
+
+    address_cache_index_check();
+    index = Address_Cache_List[ADDRESS_LIST_FREE].head;
+    if (index != ADDRESS_CACHE_NONE) {
         pMatch = &Address_Cache[index];
-        if ((pMatch->Flags &
-             (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
-            ((uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ))) {
-            if (pMatch->TimeToLive <= ulTime) { /* Shorter lived entry found */
-                ulTime = pMatch->TimeToLive;
-                pCandidate = pMatch;
-            }
+        address_list_remove(index);
+    } else {
+        pMatch = address_remove_oldest();
+        if (pMatch) {
+            index = (ADDRESS_CACHE_INDEX)(pMatch - Address_Cache);
+            address_list_remove(index);
         }
     }
-
-    if (pCandidate != NULL) {
-        /* Found something to free up */
-        pCandidate->Flags = BAC_ADDR_RESERVED;
-        /* only reserve it for a short while */
-        pCandidate->TimeToLive = BAC_ADDR_SHORT_TIME;
+    if (pMatch) {
+        pMatch->Flags = flags;
+        pMatch->device_id = device_id;
+        pMatch->max_apdu = 0;
+#if BACNET_SEGMENTATION_ENABLED
+        pMatch->segmentation = 0;
+        pMatch->maxsegments = 0;
+#endif
+        address_hash_insert(index);
+        address_list_insert(index, false);
     }
 
-    return (pCandidate);
+    return pMatch;
 }
 
 #ifdef BACNET_ADDRESS_CACHE_FILE
@@ -262,10 +770,12 @@ void address_init(void)
     unsigned index;
 
     Top_Protected_Entry = 0;
+    Address_Cache_Clock = 0;
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
         pMatch = &Address_Cache[index];
         pMatch->Flags = 0;
     }
+    address_cache_index_rebuild();
 #ifdef BACNET_ADDRESS_CACHE_FILE
     address_file_init(Address_Cache_Filename);
 #endif
@@ -289,7 +799,7 @@ void address_init_partial(void)
         if ((pMatch->Flags & BAC_ADDR_IN_USE) != 0) {
             /* It's in use so let's check further */
             if (((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) ||
-                (pMatch->TimeToLive == 0)) {
+                (address_entry_ttl(pMatch) == 0)) {
                 pMatch->Flags = 0;
             }
         }
@@ -299,6 +809,8 @@ void address_init_partial(void)
             pMatch->Flags = 0;
         }
     }
+    /* the indexes live beside the entries, so rebuild them to match */
+    address_cache_index_rebuild();
 #ifdef BACNET_ADDRESS_CACHE_FILE
     address_file_init(Address_Cache_Filename);
 #endif
@@ -320,26 +832,23 @@ void address_set_device_TTL(
     uint32_t device_id, uint32_t TimeOut, bool StaticFlag)
 {
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* If bound then we have either static or normaal */
-                if (StaticFlag) {
-                    pMatch->Flags |= BAC_ADDR_STATIC;
-                    pMatch->TimeToLive = BAC_ADDR_FOREVER;
-                } else {
-                    pMatch->Flags &= ~BAC_ADDR_STATIC;
-                    pMatch->TimeToLive = TimeOut;
-                }
+    pMatch = address_entry_find(device_id);
+    if (pMatch) {
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* If bound then we have either static or normaal */
+            if (StaticFlag) {
+                pMatch->Flags |= BAC_ADDR_STATIC;
+                address_entry_ttl_set(pMatch, BAC_ADDR_FOREVER);
             } else {
-                /* For unbound we can only set the time to live */
-                pMatch->TimeToLive = TimeOut;
+                pMatch->Flags &= ~BAC_ADDR_STATIC;
+                address_entry_ttl_set(pMatch, TimeOut);
             }
-            break; /* Exit now if found at all - bound or unbound */
+            /* static entries move off the eviction list */
+            address_entry_touch(pMatch);
+        } else {
+            /* For unbound we can only set the time to live */
+            address_entry_ttl_set(pMatch, TimeOut);
         }
     }
 }
@@ -365,28 +874,21 @@ bool address_get_by_device(
 {
     struct Address_Cache_Entry *pMatch;
     bool found = false; /* return value */
-    unsigned index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* If bound then fetch data */
-                bacnet_address_copy(src, &pMatch->address);
-                if (max_apdu) {
-                    *max_apdu = pMatch->max_apdu;
-                }
-#if BACNET_SEGMENTATION_ENABLED                
-                *segmentation = pMatch->segmentation;
-                *maxsegments = pMatch->maxsegments;
-#endif
-                /* Prove we found it */
-                found = true;
-            }
-            /* Exit now if found at all - bound or unbound */
-            break;
+    pMatch = address_entry_find(device_id);
+    if (pMatch && ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0)) {
+        /* If bound then fetch data */
+        bacnet_address_copy(src, &pMatch->address);
+        if (max_apdu) {
+            *max_apdu = pMatch->max_apdu;
         }
+#if BACNET_SEGMENTATION_ENABLED
+        *segmentation = pMatch->segmentation;
+        *maxsegments = pMatch->maxsegments;
+#endif
+        address_entry_touch(pMatch);
+        /* Prove we found it */
+        found = true;
     }
 
     return found;
@@ -404,9 +906,14 @@ bool address_get_device_id(const BACNET_ADDRESS *src, uint32_t *device_id)
 {
     struct Address_Cache_Entry *pMatch;
     bool found = false; /* return value */
-    unsigned index;
+    ADDRESS_CACHE_INDEX index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+    if (!src) {
+        return false;
+    }
+    address_cache_index_check();
+    index = Address_Hash[address_mac_hash(src)];
+    while (index != ADDRESS_CACHE_NONE) {
         pMatch = &Address_Cache[index];
         if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
             BAC_ADDR_IN_USE) {
@@ -415,10 +922,12 @@ bool address_get_device_id(const BACNET_ADDRESS *src, uint32_t *device_id)
                 if (device_id) {
                     *device_id = pMatch->device_id;
                 }
+                address_entry_touch(pMatch);
                 found = true;
                 break;
             }
         }
+        index = pMatch->address_next;
     }
 
     return found;
@@ -434,9 +943,7 @@ bool address_get_device_id(const BACNET_ADDRESS *src, uint32_t *device_id)
 void address_add(
     uint32_t device_id, unsigned max_apdu, const BACNET_ADDRESS *src)
 {
-    bool found = false; /* return value */
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
 
     if (Own_Device_ID == device_id) {
         return;
@@ -449,61 +956,38 @@ void address_add(
        bind request if it exists */
 
     /* existing device or bind request outstanding - update address */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+    pMatch = address_entry_find(device_id);
+    if (pMatch) {
         /* Device already in the list, then update the values. */
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            bacnet_address_copy(&pMatch->address, src);
-            pMatch->max_apdu = max_apdu;
-            /* Pick the right time to live */
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) {
-                /* Bind requested so long time */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            } else if ((pMatch->Flags & BAC_ADDR_STATIC) != 0) {
-                /* Static already so make sure it never expires */
-                pMatch->TimeToLive = BAC_ADDR_FOREVER;
-            } else if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
-                /* Opportunistic entry so leave on short fuse */
-                pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-            } else {
-                /* Renewing existing entry */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            }
-            /* Clear bind request flag just in case */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
-            found = true;
-            break;
-        }
-    }
-    /* New device - add to cache if there is room. */
-    if (!found) {
-        for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-            pMatch = &Address_Cache[index];
-            if ((pMatch->Flags & BAC_ADDR_IN_USE) == 0) {
-                pMatch->Flags = BAC_ADDR_IN_USE;
-                pMatch->device_id = device_id;
-                pMatch->max_apdu = max_apdu;
-                bacnet_address_copy(&pMatch->address, src);
-                /* Opportunistic entry so leave on short fuse */
-                pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-                found = true;
-                break;
-            }
-        }
-    }
-    /* If adding has failed, see if we can squeeze it in by removed the oldest
-     * entry. */
-    if (!found) {
-        pMatch = address_remove_oldest();
-        if (pMatch != NULL) {
-            pMatch->Flags = BAC_ADDR_IN_USE;
-            pMatch->device_id = device_id;
-            pMatch->max_apdu = max_apdu;
-            bacnet_address_copy(&pMatch->address, src);
+        address_entry_address_set(pMatch, src);
+        pMatch->max_apdu = max_apdu;
+        /* Pick the right time to live */
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) {
+            /* Bind requested so long time */
+            address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
+        } else if ((pMatch->Flags & BAC_ADDR_STATIC) != 0) {
+            /* Static already so make sure it never expires */
+            address_entry_ttl_set(pMatch, BAC_ADDR_FOREVER);
+        } else if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
             /* Opportunistic entry so leave on short fuse */
-            pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+            address_entry_ttl_set(pMatch, BAC_ADDR_SHORT_TIME);
+        } else {
+            /* Renewing existing entry */
+            address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
         }
+        /* Clear bind request flag just in case */
+        pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
+        address_entry_touch(pMatch);
+        return;
+    }
+    /* New device - add to cache if there is room, or squeeze it in
+       by removing the least recently used entry. */
+    pMatch = address_entry_new(device_id, BAC_ADDR_IN_USE);
+    if (pMatch != NULL) {
+        pMatch->max_apdu = max_apdu;
+        address_entry_address_set(pMatch, src);
+        /* Opportunistic entry so leave on short fuse */
+        address_entry_ttl_set(pMatch, BAC_ADDR_SHORT_TIME);
     }
     return;
 }
@@ -529,61 +1013,43 @@ bool address_device_bind_request(
 {
     bool found = false; /* return value */
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
 
     /* existing device - update address info if currently bound */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* Already bound */
-                found = true;
-                if (src) {
-                    bacnet_address_copy(src, &pMatch->address);
-                }
-                if (max_apdu) {
-                    *max_apdu = pMatch->max_apdu;
-                }
-                if (device_ttl) {
-                    *device_ttl = pMatch->TimeToLive;
-                }
-                if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
-                    /* Was picked up opportunistacilly */
-                    /* Convert to normal entry  */
-                    pMatch->Flags &= ~BAC_ADDR_SHORT_TTL;
-                    /* And give it a decent time to live */
-                    pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-                }
+    pMatch = address_entry_find(device_id);
+    if (pMatch) {
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* Already bound */
+            found = true;
+            if (src) {
+                bacnet_address_copy(src, &pMatch->address);
             }
-            /* True if bound, false if bind request outstanding */
-            return (found);
-        }
-    }
-
-    /* Not there already so look for a free entry to put it in */
-    /* existing device - update address info if currently bound */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) == 0) {
-            /* In use and awaiting binding */
-            pMatch->Flags = (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
-            pMatch->device_id = device_id;
-            /* No point in leaving bind requests in for long haul */
-            pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-            /* now would be a good time to do a Who-Is request */
-            return (false);
+            if (max_apdu) {
+                *max_apdu = pMatch->max_apdu;
+            }
+            if (device_ttl) {
+                *device_ttl = address_entry_ttl(pMatch);
+            }
+            if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
+                /* Was picked up opportunistacilly */
+                /* Convert to normal entry  */
+                pMatch->Flags &= ~BAC_ADDR_SHORT_TTL;
+                /* And give it a decent time to live */
+                address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
+            }
+            address_entry_touch(pMatch);
         }
+        /* True if bound, false if bind request outstanding */
+        return (found);
     }
 
-    /* No free entries, See if we can squeeze it in by dropping an existing one
-     */
-    pMatch = address_remove_oldest();
+    /* Not there already so look for a free entry to put it in, or
+       see if we can squeeze it in by dropping an existing one */
+    pMatch =
+        address_entry_new(device_id, BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
     if (pMatch != NULL) {
-        pMatch->Flags = (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
-        pMatch->device_id = device_id;
         /* No point in leaving bind requests in for long haul */
-        pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+        address_entry_ttl_set(pMatch, BAC_ADDR_SHORT_TIME);
+        /* now would be a good time to do a Who-Is request */
     }
     return (false);
 }
@@ -617,24 +1083,20 @@ void address_add_binding(
     uint32_t device_id, unsigned max_apdu, const BACNET_ADDRESS *src)
 {
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
 
     /* existing device or bind request - update address */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            bacnet_address_copy(&pMatch->address, src);
-            pMatch->max_apdu = max_apdu;
-            /* Clear bind request flag in case it was set */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
-            /* Only update TTL if not static */
-            if ((pMatch->Flags & BAC_ADDR_STATIC) == 0) {
-                /* and set it on a long fuse */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            }
-            break;
+    pMatch = address_entry_find(device_id);
+    if (pMatch) {
+        address_entry_address_set(pMatch, src);
+        pMatch->max_apdu = max_apdu;
+        /* Clear bind request flag in case it was set */
+        pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
+        /* Only update TTL if not static */
+        if ((pMatch->Flags & BAC_ADDR_STATIC) == 0) {
+            /* and set it on a long fuse */
+            address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
         }
+        address_entry_touch(pMatch);
     }
     return;
 }
@@ -676,7 +1138,7 @@ bool address_device_get_by_index(
                 *max_apdu = pMatch->max_apdu;
             }
             if (device_ttl) {
-                *device_ttl = pMatch->TimeToLive;
+                *device_ttl = address_entry_ttl(pMatch);
             }
             found = true;
         }
@@ -712,20 +1174,10 @@ bool address_get_by_index(
  */
 unsigned address_count(void)
 {
-    struct Address_Cache_Entry *pMatch;
-    unsigned count = 0; /* return value */
-    unsigned index;
-
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        /* Only count bound entries */
-        if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
-            BAC_ADDR_IN_USE) {
-            count++;
-        }
-    }
-
-    return count;
+    address_cache_index_check();
+    /* Only count bound entries */
+    return Address_Cache_List[ADDRESS_LIST_BOUND].count +
+        Address_Cache_List[ADDRESS_LIST_STATIC].count;
 }
 
 /**
@@ -991,10 +1443,14 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 }
 
 /**
- * Scan the cache and eliminate any expired entries. Should be called
+ * Advance the cache clock and eliminate any expired entries. Should be called
  * periodically to ensure the cache is managed correctly. If this function
  * is never called at all the whole cache is effectively rendered static and
- * entries never expire unless explicitly deleted.
+ * entries never expire unless explicitly deleted. Each second visits the
+ * entries that expire in it. Once per lap of the one-second slots, the
+ * entries due in the next lap move down from the second level of the
+ * wheel, and once per lap of the second level the overflow list is
+ * sorted into it, so an entry is moved a few times in a long time to live.
  *
  * @param uSeconds  Approximate number of seconds since last call to this
  * function
@@ -1002,19 +1458,30 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 void address_cache_timer(uint16_t uSeconds)
 {
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
-
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) != 0) &&
-            ((pMatch->Flags & BAC_ADDR_STATIC) ==
-             0)) { /* Check all entries holding a slot except statics
-                    */
-            if (pMatch->TimeToLive >= uSeconds) {
-                pMatch->TimeToLive -= uSeconds;
-            } else {
-                pMatch->Flags = 0;
+    ADDRESS_CACHE_INDEX index, next;
+    uint32_t clock, lap;
+
+    address_cache_index_check();
+    while (uSeconds) {
+        clock = Address_Cache_Clock + 1;
+        if ((clock % ADDRESS_CACHE_WHEEL_SIZE) == 0) {
+            lap = clock / ADDRESS_CACHE_WHEEL_SIZE;
+            if ((lap % ADDRESS_CACHE_WHEEL_SIZE) == 0) {
+                address_wheel_cascade(ADDRESS_WHEEL_OVERFLOW);
+            }
+            address_wheel_cascade(
+                ADDRESS_WHEEL_LAP + (unsigned)(lap % ADDRESS_CACHE_WHEEL_SIZE));
+        }
+        index = Timer_Wheel[clock % ADDRESS_CACHE_WHEEL_SIZE];
+        while (index != ADDRESS_CACHE_NONE) {
+            pMatch = &Address_Cache[index];
+            next = pMatch->wheel_next;
+            if ((int32_t)(clock - pMatch->Expires) > 0) {
+                address_entry_release(pMatch, 0);
             }
+            index = next;
         }
+        Address_Cache_Clock = clock;
+        uSeconds--;
     }
 }
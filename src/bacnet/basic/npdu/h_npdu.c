@@ -16,6 +16,8 @@
 #include "bacnet/npdu.h"
 #include "bacnet/apdu.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/npdu/h_npdu.h"
+#include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/datalink.h"
 
@@ -25,6 +27,14 @@
 
 static uint16_t Local_Network_Number;
 static uint8_t Local_Network_Number_Status = NETWORK_NUMBER_LEARNED;
+/* receive filter rules that are enabled, one bit per rule */
+static uint32_t NPDU_Filter_Enabled =
+    (1U << NPDU_FILTER_DNET) | (1U << NPDU_FILTER_CONFIRMED_BROADCAST);
+/* number of received PDUs dropped by each rule */
+static uint32_t NPDU_Filter_Count[NPDU_FILTER_MAX];
+/* tells whether an unconfirmed service is handled, or NULL */
+static npdu_filter_unconfirmed_handled_function
+    NPDU_Filter_Unconfirmed_Handled;
 
 /**
  * @brief get the local network number
@@ -112,6 +122,231 @@ int npdu_send_what_is_network_number(BACNET_ADDRESS *dst)
     return datalink_send_pdu(dst, &npdu_data, pdu, pdu_len);
 }
 
+/**
+ * @brief Decode a small unsigned context tagged value in place
+ * @param apdu [in] buffer positioned at the context tag octet
+ * @param apdu_len [in] number of bytes in the buffer
+ * @param tag_number [in] expected context tag number 0..14
+ * @param value [out] the decoded value
+ * @return number of bytes used, or 0 if the tag does not match
+ */
+static int npdu_filter_context_unsigned(
+    const uint8_t *apdu, uint16_t apdu_len, uint8_t tag_number, uint32_t *value)
+{
+    uint8_t len_value;
+    uint8_t i;
+
+    if (apdu_len < 1) {
+        return 0;
+    }
+    /* context specific bit, tag number, and a length of 1..4 octets */
+    if ((apdu[0] & 0xF8) != ((tag_number << 4) | BIT(3))) {
+        return 0;
+    }
+    len_value = apdu[0] & 0x07;
+    if ((len_value < 1) || (len_value > 4) || (apdu_len < (1 + len_value))) {
+        return 0;
+    }
+    *value = 0;
+    for (i = 1; i <= len_value; i++) {
+        *value = (*value << 8) | apdu[i];
+    }
+
+    return 1 + len_value;
+}
+
+/**
+ * @brief Check whether the optional device instance range of a Who-Is
+ *  or Who-Has request excludes this device
+ * @param apdu [in] the service request, after the service choice
+ * @param apdu_len [in] number of bytes in the service request
+ * @return true if a range is present and excludes this device
+ */
+static bool npdu_filter_range_excludes(const uint8_t *apdu, uint16_t apdu_len)
+{
+    uint32_t low_limit = 0;
+    uint32_t high_limit = 0;
+    uint32_t instance;
+    int len;
+
+    len = npdu_filter_context_unsigned(apdu, apdu_len, 0, &low_limit);
+    if (len == 0) {
+        /* no range: every device is asked */
+        return false;
+    }
+    if (npdu_filter_context_unsigned(
+            &apdu[len], (uint16_t)(apdu_len - len), 1, &high_limit) == 0) {
+        /* malformed, leave it to the service decoder */
+        return false;
+    }
+    if ((low_limit > BACNET_MAX_INSTANCE) ||
+        (high_limit > BACNET_MAX_INSTANCE)) {
+        return false;
+    }
+    instance = Device_Object_Instance_Number();
+
+    return (instance < low_limit) || (instance > high_limit);
+}
+
+/**
+ * @brief Classify a received NPDU by peeking at the NPCI and the first
+ *  APDU octets, without decoding them, so that uninteresting traffic is
+ *  dropped before the NPDU and APDU decoders run.
+ * @param pdu [in] Buffer containing the NPDU and APDU of the received packet.
+ * @param pdu_len [in] The size of the received message in the pdu[] buffer.
+ * @return the enabled rule that rejects the PDU, or NPDU_FILTER_NONE if the
+ *  PDU shall be processed
+ */
+BACNET_NPDU_FILTER_RULE
+npdu_filter_classify(const uint8_t *pdu, uint16_t pdu_len)
+{
+    uint16_t dnet = 0;
+    uint16_t len = 2;
+    uint8_t control;
+    uint8_t service_choice;
+    const uint8_t *apdu;
+    uint16_t apdu_len;
+
+    if ((pdu_len < 2) || (pdu[0] != BACNET_PROTOCOL_VERSION)) {
+        return NPDU_FILTER_NONE;
+    }
+    control = pdu[1];
+    if (control & BIT(5)) {
+        if (pdu_len < (len + 3)) {
+            return NPDU_FILTER_NONE;
+        }
+        dnet = ((uint16_t)pdu[len] << 8) | pdu[len + 1];
+        len += 3 + pdu[len + 2];
+    }
+    if ((dnet != 0) && (dnet != BACNET_BROADCAST_NETWORK) &&
+        npdu_filter_rule_enabled(NPDU_FILTER_DNET)) {
+        /* we are not a router */
+        return NPDU_FILTER_DNET;
+    }
+    if (control & BIT(7)) {
+        /* network layer messages are few, always decode them */
+        return NPDU_FILTER_NONE;
+    }
+    if (control & BIT(3)) {
+        if (pdu_len < (len + 3)) {
+            return NPDU_FILTER_NONE;
+        }
+        len += 3 + pdu[len + 2];
+    }
+    if (dnet) {
+        /* hop count */
+        len++;
+    }
+    if (pdu_len <= len) {
+        return NPDU_FILTER_NONE;
+    }
+    apdu = &pdu[len];
+    apdu_len = pdu_len - len;
+    switch (apdu[0] & 0xF0) {
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+            if ((dnet == BACNET_BROADCAST_NETWORK) &&
+                npdu_filter_rule_enabled(NPDU_FILTER_CONFIRMED_BROADCAST)) {
+                /* 5.4.5.1 - IDLE: ConfirmedBroadcastReceived */
+                return NPDU_FILTER_CONFIRMED_BROADCAST;
+            }
+            break;
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            if (apdu_len < 2) {
+                break;
+            }
+            service_choice = apdu[1];
+            if (NPDU_Filter_Unconfirmed_Handled &&
+                npdu_filter_rule_enabled(NPDU_FILTER_UNCONFIRMED_UNHANDLED) &&
+                !NPDU_Filter_Unconfirmed_Handled(
+                    (BACNET_UNCONFIRMED_SERVICE)service_choice)) {
+                return NPDU_FILTER_UNCONFIRMED_UNHANDLED;
+            }
+            if ((service_choice == SERVICE_UNCONFIRMED_WHO_IS) &&
+                npdu_filter_rule_enabled(NPDU_FILTER_WHO_IS_RANGE) &&
+                npdu_filter_range_excludes(&apdu[2], apdu_len - 2)) {
+                return NPDU_FILTER_WHO_IS_RANGE;
+            }
+            if ((service_choice == SERVICE_UNCONFIRMED_WHO_HAS) &&
+                npdu_filter_rule_enabled(NPDU_FILTER_WHO_HAS_RANGE) &&
+                npdu_filter_range_excludes(&apdu[2], apdu_len - 2)) {
+                return NPDU_FILTER_WHO_HAS_RANGE;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return NPDU_FILTER_NONE;
+}
+
+/**
+ * @brief Enable or disable a receive filter rule
+ * @param rule [in] the rule
+ * @param enable [in] true to drop the PDUs matching the rule
+ */
+void npdu_filter_rule_enable(BACNET_NPDU_FILTER_RULE rule, bool enable)
+{
+    if ((rule > NPDU_FILTER_NONE) && (rule < NPDU_FILTER_MAX)) {
+        if (enable) {
+            NPDU_Filter_Enabled |= (1U << rule);
+        } else {
+            NPDU_Filter_Enabled &= ~(1U << rule);
+        }
+    }
+}
+
+/**
+ * @brief Determine whether a receive filter rule is enabled
+ * @param rule [in] the rule
+ * @return true if PDUs matching the rule are dropped
+ */
+bool npdu_filter_rule_enabled(BACNET_NPDU_FILTER_RULE rule)
+{
+    if ((rule > NPDU_FILTER_NONE) && (rule < NPDU_FILTER_MAX)) {
+        return (NPDU_Filter_Enabled & (1U << rule)) != 0;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Set the function that tells whether an unconfirmed service is
+ *  handled, such as apdu_unconfirmed_service_handled(). The
+ *  UNCONFIRMED_UNHANDLED rule only drops PDUs while a function is set.
+ * @param pFunction [in] the function, or NULL
+ */
+void npdu_filter_unconfirmed_handled_set(
+    npdu_filter_unconfirmed_handled_function pFunction)
+{
+    NPDU_Filter_Unconfirmed_Handled = pFunction;
+}
+
+/**
+ * @brief Get the number of received PDUs dropped by a filter rule
+ * @param rule [in] the rule
+ * @return the number of PDUs dropped since the last reset
+ */
+uint32_t npdu_filter_count(BACNET_NPDU_FILTER_RULE rule)
+{
+    if ((rule > NPDU_FILTER_NONE) && (rule < NPDU_FILTER_MAX)) {
+        return NPDU_Filter_Count[rule];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Reset the receive filter counters
+ */
+void npdu_filter_count_reset(void)
+{
+    unsigned i;
+
+    for (i = 0; i < NPDU_FILTER_MAX; i++) {
+        NPDU_Filter_Count[i] = 0;
+    }
+}
+
 /** @file h_npdu.c  Handles messages at the NPDU level of the BACnet stack. */
 
 /** Handler to manage the Network Layer Control Messages received in a packet.
@@ -216,10 +451,16 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
     int apdu_offset = 0;
     BACNET_ADDRESS dest = { 0 };
     BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_NPDU_FILTER_RULE rule;
 
     if (pdu_len < 1) {
         return;
     }
+    rule = npdu_filter_classify(pdu, pdu_len);
+    if (rule != NPDU_FILTER_NONE) {
+        NPDU_Filter_Count[rule]++;
+        return;
+    }
 
     /* only handle the version that we know how to handle */
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
@@ -17,6 +17,35 @@
 #include "bacnet/apdu.h"
 #include "bacnet/npdu.h"
 
+/**
+ * Rules of the receive filter that drops uninteresting PDUs before they are
+ * decoded. DNET and CONFIRMED_BROADCAST drop what npdu_handler() and
+ * apdu_handler() would discard anyway and are enabled by default.
+ * UNCONFIRMED_UNHANDLED is enabled by the application, and also needs the
+ * function set with npdu_filter_unconfirmed_handled_set(). The Who-Is and
+ * Who-Has device range rules assume that the only device behind
+ * npdu_handler() is Device_Object_Instance_Number(), and are enabled by the
+ * application.
+ */
+typedef enum BACnet_NPDU_Filter_Rule {
+    NPDU_FILTER_NONE = 0,
+    /* routed to a remote network, and we are not a router */
+    NPDU_FILTER_DNET,
+    /* confirmed request sent as a global broadcast */
+    NPDU_FILTER_CONFIRMED_BROADCAST,
+    /* unconfirmed service without a handler */
+    NPDU_FILTER_UNCONFIRMED_UNHANDLED,
+    /* Who-Is with a device range excluding this device */
+    NPDU_FILTER_WHO_IS_RANGE,
+    /* Who-Has with a device range excluding this device */
+    NPDU_FILTER_WHO_HAS_RANGE,
+    NPDU_FILTER_MAX
+} BACNET_NPDU_FILTER_RULE;
+
+/* returns true if the unconfirmed service is handled */
+typedef bool (*npdu_filter_unconfirmed_handled_function)(
+    BACNET_UNCONFIRMED_SERVICE service_choice);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -24,6 +53,21 @@ extern "C" {
 BACNET_STACK_EXPORT
 void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len);
 
+BACNET_STACK_EXPORT
+BACNET_NPDU_FILTER_RULE
+npdu_filter_classify(const uint8_t *pdu, uint16_t pdu_len);
+BACNET_STACK_EXPORT
+void npdu_filter_rule_enable(BACNET_NPDU_FILTER_RULE rule, bool enable);
+BACNET_STACK_EXPORT
+bool npdu_filter_rule_enabled(BACNET_NPDU_FILTER_RULE rule);
+BACNET_STACK_EXPORT
+void npdu_filter_unconfirmed_handled_set(
+    npdu_filter_unconfirmed_handled_function pFunction);
+BACNET_STACK_EXPORT
+uint32_t npdu_filter_count(BACNET_NPDU_FILTER_RULE rule);
+BACNET_STACK_EXPORT
+void npdu_filter_count_reset(void);
+
 BACNET_STACK_EXPORT
 uint16_t npdu_network_number(void);
 BACNET_STACK_EXPORT
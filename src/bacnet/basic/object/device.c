@@ -628,6 +628,12 @@ static uint32_t Database_Revision = 0;
 static BACNET_REINITIALIZED_STATE Reinitialize_State = BACNET_REINIT_IDLE;
 static const char *Reinit_Password = "filister";
 static write_property_function Device_Write_Property_Store_Callback;
+static write_property_commit_function Device_Write_Property_Commit_Callback;
+/* WritePropertyMultiple batch, where side effects are deferred */
+static bool Write_Property_Batch;
+static unsigned Write_Property_Batch_Count;
+static unsigned Write_Property_Batch_Stored;
+static bool Database_Revision_Deferred;
 
 #ifdef BAC_ROUTING
 static bool Device_Router_Mode = false;
@@ -939,6 +945,8 @@ uint16_t Device_Vendor_Identifier(void)
 void Device_Set_Vendor_Identifier(uint16_t vendor_id)
 {
     Vendor_Identifier = vendor_id;
+    Device_Property_Cache_Invalidate(
+        OBJECT_DEVICE, Object_Instance_Number, PROP_VENDOR_IDENTIFIER);
 }
 
 const char *Device_Model_Name(void)
@@ -954,6 +962,8 @@ bool Device_Set_Model_Name(const char *name, size_t length)
         memmove(Model_Name, name, length);
         Model_Name[length] = 0;
         status = true;
+        Device_Property_Cache_Invalidate(
+            OBJECT_DEVICE, Object_Instance_Number, PROP_MODEL_NAME);
     }
 
     return status;
@@ -972,6 +982,8 @@ bool Device_Set_Firmware_Revision(const char *name, size_t length)
         memmove(Firmware_Version, name, length);
         Firmware_Version[length] = 0;
         status = true;
+        Device_Property_Cache_Invalidate(
+            OBJECT_DEVICE, Object_Instance_Number, PROP_FIRMWARE_REVISION);
     }
 
     return status;
@@ -990,6 +1002,9 @@ bool Device_Set_Application_Software_Version(const char *name, size_t length)
         memmove(Application_Software_Version, name, length);
         Application_Software_Version[length] = 0;
         status = true;
+        Device_Property_Cache_Invalidate(
+            OBJECT_DEVICE, Object_Instance_Number,
+            PROP_APPLICATION_SOFTWARE_VERSION);
     }
 
     return status;
@@ -1008,6 +1023,8 @@ bool Device_Set_Description(const char *name, size_t length)
         memmove(Description, name, length);
         Description[length] = 0;
         status = true;
+        Device_Property_Cache_Invalidate(
+            OBJECT_DEVICE, Object_Instance_Number, PROP_DESCRIPTION);
     }
 
     return status;
@@ -1113,7 +1130,14 @@ void Device_Set_Database_Revision(uint32_t revision)
  */
 void Device_Inc_Database_Revision(void)
 {
-    Database_Revision++;
+    if (Write_Property_Batch) {
+        /* incremented once at the end of the batch */
+        Database_Revision_Deferred = true;
+    } else {
+        Database_Revision++;
+    }
+    /* object names or identifiers changed */
+    Device_Property_Cache_Clear();
 }
 
 /** Get the total count of objects supported by this Device Object.
@@ -1243,6 +1267,30 @@ bool Device_Valid_Object_Name(
     const BACNET_CHARACTER_STRING *object_name1,
     BACNET_OBJECT_TYPE *object_type,
     uint32_t *object_instance)
+{
+    BACNET_CHARACTER_STRING_VIEW view;
+
+    if (!characterstring_view_from_string(&view, object_name1)) {
+        return false;
+    }
+
+    return Device_Valid_Object_Name_View(&view, object_type, object_instance);
+}
+
+/** Determine if we have an object with the given object_name, given as
+ * a view so that it can be looked up straight from a decoded APDU.
+ * If the object_type and object_instance pointers are not null,
+ * and the lookup succeeds, they will be given the resulting values.
+ * @param object_name [in] The desired Object Name to look for.
+ * @param object_type [out] The BACNET_OBJECT_TYPE of the matching Object.
+ * @param object_instance [out] The object instance number of the matching
+ * Object.
+ * @return True on success or else False if not found.
+ */
+bool Device_Valid_Object_Name_View(
+    const BACNET_CHARACTER_STRING_VIEW *object_name,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance)
 {
     bool found = false;
     BACNET_OBJECT_TYPE type = OBJECT_NONE;
@@ -1259,7 +1307,8 @@ bool Device_Valid_Object_Name(
             pObject = Device_Objects_Find_Functions(type);
             if ((pObject != NULL) && (pObject->Object_Name != NULL) &&
                 (pObject->Object_Name(instance, &object_name2) &&
-                 characterstring_same(object_name1, &object_name2))) {
+                 characterstring_view_string_same(
+                     object_name, &object_name2))) {
                 found = true;
                 if (object_type) {
                     *object_type = type;
@@ -1641,6 +1690,163 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     return apdu_len;
 }
 
+#if BACNET_PROPERTY_CACHE_SIZE
+/* encoded property value of one object, an apdu_len of zero is unused */
+struct property_cache_entry {
+    uint32_t device_instance;
+    uint32_t object_instance;
+    uint32_t object_property;
+    BACNET_ARRAY_INDEX array_index;
+    uint16_t object_type;
+    uint16_t apdu_len;
+    uint8_t apdu[BACNET_PROPERTY_CACHE_DATA_SIZE];
+};
+static struct property_cache_entry Property_Cache[BACNET_PROPERTY_CACHE_SIZE];
+
+/* properties of any object that do not change */
+static const int Property_Cache_List[] = {
+    PROP_OBJECT_IDENTIFIER,
+    PROP_OBJECT_TYPE,
+    PROP_PROPERTY_LIST,
+    -1
+};
+
+/* properties of the Device object that only change through WriteProperty
+   or a Device setter, which forget the cached value. The object-name and
+   description of other objects are not cached, because their *_Set
+   functions do not reach this cache. */
+static const int Property_Cache_Device_List[] = {
+    PROP_OBJECT_NAME,
+    PROP_DESCRIPTION,
+    PROP_VENDOR_NAME,
+    PROP_VENDOR_IDENTIFIER,
+    PROP_MODEL_NAME,
+    PROP_FIRMWARE_REVISION,
+    PROP_APPLICATION_SOFTWARE_VERSION,
+    PROP_PROTOCOL_VERSION,
+    PROP_PROTOCOL_REVISION,
+    PROP_PROTOCOL_SERVICES_SUPPORTED,
+    PROP_PROTOCOL_OBJECT_TYPES_SUPPORTED,
+    -1
+};
+
+/**
+ * @brief Find the cache slot of a property of the current Device
+ * @param rpdata [in] The requested object and property
+ * @return the one slot the property can be kept in
+ */
+static struct property_cache_entry *
+Property_Cache_Slot(const BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    uint32_t hash;
+
+    hash = Device_Object_Instance_Number();
+    hash = (hash * 31U) + rpdata->object_instance;
+    hash = (hash * 31U) + (uint32_t)rpdata->object_type;
+    hash = (hash * 31U) + (uint32_t)rpdata->object_property;
+    hash = (hash * 31U) + (uint32_t)rpdata->array_index;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bU;
+    hash ^= hash >> 16;
+
+    return &Property_Cache[hash % BACNET_PROPERTY_CACHE_SIZE];
+}
+
+/**
+ * @brief Determine if a cache slot holds the requested property
+ * @param entry [in] The cache slot
+ * @param rpdata [in] The requested object and property
+ * @return true if the slot holds the encoded value of the property
+ */
+static bool Property_Cache_Match(
+    const struct property_cache_entry *entry,
+    const BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    return (entry->apdu_len > 0) &&
+        (entry->object_instance == rpdata->object_instance) &&
+        (entry->object_type == (uint16_t)rpdata->object_type) &&
+        (entry->object_property == (uint32_t)rpdata->object_property) &&
+        (entry->array_index == rpdata->array_index) &&
+        (entry->device_instance == Device_Object_Instance_Number());
+}
+#endif
+
+/**
+ * @brief Determine if Device_Read_Property() keeps the encoded value
+ *  of a property for the next read of it
+ * @param object_type [in] The object type
+ * @param object_property [in] The property to check
+ * @return true if the property value is cached
+ */
+bool Device_Property_Cacheable(
+    BACNET_OBJECT_TYPE object_type, BACNET_PROPERTY_ID object_property)
+{
+#if BACNET_PROPERTY_CACHE_SIZE
+    if (property_list_member(Property_Cache_List, object_property)) {
+        return true;
+    }
+    if (object_type == OBJECT_DEVICE) {
+        return property_list_member(
+            Property_Cache_Device_List, object_property);
+    }
+
+    return false;
+#else
+    (void)object_type;
+    (void)object_property;
+    return false;
+#endif
+}
+
+/**
+ * @brief Forget the cached encoded values of an object property.
+ * @note Call this after changing a cached Device property other than
+ *  with WriteProperty or a Device setter.
+ * @param object_type [in] The object type
+ * @param object_instance [in] The object instance
+ * @param object_property [in] The property, or PROP_ALL for every
+ *  property of the object
+ */
+void Device_Property_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+#if BACNET_PROPERTY_CACHE_SIZE
+    struct property_cache_entry *entry;
+    unsigned index;
+
+    for (index = 0; index < BACNET_PROPERTY_CACHE_SIZE; index++) {
+        entry = &Property_Cache[index];
+        if ((entry->apdu_len > 0) &&
+            (entry->object_type == (uint16_t)object_type) &&
+            (entry->object_instance == object_instance) &&
+            ((object_property == PROP_ALL) ||
+             (entry->object_property == (uint32_t)object_property))) {
+            entry->apdu_len = 0;
+        }
+    }
+#else
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+#endif
+}
+
+/**
+ * @brief Forget all the cached encoded property values
+ */
+void Device_Property_Cache_Clear(void)
+{
+#if BACNET_PROPERTY_CACHE_SIZE
+    unsigned index;
+
+    for (index = 0; index < BACNET_PROPERTY_CACHE_SIZE; index++) {
+        Property_Cache[index].apdu_len = 0;
+    }
+#endif
+}
+
 /** Looks up the common Object and Property, and encodes its Value in an
  * APDU. Sets the error class and code if request is not appropriate.
  * @param pObject - object table
@@ -1657,12 +1863,26 @@ static int Read_Property_Common(
 #if (BACNET_PROTOCOL_REVISION >= 14)
     struct special_property_list_t property_list;
 #endif
+#if BACNET_PROPERTY_CACHE_SIZE
+    struct property_cache_entry *entry = NULL;
+#endif
 
     if ((rpdata->application_data == NULL) ||
         (rpdata->application_data_len == 0)) {
         return 0;
     }
     apdu = rpdata->application_data;
+#if BACNET_PROPERTY_CACHE_SIZE
+    if (Device_Property_Cacheable(
+            rpdata->object_type, rpdata->object_property)) {
+        entry = Property_Cache_Slot(rpdata);
+        if (Property_Cache_Match(entry, rpdata) &&
+            (entry->apdu_len <= rpdata->application_data_len)) {
+            memcpy(apdu, entry->apdu, entry->apdu_len);
+            return entry->apdu_len;
+        }
+    }
+#endif
     if (property_list_common(rpdata->object_property)) {
         apdu_len = property_list_common_encode(rpdata, Object_Instance_Number);
     } else if (rpdata->object_property == PROP_OBJECT_NAME) {
@@ -1682,6 +1902,18 @@ static int Read_Property_Common(
     } else if (pObject->Object_Read_Property) {
         apdu_len = pObject->Object_Read_Property(rpdata);
     }
+#if BACNET_PROPERTY_CACHE_SIZE
+    if (entry && (apdu_len > 0) &&
+        (apdu_len <= BACNET_PROPERTY_CACHE_DATA_SIZE)) {
+        memcpy(entry->apdu, apdu, (size_t)apdu_len);
+        entry->apdu_len = (uint16_t)apdu_len;
+        entry->device_instance = Device_Object_Instance_Number();
+        entry->object_instance = rpdata->object_instance;
+        entry->object_type = (uint16_t)rpdata->object_type;
+        entry->object_property = (uint32_t)rpdata->object_property;
+        entry->array_index = rpdata->array_index;
+    }
+#endif
 
     return apdu_len;
 }
@@ -1971,7 +2203,7 @@ static bool Device_Write_Property_Object_Name(
 {
     bool status = false; /* return value */
     int len = 0;
-    BACNET_CHARACTER_STRING value;
+    BACNET_CHARACTER_STRING_VIEW value = { 0 };
     BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
     uint32_t object_instance = 0;
     int apdu_size = 0;
@@ -1982,11 +2214,13 @@ static bool Device_Write_Property_Object_Name(
     }
     apdu = wp_data->application_data;
     apdu_size = wp_data->application_data_len;
-    len = bacnet_character_string_application_decode(apdu, apdu_size, &value);
+    /* the name is checked where it is in the request, without a copy */
+    len = bacnet_character_string_view_application_decode(
+        apdu, apdu_size, &value);
     if (len > 0) {
-        if ((characterstring_encoding(&value) != CHARACTER_ANSI_X34) ||
-            (characterstring_length(&value) == 0) ||
-            (!characterstring_printable(&value))) {
+        if ((value.encoding != CHARACTER_ANSI_X34) || (value.length == 0) ||
+            (value.length >= MAX_CHARACTER_STRING_BYTES) ||
+            (!characterstring_view_printable(&value))) {
             wp_data->error_class = ERROR_CLASS_PROPERTY;
             wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
         } else {
@@ -2001,7 +2235,8 @@ static bool Device_Write_Property_Object_Name(
     }
     if (status) {
         /* All the object names in a device must be unique */
-        if (Device_Valid_Object_Name(&value, &object_type, &object_instance)) {
+        if (Device_Valid_Object_Name_View(
+                &value, &object_type, &object_instance)) {
             if ((object_type == wp_data->object_type) &&
                 (object_instance == wp_data->object_instance)) {
                 /* writing same name to same object - but is it writable? */
@@ -2039,6 +2274,82 @@ static void Device_Write_Property_Store(BACNET_WRITE_PROPERTY_DATA *wp_data)
     }
 }
 
+/**
+ * @brief Set the callback for the end of a set of stored WriteProperty
+ *  values, e.g. to write the stored values to non-volatile memory once.
+ * @param cb [in] The function to be called, or NULL to disable
+ */
+void Device_Write_Property_Commit_Callback_Set(
+    write_property_commit_function cb)
+{
+    Device_Write_Property_Commit_Callback = cb;
+}
+
+/**
+ * @brief Commit the values stored since the last commit
+ * @param count [in] number of values stored
+ */
+static void Device_Write_Property_Commit(unsigned count)
+{
+    if (Device_Write_Property_Commit_Callback && (count > 0)) {
+        Device_Write_Property_Commit_Callback(count);
+    }
+}
+
+/**
+ * @brief Begin a batch of WriteProperty operations, such as the writes
+ *  of one WritePropertyMultiple request. Until the batch ends, successful
+ *  writes are counted but not stored, and the database revision is not
+ *  incremented.
+ */
+void Device_Write_Property_Batch_Begin(void)
+{
+    Write_Property_Batch = true;
+    Write_Property_Batch_Count = 0;
+    Write_Property_Batch_Stored = 0;
+    Database_Revision_Deferred = false;
+}
+
+/**
+ * @brief Store the value of a property written during the batch.
+ *  Called once for each successful write, in the same order, after
+ *  the write was applied.
+ * @param wp_data [in] Structure with the written Object and Property info
+ *  and Value
+ * @return true always, so that it can be used as a write_property_function
+ */
+bool Device_Write_Property_Batch_Store(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    if (Write_Property_Batch &&
+        (Write_Property_Batch_Stored < Write_Property_Batch_Count)) {
+        Write_Property_Batch_Stored++;
+        Device_Write_Property_Store(wp_data);
+    }
+
+    return true;
+}
+
+/**
+ * @brief End a batch of WriteProperty operations, incrementing the
+ *  database revision and committing the stored values once.
+ * @return number of successful writes during the batch
+ */
+unsigned Device_Write_Property_Batch_End(void)
+{
+    unsigned count = Write_Property_Batch_Count;
+
+    Write_Property_Batch = false;
+    if (Database_Revision_Deferred) {
+        Database_Revision_Deferred = false;
+        Device_Inc_Database_Revision();
+    }
+    Device_Write_Property_Commit(Write_Property_Batch_Stored);
+    Write_Property_Batch_Count = 0;
+    Write_Property_Batch_Stored = 0;
+
+    return count;
+}
+
 /** Looks up the requested Object and Property, and set the new Value in it,
  *  if allowed.
  * If the Object or Property can't be found, sets the error class and code.
@@ -2075,7 +2386,15 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     status = pObject->Object_Write_Property(wp_data);
                 }
                 if (status) {
-                    Device_Write_Property_Store(wp_data);
+                    Device_Property_Cache_Invalidate(
+                        wp_data->object_type, wp_data->object_instance,
+                        PROP_ALL);
+                    if (Write_Property_Batch) {
+                        Write_Property_Batch_Count++;
+                    } else {
+                        Device_Write_Property_Store(wp_data);
+                        Device_Write_Property_Commit(1);
+                    }
                 }
             } else {
                 if (Device_Objects_Property_List_Member(
@@ -2425,6 +2744,7 @@ void Device_Init(object_functions_t *object_table)
 #if (BACNET_PROTOCOL_REVISION >= 14)
     Channel_Write_Property_Internal_Callback_Set(Device_Write_Property);
 #endif
+    Device_Property_Cache_Clear();
 }
 
 bool DeviceGetRRInfo(
@@ -2514,6 +2834,22 @@ void Device_Timer(uint16_t milliseconds)
  * that need access to local data in this file.
  ****************************************************************************/
 
+/* object table of the gateway, shared by routed Devices without their own */
+static object_functions_t *Routing_Object_Table;
+
+/** Use the object table of a routed Device for the following requests.
+ * @param object_table The object table of the Device, or NULL for the
+ *  object table of the gateway.
+ */
+static void Routing_Device_Object_Table_Select(object_functions_t *object_table)
+{
+    if (object_table) {
+        Object_Table = object_table;
+    } else if (Routing_Object_Table) {
+        Object_Table = Routing_Object_Table;
+    }
+}
+
 /** Initialize the first of our array of Devices with the main Device's
  * information, and then swap out some of the Device object functions and
  * replace with ones appropriate for routing.
@@ -2523,20 +2859,16 @@ void Device_Timer(uint16_t milliseconds)
  */
 void Routing_Device_Init(uint32_t first_object_instance)
 {
-    struct object_functions *pDevObject = NULL;
     Device_Router_Mode = true;
+    Routing_Object_Table = Object_Table;
+    Routed_Device_Object_Table_Callback_Set(
+        Routing_Device_Object_Table_Select);
 
     /* Initialize with our preset strings */
     Add_Routed_Device(first_object_instance, &My_Object_Name, Description);
 
     /* Now substitute our routed versions of the main object functions. */
-    pDevObject = Object_Table;
-    pDevObject->Object_Index_To_Instance = Routed_Device_Index_To_Instance;
-    pDevObject->Object_Valid_Instance =
-        Routed_Device_Valid_Object_Instance_Number;
-    pDevObject->Object_Name = Routed_Device_Name;
-    pDevObject->Object_Read_Property = Routed_Device_Read_Property_Local;
-    pDevObject->Object_Write_Property = Routed_Device_Write_Property_Local;
+    Routed_Device_Object_Table_Init(Object_Table);
 }
 
 #endif /* BAC_ROUTING */
@@ -110,6 +110,13 @@ typedef void (*object_intrinsic_reporting_function)(uint32_t object_instance);
 typedef void (*object_timer_function)(
     uint32_t object_instance, uint16_t milliseconds);
 
+/**
+ * @brief Called once after a set of successful WriteProperty values
+ *  were stored, e.g. to write them to non-volatile memory at once.
+ * @param count - number of values stored since the last commit
+ */
+typedef void (*write_property_commit_function)(unsigned count);
+
 /** Defines the group of object helper functions for any supported Object.
  * @ingroup ObjHelpers
  * Each Object must provide some implementation of each of these helpers
@@ -142,6 +149,10 @@ typedef struct object_functions {
     object_timer_function Object_Timer;
 } object_functions_t;
 
+/* selects the object table used for the current routed Device */
+typedef void (*routed_device_object_table_function)(
+    object_functions_t *object_table);
+
 /* String Lengths - excluding any nul terminator */
 #define MAX_DEV_NAME_LEN 32
 #define MAX_DEV_LOC_LEN 64
@@ -149,6 +160,17 @@ typedef struct object_functions {
 #define MAX_DEV_VER_LEN 16
 #define MAX_DEV_DESC_LEN 64
 
+/* number of encoded property values kept by Device_Read_Property() for
+   properties that rarely change, such as the Device object-name.
+   0 disables it. */
+#ifndef BACNET_PROPERTY_CACHE_SIZE
+#define BACNET_PROPERTY_CACHE_SIZE 0
+#endif
+/* largest encoded property value kept in the cache */
+#ifndef BACNET_PROPERTY_CACHE_DATA_SIZE
+#define BACNET_PROPERTY_CACHE_DATA_SIZE 128
+#endif
+
 /** Structure to define the Object Properties common to all Objects. */
 typedef struct commonBacObj_s {
     /** The BACnet type of this object (ie, what class is this object from?).
@@ -375,12 +397,28 @@ void Device_Set_Database_Revision(uint32_t revision);
 BACNET_STACK_EXPORT
 void Device_Inc_Database_Revision(void);
 
+BACNET_STACK_EXPORT
+void Device_Property_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property);
+BACNET_STACK_EXPORT
+void Device_Property_Cache_Clear(void);
+BACNET_STACK_EXPORT
+bool Device_Property_Cacheable(
+    BACNET_OBJECT_TYPE object_type, BACNET_PROPERTY_ID object_property);
+
 BACNET_STACK_EXPORT
 bool Device_Valid_Object_Name(
     const BACNET_CHARACTER_STRING *object_name,
     BACNET_OBJECT_TYPE *object_type,
     uint32_t *object_instance);
 BACNET_STACK_EXPORT
+bool Device_Valid_Object_Name_View(
+    const BACNET_CHARACTER_STRING_VIEW *object_name,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance);
+BACNET_STACK_EXPORT
 bool Device_Valid_Object_Id(
     BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
 
@@ -406,6 +444,15 @@ BACNET_STACK_EXPORT
 bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
 BACNET_STACK_EXPORT
 void Device_Write_Property_Store_Callback_Set(write_property_function cb);
+BACNET_STACK_EXPORT
+void Device_Write_Property_Commit_Callback_Set(
+    write_property_commit_function cb);
+BACNET_STACK_EXPORT
+void Device_Write_Property_Batch_Begin(void);
+BACNET_STACK_EXPORT
+bool Device_Write_Property_Batch_Store(BACNET_WRITE_PROPERTY_DATA *wp_data);
+BACNET_STACK_EXPORT
+unsigned Device_Write_Property_Batch_End(void);
 
 #if defined(INTRINSIC_REPORTING)
 BACNET_STACK_EXPORT
@@ -428,6 +475,19 @@ BACNET_STACK_EXPORT
 DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx);
 BACNET_STACK_EXPORT
 BACNET_ADDRESS *Get_Routed_Device_Address(int idx);
+BACNET_STACK_EXPORT
+bool Routed_Device_Address_Set(int idx, const BACNET_ADDRESS *address);
+BACNET_STACK_EXPORT
+bool Routed_Device_Object_Table_Set(int idx, object_functions_t *object_table);
+BACNET_STACK_EXPORT
+void Routed_Device_Object_Table_Init(object_functions_t *object_table);
+BACNET_STACK_EXPORT
+void Routed_Device_Object_Table_Callback_Set(
+    routed_device_object_table_function callback);
+BACNET_STACK_EXPORT
+uint16_t Routed_Device_Count(void);
+BACNET_STACK_EXPORT
+void Routed_Device_Cleanup(void);
 
 BACNET_STACK_EXPORT
 bool Routed_Device_Address_Lookup(
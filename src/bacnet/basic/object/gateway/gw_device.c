@@ -9,6 +9,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -63,10 +64,47 @@ bool Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
  * and extending the regular Device Object functionality.
  ****************************************************************************/
 
-/** Model the gateway as the main Device, with (two) remote
- * Devices that are reached via its routing capabilities.
+/** Number of Devices allocated together in one block of the table. Blocks
+ * are allocated as Devices are added, and are never moved, so pointers to
+ * a Device stay valid while the table grows.
  */
-DEVICE_OBJECT_DATA Devices[MAX_NUM_DEVICES];
+#ifndef ROUTED_DEVICE_BLOCK_SIZE
+#define ROUTED_DEVICE_BLOCK_SIZE 64
+#endif
+#define ROUTED_DEVICE_BLOCKS            \
+    ((MAX_NUM_DEVICES + ROUTED_DEVICE_BLOCK_SIZE - 1) / \
+     ROUTED_DEVICE_BLOCK_SIZE)
+/** Number of buckets in the instance and MAC address indexes.
+ * Must be a power of two.
+ */
+#ifndef ROUTED_DEVICE_HASH_SIZE
+#define ROUTED_DEVICE_HASH_SIZE 256
+#endif
+#if (ROUTED_DEVICE_HASH_SIZE & (ROUTED_DEVICE_HASH_SIZE - 1)) != 0
+#error ROUTED_DEVICE_HASH_SIZE must be a power of two
+#endif
+/* end of a hash chain */
+#define ROUTED_DEVICE_NONE UINT16_MAX
+
+struct routed_device {
+    DEVICE_OBJECT_DATA data;
+    /* object table of this Device, or NULL to use the gateway table */
+    object_functions_t *object_table;
+    /* next Device in the same instance and address hash buckets */
+    uint16_t instance_next;
+    uint16_t address_next;
+};
+
+/** Model the gateway as the main Device, with remote Devices
+ * that are reached via its routing capabilities.
+ */
+static struct routed_device *Devices[ROUTED_DEVICE_BLOCKS];
+static uint16_t Instance_Hash[ROUTED_DEVICE_HASH_SIZE];
+static uint16_t Address_Hash[ROUTED_DEVICE_HASH_SIZE];
+/* handed out when there is no Device yet */
+static DEVICE_OBJECT_DATA Device_None;
+/* switches the Device object to the object table of the current Device */
+static routed_device_object_table_function Object_Table_Select;
 /** Keep track of the number of managed devices, including the gateway */
 uint16_t Num_Managed_Devices = 0;
 /** Which Device entry are we currently managing.
@@ -80,6 +118,203 @@ uint16_t iCurrent_Device_Idx = 0;
  * found in device.c
  */
 
+/**
+ * @brief Get the table entry of a Device
+ * @param idx - index of a Device that was added
+ * @return the table entry
+ */
+static struct routed_device *routed_device(uint16_t idx)
+{
+    return &Devices[idx / ROUTED_DEVICE_BLOCK_SIZE]
+                   [idx % ROUTED_DEVICE_BLOCK_SIZE];
+}
+
+/**
+ * @brief Get the Device Object data of a Device
+ * @param idx - index of a Device
+ * @return the Device Object data, or an empty placeholder if the
+ *  Device was not added
+ */
+static DEVICE_OBJECT_DATA *routed_device_data(uint16_t idx)
+{
+    if (idx < Num_Managed_Devices) {
+        return &routed_device(idx)->data;
+    }
+
+    return &Device_None;
+}
+
+/**
+ * @brief Make a Device the current Device, and use its object table
+ * @param idx - index of a Device that was added
+ */
+static void routed_device_select(uint16_t idx)
+{
+    iCurrent_Device_Idx = idx;
+    if (Object_Table_Select) {
+        Object_Table_Select(routed_device(idx)->object_table);
+    }
+}
+
+static unsigned routed_device_instance_hash(uint32_t instance)
+{
+    return (instance ^ (instance >> 8) ^ (instance >> 16)) &
+        (ROUTED_DEVICE_HASH_SIZE - 1);
+}
+
+static unsigned routed_device_address_hash(uint8_t len, const uint8_t *adr)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= adr[i];
+        hash *= 16777619UL;
+    }
+
+    return hash & (ROUTED_DEVICE_HASH_SIZE - 1);
+}
+
+static void routed_device_instance_link(uint16_t idx)
+{
+    struct routed_device *device = routed_device(idx);
+    unsigned hash =
+        routed_device_instance_hash(device->data.bacObj.Object_Instance_Number);
+
+    device->instance_next = Instance_Hash[hash];
+    Instance_Hash[hash] = idx;
+}
+
+static void routed_device_address_link(uint16_t idx)
+{
+    struct routed_device *device = routed_device(idx);
+    unsigned hash = routed_device_address_hash(
+        device->data.bacDevAddr.len, device->data.bacDevAddr.adr);
+
+    device->address_next = Address_Hash[hash];
+    Address_Hash[hash] = idx;
+}
+
+/**
+ * @brief Rebuild both indexes from the table. Used when a Device to be
+ *  changed is not where the index expects it, because its instance or
+ *  address was written through a pointer from Get_Routed_Device_Object()
+ *  or Get_Routed_Device_Address() instead of through the setters.
+ */
+static void routed_device_index_rebuild(void)
+{
+    uint16_t idx;
+
+    for (idx = 0; idx < ROUTED_DEVICE_HASH_SIZE; idx++) {
+        Instance_Hash[idx] = ROUTED_DEVICE_NONE;
+        Address_Hash[idx] = ROUTED_DEVICE_NONE;
+    }
+    for (idx = 0; idx < Num_Managed_Devices; idx++) {
+        routed_device_instance_link(idx);
+        routed_device_address_link(idx);
+    }
+}
+
+/**
+ * @brief Remove a Device from the instance index before its instance
+ *  changes. The index is rebuilt if the Device is not in the bucket of
+ *  its current instance.
+ * @param idx - index of a Device that was added
+ * @return true if the Device was unlinked and needs to be linked again
+ */
+static bool routed_device_instance_unlink(uint16_t idx)
+{
+    struct routed_device *device = routed_device(idx);
+    uint16_t *link = &Instance_Hash[routed_device_instance_hash(
+        device->data.bacObj.Object_Instance_Number)];
+
+    while (*link != ROUTED_DEVICE_NONE) {
+        if (*link == idx) {
+            *link = device->instance_next;
+            return true;
+        }
+        link = &routed_device(*link)->instance_next;
+    }
+    routed_device_index_rebuild();
+
+    return false;
+}
+
+/**
+ * @brief Remove a Device from the address index before its address
+ *  changes. The index is rebuilt if the Device is not in the bucket of
+ *  its current address.
+ * @param idx - index of a Device that was added
+ * @return true if the Device was unlinked and needs to be linked again
+ */
+static bool routed_device_address_unlink(uint16_t idx)
+{
+    struct routed_device *device = routed_device(idx);
+    uint16_t *link = &Address_Hash[routed_device_address_hash(
+        device->data.bacDevAddr.len, device->data.bacDevAddr.adr)];
+
+    while (*link != ROUTED_DEVICE_NONE) {
+        if (*link == idx) {
+            *link = device->address_next;
+            return true;
+        }
+        link = &routed_device(*link)->address_next;
+    }
+    routed_device_index_rebuild();
+
+    return false;
+}
+
+/**
+ * @brief Find a Device by its Object Instance number. The index is kept
+ *  by Add_Routed_Device() and Routed_Device_Set_Object_Instance_Number(),
+ *  so a miss is answered without looking at every Device.
+ * @param instance - Device Object Instance number
+ * @return index of the Device, or ROUTED_DEVICE_NONE if not found
+ */
+static uint16_t routed_device_instance_find(uint32_t instance)
+{
+    uint16_t idx;
+
+    idx = Instance_Hash[routed_device_instance_hash(instance)];
+    while (idx != ROUTED_DEVICE_NONE) {
+        if (routed_device(idx)->data.bacObj.Object_Instance_Number ==
+            instance) {
+            return idx;
+        }
+        idx = routed_device(idx)->instance_next;
+    }
+
+    return ROUTED_DEVICE_NONE;
+}
+
+/**
+ * @brief Find a routed Device by its MAC address on the virtual network.
+ *  The gateway Device at index 0 is never returned. The index is kept by
+ *  Add_Routed_Device() and Routed_Device_Address_Set().
+ * @param len - length of the MAC address
+ * @param adr - MAC address
+ * @return index of the Device, or ROUTED_DEVICE_NONE if not found
+ */
+static uint16_t routed_device_address_find(uint8_t len, const uint8_t *adr)
+{
+    const BACNET_ADDRESS *address;
+    uint16_t idx;
+
+    idx = Address_Hash[routed_device_address_hash(len, adr)];
+    while (idx != ROUTED_DEVICE_NONE) {
+        address = &routed_device(idx)->data.bacDevAddr;
+        if ((idx > 0) && (address->len == len) &&
+            (memcmp(address->adr, adr, len) == 0)) {
+            return idx;
+        }
+        idx = routed_device(idx)->address_next;
+    }
+
+    return ROUTED_DEVICE_NONE;
+}
+
 /** Add a Device to our table of Devices[].
  * The first entry must be the gateway device.
  * @param Object_Instance [in] Set the new Device to this instance number.
@@ -94,30 +329,70 @@ uint16_t Add_Routed_Device(
     const char *sDescription)
 {
     int i = Num_Managed_Devices;
-    if (i < MAX_NUM_DEVICES) {
-        DEVICE_OBJECT_DATA *pDev = &Devices[i];
-        Num_Managed_Devices++;
-        iCurrent_Device_Idx = i;
-        pDev->bacObj.mObject_Type = OBJECT_DEVICE;
-        pDev->bacObj.Object_Instance_Number = Object_Instance;
-        if (sObject_Name != NULL) {
-            Routed_Device_Set_Object_Name(
-                sObject_Name->encoding, sObject_Name->value,
-                sObject_Name->length);
-        } else {
-            Routed_Device_Set_Object_Name(
-                CHARACTER_UTF8, "No Name", strlen("No Name"));
-        }
-        if (sDescription != NULL) {
-            Routed_Device_Set_Description(sDescription, strlen(sDescription));
-        } else {
-            Routed_Device_Set_Description("No Descr", strlen("No Descr"));
+    unsigned block = i / ROUTED_DEVICE_BLOCK_SIZE;
+    DEVICE_OBJECT_DATA *pDev;
+
+    if (i >= MAX_NUM_DEVICES) {
+        return UINT16_MAX;
+    }
+    if (!Devices[block]) {
+        Devices[block] =
+            calloc(ROUTED_DEVICE_BLOCK_SIZE, sizeof(struct routed_device));
+        if (!Devices[block]) {
+            return UINT16_MAX;
         }
-        pDev->Database_Revision = 0; /* Reset/Initialize now */
-        return i;
+    }
+    if (i == 0) {
+        routed_device_index_rebuild();
+    }
+    memset(routed_device(i), 0, sizeof(struct routed_device));
+    pDev = &routed_device(i)->data;
+    Num_Managed_Devices++;
+    routed_device_select(i);
+    pDev->bacObj.mObject_Type = OBJECT_DEVICE;
+    pDev->bacObj.Object_Instance_Number = Object_Instance;
+    routed_device_instance_link(i);
+    routed_device_address_link(i);
+    if (sObject_Name != NULL) {
+        Routed_Device_Set_Object_Name(
+            sObject_Name->encoding, sObject_Name->value, sObject_Name->length);
     } else {
-        return UINT16_MAX;
+        Routed_Device_Set_Object_Name(
+            CHARACTER_UTF8, "No Name", strlen("No Name"));
     }
+    if (sDescription != NULL) {
+        Routed_Device_Set_Description(sDescription, strlen(sDescription));
+    } else {
+        Routed_Device_Set_Description("No Descr", strlen("No Descr"));
+    }
+    pDev->Database_Revision = 0; /* Reset/Initialize now */
+
+    return i;
+}
+
+/** Return the number of Devices in the table, including the gateway.
+ * @return number of Devices
+ */
+uint16_t Routed_Device_Count(void)
+{
+    return Num_Managed_Devices;
+}
+
+/** Remove all Devices from the table and release its memory.
+ */
+void Routed_Device_Cleanup(void)
+{
+    unsigned block;
+
+    if (Object_Table_Select) {
+        Object_Table_Select(NULL);
+    }
+    for (block = 0; block < ROUTED_DEVICE_BLOCKS; block++) {
+        free(Devices[block]);
+        Devices[block] = NULL;
+    }
+    Num_Managed_Devices = 0;
+    iCurrent_Device_Idx = 0;
 }
 
 /** Return the Device Object descriptive data for the indicated entry.
@@ -128,15 +403,17 @@ uint16_t Add_Routed_Device(
  *                 If valid idx, will set iCurrent_Device_Idx with the idx
  * @return Pointer to the requested Device Object data, or NULL if the idx
  *         is for an invalid row entry (eg, after the last good Device).
+ * @note Change the instance with Routed_Device_Set_Object_Instance_Number()
+ *       and the address with Routed_Device_Address_Set(), not through this
+ *       pointer, or the Device is not found by its new instance or address.
  */
 DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
 {
     if (idx == -1) {
-        return &Devices[iCurrent_Device_Idx];
-    } else if (
-        (idx >= 0) && (idx < min(MAX_NUM_DEVICES, Num_Managed_Devices))) {
-        iCurrent_Device_Idx = idx;
-        return &Devices[idx];
+        return routed_device_data(iCurrent_Device_Idx);
+    } else if ((idx >= 0) && (idx < Num_Managed_Devices)) {
+        routed_device_select(idx);
+        return &routed_device(idx)->data;
     } else {
         return NULL;
     }
@@ -150,20 +427,103 @@ DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
  *                 If valid idx, will set iCurrent_Device_Idx with the idx
  * @return Pointer to the requested Device Object BACnet address, or NULL if the
  * idx is for an invalid row entry (eg, after the last good Device).
+ * @note Change the address with Routed_Device_Address_Set(), not through
+ *       this pointer, or the Device is not found by its new address.
  */
 BACNET_ADDRESS *Get_Routed_Device_Address(int idx)
 {
     if (idx == -1) {
-        return &Devices[iCurrent_Device_Idx].bacDevAddr;
-    } else if (
-        (idx >= 0) && (idx < min(MAX_NUM_DEVICES, Num_Managed_Devices))) {
-        iCurrent_Device_Idx = idx;
-        return &Devices[idx].bacDevAddr;
+        return &routed_device_data(iCurrent_Device_Idx)->bacDevAddr;
+    } else if ((idx >= 0) && (idx < Num_Managed_Devices)) {
+        routed_device_select(idx);
+        return &routed_device(idx)->data.bacDevAddr;
     } else {
         return NULL;
     }
 }
 
+/** Set the BACnet address of the indicated entry, and index it so that
+ * messages to its MAC address on the virtual network find it directly.
+ * @param idx [in] Index into Devices[] array being changed.
+ * @param address [in] The BACnet address of the Device.
+ * @return True if the address was set, else False for an invalid idx.
+ */
+bool Routed_Device_Address_Set(int idx, const BACNET_ADDRESS *address)
+{
+    bool linked;
+
+    if ((idx < 0) || (idx >= Num_Managed_Devices) || (!address)) {
+        return false;
+    }
+    linked = routed_device_address_unlink(idx);
+    bacnet_address_copy(&routed_device(idx)->data.bacDevAddr, address);
+    if (linked) {
+        routed_device_address_link(idx);
+    } else {
+        routed_device_index_rebuild();
+    }
+
+    return true;
+}
+
+/** Give the indicated entry its own table of objects. The first object in
+ * the table must be its Device object, which is set up here to use the
+ * routed Device functions. Requests addressed to the Device use this
+ * table instead of the one of the gateway.
+ * @param idx [in] Index into Devices[] array being changed.
+ * @param object_table [in] The object table of the Device, or NULL to use
+ *                          the object table of the gateway.
+ * @return True if the table was set, else False for an invalid idx or table.
+ */
+bool Routed_Device_Object_Table_Set(int idx, object_functions_t *object_table)
+{
+    if ((idx < 0) || (idx >= Num_Managed_Devices)) {
+        return false;
+    }
+    if (object_table) {
+        if (object_table->Object_Type != OBJECT_DEVICE) {
+            return false;
+        }
+        Routed_Device_Object_Table_Init(object_table);
+    }
+    routed_device(idx)->object_table = object_table;
+    if (idx == iCurrent_Device_Idx) {
+        routed_device_select(idx);
+    }
+
+    return true;
+}
+
+/** Substitute the routed versions of the Device object functions in
+ * the first entry of an object table, which must be the Device object.
+ * @param object_table [in] The object table of the gateway or of a
+ *                          routed Device.
+ */
+void Routed_Device_Object_Table_Init(object_functions_t *object_table)
+{
+    struct object_functions *pDevObject = object_table;
+
+    if (!pDevObject) {
+        return;
+    }
+    pDevObject->Object_Index_To_Instance = Routed_Device_Index_To_Instance;
+    pDevObject->Object_Valid_Instance =
+        Routed_Device_Valid_Object_Instance_Number;
+    pDevObject->Object_Name = Routed_Device_Name;
+    pDevObject->Object_Read_Property = Routed_Device_Read_Property_Local;
+    pDevObject->Object_Write_Property = Routed_Device_Write_Property_Local;
+}
+
+/** Set the function that switches the Device object to the object table
+ * of the current Device. The Device object sets it in Routing_Device_Init().
+ * @param callback [in] The function, or NULL to always use one table.
+ */
+void Routed_Device_Object_Table_Callback_Set(
+    routed_device_object_table_function callback)
+{
+    Object_Table_Select = callback;
+}
+
 /** Get the currently active BACnet address.
  * This is an implementation of the datalink_get_my_address() template for
  * devices with routing.
@@ -175,7 +535,7 @@ void routed_get_my_address(BACNET_ADDRESS *my_address)
 {
     if (my_address) {
         memcpy(
-            my_address, &Devices[iCurrent_Device_Idx].bacDevAddr,
+            my_address, &routed_device_data(iCurrent_Device_Idx)->bacDevAddr,
             sizeof(BACNET_ADDRESS));
     }
 }
@@ -203,11 +563,11 @@ bool Routed_Device_Address_Lookup(int idx, uint8_t dlen, const uint8_t *dadr)
     DEVICE_OBJECT_DATA *pDev;
     int i;
 
-    if ((idx >= 0) && (idx < min(MAX_NUM_DEVICES, Num_Managed_Devices))) {
-        pDev = &Devices[idx];
+    if ((idx >= 0) && (idx < Num_Managed_Devices)) {
+        pDev = &routed_device(idx)->data;
         if (dlen == 0) {
             /* Automatic match */
-            iCurrent_Device_Idx = idx;
+            routed_device_select(idx);
             result = true;
         } else if (dadr != NULL) {
             for (i = 0; i < dlen; i++) {
@@ -216,7 +576,7 @@ bool Routed_Device_Address_Lookup(int idx, uint8_t dlen, const uint8_t *dadr)
                 }
             }
             if (i == dlen) { /* Success! */
-                iCurrent_Device_Idx = idx;
+                routed_device_select(idx);
                 result = true;
             }
         }
@@ -255,9 +615,10 @@ bool Routed_Device_GetNext(
 {
     int dnet = DNET_list[0]; /* Get the DNET of our virtual network */
     int idx = *cursor;
+    uint16_t found;
     bool bSuccess = false;
 
-    if ((idx < 0) || (idx >= min(MAX_NUM_DEVICES, Num_Managed_Devices))) {
+    if ((idx < 0) || (idx >= Num_Managed_Devices)) {
         /* The next index will be out of range.
            Eg, last call to GetNext may have been the last successful one.*/
         idx = -1;
@@ -283,18 +644,28 @@ bool Routed_Device_GetNext(
             /* Step over this case (starting point) */
             idx = 1;
         }
-        while (idx < min(MAX_NUM_DEVICES, Num_Managed_Devices)) {
-            bSuccess =
-                Routed_Device_Address_Lookup(idx++, dest->len, dest->adr);
-            if (bSuccess) {
-                /* We don't need to keep looking */
-                break;
+        if (dest->len > 0) {
+            /* a MAC address belongs to one Device, look it up directly */
+            found = routed_device_address_find(dest->len, dest->adr);
+            if ((found != ROUTED_DEVICE_NONE) && (found >= idx)) {
+                routed_device_select(found);
+                bSuccess = true;
+            }
+            idx = -1;
+        } else {
+            while (idx < Num_Managed_Devices) {
+                bSuccess =
+                    Routed_Device_Address_Lookup(idx++, dest->len, dest->adr);
+                if (bSuccess) {
+                    /* We don't need to keep looking */
+                    break;
+                }
             }
         }
     }
     if (!bSuccess) {
         *cursor = -1;
-    } else if (idx == min(MAX_NUM_DEVICES, Num_Managed_Devices)) {
+    } else if ((idx < 0) || (idx == Num_Managed_Devices)) {
         /* No more to GetNext */
         *cursor = -1;
     } else {
@@ -341,7 +712,8 @@ bool Routed_Device_Is_Valid_Network(uint16_t dest_net, const int *DNET_list)
 uint32_t Routed_Device_Index_To_Instance(unsigned index)
 {
     (void)index;
-    return Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number;
+    return routed_device_data(iCurrent_Device_Idx)
+        ->bacObj.Object_Instance_Number;
 }
 
 /**
@@ -353,13 +725,11 @@ uint32_t Routed_Device_Index_To_Instance(unsigned index)
  */
 static uint32_t Routed_Device_Instance_To_Index(uint32_t Instance_Number)
 {
-    int i;
+    uint16_t idx = routed_device_instance_find(Instance_Number);
 
-    for (i = 0; i < min(MAX_NUM_DEVICES, Num_Managed_Devices); i++) {
-        if (Devices[i].bacObj.Object_Instance_Number == Instance_Number) {
-            /* Found Instance, so return the Device Index Number */
-            return i;
-        }
+    if (idx != ROUTED_DEVICE_NONE) {
+        /* Found Instance, so return the Device Index Number */
+        return idx;
     }
 
     /* We did not find instance... so simply return an Index of 0
@@ -378,8 +748,11 @@ bool Routed_Device_Valid_Object_Instance_Number(uint32_t object_id)
     bool valid = false;
     DEVICE_OBJECT_DATA *pDev = NULL;
 
-    iCurrent_Device_Idx = Routed_Device_Instance_To_Index(object_id);
-    pDev = &Devices[iCurrent_Device_Idx];
+    if (Num_Managed_Devices == 0) {
+        return false;
+    }
+    routed_device_select(Routed_Device_Instance_To_Index(object_id));
+    pDev = &routed_device(iCurrent_Device_Idx)->data;
     if (pDev->bacObj.Object_Instance_Number == object_id) {
         valid = true;
     }
@@ -390,7 +763,7 @@ bool Routed_Device_Valid_Object_Instance_Number(uint32_t object_id)
 bool Routed_Device_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = routed_device_data(iCurrent_Device_Idx);
     if (object_instance == pDev->bacObj.Object_Instance_Number) {
         return characterstring_init_ansi(object_name, pDev->bacObj.Object_Name);
     }
@@ -409,7 +782,7 @@ int Routed_Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_len = 0; /* return value */
     BACNET_CHARACTER_STRING char_string;
     uint8_t *apdu = NULL;
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = routed_device_data(iCurrent_Device_Idx);
 
     if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
         (rpdata->application_data_len == 0)) {
@@ -503,16 +876,30 @@ bool Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
  */
 uint32_t Routed_Device_Object_Instance_Number(void)
 {
-    return Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number;
+    return routed_device_data(iCurrent_Device_Idx)
+        ->bacObj.Object_Instance_Number;
 }
 
 bool Routed_Device_Set_Object_Instance_Number(uint32_t object_id)
 {
     bool status = true; /* return value */
+    DEVICE_OBJECT_DATA *pDev;
+    bool linked;
 
     if (object_id <= BACNET_MAX_INSTANCE) {
         /* Make the change and update the database revision */
-        Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number = object_id;
+        pDev = routed_device_data(iCurrent_Device_Idx);
+        if (iCurrent_Device_Idx < Num_Managed_Devices) {
+            linked = routed_device_instance_unlink(iCurrent_Device_Idx);
+            pDev->bacObj.Object_Instance_Number = object_id;
+            if (linked) {
+                routed_device_instance_link(iCurrent_Device_Idx);
+            } else {
+                routed_device_index_rebuild();
+            }
+        } else {
+            pDev->bacObj.Object_Instance_Number = object_id;
+        }
         Routed_Device_Inc_Database_Revision();
     } else {
         status = false;
@@ -531,12 +918,15 @@ bool Routed_Device_Set_Object_Name(
     uint8_t encoding, const char *value, size_t length)
 {
     bool status = false; /*return value */
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = routed_device_data(iCurrent_Device_Idx);
 
     if ((encoding == CHARACTER_UTF8) && (length < MAX_DEV_NAME_LEN)) {
         /* Make the change and update the database revision */
         memmove(pDev->bacObj.Object_Name, value, length);
         pDev->bacObj.Object_Name[length] = 0;
+        Device_Property_Cache_Invalidate(
+            OBJECT_DEVICE, pDev->bacObj.Object_Instance_Number,
+            PROP_OBJECT_NAME);
         Routed_Device_Inc_Database_Revision();
         status = true;
     }
@@ -547,11 +937,14 @@ bool Routed_Device_Set_Object_Name(
 bool Routed_Device_Set_Description(const char *name, size_t length)
 {
     bool status = false; /*return value */
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = routed_device_data(iCurrent_Device_Idx);
 
     if (length < MAX_DEV_DESC_LEN) {
         memmove(pDev->Description, name, length);
         pDev->Description[length] = 0;
+        Device_Property_Cache_Invalidate(
+            OBJECT_DEVICE, pDev->bacObj.Object_Instance_Number,
+            PROP_DESCRIPTION);
         status = true;
     }
 
@@ -565,7 +958,7 @@ bool Routed_Device_Set_Description(const char *name, size_t length)
  */
 void Routed_Device_Inc_Database_Revision(void)
 {
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = routed_device_data(iCurrent_Device_Idx);
     pDev->Database_Revision++;
 }
 
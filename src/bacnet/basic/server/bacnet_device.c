@@ -802,6 +802,12 @@ static uint32_t Database_Revision;
 static BACNET_REINITIALIZED_STATE Reinitialize_State = BACNET_REINIT_IDLE;
 static BACNET_CHARACTER_STRING Reinit_Password;
 static write_property_function Device_Write_Property_Store_Callback;
+static write_property_commit_function Device_Write_Property_Commit_Callback;
+/* WritePropertyMultiple batch, where side effects are deferred */
+static bool Write_Property_Batch;
+static unsigned Write_Property_Batch_Count;
+static unsigned Write_Property_Batch_Stored;
+static bool Database_Revision_Deferred;
 static uint8_t Device_UUID[16];
 static const char *Serial_Number = BACNET_DEVICE_SERIAL_NUMBER;
 static BACNET_TIMESTAMP Time_Of_Device_Restart;
@@ -1405,7 +1411,53 @@ void Device_Set_Database_Revision(uint32_t revision)
  */
 void Device_Inc_Database_Revision(void)
 {
-    Database_Revision++;
+    if (Write_Property_Batch) {
+        /* incremented once at the end of the batch */
+        Database_Revision_Deferred = true;
+    } else {
+        Database_Revision++;
+    }
+}
+
+/**
+ * @brief Determine if Device_Read_Property() keeps the encoded value
+ *  of a property for the next read of it. This Device object does not
+ *  keep any.
+ * @param object_type [in] The object type
+ * @param object_property [in] The property to check
+ * @return false
+ */
+bool Device_Property_Cacheable(
+    BACNET_OBJECT_TYPE object_type, BACNET_PROPERTY_ID object_property)
+{
+    (void)object_type;
+    (void)object_property;
+    return false;
+}
+
+/**
+ * @brief Forget the cached encoded values of an object property.
+ *  This Device object does not keep any.
+ * @param object_type [in] The object type
+ * @param object_instance [in] The object instance
+ * @param object_property [in] The property, or PROP_ALL
+ */
+void Device_Property_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+}
+
+/**
+ * @brief Forget all the cached encoded property values.
+ *  This Device object does not keep any.
+ */
+void Device_Property_Cache_Clear(void)
+{
 }
 
 /** Get the total count of objects supported by this Device Object.
@@ -1518,6 +1570,30 @@ bool Device_Valid_Object_Name(
     const BACNET_CHARACTER_STRING *object_name1,
     BACNET_OBJECT_TYPE *object_type,
     uint32_t *object_instance)
+{
+    BACNET_CHARACTER_STRING_VIEW view;
+
+    if (!characterstring_view_from_string(&view, object_name1)) {
+        return false;
+    }
+
+    return Device_Valid_Object_Name_View(&view, object_type, object_instance);
+}
+
+/** Determine if we have an object with the given object_name, given as
+ * a view so that it can be looked up straight from a decoded APDU.
+ * If the object_type and object_instance pointers are not null,
+ * and the lookup succeeds, they will be given the resulting values.
+ * @param object_name [in] The desired Object Name to look for.
+ * @param object_type [out] The BACNET_OBJECT_TYPE of the matching Object.
+ * @param object_instance [out] The object instance number of the matching
+ * Object.
+ * @return True on success or else False if not found.
+ */
+bool Device_Valid_Object_Name_View(
+    const BACNET_CHARACTER_STRING_VIEW *object_name,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance)
 {
     bool found = false;
     BACNET_OBJECT_TYPE type = OBJECT_NONE;
@@ -1534,7 +1610,8 @@ bool Device_Valid_Object_Name(
             pObject = Device_Objects_Find_Functions((BACNET_OBJECT_TYPE)type);
             if ((pObject != NULL) && (pObject->Object_Name != NULL) &&
                 (pObject->Object_Name(instance, &object_name2) &&
-                 characterstring_same(object_name1, &object_name2))) {
+                 characterstring_view_string_same(
+                     object_name, &object_name2))) {
                 found = true;
                 if (object_type) {
                     *object_type = type;
@@ -2042,7 +2119,7 @@ static bool Device_Write_Property_Object_Name(
 {
     bool status = false; /* return value */
     int len = 0;
-    BACNET_CHARACTER_STRING value;
+    BACNET_CHARACTER_STRING_VIEW value = { 0 };
     BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
     uint32_t object_instance = 0;
     int apdu_size = 0;
@@ -2059,11 +2136,13 @@ static bool Device_Write_Property_Object_Name(
     }
     apdu = wp_data->application_data;
     apdu_size = wp_data->application_data_len;
-    len = bacnet_character_string_application_decode(apdu, apdu_size, &value);
+    /* the name is checked where it is in the request, without a copy */
+    len = bacnet_character_string_view_application_decode(
+        apdu, apdu_size, &value);
     if (len > 0) {
-        if ((characterstring_encoding(&value) != CHARACTER_ANSI_X34) ||
-            (characterstring_length(&value) == 0) ||
-            (!characterstring_printable(&value))) {
+        if ((value.encoding != CHARACTER_ANSI_X34) || (value.length == 0) ||
+            (value.length >= MAX_CHARACTER_STRING_BYTES) ||
+            (!characterstring_view_printable(&value))) {
             wp_data->error_class = ERROR_CLASS_PROPERTY;
             wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
         } else {
@@ -2078,7 +2157,8 @@ static bool Device_Write_Property_Object_Name(
     }
     if (status) {
         /* All the object names in a device must be unique */
-        if (Device_Valid_Object_Name(&value, &object_type, &object_instance)) {
+        if (Device_Valid_Object_Name_View(
+                &value, &object_type, &object_instance)) {
             if ((object_type == wp_data->object_type) &&
                 (object_instance == wp_data->object_instance)) {
                 /* writing same name to same object */
@@ -2116,6 +2196,82 @@ static void Device_Write_Property_Store(BACNET_WRITE_PROPERTY_DATA *wp_data)
     }
 }
 
+/**
+ * @brief Set the callback for the end of a set of stored WriteProperty
+ *  values, e.g. to write the stored values to non-volatile memory once.
+ * @param cb [in] The function to be called, or NULL to disable
+ */
+void Device_Write_Property_Commit_Callback_Set(
+    write_property_commit_function cb)
+{
+    Device_Write_Property_Commit_Callback = cb;
+}
+
+/**
+ * @brief Commit the values stored since the last commit
+ * @param count [in] number of values stored
+ */
+static void Device_Write_Property_Commit(unsigned count)
+{
+    if (Device_Write_Property_Commit_Callback && (count > 0)) {
+        Device_Write_Property_Commit_Callback(count);
+    }
+}
+
+/**
+ * @brief Begin a batch of WriteProperty operations, such as the writes
+ *  of one WritePropertyMultiple request. Until the batch ends, successful
+ *  writes are counted but not stored, and the database revision is not
+ *  incremented.
+ */
+void Device_Write_Property_Batch_Begin(void)
+{
+    Write_Property_Batch = true;
+    Write_Property_Batch_Count = 0;
+    Write_Property_Batch_Stored = 0;
+    Database_Revision_Deferred = false;
+}
+
+/**
+ * @brief Store the value of a property written during the batch.
+ *  Called once for each successful write, in the same order, after
+ *  the write was applied.
+ * @param wp_data [in] Structure with the written Object and Property info
+ *  and Value
+ * @return true always, so that it can be used as a write_property_function
+ */
+bool Device_Write_Property_Batch_Store(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    if (Write_Property_Batch &&
+        (Write_Property_Batch_Stored < Write_Property_Batch_Count)) {
+        Write_Property_Batch_Stored++;
+        Device_Write_Property_Store(wp_data);
+    }
+
+    return true;
+}
+
+/**
+ * @brief End a batch of WriteProperty operations, incrementing the
+ *  database revision and committing the stored values once.
+ * @return number of successful writes during the batch
+ */
+unsigned Device_Write_Property_Batch_End(void)
+{
+    unsigned count = Write_Property_Batch_Count;
+
+    Write_Property_Batch = false;
+    if (Database_Revision_Deferred) {
+        Database_Revision_Deferred = false;
+        Device_Inc_Database_Revision();
+    }
+    Device_Write_Property_Commit(Write_Property_Batch_Stored);
+    Write_Property_Batch_Count = 0;
+    Write_Property_Batch_Stored = 0;
+
+    return count;
+}
+
 /** Looks up the requested Object and Property, and set the new Value in it,
  *  if allowed.
  * If the Object or Property can't be found, sets the error class and code.
@@ -2152,7 +2308,12 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     status = pObject->Object_Write_Property(wp_data);
                 }
                 if (status) {
-                    Device_Write_Property_Store(wp_data);
+                    if (Write_Property_Batch) {
+                        Write_Property_Batch_Count++;
+                    } else {
+                        Device_Write_Property_Store(wp_data);
+                        Device_Write_Property_Commit(1);
+                    }
                 }
             } else {
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
@@ -160,6 +160,23 @@ void apdu_set_unconfirmed_handler(
     }
 }
 
+/**
+ * @brief Determine whether a handler is set for the given unconfirmed
+ *  service, i.e. whether apdu_handler() would do anything with it.
+ *
+ * @param service_choice Service, see SERVICE_UNCONFIRMED_X enumeration.
+ *
+ * @return true if a handler is set for the service
+ */
+bool apdu_unconfirmed_service_handled(BACNET_UNCONFIRMED_SERVICE service_choice)
+{
+    if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
+        return Unconfirmed_Function[service_choice] != NULL;
+    }
+
+    return false;
+}
+
 /**
  * @brief Checks if the given service is supported or not.
  *
@@ -111,6 +111,10 @@ void apdu_set_unconfirmed_handler(
 /* returns true if the service is supported by a handler */
 BACNET_STACK_EXPORT
 bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported);
+/* returns true if a handler is set for the unconfirmed service */
+BACNET_STACK_EXPORT
+bool apdu_unconfirmed_service_handled(
+    BACNET_UNCONFIRMED_SERVICE service_choice);
 
 /* Function to translate a SERVICE_SUPPORTED_ enum to its SERVICE_CONFIRMED_
  *  or SERVICE_UNCONFIRMED_ index.
@@ -33,6 +33,9 @@
 
 /** @file h_rp.c  Handles Read Property requests. */
 
+/* NPDU header of the replies, usually sent to the same clients */
+static BACNET_NPDU_HEADER RP_NPDU_Header;
+
 /** Handler for a ReadProperty Service request.
  * @ingroup DSRP
  * This handler will be invoked by apdu_handler() if it has been enabled
@@ -81,8 +84,9 @@ void handler_read_property(
     /* encode the NPDU portion of the packet */
     datalink_get_my_address(&my_address);
     npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
-    npdu_len = npdu_encode_pdu(
-        &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    npdu_len = npdu_header_encode(
+        &RP_NPDU_Header, &Handler_Transmit_Buffer[0], src, &my_address,
+        &npdu_data);
     if (npdu_len <= 0) {
         /* If 0 or negative, there were problems with the data or encoding. */
         len = BACNET_STATUS_ABORT;
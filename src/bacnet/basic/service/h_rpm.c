@@ -35,6 +35,13 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/datalink.h"
 
+/* NPDU header of the replies, usually sent to the same clients */
+static BACNET_NPDU_HEADER RPM_NPDU_Header;
+/* property values are read here when less than MAX_APDU is left in the
+   reply, since not every object property encoder keeps within the
+   application_data_len it is given */
+static uint8_t RPM_Value_Buffer[MAX_APDU];
+
 /**
  * @brief Fetches the lists of properties (array of BACNET_PROPERTY_ID's) for
  * this object type and the special properties ALL or REQUIRED or OPTIONAL.
@@ -46,7 +53,7 @@
  * @return The property ID or -1 if not found.
  */
 static BACNET_PROPERTY_ID RPM_Object_Property(
-    struct special_property_list_t *pPropertyList,
+    const struct special_property_list_t *pPropertyList,
     BACNET_PROPERTY_ID special_property,
     unsigned index)
 {
@@ -90,7 +97,7 @@ static BACNET_PROPERTY_ID RPM_Object_Property(
  * @return The number of properties.
  */
 static unsigned RPM_Object_Property_Count(
-    struct special_property_list_t *pPropertyList,
+    const struct special_property_list_t *pPropertyList,
     BACNET_PROPERTY_ID special_property)
 {
     unsigned count = 0; /* return value */
@@ -107,41 +114,267 @@ static unsigned RPM_Object_Property_Count(
     return count;
 }
 
+/* number of object types whose special property lists are kept while
+   handling one ReadPropertyMultiple request */
+#ifndef RPM_PLAN_OBJECT_TYPES
+#define RPM_PLAN_OBJECT_TYPES 8
+#endif
+
+/* special property lists of one object type, and the smallest encoding
+   of the results for each list */
+struct rpm_plan_entry {
+    BACNET_OBJECT_TYPE object_type;
+    struct special_property_list_t property_list;
+    unsigned required_len;
+    unsigned optional_len;
+    unsigned proprietary_len;
+};
+
+/* special property lists resolved during one request */
+struct rpm_plan {
+    struct rpm_plan_entry entry[RPM_PLAN_OBJECT_TYPES];
+    unsigned count;
+    unsigned next;
+};
+
+/**
+ * @brief Determine the smallest encoding of the results of a list of
+ * properties: the property identifier, and a one octet property value
+ * within its opening and closing tags.
+ * @param pList [in] property list
+ * @return The smallest length of the encoded results
+ */
+static unsigned RPM_Property_List_Size(const struct property_list_t *pList)
+{
+    unsigned apdu_len = 0;
+    unsigned index;
+
+    for (index = 0; index < pList->count; index++) {
+        apdu_len +=
+            encode_context_enumerated(NULL, 2, (uint32_t)pList->pList[index]);
+        apdu_len += 3;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Get the special property lists of an object type, resolving
+ * them the first time the object type is seen in the request.
+ * @param plan [in,out] The plan of the request
+ * @param object_type [in] The object type
+ * @param object_instance [in] The object instance
+ * @return The plan entry of the object type
+ */
+static const struct rpm_plan_entry *RPM_Plan_Object(
+    struct rpm_plan *plan,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance)
+{
+    struct rpm_plan_entry *entry;
+    unsigned index;
+
+    for (index = 0; index < plan->count; index++) {
+        entry = &plan->entry[index];
+        if (entry->object_type == object_type) {
+            return entry;
+        }
+    }
+    /* replace the oldest entry when full */
+    if (plan->count < RPM_PLAN_OBJECT_TYPES) {
+        entry = &plan->entry[plan->count];
+        plan->count++;
+    } else {
+        entry = &plan->entry[plan->next];
+        plan->next = (plan->next + 1) % RPM_PLAN_OBJECT_TYPES;
+    }
+    entry->object_type = object_type;
+    Device_Objects_Property_List(
+        object_type, object_instance, &entry->property_list);
+    entry->required_len =
+        RPM_Property_List_Size(&entry->property_list.Required);
+    entry->optional_len =
+        RPM_Property_List_Size(&entry->property_list.Optional);
+    entry->proprietary_len =
+        RPM_Property_List_Size(&entry->property_list.Proprietary);
+
+    return entry;
+}
+
+/**
+ * @brief Determine the smallest encoding of the results of a special
+ * property, so that an oversized response is known before it is encoded.
+ * @param entry [in] The plan entry of the object type
+ * @param special_property The special property ALL, REQUIRED, or OPTIONAL
+ * @return The smallest length of the encoded results
+ */
+static unsigned RPM_Plan_Size(
+    const struct rpm_plan_entry *entry, BACNET_PROPERTY_ID special_property)
+{
+    unsigned apdu_len = 0;
+
+    if (special_property == PROP_ALL) {
+        apdu_len = entry->required_len + entry->optional_len +
+            entry->proprietary_len;
+    } else if (special_property == PROP_REQUIRED) {
+        apdu_len = entry->required_len;
+    } else if (special_property == PROP_OPTIONAL) {
+        apdu_len = entry->optional_len;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Get the abort reason for results that do not fit in the reply
+ * @param service_data [in] The confirmed service data of the request
+ * @return ERROR_CODE_ABORT_BUFFER_OVERFLOW when the client accepts a
+ * segmented response, so only the transmit buffer is too small, else
+ * ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED
+ */
+static BACNET_ERROR_CODE
+RPM_Overflow_Error_Code(const BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+#if BACNET_SEGMENTATION_ENABLED
+    if (service_data->segmented_response_accepted) {
+        return ERROR_CODE_ABORT_BUFFER_OVERFLOW;
+    }
+#else
+    (void)service_data;
+#endif
+
+    return ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+}
+
+/**
+ * @brief Encode the RPM object identifier and the opening of its list of
+ * results in place, if it fits.
+ * @param apdu [out] The buffer to encode into.
+ * @param offset [in] The offset into the buffer to start encoding.
+ * @param max_apdu [in] The maximum length of the buffer.
+ * @param rpmdata [in] The RPM data to encode.
+ * @return The length of the encoding, or 0 if there is no room to fit it.
+ */
+static int RPM_Encode_Object_Begin(
+    uint8_t *apdu, size_t offset, size_t max_apdu, const BACNET_RPM_DATA *rpmdata)
+{
+    int len;
+
+    len = rpm_ack_encode_apdu_object_begin(NULL, rpmdata);
+    if (!memcopylen(offset, max_apdu, len)) {
+        return 0;
+    }
+
+    return rpm_ack_encode_apdu_object_begin(&apdu[offset], rpmdata);
+}
+
+/**
+ * @brief Encode the closing of the RPM list of results in place, if it fits.
+ * @param apdu [out] The buffer to encode into.
+ * @param offset [in] The offset into the buffer to start encoding.
+ * @param max_apdu [in] The maximum length of the buffer.
+ * @return The length of the encoding, or 0 if there is no room to fit it.
+ */
+static int RPM_Encode_Object_End(uint8_t *apdu, size_t offset, size_t max_apdu)
+{
+    int len;
+
+    len = rpm_ack_encode_apdu_object_end(NULL);
+    if (!memcopylen(offset, max_apdu, len)) {
+        return 0;
+    }
+
+    return rpm_ack_encode_apdu_object_end(&apdu[offset]);
+}
+
+/**
+ * @brief Encode the RPM property and a property access error in place,
+ * if both fit.
+ * @param apdu [out] The buffer to encode into.
+ * @param offset [in] The offset into the buffer to start encoding.
+ * @param max_apdu [in] The maximum length of the buffer.
+ * @param rpmdata [in] The RPM data to encode.
+ * @param error_class [in] The property access error class
+ * @param error_code [in] The property access error code
+ * @return The length of the encoding, or 0 if there is no room to fit it.
+ */
+static int RPM_Encode_Property_Error(
+    uint8_t *apdu,
+    size_t offset,
+    size_t max_apdu,
+    const BACNET_RPM_DATA *rpmdata,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    int len;
+    int apdu_len;
+
+    apdu_len = rpm_ack_encode_apdu_object_property(
+        NULL, rpmdata->object_property, rpmdata->array_index);
+    len = rpm_ack_encode_apdu_object_property_error(
+        NULL, error_class, error_code);
+    if (!memcopylen(offset, max_apdu, apdu_len + len)) {
+        return 0;
+    }
+    apdu_len = rpm_ack_encode_apdu_object_property(
+        &apdu[offset], rpmdata->object_property, rpmdata->array_index);
+    len = rpm_ack_encode_apdu_object_property_error(
+        &apdu[offset + apdu_len], error_class, error_code);
+
+    return apdu_len + len;
+}
+
 /**
  * @brief Encode the RPM property returning the length of the encoding,
  * or 0 if there is no room to fit the encoding.
+ * @note The property value is read straight into the buffer, after the
+ * property header and the propertyValue opening tag, when at least
+ * MAX_APDU is left there. Otherwise it is read into RPM_Value_Buffer and
+ * copied once it is known to fit. Nothing beyond offset is kept when the
+ * encoding does not fit.
  * @param apdu [out] The buffer to encode the property into.
  * @param offset [in] The offset into the buffer to start encoding.
  * @param max_apdu [in] The maximum length of the buffer.
  * @param rpmdata [in] The RPM data to encode.
+ * @param overflow_code [in] The abort reason when the encoding does not fit
  * @return The length of the encoding, or 0 if there is no room to fit the
  * encoding.
  */
 static int RPM_Encode_Property(
-    uint8_t *apdu, uint16_t offset, uint16_t max_apdu, BACNET_RPM_DATA *rpmdata)
+    uint8_t *apdu,
+    uint16_t offset,
+    uint16_t max_apdu,
+    BACNET_RPM_DATA *rpmdata,
+    BACNET_ERROR_CODE overflow_code)
 {
     int len = 0;
-    size_t copy_len = 0;
     int apdu_len = 0;
+    size_t value_offset = 0;
     BACNET_READ_PROPERTY_DATA rpdata;
-    uint8_t Temp_Buf[MAX_APDU];
 
     len = rpm_ack_encode_apdu_object_property(
-        &Temp_Buf[0], rpmdata->object_property, rpmdata->array_index);
-    copy_len = memcopy(&apdu[0], &Temp_Buf[0], offset, len, max_apdu);
-    if (copy_len == 0) {
-        rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        NULL, rpmdata->object_property, rpmdata->array_index);
+    /* the property value needs at least one octet and its closing tag */
+    value_offset = (size_t)offset + len + 1;
+    if (!memcopylen(value_offset, max_apdu, 2)) {
+        rpmdata->error_code = overflow_code;
         return BACNET_STATUS_ABORT;
     }
-    apdu_len += len;
+    apdu_len = rpm_ack_encode_apdu_object_property(
+        &apdu[offset], rpmdata->object_property, rpmdata->array_index);
     rpdata.error_class = ERROR_CLASS_OBJECT;
     rpdata.error_code = ERROR_CODE_UNKNOWN_OBJECT;
     rpdata.object_type = rpmdata->object_type;
     rpdata.object_instance = rpmdata->object_instance;
     rpdata.object_property = rpmdata->object_property;
     rpdata.array_index = rpmdata->array_index;
-    rpdata.application_data = &Temp_Buf[0];
-    rpdata.application_data_len = sizeof(Temp_Buf);
+    if ((max_apdu - value_offset - 1) >= MAX_APDU) {
+        rpdata.application_data = &apdu[value_offset];
+        rpdata.application_data_len = max_apdu - value_offset - 1;
+    } else {
+        rpdata.application_data = &RPM_Value_Buffer[0];
+        rpdata.application_data_len = sizeof(RPM_Value_Buffer);
+    }
 
     if ((rpmdata->object_property == PROP_ALL) ||
         (rpmdata->object_property == PROP_REQUIRED) ||
@@ -162,21 +395,21 @@ static int RPM_Encode_Property(
         }
         /* error was returned - encode that for the response */
         len = rpm_ack_encode_apdu_object_property_error(
-            &Temp_Buf[0], rpdata.error_class, rpdata.error_code);
-        copy_len =
-            memcopy(&apdu[0], &Temp_Buf[0], offset + apdu_len, len, max_apdu);
-
-        if (copy_len == 0) {
-            rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+            NULL, rpdata.error_class, rpdata.error_code);
+        if (!memcopylen(offset + apdu_len, max_apdu, len)) {
+            rpmdata->error_code = overflow_code;
             return BACNET_STATUS_ABORT;
         }
-    } else if ((offset + apdu_len + 1 + len + 1) < max_apdu) {
-        /* enough room to fit the property value and tags */
+        len = rpm_ack_encode_apdu_object_property_error(
+            &apdu[offset + apdu_len], rpdata.error_class, rpdata.error_code);
+    } else if (memcopylen(value_offset, max_apdu, len + 1)) {
+        /* enough room to fit the property value and tags - a value
+           that is already in place is not copied */
         len = rpm_ack_encode_apdu_object_property_value(
-            &apdu[offset + apdu_len], &Temp_Buf[0], len);
+            &apdu[offset + apdu_len], rpdata.application_data, len);
     } else {
         /* not enough room - abort! */
-        rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        rpmdata->error_code = overflow_code;
         return BACNET_STATUS_ABORT;
     }
     apdu_len += len;
@@ -224,13 +457,18 @@ void handler_read_property_multiple(
     BACNET_APDU_FIXED_HEADER apdu_fixed_header;
     int apdu_header_len = 3;
     int sizeOfBuffer = MAX_PDU - MAX_NPDU;
-    uint8_t Temp_Buf_rpm[MAX_PDU - MAX_NPDU];
+    struct rpm_plan plan = { 0 };
+    size_t plan_max_apdu = 0;
+    BACNET_ERROR_CODE overflow_code =
+        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
 
     if (service_data) {
+        overflow_code = RPM_Overflow_Error_Code(service_data);
         datalink_get_my_address(&my_address);
         npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
-        npdu_len = npdu_encode_pdu(
-            &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+        npdu_len = npdu_header_encode(
+            &RPM_NPDU_Header, &Handler_Transmit_Buffer[0], src, &my_address,
+            &npdu_data);
         if (service_len == 0) {
             rpmdata.error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
             error = BACNET_STATUS_REJECT;
@@ -246,6 +484,15 @@ void handler_read_property_multiple(
                encode complex ack, invoke id, service choice */
             apdu_len = rpm_ack_encode_apdu_init(
                 &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id);
+            /* the largest response that could be sent */
+            plan_max_apdu = service_data->max_resp < MAX_APDU
+                ? service_data->max_resp
+                : MAX_APDU;
+#if BACNET_SEGMENTATION_ENABLED
+            if (service_data->segmented_response_accepted) {
+                plan_max_apdu = sizeOfBuffer;
+            }
+#endif
 
             for (;;) {
                 /* Start by looking for an object ID */
@@ -286,19 +533,12 @@ void handler_read_property_multiple(
                 }
 #endif
                 /* Stick this object id into the reply - if it will fit */
-                len = rpm_ack_encode_apdu_object_begin(&Temp_Buf_rpm[0], &rpmdata);
-                copy_len = memcopy(
-                    &Handler_Transmit_Buffer[npdu_len], &Temp_Buf_rpm[0], apdu_len,
-                    len, sizeOfBuffer);
+                copy_len = RPM_Encode_Object_Begin(
+                    &Handler_Transmit_Buffer[npdu_len], apdu_len, sizeOfBuffer,
+                    &rpmdata);
                 if (copy_len == 0) {
                     debug_print("RPM: Response too big!\n");
-#if !BACNET_SEGMENTATION_ENABLED
-                    rpmdata.error_code =
-                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-#else
-                    rpmdata.error_code =
-                        ERROR_CODE_ABORT_BUFFER_OVERFLOW;
-#endif
+                    rpmdata.error_code = overflow_code;
                     error = BACNET_STATUS_ABORT;
                     berror = true;
                     break;
@@ -324,7 +564,7 @@ void handler_read_property_multiple(
                     if ((rpmdata.object_property == PROP_ALL) ||
                         (rpmdata.object_property == PROP_REQUIRED) ||
                         (rpmdata.object_property == PROP_OPTIONAL)) {
-                        struct special_property_list_t property_list;
+                        const struct rpm_plan_entry *plan_entry;
                         unsigned property_count = 0;
                         unsigned index = 0;
                         BACNET_PROPERTY_ID special_object_property;
@@ -333,7 +573,8 @@ void handler_read_property_multiple(
                                 rpmdata.object_type, rpmdata.object_instance)) {
                             len = RPM_Encode_Property(
                                 &Handler_Transmit_Buffer[npdu_len],
-                                (uint16_t)apdu_len, sizeOfBuffer, &rpmdata);
+                                (uint16_t)apdu_len, sizeOfBuffer, &rpmdata,
+                                overflow_code);
                             if (len > 0) {
                                 apdu_len += len;
                             } else {
@@ -347,49 +588,14 @@ void handler_read_property_multiple(
                         } else if (rpmdata.array_index != BACNET_ARRAY_ALL) {
                             /* No array index options for this special property.
                                Encode error for this object property response */
-                            len = rpm_ack_encode_apdu_object_property(
-                                &Temp_Buf_rpm[0], rpmdata.object_property,
-                                rpmdata.array_index);
-
-                            copy_len = memcopy(
-                                &Handler_Transmit_Buffer[npdu_len],
-                                &Temp_Buf_rpm[0], apdu_len, len, sizeOfBuffer);
-
-                            if (copy_len == 0) {
+                            len = RPM_Encode_Property_Error(
+                                &Handler_Transmit_Buffer[npdu_len], apdu_len,
+                                sizeOfBuffer, &rpmdata, ERROR_CLASS_PROPERTY,
+                                ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY);
+                            if (len == 0) {
                                 debug_print(
                                     "RPM: Too full to encode property!\n");
-#if !BACNET_SEGMENTATION_ENABLED
-                                rpmdata.error_code =
-                                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-#else
-                                rpmdata.error_code =
-                                    ERROR_CODE_ABORT_BUFFER_OVERFLOW;
-#endif
-                                error = BACNET_STATUS_ABORT;
-                                /* The berror flag ensures that
-                                   both loops will be broken! */
-                                berror = true;
-                                break;
-                            }
-
-                            apdu_len += len;
-                            len = rpm_ack_encode_apdu_object_property_error(
-                                &Temp_Buf_rpm[0], ERROR_CLASS_PROPERTY,
-                                ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY);
-
-                            copy_len = memcopy(
-                                &Handler_Transmit_Buffer[npdu_len],
-                                &Temp_Buf_rpm[0], apdu_len, len, sizeOfBuffer);
-
-                            if (copy_len == 0) {
-                                debug_print("RPM: Too full to encode error!\n");
-#if !BACNET_SEGMENTATION_ENABLED
-                                rpmdata.error_code =
-                                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-#else
-                                rpmdata.error_code =
-                                    ERROR_CODE_ABORT_BUFFER_OVERFLOW;
-#endif
+                                rpmdata.error_code = overflow_code;
                                 error = BACNET_STATUS_ABORT;
                                 /* The berror flag ensures that
                                    both loops will be broken! */
@@ -399,11 +605,12 @@ void handler_read_property_multiple(
                             apdu_len += len;
                         } else {
                             special_object_property = rpmdata.object_property;
-                            Device_Objects_Property_List(
-                                rpmdata.object_type, rpmdata.object_instance,
-                                &property_list);
+                            plan_entry = RPM_Plan_Object(
+                                &plan, rpmdata.object_type,
+                                rpmdata.object_instance);
                             property_count = RPM_Object_Property_Count(
-                                &property_list, special_object_property);
+                                &plan_entry->property_list,
+                                special_object_property);
 
                             if (property_count == 0) {
                                 /* Only happens with the OPTIONAL property */
@@ -418,7 +625,8 @@ void handler_read_property_multiple(
                                         rpmdata.object_instance)) {
                                     len = RPM_Encode_Property(
                                         &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, sizeOfBuffer, &rpmdata);
+                                        (uint16_t)apdu_len, sizeOfBuffer,
+                                        &rpmdata, overflow_code);
                                     if (len > 0) {
                                         apdu_len += len;
                                     } else {
@@ -431,16 +639,29 @@ void handler_read_property_multiple(
                                         break;
                                     }
                                 }
+                            } else if (!memcopylen(
+                                           apdu_len, plan_max_apdu,
+                                           RPM_Plan_Size(
+                                               plan_entry,
+                                               special_object_property))) {
+                                /* the results can never fit - abort
+                                   before reading any of them */
+                                debug_print("RPM: Results too big!\n");
+                                rpmdata.error_code = overflow_code;
+                                error = BACNET_STATUS_ABORT;
+                                berror = true;
+                                break;
                             } else {
                                 for (index = 0; index < property_count;
                                      index++) {
                                     rpmdata.object_property =
                                         RPM_Object_Property(
-                                            &property_list,
+                                            &plan_entry->property_list,
                                             special_object_property, index);
                                     len = RPM_Encode_Property(
                                         &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, sizeOfBuffer, &rpmdata);
+                                        (uint16_t)apdu_len, sizeOfBuffer,
+                                        &rpmdata, overflow_code);
                                     if (len > 0) {
                                         apdu_len += len;
                                     } else {
@@ -459,7 +680,8 @@ void handler_read_property_multiple(
                         /* handle an individual property */
                         len = RPM_Encode_Property(
                             &Handler_Transmit_Buffer[npdu_len],
-                            (uint16_t)apdu_len, sizeOfBuffer, &rpmdata);
+                            (uint16_t)apdu_len, sizeOfBuffer, &rpmdata,
+                            overflow_code);
                         if (len > 0) {
                             apdu_len += len;
                         } else {
@@ -478,20 +700,13 @@ void handler_read_property_multiple(
                         /* Reached end of property list so cap the result list
                          */
                         decode_len++;
-                        len = rpm_ack_encode_apdu_object_end(&Temp_Buf_rpm[0]);
-                        copy_len = memcopy(
-                            &Handler_Transmit_Buffer[npdu_len], &Temp_Buf_rpm[0],
-                            apdu_len, len, sizeOfBuffer);
+                        copy_len = RPM_Encode_Object_End(
+                            &Handler_Transmit_Buffer[npdu_len], apdu_len,
+                            sizeOfBuffer);
                         if (copy_len == 0) {
                             debug_print(
                                 "RPM: Too full to encode object end!\n");
-#if !BACNET_SEGMENTATION_ENABLED
-                            rpmdata.error_code =
-                                ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-#else
-                            rpmdata.error_code =
-                                ERROR_CODE_ABORT_BUFFER_OVERFLOW;
-#endif
+                            rpmdata.error_code = overflow_code;
                             error = BACNET_STATUS_ABORT;
                             /* The berror flag ensures that
                                both loops will be broken! */
@@ -20,6 +20,7 @@
 /* some demo stuff needed */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/arena.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
@@ -27,6 +28,43 @@
 #define PRINTF debug_printf_stdout
 #define PERROR debug_printf_stderr
 
+/* size of the memory blocks used to decode a ReadPropertyMultiple-ACK */
+#ifndef RPM_ACK_ARENA_BLOCK_SIZE
+#define RPM_ACK_ARENA_BLOCK_SIZE (4 * sizeof(BACNET_APPLICATION_DATA_VALUE))
+#endif
+
+/* decoded data of the ReadPropertyMultiple-ACK handler */
+static MEMORY_ARENA RPM_Ack_Arena;
+static bool RPM_Ack_Arena_Initialized;
+
+/**
+ * @brief Allocate a zeroed node of the decoded RPM data
+ * @param arena [in] memory arena, or NULL to use calloc()
+ * @param size [in] size of the node, in bytes
+ * @return the node, or NULL if out of memory
+ */
+static void *rpm_ack_node_alloc(MEMORY_ARENA *arena, size_t size)
+{
+    if (arena) {
+        return arena_alloc(arena, size);
+    }
+
+    return calloc(1, size);
+}
+
+/**
+ * @brief Free a node of the decoded RPM data
+ * @param arena [in] memory arena, or NULL if the node is from calloc()
+ * @param node [in] the node to free. Nodes from an arena are freed
+ *  with the whole arena.
+ */
+static void rpm_ack_node_free(MEMORY_ARENA *arena, void *node)
+{
+    if (!arena) {
+        free(node);
+    }
+}
+
 /** Decode the received RPM data and make a linked list of the results.
  * @ingroup DSRPM
  *
@@ -40,6 +78,32 @@ int rpm_ack_decode_service_request(
     const uint8_t *apdu,
     int apdu_len,
     BACNET_READ_ACCESS_DATA *read_access_data)
+{
+    return rpm_ack_decode_service_request_arena(
+        apdu, apdu_len, read_access_data, NULL);
+}
+
+/** Decode the received RPM data and make a linked list of the results,
+ * taking the nodes of the list from a memory arena.
+ * @ingroup DSRPM
+ *
+ * The nodes sit next to each other in the arena, in the order they were
+ * decoded, and are all freed at once with arena_reset() instead of with
+ * rpm_data_free().
+ *
+ * @param apdu [in] The received apdu data.
+ * @param apdu_len [in] Total length of the apdu.
+ * @param read_access_data [out] Pointer to the head of the linked list
+ *          where the RPM data is to be stored.
+ * @param arena [in] Memory arena for the nodes of the list, or NULL to
+ *          allocate each node with calloc()
+ * @return The number of bytes decoded, or -1 on error
+ */
+int rpm_ack_decode_service_request_arena(
+    const uint8_t *apdu,
+    int apdu_len,
+    BACNET_READ_ACCESS_DATA *read_access_data,
+    MEMORY_ARENA *arena)
 {
     int decoded_len = 0; /* return value */
     uint32_t error_value = 0; /* decoded error value */
@@ -67,7 +131,7 @@ int rpm_ack_decode_service_request(
             old_rpm_object->next = NULL;
             if (rpm_object != read_access_data) {
                 /* don't free original */
-                free(rpm_object);
+                rpm_ack_node_free(arena, rpm_object);
                 rpm_object = NULL;
             }
             break;
@@ -75,7 +139,8 @@ int rpm_ack_decode_service_request(
         decoded_len += len;
         apdu_len -= len;
         apdu += len;
-        rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+        rpm_property = rpm_ack_node_alloc(
+            arena, sizeof(BACNET_PROPERTY_REFERENCE));
         rpm_object->listOfProperties = rpm_property;
         old_rpm_property = rpm_property;
         while (rpm_property && apdu_len) {
@@ -88,7 +153,7 @@ int rpm_ack_decode_service_request(
                     /* was this the only property in the list? */
                     rpm_object->listOfProperties = NULL;
                 }
-                free(rpm_property);
+                rpm_ack_node_free(arena, rpm_property);
                 rpm_property = NULL;
                 break;
             }
@@ -101,7 +166,8 @@ int rpm_ack_decode_service_request(
                 decoded_len++;
                 apdu_len--;
                 apdu++;
-                value = calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                value = rpm_ack_node_alloc(
+                    arena, sizeof(BACNET_APPLICATION_DATA_VALUE));
                 rpm_property->value = value;
                 if (apdu_len && decode_is_closing_tag_number(apdu, 4)) {
                     /* Special case for an empty array or list */
@@ -149,8 +215,8 @@ int rpm_ack_decode_service_request(
                             break;
                         } else if (len > 0) {
                             old_value = value;
-                            value = calloc(
-                                1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                            value = rpm_ack_node_alloc(
+                                arena, sizeof(BACNET_APPLICATION_DATA_VALUE));
                             old_value->next = value;
                         } else {
                             PERROR(
@@ -200,7 +266,8 @@ int rpm_ack_decode_service_request(
                 }
             }
             old_rpm_property = rpm_property;
-            rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+            rpm_property = rpm_ack_node_alloc(
+                arena, sizeof(BACNET_PROPERTY_REFERENCE));
             old_rpm_property->next = rpm_property;
         }
         len = rpm_decode_object_end(apdu, apdu_len);
@@ -211,7 +278,8 @@ int rpm_ack_decode_service_request(
         }
         if (apdu_len) {
             old_rpm_object = rpm_object;
-            rpm_object = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+            rpm_object = rpm_ack_node_alloc(
+                arena, sizeof(BACNET_READ_ACCESS_DATA));
             old_rpm_object->next = rpm_object;
         }
     }
@@ -362,20 +430,24 @@ void handler_read_property_multiple_ack(
     (void)src;
     (void)service_data; /* we could use these... */
 
-    rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+    if (!RPM_Ack_Arena_Initialized) {
+        arena_init(&RPM_Ack_Arena, NULL, 0, RPM_ACK_ARENA_BLOCK_SIZE);
+        RPM_Ack_Arena_Initialized = true;
+    }
+    rpm_data =
+        arena_alloc(&RPM_Ack_Arena, sizeof(BACNET_READ_ACCESS_DATA));
     if (rpm_data) {
-        len = rpm_ack_decode_service_request(
-            service_request, service_len, rpm_data);
+        len = rpm_ack_decode_service_request_arena(
+            service_request, service_len, rpm_data, &RPM_Ack_Arena);
         if (len > 0) {
             while (rpm_data) {
                 rpm_ack_print_data(rpm_data);
-                rpm_data = rpm_data_free(rpm_data);
+                rpm_data = rpm_data->next;
             }
         } else {
             PERROR("RPM Ack Malformed! Freeing memory...\n");
-            while (rpm_data) {
-                rpm_data = rpm_data_free(rpm_data);
-            }
         }
     }
+    /* the blocks are kept for the next ACK */
+    arena_reset(&RPM_Ack_Arena);
 }
@@ -20,6 +20,7 @@
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
 #include "bacnet/rpm.h"
+#include "bacnet/basic/sys/arena.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,12 @@ int rpm_ack_decode_service_request(
     int apdu_len,
     BACNET_READ_ACCESS_DATA *read_access_data);
 BACNET_STACK_EXPORT
+int rpm_ack_decode_service_request_arena(
+    const uint8_t *apdu,
+    int apdu_len,
+    BACNET_READ_ACCESS_DATA *read_access_data,
+    MEMORY_ARENA *arena);
+BACNET_STACK_EXPORT
 void rpm_ack_print_data(BACNET_READ_ACCESS_DATA *rpm_data);
 BACNET_STACK_EXPORT
 BACNET_READ_ACCESS_DATA *rpm_data_free(BACNET_READ_ACCESS_DATA *rpm_data);
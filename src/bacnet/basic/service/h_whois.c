@@ -38,12 +38,12 @@ void handler_who_is(
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
     if (len == 0) {
-        Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+        Send_I_Am_Reply(NULL);
     } else if (len != BACNET_STATUS_ERROR) {
         /* is my device id within the limits? */
         if ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
             (Device_Object_Instance_Number() <= (uint32_t)high_limit)) {
-            Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+            Send_I_Am_Reply(NULL);
         }
     }
 
@@ -69,12 +69,12 @@ void handler_who_is_unicast(
         service_request, service_len, &low_limit, &high_limit);
     if (len == 0) {
         /* If no limits, then always respond */
-        Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+        Send_I_Am_Reply(src);
     } else if (len != BACNET_STATUS_ERROR) {
         /* is my device id within the limits? */
         if ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
             (Device_Object_Instance_Number() <= (uint32_t)high_limit)) {
-            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+            Send_I_Am_Reply(src);
         }
     }
 
@@ -108,7 +108,7 @@ void handler_who_is_who_am_i_unicast(
                 src, Device_Vendor_Identifier(), &model_name, &serial_number);
         } else {
             /* If no limits, then always respond */
-            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+            Send_I_Am_Reply(src);
         }
     } else if (len != BACNET_STATUS_ERROR) {
         /* is my device id within the limits? */
@@ -125,7 +125,7 @@ void handler_who_is_who_am_i_unicast(
                     src, Device_Vendor_Identifier(), &model_name,
                     &serial_number);
             } else {
-                Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+                Send_I_Am_Reply(src);
             }
         }
     }
@@ -179,9 +179,9 @@ static void check_who_is_for_routing(
         if ((len == 0) ||
             ((dev_instance >= low_limit) && (dev_instance <= high_limit))) {
             if (is_unicast) {
-                Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+                Send_I_Am_Reply(src);
             } else {
-                Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+                Send_I_Am_Reply(NULL);
             }
         }
     }
@@ -27,12 +27,86 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/datalink.h"
 
+/* number of applied writes whose values are stored together; when full,
+   they are stored before the next write is recorded */
+#ifndef WPM_STORE_SIZE
+#define WPM_STORE_SIZE 32
+#endif
+
+/* an applied write, and where its property is encoded in the request */
+struct wpm_store_entry {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    uint16_t offset;
+};
+
+/* the applied writes of a request whose values are not yet stored */
+struct wpm_store {
+    const uint8_t *apdu;
+    uint16_t apdu_len;
+    unsigned count;
+    struct wpm_store_entry entry[WPM_STORE_SIZE];
+    BACNET_WRITE_PROPERTY_DATA wp_data;
+};
+
+static struct wpm_store WPM_Store;
+
+/**
+ * @brief Store the values of the recorded writes, in the order that they
+ *  were applied, decoding only their properties from the request.
+ * @param store [in,out] The recorded writes, which are cleared.
+ */
+static void write_property_multiple_store(struct wpm_store *store)
+{
+    BACNET_WRITE_PROPERTY_DATA *wp_data = &store->wp_data;
+    const struct wpm_store_entry *entry;
+    unsigned index;
+    int len;
+
+    for (index = 0; index < store->count; index++) {
+        entry = &store->entry[index];
+        wp_data->object_type = entry->object_type;
+        wp_data->object_instance = entry->object_instance;
+        len = wpm_decode_object_property(
+            &store->apdu[entry->offset], store->apdu_len - entry->offset,
+            wp_data);
+        if (len > 0) {
+            (void)Device_Write_Property_Batch_Store(wp_data);
+        }
+    }
+    store->count = 0;
+}
+
+/**
+ * @brief Record an applied write, so that its value is stored later
+ * @param store [in,out] The recorded writes
+ * @param wp_data [in] The applied write
+ * @param offset [in] The offset of its property in the request
+ */
+static void write_property_multiple_record(
+    struct wpm_store *store,
+    const BACNET_WRITE_PROPERTY_DATA *wp_data,
+    uint16_t offset)
+{
+    struct wpm_store_entry *entry;
+
+    if (store->count >= WPM_STORE_SIZE) {
+        write_property_multiple_store(store);
+    }
+    entry = &store->entry[store->count];
+    entry->object_type = wp_data->object_type;
+    entry->object_instance = wp_data->object_instance;
+    entry->offset = offset;
+    store->count++;
+}
+
 /** Decoding for an object property.
  *
  * @param apdu [in] The contents of the APDU buffer.
  * @param apdu_len [in] The length of the APDU buffer.
  * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure.
  * @param device_write_property - Device object WriteProperty function
+ * @param store [in,out] Where the applied writes are recorded, or NULL
  *
  * @return number of bytes decoded, or BACNET_STATUS_REJECT,
  *  or BACNET_STATUS_ERROR
@@ -41,10 +115,12 @@ static int write_property_multiple_decode(
     const uint8_t *apdu,
     uint16_t apdu_len,
     BACNET_WRITE_PROPERTY_DATA *wp_data,
-    write_property_function device_write_property)
+    write_property_function device_write_property,
+    struct wpm_store *store)
 {
     int len = 0;
     int offset = 0;
+    int property_offset = 0;
     uint8_t tag_number = 0;
 
     /* decode service request */
@@ -60,6 +136,7 @@ static int write_property_multiple_decode(
                       (3) an optional 'Property Array Index'
                       (4) a 'Property Value'
                       (5) an optional 'Priority' */
+                    property_offset = offset;
                     len = wpm_decode_object_property(
                         &apdu[offset], apdu_len - offset, wp_data);
                     if (len > 0) {
@@ -88,6 +165,10 @@ static int write_property_multiple_decode(
                                 }
                                 return BACNET_STATUS_ERROR;
                             }
+                            if (store) {
+                                write_property_multiple_record(
+                                    store, wp_data, (uint16_t)property_offset);
+                            }
                         }
                     } else {
                         debug_printf_stderr("WPM: Bad Encoding!\n");
@@ -124,6 +205,10 @@ static int write_property_multiple_decode(
  * - an ACK if Device_Write_Property_Multiple() succeeds
  * - an Error if Device_Write_PropertyMultiple() encounters an error
  *
+ * The writes are applied as one batch: the values are stored, and the
+ * database revision is incremented, after the writes were applied. A write
+ * that fails ends the batch, and the writes before it stay applied.
+ *
  * @param service_request [in] The contents of the service request.
  * @param service_len [in] The length of the service_request.
  * @param src [in] BACNET_ADDRESS of the source of the message
@@ -160,10 +245,17 @@ void handler_write_property_multiple(
     } else {
         /* first time - detect malformed request before writing any data */
         len = write_property_multiple_decode(
-            service_request, service_len, &wp_data, NULL);
+            service_request, service_len, &wp_data, NULL, NULL);
         if (len > 0) {
+            Device_Write_Property_Batch_Begin();
+            WPM_Store.apdu = service_request;
+            WPM_Store.apdu_len = service_len;
+            WPM_Store.count = 0;
             len = write_property_multiple_decode(
-                service_request, service_len, &wp_data, Device_Write_Property);
+                service_request, service_len, &wp_data, Device_Write_Property,
+                &WPM_Store);
+            write_property_multiple_store(&WPM_Store);
+            (void)Device_Write_Property_Batch_End();
         }
     }
     /* encode the confirmed reply */
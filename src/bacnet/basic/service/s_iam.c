@@ -7,6 +7,7 @@
  */
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -191,3 +192,268 @@ void Send_I_Am_Unicast(uint8_t *buffer, const BACNET_ADDRESS *src)
         debug_perror("Failed to Send I-Am Reply");
     }
 }
+
+/* I-Am replies to Who-Is waiting in the schedule. The links are the
+   index of the next entry plus one, so that 0 ends a list. */
+#if (BACNET_IAM_SCHEDULE_SIZE > 65534)
+#error "BACNET_IAM_SCHEDULE_SIZE must fit the 16-bit schedule links"
+#endif
+struct iam_schedule_entry {
+    /* next entry of the same device chain, or of the free list */
+    uint16_t next;
+    /* next entry in the order the replies were queued */
+    uint16_t next_pending;
+    uint16_t delay_ms;
+    uint32_t device_id;
+    int segmentation;
+    uint16_t vendor_id;
+    BACNET_ADDRESS dest;
+    BACNET_ADDRESS my_address;
+};
+static struct iam_schedule_entry I_Am_Schedule[BACNET_IAM_SCHEDULE_SIZE];
+/* first pending entry of each device chain */
+static uint16_t I_Am_Schedule_Bucket[BACNET_IAM_SCHEDULE_BUCKETS];
+static uint16_t I_Am_Schedule_Head;
+static uint16_t I_Am_Schedule_Tail;
+static uint16_t I_Am_Schedule_Free;
+/* number of entries taken from the array; the rest were never used */
+static uint16_t I_Am_Schedule_Top;
+static unsigned I_Am_Schedule_Count;
+static uint16_t I_Am_Window_Ms;
+static uint16_t I_Am_Rate;
+static uint16_t I_Am_Burst = 1;
+/* tokens of the rate limit, in thousandths of an I-Am */
+static uint32_t I_Am_Tokens = 1000;
+static uint32_t I_Am_Coalesced;
+static uint32_t I_Am_Dropped;
+
+/**
+ * @brief Set the window within which I-Am replies to Who-Is are spread
+ *  at random, so that many devices, or the many virtual devices of a
+ *  gateway, do not all answer a global Who-Is at once.
+ * @param milliseconds - window width, or 0 to reply immediately
+ */
+void Send_I_Am_Window_Set(uint16_t milliseconds)
+{
+    I_Am_Window_Ms = milliseconds;
+}
+
+/**
+ * @brief Get the window within which I-Am replies to Who-Is are spread
+ * @return window width in milliseconds, 0 when replies are immediate
+ */
+uint16_t Send_I_Am_Window(void)
+{
+    return I_Am_Window_Ms;
+}
+
+/**
+ * @brief Limit the rate of scheduled I-Am replies with a token bucket
+ * @param per_second - replies sent per second on average, 0 for no limit
+ * @param burst - replies that may be sent back to back, at least 1
+ */
+void Send_I_Am_Rate_Set(uint16_t per_second, uint16_t burst)
+{
+    I_Am_Rate = per_second;
+    I_Am_Burst = burst ? burst : 1;
+    I_Am_Tokens = (uint32_t)I_Am_Burst * 1000UL;
+}
+
+/**
+ * @brief Get the number of scheduled I-Am replies not sent yet
+ * @return number of pending replies
+ */
+unsigned Send_I_Am_Pending(void)
+{
+    return I_Am_Schedule_Count;
+}
+
+/**
+ * @brief Get the number of I-Am replies merged into one already pending
+ *  for the same device and destination
+ * @return number of coalesced replies
+ */
+uint32_t Send_I_Am_Coalesced(void)
+{
+    return I_Am_Coalesced;
+}
+
+/**
+ * @brief Get the number of I-Am replies dropped because the schedule
+ *  was full
+ * @return number of dropped replies
+ */
+uint32_t Send_I_Am_Dropped(void)
+{
+    return I_Am_Dropped;
+}
+
+/**
+ * @brief Send one scheduled I-Am reply
+ * @param entry - the scheduled reply
+ */
+static void Send_I_Am_Entry(struct iam_schedule_entry *entry)
+{
+    int len = 0;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+    BACNET_NPDU_DATA npdu_data;
+
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], &entry->dest, &entry->my_address,
+        &npdu_data);
+    len = iam_encode_apdu(
+        &Handler_Transmit_Buffer[pdu_len], entry->device_id, MAX_APDU,
+        entry->segmentation, entry->vendor_id);
+    pdu_len += len;
+    bytes_sent = datalink_send_pdu(
+        &entry->dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent <= 0) {
+        debug_perror("Failed to Send I-Am Reply");
+    }
+}
+
+/**
+ * @brief Reply to a Who-Is with an I-Am for the current device.
+ *
+ * Without a window the reply is sent immediately. Otherwise it is queued
+ * with a random delay within the window, and sent by Send_I_Am_Timer()
+ * within the rate limit. A reply already pending for the same device and
+ * destination absorbs the new one, so repeated Who-Is within the window
+ * get a single I-Am.
+ *
+ * @param src - address to unicast the I-Am to, or NULL to broadcast it
+ */
+void Send_I_Am_Reply(const BACNET_ADDRESS *src)
+{
+    struct iam_schedule_entry *entry;
+    BACNET_ADDRESS dest;
+    uint32_t device_id;
+    uint16_t *bucket;
+    uint16_t index;
+
+    if (I_Am_Window_Ms == 0) {
+        if (src) {
+            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+        } else {
+            Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+        }
+        return;
+    }
+    if (src) {
+        bacnet_address_copy(&dest, src);
+    } else {
+        datalink_get_broadcast_address(&dest);
+    }
+    device_id = Device_Object_Instance_Number();
+    bucket = &I_Am_Schedule_Bucket[device_id % BACNET_IAM_SCHEDULE_BUCKETS];
+    for (index = *bucket; index; index = entry->next) {
+        entry = &I_Am_Schedule[index - 1];
+        if ((entry->device_id == device_id) &&
+            bacnet_address_same(&entry->dest, &dest)) {
+            I_Am_Coalesced++;
+            return;
+        }
+    }
+    if (I_Am_Schedule_Free) {
+        index = I_Am_Schedule_Free;
+        I_Am_Schedule_Free = I_Am_Schedule[index - 1].next;
+    } else if (I_Am_Schedule_Top < BACNET_IAM_SCHEDULE_SIZE) {
+        I_Am_Schedule_Top++;
+        index = I_Am_Schedule_Top;
+    } else {
+        I_Am_Dropped++;
+        debug_print("I-Am: schedule full!\n");
+        return;
+    }
+    entry = &I_Am_Schedule[index - 1];
+    entry->device_id = device_id;
+    entry->segmentation = Device_Segmentation_Supported();
+    entry->vendor_id = Device_Vendor_Identifier();
+    bacnet_address_copy(&entry->dest, &dest);
+    /* the source address of a routed virtual device */
+    datalink_get_my_address(&entry->my_address);
+    entry->delay_ms = (uint16_t)(rand() % I_Am_Window_Ms);
+    entry->next = *bucket;
+    *bucket = index;
+    entry->next_pending = 0;
+    if (I_Am_Schedule_Tail) {
+        I_Am_Schedule[I_Am_Schedule_Tail - 1].next_pending = index;
+    } else {
+        I_Am_Schedule_Head = index;
+    }
+    I_Am_Schedule_Tail = index;
+    I_Am_Schedule_Count++;
+}
+
+/**
+ * @brief Take a sent reply out of the schedule
+ * @param index - the link of the entry
+ * @param prev - the link of the entry queued before it, or 0
+ */
+static void Send_I_Am_Schedule_Remove(uint16_t index, uint16_t prev)
+{
+    struct iam_schedule_entry *entry = &I_Am_Schedule[index - 1];
+    uint16_t *link;
+
+    if (prev) {
+        I_Am_Schedule[prev - 1].next_pending = entry->next_pending;
+    } else {
+        I_Am_Schedule_Head = entry->next_pending;
+    }
+    if (I_Am_Schedule_Tail == index) {
+        I_Am_Schedule_Tail = prev;
+    }
+    link =
+        &I_Am_Schedule_Bucket[entry->device_id % BACNET_IAM_SCHEDULE_BUCKETS];
+    while (*link != index) {
+        link = &I_Am_Schedule[*link - 1].next;
+    }
+    *link = entry->next;
+    entry->next = I_Am_Schedule_Free;
+    I_Am_Schedule_Free = index;
+    I_Am_Schedule_Count--;
+}
+
+/**
+ * @brief Send the scheduled I-Am replies that are due, within the rate
+ *  limit. Call this periodically, e.g. along with the TSM timer.
+ * @param milliseconds - time elapsed since the last call
+ */
+void Send_I_Am_Timer(uint16_t milliseconds)
+{
+    struct iam_schedule_entry *entry;
+    uint32_t tokens_max;
+    uint16_t index;
+    uint16_t prev = 0;
+    uint16_t next;
+
+    tokens_max = (uint32_t)I_Am_Burst * 1000UL;
+    if (I_Am_Tokens < tokens_max) {
+        I_Am_Tokens += (uint32_t)milliseconds * I_Am_Rate;
+        if (I_Am_Tokens > tokens_max) {
+            I_Am_Tokens = tokens_max;
+        }
+    }
+    for (index = I_Am_Schedule_Head; index; index = next) {
+        entry = &I_Am_Schedule[index - 1];
+        next = entry->next_pending;
+        if (entry->delay_ms > milliseconds) {
+            entry->delay_ms -= milliseconds;
+            prev = index;
+            continue;
+        }
+        entry->delay_ms = 0;
+        if (I_Am_Rate) {
+            if (I_Am_Tokens < 1000) {
+                /* due, but wait for the bucket to refill */
+                prev = index;
+                continue;
+            }
+            I_Am_Tokens -= 1000;
+        }
+        Send_I_Am_Entry(entry);
+        Send_I_Am_Schedule_Remove(index, prev);
+    }
+}
@@ -22,6 +22,17 @@
 #include "bacnet/bacapp.h"
 #include "bacnet/npdu.h"
 
+/* number of I-Am replies to Who-Is that may wait for their turn,
+   see Send_I_Am_Window_Set() */
+#ifndef BACNET_IAM_SCHEDULE_SIZE
+#define BACNET_IAM_SCHEDULE_SIZE (MAX_NUM_DEVICES * 4)
+#endif
+/* number of chains that the pending replies are kept in, by the instance
+   number of their device, so that a Who-Is only looks at its own device */
+#ifndef BACNET_IAM_SCHEDULE_BUCKETS
+#define BACNET_IAM_SCHEDULE_BUCKETS MAX_NUM_DEVICES
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -49,6 +60,23 @@ int iam_unicast_encode_pdu(
 BACNET_STACK_EXPORT
 void Send_I_Am_Unicast(uint8_t *buffer, const BACNET_ADDRESS *src);
 
+BACNET_STACK_EXPORT
+void Send_I_Am_Reply(const BACNET_ADDRESS *src);
+BACNET_STACK_EXPORT
+void Send_I_Am_Timer(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void Send_I_Am_Window_Set(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+uint16_t Send_I_Am_Window(void);
+BACNET_STACK_EXPORT
+void Send_I_Am_Rate_Set(uint16_t per_second, uint16_t burst);
+BACNET_STACK_EXPORT
+unsigned Send_I_Am_Pending(void);
+BACNET_STACK_EXPORT
+uint32_t Send_I_Am_Coalesced(void);
+BACNET_STACK_EXPORT
+uint32_t Send_I_Am_Dropped(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,235 @@
+/**
+ * @file
+ * @brief A memory arena, where many small allocations are taken from
+ *  a few blocks of memory and all freed at once.
+ *
+ * Allocations are taken in order from the buffer given at init, and then
+ * from blocks allocated on demand, so that allocations made one after the
+ * other sit next to each other in memory. Resetting the arena takes O(1),
+ * and keeps the blocks for the next use of the arena.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/basic/sys/arena.h"
+
+/* a block of memory allocated when the arena runs out of room,
+   followed by its data */
+struct arena_block_t {
+    struct arena_block_t *next;
+    size_t size;
+};
+
+/* room for the block header, keeping the data after it aligned */
+#define ARENA_BLOCK_HEADER_SIZE                                             \
+    (((sizeof(struct arena_block_t) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT) * \
+     ARENA_ALIGNMENT)
+
+/**
+ * @brief Get the number of bytes needed to align the next allocation
+ * @param data [in] block of memory
+ * @param used [in] number of bytes in use in the block
+ * @return number of padding bytes
+ */
+static size_t arena_padding(const uint8_t *data, size_t used)
+{
+    uintptr_t address = (uintptr_t)(data + used);
+
+    return (size_t)((ARENA_ALIGNMENT - (address % ARENA_ALIGNMENT)) %
+                    ARENA_ALIGNMENT);
+}
+
+/**
+ * @brief Determine if an allocation fits in the block being allocated from
+ * @param arena [in] memory arena
+ * @param size [in] number of bytes to allocate
+ * @return true if the allocation fits
+ */
+static bool arena_fits(const MEMORY_ARENA *arena, size_t size)
+{
+    size_t padding;
+
+    if (!arena->data) {
+        return false;
+    }
+    padding = arena_padding(arena->data, arena->used);
+    if (arena->used + padding > arena->size) {
+        return false;
+    }
+
+    return (size <= (arena->size - arena->used - padding));
+}
+
+/**
+ * @brief Make a block the one being allocated from
+ * @param arena [in] memory arena
+ * @param block [in] block to allocate from
+ */
+static void arena_block_select(MEMORY_ARENA *arena, struct arena_block_t *block)
+{
+    arena->block = block;
+    arena->data = (uint8_t *)block + ARENA_BLOCK_HEADER_SIZE;
+    arena->size = block->size;
+    arena->used = 0;
+}
+
+/**
+ * @brief Move to the next block that has room for an allocation,
+ *  allocating a new block if none of the kept blocks has room.
+ * @param arena [in] memory arena
+ * @param size [in] number of bytes to allocate
+ * @return true if a block with room was found
+ */
+static bool arena_block_next(MEMORY_ARENA *arena, size_t size)
+{
+    struct arena_block_t *block;
+    struct arena_block_t *last = NULL;
+    size_t block_size;
+
+    /* blocks after the current one were kept from before a reset */
+    if (arena->block) {
+        block = arena->block->next;
+        last = arena->block;
+    } else {
+        block = arena->blocks;
+    }
+    while (block) {
+        /* aligned data, so no padding is needed for the first allocation */
+        if (size <= block->size) {
+            arena_block_select(arena, block);
+            return true;
+        }
+        last = block;
+        block = block->next;
+    }
+    if (arena->block_size == 0) {
+        return false;
+    }
+    block_size = arena->block_size;
+    if (size > block_size) {
+        block_size = size;
+    }
+    block = malloc(ARENA_BLOCK_HEADER_SIZE + block_size);
+    if (!block) {
+        return false;
+    }
+    block->next = NULL;
+    block->size = block_size;
+    if (last) {
+        last->next = block;
+    } else {
+        arena->blocks = block;
+    }
+    arena_block_select(arena, block);
+
+    return true;
+}
+
+/**
+ * @brief Initialize a memory arena
+ * @param arena [in] memory arena
+ * @param buffer [in] first block of memory to allocate from, or NULL
+ * @param buffer_size [in] size, in bytes, of the first block of memory
+ * @param block_size [in] size, in bytes, of the blocks allocated with
+ *  malloc() once the first block is full, or 0 to only use the buffer
+ */
+void arena_init(
+    MEMORY_ARENA *arena, void *buffer, size_t buffer_size, size_t block_size)
+{
+    if (arena) {
+        arena->buffer = buffer;
+        arena->buffer_size = buffer ? buffer_size : 0;
+        arena->block_size = block_size;
+        arena->blocks = NULL;
+        arena_reset(arena);
+    }
+}
+
+/**
+ * @brief Allocate zeroed memory from a memory arena
+ * @param arena [in] memory arena
+ * @param size [in] number of bytes to allocate
+ * @return aligned and zeroed memory, or NULL if there is no room
+ */
+void *arena_alloc(MEMORY_ARENA *arena, size_t size)
+{
+    uint8_t *data;
+
+    if (!arena || (size == 0)) {
+        return NULL;
+    }
+    if (!arena_fits(arena, size)) {
+        if (!arena_block_next(arena, size)) {
+            return NULL;
+        }
+    }
+    arena->used += arena_padding(arena->data, arena->used);
+    data = &arena->data[arena->used];
+    arena->used += size;
+    arena->count += size;
+    memset(data, 0, size);
+
+    return data;
+}
+
+/**
+ * @brief Free every allocation of a memory arena at once. The blocks
+ *  allocated on demand are kept for the next allocations.
+ * @param arena [in] memory arena
+ */
+void arena_reset(MEMORY_ARENA *arena)
+{
+    if (arena) {
+        arena->data = arena->buffer;
+        arena->size = arena->buffer_size;
+        arena->used = 0;
+        arena->count = 0;
+        arena->block = NULL;
+    }
+}
+
+/**
+ * @brief Free every allocation of a memory arena, and the blocks
+ *  allocated on demand.
+ * @param arena [in] memory arena
+ */
+void arena_free(MEMORY_ARENA *arena)
+{
+    struct arena_block_t *block;
+    struct arena_block_t *next;
+
+    if (arena) {
+        block = arena->blocks;
+        while (block) {
+            next = block->next;
+            free(block);
+            block = next;
+        }
+        arena->blocks = NULL;
+        arena_reset(arena);
+    }
+}
+
+/**
+ * @brief Get the number of bytes allocated since the arena was reset
+ * @param arena [in] memory arena
+ * @return number of bytes allocated, not counting alignment padding
+ */
+size_t arena_count(const MEMORY_ARENA *arena)
+{
+    return (arena ? arena->count : 0);
+}
+
+/**
+ * @brief Determine if nothing is allocated from a memory arena
+ * @param arena [in] memory arena
+ * @return true if nothing is allocated
+ */
+bool arena_empty(const MEMORY_ARENA *arena)
+{
+    return (arena ? (arena->count == 0) : true);
+}
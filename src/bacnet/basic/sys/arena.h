@@ -0,0 +1,58 @@
+/**
+ * @file
+ * @brief API for a memory arena, where many small allocations are taken
+ *  from a few blocks of memory and all freed at once.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_ARENA_H
+#define BACNET_SYS_ARENA_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* alignment, in bytes, of every allocation */
+#ifndef ARENA_ALIGNMENT
+#define ARENA_ALIGNMENT 8
+#endif
+
+/* a block of memory allocated when the arena runs out of room */
+struct arena_block_t;
+
+struct memory_arena_t {
+    uint8_t *buffer; /* first block of memory, given at init, or NULL */
+    size_t buffer_size; /* size, in bytes, of the first block */
+    uint8_t *data; /* block being allocated from */
+    size_t size; /* size, in bytes, of the block being allocated from */
+    size_t used; /* bytes in use in the block being allocated from */
+    size_t count; /* bytes handed out since the arena was reset */
+    size_t block_size; /* size of the blocks allocated on demand, or 0 */
+    struct arena_block_t *blocks; /* blocks allocated on demand */
+    struct arena_block_t *block; /* block being allocated from, or NULL */
+};
+typedef struct memory_arena_t MEMORY_ARENA;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void arena_init(
+    MEMORY_ARENA *arena, void *buffer, size_t buffer_size, size_t block_size);
+BACNET_STACK_EXPORT
+void *arena_alloc(MEMORY_ARENA *arena, size_t size);
+BACNET_STACK_EXPORT
+void arena_reset(MEMORY_ARENA *arena);
+BACNET_STACK_EXPORT
+void arena_free(MEMORY_ARENA *arena);
+BACNET_STACK_EXPORT
+size_t arena_count(const MEMORY_ARENA *arena);
+BACNET_STACK_EXPORT
+bool arena_empty(const MEMORY_ARENA *arena);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -33,6 +33,10 @@ static uint8_t Duplicate_Count = 0;
 
 /* Indirection of state machine data with peer unique id values */
 static BACNET_TSM_INDIRECT_DATA TSM_Peer_Ids[MAX_TSM_PEERS];
+
+/* NPDU header of the SegmentACK and Abort replies, which are
+   usually sent to the same peer many times in a row */
+static BACNET_NPDU_HEADER Reply_NPDU_Header;
 #endif // BACNET_SEGMENTATION_ENABLED
 
 /** @file tsm.c  BACnet Transaction State Machine operations  */
@@ -381,7 +385,9 @@ void segmentack_pdu_send(
     uint8_t Transmit_Buffer[MAX_PDU] = { 0 };
     datalink_get_my_address(&my_address);
     npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
-    npdu_len = npdu_encode_pdu(&Transmit_Buffer[0], dest, &my_address, &npdu_data);
+    npdu_len = npdu_header_encode(
+        &Reply_NPDU_Header, &Transmit_Buffer[0], dest, &my_address,
+        &npdu_data);
     apdu_len = segmentack_encode_apdu(
         &Transmit_Buffer[npdu_len], negativeack, server, invoke_id,
         sequence_number, actual_window_size);
@@ -676,7 +682,9 @@ void abort_pdu_send(
 
     datalink_get_my_address(&my_address);
     npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
-    npdu_len = npdu_encode_pdu(&Transmit_Buffer[0], dest, &my_address, &npdu_data);
+    npdu_len = npdu_header_encode(
+        &Reply_NPDU_Header, &Transmit_Buffer[0], dest, &my_address,
+        &npdu_data);
     apdu_len = abort_encode_apdu(
         &Transmit_Buffer[npdu_len], invoke_id, reason, server);
     pdu_len = apdu_len + npdu_len;
@@ -976,9 +984,9 @@ int tsm_pdu_send(BACNET_TSM_DATA *tsm_data, uint32_t segment_number)
 
     /* Rebuild PDU */
     datalink_get_my_address(&my_address);
-    len = npdu_encode_pdu(
-        &Transmit_Buffer[pdu_len], &tsm_data->dest, &my_address,
-        &tsm_data->npdu_data);
+    len = npdu_header_encode(
+        &tsm_data->npdu_header, &Transmit_Buffer[pdu_len], &tsm_data->dest,
+        &my_address, &tsm_data->npdu_data);
     if (len < 0) {
         return -1;
     }
@@ -112,6 +112,8 @@ typedef struct BACnet_TSM_Data {
     uint32_t apdu_blob_size;
     /* Count received segments (prevents D.O.S.) */
     uint32_t ReceivedSegmentsCount;
+    /* NPDU header, encoded once for all segments and retries */
+    BACNET_NPDU_HEADER npdu_header;
 #endif
 } BACNET_TSM_DATA;
 
@@ -86,6 +86,9 @@ bool bip_get_addr(BACNET_IP_ADDRESS *addr);
 
 BACNET_STACK_EXPORT
 bool bip_get_addr_by_name(const char *host_name, BACNET_IP_ADDRESS *addr);
+BACNET_STACK_EXPORT
+bool bip_get_addr_by_name_async(
+    const char *host_name, BACNET_IP_ADDRESS *addr);
 
 BACNET_STACK_EXPORT
 bool bip_set_broadcast_addr(const BACNET_IP_ADDRESS *addr);
@@ -83,6 +83,12 @@ BACNET_STACK_EXPORT
 int bip6_send_mpdu(
     const BACNET_IP6_ADDRESS *addr, const uint8_t *mtu, uint16_t mtu_len);
 BACNET_STACK_EXPORT
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len);
+BACNET_STACK_EXPORT
 bool bip6_send_pdu_queue_empty(void);
 BACNET_STACK_EXPORT
 void bip6_receive_callback(void);
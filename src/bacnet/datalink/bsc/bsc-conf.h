@@ -68,10 +68,35 @@
 #define BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM (BSC_CONF_HUB_FUNCTIONS_NUM * 10)
 #endif
 
+/* number of buckets in the VMAC and UUID indexes of a hub function, */
+/* one per connection keeps the chains short for large hubs */
+#ifndef BSC_CONF_HUB_FUNCTION_HASH_SIZE
+#define BSC_CONF_HUB_FUNCTION_HASH_SIZE BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM
+#endif
+
 #ifndef BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM
 #define BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM 10
 #endif
 
+/* Unicast PDUs sent to one peer through the hub within one traffic */
+/* window after which the node switch opens a direct connection to that */
+/* peer on its own. Such pooled connections are closed least recently */
+/* used first when the initiator runs out of sockets. 0 disables it. */
+#ifndef BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD
+#define BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD 0
+#endif
+
+/* number of peers whose hub traffic is tracked for auto connection */
+#ifndef BSC_CONF_NODE_SWITCH_TRAFFIC_NUM
+#define BSC_CONF_NODE_SWITCH_TRAFFIC_NUM \
+    (BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM * 2)
+#endif
+
+/* the tracked traffic counters are halved every window */
+#ifndef BSC_CONF_NODE_SWITCH_TRAFFIC_WINDOW_S
+#define BSC_CONF_NODE_SWITCH_TRAFFIC_WINDOW_S 10
+#endif
+
 /* Total amount of client(initiator) webosocket connections */
 #ifndef BSC_CONF_CLIENT_CONNECTIONS_NUM
 #define BSC_CONF_CLIENT_CONNECTIONS_NUM       \
@@ -89,7 +114,24 @@
     (BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM * BSC_CONF_NODE_SWITCHES_NUM)
 #endif
 
+/* number of VMAC to URIs address resolutions a node caches, */
+/* each one is kept for the address resolution freshness timeout */
+#ifndef BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM
+#define BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM \
+    BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM
+#endif
+
+#ifndef BSC_CONF_SOCKET_TX_BUFFERED_PACKET_NUM
 #define BSC_CONF_SOCKET_TX_BUFFERED_PACKET_NUM 2
+#endif
+
+/* Shared PDUs are encoded once and queued by reference to many sockets, */
+/* e.g. broadcasts forwarded by a hub function. A queued reference takes */
+/* only 2 bytes of a socket TX buffer. */
+#ifndef BSC_CONF_SHARED_PDU_NUM
+#define BSC_CONF_SHARED_PDU_NUM 4
+#endif
+
 #define BSC_CONF_DATALINK_BUFFERED_PACKET_NUM 10
 
 #define BSC_CONF_SOCK_RX_BUFFER_SIZE BVLC_SC_NPDU_SIZE_CONF
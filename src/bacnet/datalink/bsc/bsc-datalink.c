@@ -75,7 +75,8 @@ static void bsc_node_event(
     uint8_t *pdu,
     size_t pdu_len)
 {
-    uint16_t pdu16_len;
+    uint16_t npdu16_len;
+    BVLC_SC_MESSAGE_VIEW view;
     DEBUG_PRINTF("bsc_node_event() >>> ev = %d\n", ev);
     bws_dispatch_lock();
     (void)node;
@@ -85,13 +86,22 @@ static void bsc_node_event(
             bsc_event_signal(bsc_event);
         }
     } else if (ev == BSC_NODE_EVENT_RECEIVED_NPDU) {
+        /* the message was already validated by the socket layer, so only */
+        /* locate origin and NPDU in place and queue just those, */
+        /* bsc_receive() then pulls them straight into the caller buffers */
         if (bsc_datalink_state == BSC_DATALINK_STATE_STARTED) {
-            if (pdu_len <= USHRT_MAX &&
+            if (bvlc_sc_decode_message_view(pdu, pdu_len, &view) &&
+                view.origin_offset && view.payload_len &&
+                view.payload_len <= USHRT_MAX &&
                 FIFO_Available(
-                    &bsc_fifo, (unsigned)(pdu_len + sizeof(pdu16_len)))) {
-                pdu16_len = (uint16_t)pdu_len;
-                FIFO_Add(&bsc_fifo, (uint8_t *)&pdu16_len, sizeof(pdu16_len));
-                FIFO_Add(&bsc_fifo, pdu, pdu16_len);
+                    &bsc_fifo,
+                    (unsigned)(view.payload_len + sizeof(npdu16_len) +
+                               BVLC_SC_VMAC_SIZE))) {
+                npdu16_len = (uint16_t)view.payload_len;
+                FIFO_Add(&bsc_fifo, (uint8_t *)&npdu16_len, sizeof(npdu16_len));
+                FIFO_Add(
+                    &bsc_fifo, &pdu[view.origin_offset], BVLC_SC_VMAC_SIZE);
+                FIFO_Add(&bsc_fifo, &pdu[view.payload_offset], npdu16_len);
                 bsc_event_signal(bsc_data_event);
             }
 #if DEBUG_ENABLED == 1
@@ -307,11 +317,6 @@ uint16_t bsc_receive(
 {
     uint16_t pdu_len = 0;
     uint16_t npdu16_len = 0;
-    BVLC_SC_DECODED_MESSAGE dm;
-    uint16_t error_code;
-    uint16_t error_class;
-    const char *err_desc = NULL;
-    static uint8_t buf[BVLC_SC_NPDU_SIZE_CONF];
 
     DEBUG_PRINTF("bsc_receive() >>>\n");
 
@@ -329,42 +334,17 @@ uint16_t bsc_receive(
             DEBUG_PRINTF("bsc_receive() processing data...\n");
             FIFO_Pull(&bsc_fifo, (uint8_t *)&npdu16_len, sizeof(npdu16_len));
 
-            if (sizeof(buf) < npdu16_len) {
-                PRINTF("bsc_receive() pdu of size %d is dropped\n", npdu16_len);
-                bsc_remove_packet(npdu16_len);
+            if (max_pdu < npdu16_len) {
+                PRINTF(
+                    "bsc_receive() pdu of size %d is dropped because "
+                    "output buf of size %d is to small\n",
+                    npdu16_len, max_pdu);
+                bsc_remove_packet(BVLC_SC_VMAC_SIZE + npdu16_len);
             } else {
-                FIFO_Pull(&bsc_fifo, buf, npdu16_len);
-                if (!bvlc_sc_decode_message(
-                        buf, npdu16_len, &dm, &error_code, &error_class,
-                        &err_desc)) {
-                    PRINTF(
-                        "bsc_receive() pdu of size %d is dropped because "
-                        "of err = %d, class %d, desc = %s\n",
-                        npdu16_len, error_code, error_class, err_desc);
-                    bsc_remove_packet(npdu16_len);
-                } else {
-                    if (dm.hdr.origin &&
-                        max_pdu >= dm.payload.encapsulated_npdu.npdu_len) {
-                        src->mac_len = BVLC_SC_VMAC_SIZE;
-                        memcpy(
-                            &src->mac[0], &dm.hdr.origin->address[0],
-                            BVLC_SC_VMAC_SIZE);
-                        memcpy(
-                            pdu, dm.payload.encapsulated_npdu.npdu,
-                            dm.payload.encapsulated_npdu.npdu_len);
-                        pdu_len =
-                            (uint16_t)dm.payload.encapsulated_npdu.npdu_len;
-                    }
-#if DEBUG_ENABLED == 1
-                    else {
-                        PRINTF(
-                            "bsc_receive() pdu of size %d is dropped "
-                            "because origin addr is absent or output "
-                            "buf of size %d is to small\n",
-                            npdu16_len, max_pdu);
-                    }
-#endif
-                }
+                src->mac_len = BVLC_SC_VMAC_SIZE;
+                FIFO_Pull(&bsc_fifo, &src->mac[0], BVLC_SC_VMAC_SIZE);
+                FIFO_Pull(&bsc_fifo, pdu, npdu16_len);
+                pdu_len = npdu16_len;
             }
             DEBUG_PRINTF("bsc_receive() pdu_len = %d\n", pdu_len);
         }
@@ -57,11 +57,30 @@ typedef enum {
     BSC_HUB_FUNCTION_STATE_STOPPING = 3
 } BSC_HUB_FUNCTION_STATE;
 
+#if BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM >= 0xFFFF
+#error "BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM must be less than 65535"
+#endif
+
+/* index of a socket in the hub function socket array */
+typedef uint16_t BSC_HUB_SOCKET_INDEX;
+#define BSC_HUB_SOCKET_NONE ((BSC_HUB_SOCKET_INDEX)0xFFFF)
+
+/* hash chain links of a connected socket */
+typedef struct BSC_Hub_Socket_Link {
+    BSC_HUB_SOCKET_INDEX vmac_next;
+    BSC_HUB_SOCKET_INDEX uuid_next;
+    bool indexed;
+} BSC_HUB_SOCKET_LINK;
+
 typedef struct BSC_Hub_Connector {
     bool used;
     BSC_SOCKET_CTX ctx;
     BSC_CONTEXT_CFG cfg;
     BSC_SOCKET sock[BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM];
+    /* connected sockets indexed by peer VMAC and peer UUID */
+    BSC_HUB_SOCKET_LINK link[BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM];
+    BSC_HUB_SOCKET_INDEX vmac_hash[BSC_CONF_HUB_FUNCTION_HASH_SIZE];
+    BSC_HUB_SOCKET_INDEX uuid_hash[BSC_CONF_HUB_FUNCTION_HASH_SIZE];
     BSC_HUB_FUNCTION_STATE state;
     BSC_HUB_EVENT_FUNC event_func;
     void *user_arg;
@@ -104,6 +123,105 @@ static void hub_function_free(BSC_HUB_FUNCTION *p)
     p->used = false;
 }
 
+/**
+ * @brief Compute the hash bucket for a block of address bytes
+ * @param data - pointer to the VMAC or UUID bytes
+ * @param len - number of bytes
+ * @return bucket index in the hub function hash tables
+ */
+static unsigned hub_function_hash(const uint8_t *data, size_t len)
+{
+    uint32_t hash = 2166136261UL;
+    size_t i;
+
+    /* FNV-1a: VMACs are often sequential, so mix every byte */
+    for (i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+
+    return (unsigned)(hash % BSC_CONF_HUB_FUNCTION_HASH_SIZE);
+}
+
+/**
+ * @brief Clear the VMAC and UUID indexes of a hub function
+ * @param f - pointer to the hub function
+ */
+static void hub_function_index_clear(BSC_HUB_FUNCTION *f)
+{
+    size_t i;
+
+    for (i = 0; i < BSC_CONF_HUB_FUNCTION_HASH_SIZE; i++) {
+        f->vmac_hash[i] = BSC_HUB_SOCKET_NONE;
+        f->uuid_hash[i] = BSC_HUB_SOCKET_NONE;
+    }
+    for (i = 0; i < BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM; i++) {
+        f->link[i].vmac_next = BSC_HUB_SOCKET_NONE;
+        f->link[i].uuid_next = BSC_HUB_SOCKET_NONE;
+        f->link[i].indexed = false;
+    }
+}
+
+/**
+ * @brief Add a connected socket to the VMAC and UUID indexes
+ * @param f - pointer to the hub function
+ * @param c - pointer to the socket, which has its peer VMAC and UUID set
+ */
+static void hub_function_index_add(BSC_HUB_FUNCTION *f, BSC_SOCKET *c)
+{
+    BSC_HUB_SOCKET_INDEX index = (BSC_HUB_SOCKET_INDEX)(c - &f->sock[0]);
+    unsigned bucket;
+
+    if (f->link[index].indexed) {
+        return;
+    }
+    /* newest connection first, so a peer that reconnected with the same
+       UUID is found ahead of the connection it replaces */
+    bucket = hub_function_hash(&c->vmac.address[0], sizeof(c->vmac.address));
+    f->link[index].vmac_next = f->vmac_hash[bucket];
+    f->vmac_hash[bucket] = index;
+    bucket = hub_function_hash(&c->uuid.uuid[0], sizeof(c->uuid.uuid));
+    f->link[index].uuid_next = f->uuid_hash[bucket];
+    f->uuid_hash[bucket] = index;
+    f->link[index].indexed = true;
+}
+
+/**
+ * @brief Remove a socket from the VMAC and UUID indexes
+ * @param f - pointer to the hub function
+ * @param c - pointer to the socket, which still has its peer VMAC and UUID
+ */
+static void hub_function_index_remove(BSC_HUB_FUNCTION *f, BSC_SOCKET *c)
+{
+    BSC_HUB_SOCKET_INDEX index = (BSC_HUB_SOCKET_INDEX)(c - &f->sock[0]);
+    BSC_HUB_SOCKET_INDEX *p;
+
+    if (!f->link[index].indexed) {
+        return;
+    }
+    p = &f->vmac_hash[hub_function_hash(
+        &c->vmac.address[0], sizeof(c->vmac.address))];
+    while (*p != BSC_HUB_SOCKET_NONE) {
+        if (*p == index) {
+            *p = f->link[index].vmac_next;
+            break;
+        }
+        p = &f->link[*p].vmac_next;
+    }
+    p = &f->uuid_hash[hub_function_hash(
+        &c->uuid.uuid[0], sizeof(c->uuid.uuid))];
+    while (*p != BSC_HUB_SOCKET_NONE) {
+        if (*p == index) {
+            *p = f->link[index].uuid_next;
+            break;
+        }
+        p = &f->link[*p].uuid_next;
+    }
+    f->link[index].vmac_next = BSC_HUB_SOCKET_NONE;
+    f->link[index].uuid_next = BSC_HUB_SOCKET_NONE;
+    f->link[index].indexed = false;
+}
+
 /**
  * @brief find a hub function connection for a specific VMAC address
  * @param vmac - pointer to the VMAC address
@@ -113,28 +231,32 @@ static void hub_function_free(BSC_HUB_FUNCTION *p)
 static BSC_SOCKET *hub_function_find_connection_for_vmac(
     BACNET_SC_VMAC_ADDRESS *vmac, void *user_arg)
 {
-    int i;
+    BSC_HUB_SOCKET_INDEX index;
     BSC_HUB_FUNCTION *f;
+    BSC_SOCKET *c = NULL;
 
     bws_dispatch_lock();
     f = (BSC_HUB_FUNCTION *)user_arg;
     DEBUG_PRINTF(
         "hubf = %p local_vmac = %s\n", f,
         bsc_vmac_to_string(&f->cfg.local_vmac));
-    for (i = 0; i < sizeof(f->sock) / sizeof(BSC_SOCKET); i++) {
+    index = f->vmac_hash[hub_function_hash(
+        &vmac->address[0], sizeof(vmac->address))];
+    while (index != BSC_HUB_SOCKET_NONE) {
         DEBUG_PRINTF(
-            "hubf = %p, sock %p, state = %d, vmac = %s\n", f, &f->sock[i],
-            f->sock[i].state, bsc_vmac_to_string(&f->sock[i].vmac));
-        if (f->sock[i].state != BSC_SOCK_STATE_IDLE &&
+            "hubf = %p, sock %p, state = %d, vmac = %s\n", f, &f->sock[index],
+            f->sock[index].state, bsc_vmac_to_string(&f->sock[index].vmac));
+        if (f->sock[index].state != BSC_SOCK_STATE_IDLE &&
             !memcmp(
-                &vmac->address[0], &f->sock[i].vmac.address[0],
+                &vmac->address[0], &f->sock[index].vmac.address[0],
                 sizeof(vmac->address))) {
-            bws_dispatch_unlock();
-            return &f->sock[i];
+            c = &f->sock[index];
+            break;
         }
+        index = f->link[index].vmac_next;
     }
     bws_dispatch_unlock();
-    return NULL;
+    return c;
 }
 
 /**
@@ -146,25 +268,30 @@ static BSC_SOCKET *hub_function_find_connection_for_vmac(
 static BSC_SOCKET *
 hub_function_find_connection_for_uuid(BACNET_SC_UUID *uuid, void *user_arg)
 {
-    int i;
+    BSC_HUB_SOCKET_INDEX index;
     BSC_HUB_FUNCTION *f;
+    BSC_SOCKET *c = NULL;
 
     bws_dispatch_lock();
     f = (BSC_HUB_FUNCTION *)user_arg;
-    for (i = 0; i < sizeof(f->sock) / sizeof(BSC_SOCKET); i++) {
+    index =
+        f->uuid_hash[hub_function_hash(&uuid->uuid[0], sizeof(uuid->uuid))];
+    while (index != BSC_HUB_SOCKET_NONE) {
         DEBUG_PRINTF(
-            "hubf = %p, sock %p, state = %d, uuid = %s\n", f, &f->sock[i],
-            f->sock[i].state, bsc_uuid_to_string(&f->sock[i].uuid));
-        if (f->sock[i].state != BSC_SOCK_STATE_IDLE &&
+            "hubf = %p, sock %p, state = %d, uuid = %s\n", f, &f->sock[index],
+            f->sock[index].state, bsc_uuid_to_string(&f->sock[index].uuid));
+        if (f->sock[index].state != BSC_SOCK_STATE_IDLE &&
             !memcmp(
-                &uuid->uuid[0], &f->sock[i].uuid.uuid[0], sizeof(uuid->uuid))) {
-            bws_dispatch_unlock();
+                &uuid->uuid[0], &f->sock[index].uuid.uuid[0],
+                sizeof(uuid->uuid))) {
             DEBUG_PRINTF("found socket\n");
-            return &f->sock[i];
+            c = &f->sock[index];
+            break;
         }
+        index = f->link[index].uuid_next;
     }
     bws_dispatch_unlock();
-    return NULL;
+    return c;
 }
 
 /**
@@ -280,6 +407,7 @@ static void hub_function_socket_event(
     int i;
     uint8_t *p_pdu;
     BSC_HUB_FUNCTION *f;
+    BSC_SHARED_PDU *shared;
     size_t len;
 
     DEBUG_PRINTF(
@@ -299,16 +427,20 @@ static void hub_function_socket_event(
                     p_pdu = bsc_socket_get_global_buf();
                     len = pdu_len;
                     memcpy(p_pdu, pdu, len);
-
+                    /* change origin address if presented or add origin */
+                    /* address into pdu by extending of it's header */
+                    len = bvlc_sc_set_orig(&p_pdu, len, &c->vmac);
+                    /* encode once and queue a reference to every */
+                    /* connection, copying only if no shared buffer is free */
+                    shared = bsc_shared_pdu_new(p_pdu, len);
                     for (i = 0; i < sizeof(f->sock) / sizeof(BSC_SOCKET); i++) {
                         if (&f->sock[i] != c &&
                             f->sock[i].state == BSC_SOCK_STATE_CONNECTED) {
-                            /* change origin address if presented or add origin
-                             */
-                            /* address into pdu by extending of it's header */
-                            len = (uint16_t)bvlc_sc_set_orig(
-                                &p_pdu, len, &c->vmac);
-                            ret = bsc_send(&f->sock[i], p_pdu, len);
+                            if (shared) {
+                                ret = bsc_send_shared(&f->sock[i], shared);
+                            } else {
+                                ret = bsc_send(&f->sock[i], p_pdu, len);
+                            }
                             (void)ret;
 #if DEBUG_ENABLED == 1
                             if (ret != BSC_SC_SUCCESS) {
@@ -320,6 +452,7 @@ static void hub_function_socket_event(
 #endif
                         }
                     }
+                    bsc_shared_pdu_release(shared);
                 }
 #if DEBUG_ENABLED == 1
                 else {
@@ -349,6 +482,7 @@ static void hub_function_socket_event(
             }
         }
     } else if (ev == BSC_SOCKET_EVENT_DISCONNECTED) {
+        hub_function_index_remove(f, c);
         hub_function_update_status(f, c, ev, reason, reason_desc);
         if (reason == ERROR_CODE_NODE_DUPLICATE_VMAC) {
             f->event_func(
@@ -356,6 +490,7 @@ static void hub_function_socket_event(
                 (BSC_HUB_FUNCTION_HANDLE)f, f->user_arg);
         }
     } else if (ev == BSC_SOCKET_EVENT_CONNECTED) {
+        hub_function_index_add(f, c);
         hub_function_update_status(f, c, ev, reason, reason_desc);
     }
     bws_dispatch_unlock();
@@ -454,6 +589,7 @@ BSC_SC_RET bsc_hub_function_start(
 
     f->user_arg = user_arg;
     f->event_func = event_func;
+    hub_function_index_clear(f);
 
     bsc_init_ctx_cfg(
         BSC_SOCKET_CTX_ACCEPTOR, &f->cfg, BSC_WEBSOCKET_HUB_PROTOCOL, port,
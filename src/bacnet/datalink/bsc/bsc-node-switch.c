@@ -95,6 +95,14 @@ typedef struct {
     int url_elem;
 } BSC_NODE_SWITCH_URLS;
 
+/* amount of unicast PDUs recently sent to a peer through the hub */
+typedef struct {
+    BACNET_SC_VMAC_ADDRESS vmac;
+    uint32_t count; /* 0 - entry is free */
+    /* no auto connection to the peer until it expires */
+    struct mstimer hold_off;
+} BSC_NODE_SWITCH_TRAFFIC;
+
 typedef struct BSC_Node_Switch_Initiator {
     BSC_SOCKET_CTX ctx;
     BSC_CONTEXT_CFG cfg;
@@ -104,6 +112,14 @@ typedef struct BSC_Node_Switch_Initiator {
     BACNET_SC_VMAC_ADDRESS dest_vmac[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
     struct mstimer t[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
     BSC_NODE_SWITCH_URLS urls[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
+    /* connection was opened by the node switch itself because of the */
+    /* traffic to the peer, so it can be closed to make room for another */
+    bool auto_connected[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
+    /* use_clock value of the last PDU sent or received on a connection */
+    uint32_t last_used[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
+    uint32_t use_clock;
+    BSC_NODE_SWITCH_TRAFFIC traffic[BSC_CONF_NODE_SWITCH_TRAFFIC_NUM];
+    unsigned int traffic_elapsed_s;
     BSC_NODE_SWITCH_STATE state;
 } BSC_NODE_SWITCH_INITIATOR;
 
@@ -575,12 +591,93 @@ static int node_switch_initiator_alloc_sock(BSC_NODE_SWITCH_CTX *ctx)
     for (i = 0; i < sizeof(ctx->initiator.sock) / sizeof(BSC_SOCKET); i++) {
         if (ctx->initiator.sock_state[i] ==
             BSC_NODE_SWITCH_CONNECTION_STATE_IDLE) {
+            ctx->initiator.auto_connected[i] = false;
+            ctx->initiator.last_used[i] = ++ctx->initiator.use_clock;
             return i;
         }
     }
     return -1;
 }
 
+/**
+ * @brief Mark a node switch initiator connection as just used
+ * @param ctx - pointer to the node switch context
+ * @param index - socket index
+ */
+static void node_switch_initiator_touch(BSC_NODE_SWITCH_CTX *ctx, int index)
+{
+    ctx->initiator.last_used[index] = ++ctx->initiator.use_clock;
+}
+
+/**
+ * @brief Close the least recently used connection which was opened by
+ *  the node switch itself, so that its socket can be reused once the
+ *  disconnect completes.
+ * @param ctx - pointer to the node switch context
+ * @return true if a connection is being closed, otherwise false
+ */
+static bool node_switch_initiator_evict(BSC_NODE_SWITCH_CTX *ctx)
+{
+    int i;
+    int lru = -1;
+    uint32_t age;
+    uint32_t max_age = 0;
+
+    for (i = 0; i < sizeof(ctx->initiator.sock) / sizeof(BSC_SOCKET); i++) {
+        if (ctx->initiator.auto_connected[i] &&
+            ctx->initiator.sock_state[i] ==
+                BSC_NODE_SWITCH_CONNECTION_STATE_LOCAL_DISCONNECT) {
+            /* one eviction at a time, its socket is not free yet */
+            return true;
+        }
+        if (ctx->initiator.auto_connected[i] &&
+            ctx->initiator.sock_state[i] ==
+                BSC_NODE_SWITCH_CONNECTION_STATE_CONNECTED) {
+            age = ctx->initiator.use_clock - ctx->initiator.last_used[i];
+            if (lru == -1 || age > max_age) {
+                max_age = age;
+                lru = i;
+            }
+        }
+    }
+    if (lru == -1) {
+        return false;
+    }
+    DEBUG_PRINTF(
+        "node_switch_initiator_evict() closes connection to %s\n",
+        bsc_vmac_to_string(&ctx->initiator.dest_vmac[lru]));
+    ctx->initiator.sock_state[lru] =
+        BSC_NODE_SWITCH_CONNECTION_STATE_LOCAL_DISCONNECT;
+    bsc_disconnect(&ctx->initiator.sock[lru]);
+    return true;
+}
+
+#if BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD > 0
+/**
+ * @brief Hold off auto connection to the peer of a pooled connection
+ *  which failed, for the reconnect timeout, so that a peer which refuses
+ *  direct connections is not tried again on every PDU sent to it
+ * @param ctx - pointer to the node switch context
+ * @param index - socket index of the failed connection
+ */
+static void node_switch_traffic_hold_off(BSC_NODE_SWITCH_CTX *ctx, int index)
+{
+    int i;
+
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_TRAFFIC_NUM; i++) {
+        if (ctx->initiator.traffic[i].count &&
+            !memcmp(
+                &ctx->initiator.traffic[i].vmac.address[0],
+                &ctx->initiator.dest_vmac[index].address[0],
+                BVLC_SC_VMAC_SIZE)) {
+            mstimer_set(
+                &ctx->initiator.traffic[i].hold_off,
+                ctx->reconnect_timeout_s * 1000);
+        }
+    }
+}
+#endif
+
 /**
  * @brief Connect to the next URL
  * @param ctx - pointer to the node switch context
@@ -593,11 +690,21 @@ static void connect_next_url(BSC_NODE_SWITCH_CTX *ctx, int index)
     while (ret != BSC_SC_SUCCESS) {
         if (ctx->initiator.urls[index].url_elem >=
             ctx->initiator.urls[index].urls_cnt) {
+            ctx->initiator.urls[index].url_elem = 0;
+            if (ctx->initiator.auto_connected[index]) {
+                /* the traffic opens it again if the peer is still busy
+                   once the reconnect timeout has passed */
+#if BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD > 0
+                node_switch_traffic_hold_off(ctx, index);
+#endif
+                ctx->initiator.sock_state[index] =
+                    BSC_NODE_SWITCH_CONNECTION_STATE_IDLE;
+                break;
+            }
             ctx->initiator.sock_state[index] =
                 BSC_NODE_SWITCH_CONNECTION_STATE_DELAYING;
             mstimer_set(
                 &ctx->initiator.t[index], ctx->reconnect_timeout_s * 1000);
-            ctx->initiator.urls[index].url_elem = 0;
             break;
         } else {
             ctx->initiator.sock_state[index] =
@@ -625,6 +732,11 @@ static void node_switch_connect_or_delay(
     if (ns->initiator.urls[sock_index].urls_cnt > 0) {
         connect_next_url(ns, sock_index);
     } else if (dest) {
+        if (dest != &ns->initiator.dest_vmac[sock_index]) {
+            memcpy(
+                &ns->initiator.dest_vmac[sock_index].address[0],
+                &dest->address[0], BVLC_SC_VMAC_SIZE);
+        }
         r = bsc_node_get_address_resolution(ns->user_arg, dest);
         if (r && r->urls_num) {
             copy_urls(ns, sock_index, r);
@@ -634,9 +746,6 @@ static void node_switch_connect_or_delay(
             ns->initiator.sock_state[sock_index] =
                 BSC_NODE_SWITCH_CONNECTION_STATE_WAIT_RESOLUTION;
             ns->initiator.urls[sock_index].urls_cnt = 0;
-            memcpy(
-                &ns->initiator.dest_vmac[sock_index].address[0],
-                &dest->address[0], BVLC_SC_VMAC_SIZE);
             mstimer_set(
                 &ns->initiator.t[sock_index],
                 ns->address_resolution_timeout_s * 1000);
@@ -673,15 +782,139 @@ static void node_switch_initiator_runloop(BSC_NODE_SWITCH_CTX *ns)
             ns->initiator.sock_state[i] ==
             BSC_NODE_SWITCH_CONNECTION_STATE_WAIT_RESOLUTION) {
             if (mstimer_expired(&ns->initiator.t[i])) {
-                ns->initiator.sock_state[i] =
-                    BSC_NODE_SWITCH_CONNECTION_STATE_DELAYING;
-                mstimer_set(
-                    &ns->initiator.t[i], ns->reconnect_timeout_s * 1000);
+                if (ns->initiator.auto_connected[i]) {
+#if BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD > 0
+                    node_switch_traffic_hold_off(ns, i);
+#endif
+                    ns->initiator.sock_state[i] =
+                        BSC_NODE_SWITCH_CONNECTION_STATE_IDLE;
+                } else {
+                    ns->initiator.sock_state[i] =
+                        BSC_NODE_SWITCH_CONNECTION_STATE_DELAYING;
+                    mstimer_set(
+                        &ns->initiator.t[i], ns->reconnect_timeout_s * 1000);
+                }
             }
         }
     }
 }
 
+#if BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD > 0
+/**
+ * @brief Halve the hub traffic counters once per traffic window, so that
+ *  only peers which are busy right now reach the auto connect threshold
+ * @param ns - pointer to the node switch context
+ * @param seconds - number of seconds elapsed from the previous call
+ */
+static void node_switch_traffic_decay(BSC_NODE_SWITCH_CTX *ns, uint16_t seconds)
+{
+    int i;
+
+    ns->initiator.traffic_elapsed_s += seconds;
+    if (ns->initiator.traffic_elapsed_s >=
+        BSC_CONF_NODE_SWITCH_TRAFFIC_WINDOW_S) {
+        ns->initiator.traffic_elapsed_s = 0;
+        for (i = 0; i < BSC_CONF_NODE_SWITCH_TRAFFIC_NUM; i++) {
+            ns->initiator.traffic[i].count /= 2;
+        }
+    }
+}
+
+/**
+ * @brief Count a unicast PDU sent to a peer through the hub. When all
+ *  entries are in use, the least busy peer is replaced, so the table
+ *  keeps the busiest peers.
+ * @param ns - pointer to the node switch context
+ * @param dest - pointer to the VMAC address of the peer
+ * @return hub traffic counter of the peer, or 0 while auto connection
+ *  to the peer is held off after a failure
+ */
+static uint32_t node_switch_traffic_account(
+    BSC_NODE_SWITCH_CTX *ns, BACNET_SC_VMAC_ADDRESS *dest)
+{
+    BSC_NODE_SWITCH_TRAFFIC *t = NULL;
+    BSC_NODE_SWITCH_TRAFFIC *min = NULL;
+    int i;
+
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_TRAFFIC_NUM; i++) {
+        if (ns->initiator.traffic[i].count &&
+            !memcmp(
+                &ns->initiator.traffic[i].vmac.address[0], &dest->address[0],
+                BVLC_SC_VMAC_SIZE)) {
+            t = &ns->initiator.traffic[i];
+            break;
+        }
+        if (!min || ns->initiator.traffic[i].count < min->count) {
+            min = &ns->initiator.traffic[i];
+        }
+    }
+    if (!t) {
+        t = min;
+        memcpy(&t->vmac.address[0], &dest->address[0], BVLC_SC_VMAC_SIZE);
+        t->count = 0;
+        mstimer_set(&t->hold_off, 0);
+    }
+    if (t->count < UINT32_MAX) {
+        t->count++;
+    }
+    if (mstimer_interval(&t->hold_off) && !mstimer_expired(&t->hold_off)) {
+        return 0;
+    }
+    return t->count;
+}
+
+/**
+ * @brief Forget the hub traffic of a peer, e.g. because a direct
+ *  connection to it is established
+ * @param ns - pointer to the node switch context
+ * @param dest - pointer to the VMAC address of the peer
+ */
+static void node_switch_traffic_forget(
+    BSC_NODE_SWITCH_CTX *ns, BACNET_SC_VMAC_ADDRESS *dest)
+{
+    int i;
+
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_TRAFFIC_NUM; i++) {
+        if (!memcmp(
+                &ns->initiator.traffic[i].vmac.address[0], &dest->address[0],
+                BVLC_SC_VMAC_SIZE)) {
+            ns->initiator.traffic[i].count = 0;
+        }
+    }
+}
+
+/**
+ * @brief Open a pooled direct connection to a peer which gets a lot of
+ *  unicast traffic through the hub. If all initiator sockets are busy,
+ *  the least recently used pooled connection is closed and the peer gets
+ *  its socket on one of the next PDUs.
+ * @param ns - pointer to the node switch context
+ * @param dest - pointer to the VMAC address of the peer
+ */
+static void
+node_switch_auto_connect(BSC_NODE_SWITCH_CTX *ns, BACNET_SC_VMAC_ADDRESS *dest)
+{
+    int i;
+
+    if (!ns->direct_connect_initiate_enable ||
+        node_switch_initiator_find_connection_index_for_vmac(dest, ns) != -1 ||
+        node_switch_acceptor_find_connection_index_for_vmac(dest, ns) != -1) {
+        return;
+    }
+    i = node_switch_initiator_alloc_sock(ns);
+    if (i == -1) {
+        (void)node_switch_initiator_evict(ns);
+        return;
+    }
+    DEBUG_PRINTF(
+        "node_switch_auto_connect() opens connection to %s\n",
+        bsc_vmac_to_string(dest));
+    ns->initiator.auto_connected[i] = true;
+    ns->initiator.urls[i].urls_cnt = 0;
+    node_switch_connect_or_delay(ns, dest, i);
+}
+#endif
+
 /**
  * @brief Run the node switch maintenance timer
  * @param seconds - number of seconds elapsed from the previous call
@@ -695,6 +928,9 @@ void bsc_node_switch_maintenance_timer(uint16_t seconds)
     for (i = 0; i < BSC_CONF_NODE_SWITCHES_NUM; i++) {
         if (bsc_node_switch[i].used) {
             node_switch_initiator_runloop(&bsc_node_switch[i]);
+#if BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD > 0
+            node_switch_traffic_decay(&bsc_node_switch[i], seconds);
+#endif
         }
     }
     bws_dispatch_unlock();
@@ -760,6 +996,9 @@ static void node_switch_initiator_socket_event(
         index = node_switch_initiator_get_index(ns, c);
 
         if (index > -1) {
+            if (ev == BSC_SOCKET_EVENT_RECEIVED) {
+                node_switch_initiator_touch(ns, index);
+            }
             elem = ns->initiator.urls[index].url_elem - 1;
             if (elem < 0 || elem >= ns->initiator.urls[index].urls_cnt) {
                 elem = -1;
@@ -777,6 +1016,10 @@ static void node_switch_initiator_socket_event(
                     memcpy(
                         &ns->initiator.dest_vmac[index].address[0],
                         &c->vmac.address[0], sizeof(c->vmac.address));
+                    node_switch_initiator_touch(ns, index);
+#if BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD > 0
+                    node_switch_traffic_forget(ns, &c->vmac);
+#endif
                     node_switch_update_status(
                         ns, true, false,
                         elem == -1 ? NULL
@@ -809,7 +1052,12 @@ static void node_switch_initiator_socket_event(
                         BSC_NODE_SWITCH_EVENT_DISCONNECTED, ns, ns->user_arg,
                         &ns->initiator.dest_vmac[index], NULL, 0, NULL);
                     ns->initiator.urls[index].url_elem = 0;
-                    connect_next_url(ns, index);
+                    if (ns->initiator.auto_connected[index]) {
+                        ns->initiator.sock_state[index] =
+                            BSC_NODE_SWITCH_CONNECTION_STATE_IDLE;
+                    } else {
+                        connect_next_url(ns, index);
+                    }
                 }
             } else if (
                 ns->initiator.sock_state[index] ==
@@ -1132,6 +1380,8 @@ BSC_SC_RET bsc_node_switch_connect(
         if (urls && urls_cnt) {
             i = node_switch_initiator_alloc_sock(ns);
             if (i == -1) {
+                /* make room for one of the next attempts */
+                (void)node_switch_initiator_evict(ns);
                 ret = BSC_SC_NO_RESOURCES;
             } else {
                 copy_urls2(ns, i, urls, urls_cnt);
@@ -1142,10 +1392,13 @@ BSC_SC_RET bsc_node_switch_connect(
         } else {
             i = node_switch_initiator_find_connection_index_for_vmac(dest, ns);
             if (i != -1) {
+                /* a pooled connection requested by the user is kept */
+                ns->initiator.auto_connected[i] = false;
                 ret = BSC_SC_SUCCESS;
             } else {
                 i = node_switch_initiator_alloc_sock(ns);
                 if (i == -1) {
+                    (void)node_switch_initiator_evict(ns);
                     ret = BSC_SC_NO_RESOURCES;
                 } else {
                     ns->initiator.urls[i].urls_cnt = 0;
@@ -1270,6 +1523,7 @@ bsc_node_switch_send(BSC_NODE_SWITCH_HANDLE h, uint8_t *pdu, size_t pdu_len)
                 ns->initiator.sock_state[i] ==
                     BSC_NODE_SWITCH_CONNECTION_STATE_CONNECTED) {
                 c = &ns->initiator.sock[i];
+                node_switch_initiator_touch(ns, i);
             }
             if (!c) {
                 c = node_switch_acceptor_find_connection_for_vmac(&dest, ns);
@@ -1281,6 +1535,12 @@ bsc_node_switch_send(BSC_NODE_SWITCH_HANDLE h, uint8_t *pdu, size_t pdu_len)
                 }
             } else {
                 ret = bsc_node_hub_connector_send(ns->user_arg, pdu, pdu_len);
+#if BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD > 0
+                if (node_switch_traffic_account(ns, &dest) >=
+                    BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD) {
+                    node_switch_auto_connect(ns, &dest);
+                }
+#endif
             }
         }
     }
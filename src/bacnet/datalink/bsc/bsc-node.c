@@ -73,7 +73,7 @@ static bool bsc_hub_status_initialized[BSC_CONF_NODES_NUM] = { 0 };
 
 static BSC_ADDRESS_RESOLUTION
     bsc_address_resolution[BSC_CONF_NODES_NUM]
-                          [BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM];
+                          [BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM];
 
 static BSC_NODE_CONF bsc_conf[BSC_CONF_NODES_NUM];
 
@@ -150,7 +150,7 @@ static BSC_NODE *bsc_alloc_node(void)
             memset(
                 bsc_node[i].resolution, 0,
                 sizeof(BSC_ADDRESS_RESOLUTION) *
-                    BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM);
+                    BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM);
 
             /* Start/stop cycles of a node must not make an influence to history
              * about failed requests */
@@ -203,7 +203,7 @@ node_get_address_resolution(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
 {
     int i;
 
-    for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
+    for (i = 0; i < BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM; i++) {
         if (node->resolution[i].used &&
             !memcmp(
                 &vmac->address[0], &node->resolution[i].vmac.address[0],
@@ -237,7 +237,7 @@ node_alloc_address_resolution(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
     unsigned long max = 0;
     int max_index = 0;
 
-    for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
+    for (i = 0; i < BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM; i++) {
         if (!node->resolution[i].used) {
             node->resolution[i].used = true;
             mstimer_set(
@@ -252,7 +252,7 @@ node_alloc_address_resolution(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
 
     /* find and remove oldest resolution */
 
-    for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
+    for (i = 0; i < BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM; i++) {
         if (mstimer_elapsed(&node->resolution[i].fresh_timer) > max) {
             max = mstimer_elapsed(&node->resolution[i].fresh_timer);
             max_index = i;
@@ -841,7 +841,7 @@ static BSC_SC_RET bsc_node_start_state(BSC_NODE *node, BSC_NODE_STATE state)
         memset(
             node->resolution, 0,
             sizeof(BSC_ADDRESS_RESOLUTION) *
-                BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM);
+                BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM);
     } else {
         bsc_generate_random_vmac(&node->conf->local_vmac);
         DEBUG_PRINTF(
@@ -1085,7 +1085,7 @@ bsc_node_get_address_resolution(void *p_node, BACNET_SC_VMAC_ADDRESS *vmac)
         bws_dispatch_unlock();
         return NULL;
     }
-    for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
+    for (i = 0; i < BSC_CONF_NODE_ADDRESS_RESOLUTION_NUM; i++) {
         if (node->resolution[i].used &&
             !memcmp(
                 &vmac->address[0], &node->resolution[i].vmac.address[0],
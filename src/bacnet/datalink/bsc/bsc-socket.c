@@ -51,6 +51,82 @@ static BVLC_SC_DECODED_MESSAGE bsc_dm = { 0 };
             BSC_CONF_TX_PRE)                                        \
          : 0)
 
+/* a TX buffer entry with this bit set in its length prefix is a */
+/* reference to a shared pdu, the low bits hold the shared pdu index */
+#define BSC_TX_SHARED_FLAG 0x8000U
+
+#if BSC_CONF_SHARED_PDU_NUM >= BSC_TX_SHARED_FLAG
+#error "BSC_CONF_SHARED_PDU_NUM is too large"
+#endif
+
+struct BSC_Shared_PDU {
+    uint16_t refs;
+    uint16_t pdu_len;
+    /* BSC_CONF_TX_PRE bytes are reserved in front of the pdu. The
+       websocket layer writes its frame header there on every send, so
+       only the pdu itself is shared between the sockets. */
+    uint8_t buf[BSC_CONF_TX_PRE + BSC_PRE + BVLC_SC_NPDU_SIZE_CONF];
+};
+
+static BSC_SHARED_PDU bsc_shared_pdu[BSC_CONF_SHARED_PDU_NUM];
+
+/**
+ * @brief Decode the TX buffer entry at the given position
+ * @param p - pointer to the length prefix of the entry
+ * @param pdu_len - filled with the length of the pdu to send
+ * @param entry_len - filled with the bytes used by the entry in tx_buf
+ * @return pointer to the pdu to send
+ */
+static uint8_t *
+bsc_tx_buf_entry(uint8_t *p, uint16_t *pdu_len, size_t *entry_len)
+{
+    uint16_t len;
+    BSC_SHARED_PDU *s;
+
+    memcpy(&len, p, sizeof(len));
+    if (len & BSC_TX_SHARED_FLAG) {
+        s = &bsc_shared_pdu[len & ~BSC_TX_SHARED_FLAG];
+        *pdu_len = s->pdu_len;
+        *entry_len = sizeof(len);
+        return &s->buf[BSC_CONF_TX_PRE];
+    }
+    *pdu_len = len;
+    *entry_len = sizeof(len) + BSC_CONF_TX_PRE + len;
+    return &p[sizeof(len) + BSC_CONF_TX_PRE];
+}
+
+/**
+ * @brief Drop the shared pdu reference held by a TX buffer entry, if any
+ * @param p - pointer to the length prefix of the entry
+ */
+static void bsc_tx_buf_entry_release(uint8_t *p)
+{
+    uint16_t len;
+
+    memcpy(&len, p, sizeof(len));
+    if (len & BSC_TX_SHARED_FLAG) {
+        bsc_shared_pdu_release(&bsc_shared_pdu[len & ~BSC_TX_SHARED_FLAG]);
+    }
+}
+
+/**
+ * @brief Discard all the queued TX data of a socket
+ * @param c - pointer to the socket
+ */
+static void bsc_tx_buf_flush(BSC_SOCKET *c)
+{
+    size_t offset = 0;
+    size_t entry_len;
+    uint16_t pdu_len;
+
+    while (offset < c->tx_buf_size) {
+        (void)bsc_tx_buf_entry(&c->tx_buf[offset], &pdu_len, &entry_len);
+        bsc_tx_buf_entry_release(&c->tx_buf[offset]);
+        offset += entry_len;
+    }
+    c->tx_buf_size = 0;
+}
+
 /**
  * @brief Add the socket context to the list
  * @param ctx - pointer to the socket context
@@ -91,7 +167,8 @@ static void bsc_reset_socket(BSC_SOCKET *c)
 {
     memset(&c->vmac, 0, sizeof(c->vmac));
     memset(&c->uuid, 0, sizeof(c->uuid));
-    c->tx_buf_size = 0;
+    bsc_tx_buf_flush(c);
+    c->tx_dropped = 0;
 }
 
 /**
@@ -372,6 +449,7 @@ static void bsc_set_socket_idle(BSC_SOCKET *c)
 {
     c->state = BSC_SOCK_STATE_IDLE;
     c->wh = BSC_WEBSOCKET_INVALID_HANDLE;
+    bsc_tx_buf_flush(c);
 }
 
 /**
@@ -1086,8 +1164,10 @@ static void bsc_dispatch_srv_func(
     BSC_SOCKET *c = NULL;
     BSC_WEBSOCKET_RET wret;
     uint8_t *p;
+    uint8_t *pdu;
     bool failed = false;
     uint16_t len;
+    size_t entry_len;
     size_t i;
 
     (void)sh;
@@ -1101,6 +1181,7 @@ static void bsc_dispatch_srv_func(
     if (ev == BSC_WEBSOCKET_SERVER_STOPPED) {
         for (i = 0; i < ctx->sock_num; i++) {
             ctx->sock[i].state = BSC_SOCK_STATE_IDLE;
+            bsc_tx_buf_flush(&ctx->sock[i]);
         }
         DEBUG_PRINTF("bsc_dispatch_srv_func() ctx %p is deinitialized\n", ctx);
         bsc_ctx_remove(ctx);
@@ -1186,9 +1267,8 @@ static void bsc_dispatch_srv_func(
         p = c->tx_buf;
 
         while (c->tx_buf_size > 0) {
-            memcpy(&len, p, sizeof(len));
-            wret = bws_srv_dispatch_send(
-                c->ctx->sh, c->wh, &p[sizeof(len) + BSC_CONF_TX_PRE], len);
+            pdu = bsc_tx_buf_entry(p, &len, &entry_len);
+            wret = bws_srv_dispatch_send(c->ctx->sh, c->wh, pdu, len);
             if (wret != BSC_WEBSOCKET_SUCCESS) {
                 DEBUG_PRINTF(
                     "bsc_dispatch_srv_func() send data failed, start "
@@ -1202,10 +1282,15 @@ static void bsc_dispatch_srv_func(
                 failed = true;
                 break;
             } else {
-                c->tx_buf_size -= len + sizeof(len) + BSC_CONF_TX_PRE;
-                p += len + sizeof(len) + BSC_CONF_TX_PRE;
+                bsc_tx_buf_entry_release(p);
+                c->tx_buf_size -= entry_len;
+                p += entry_len;
             }
         }
+        if (c->tx_buf_size > 0 && p != c->tx_buf) {
+            /* keep the unsent entries at the front of tx_buf */
+            memmove(c->tx_buf, p, c->tx_buf_size);
+        }
 
         if (!failed) {
             if (c->state == BSC_SOCK_STATE_ERROR_FLUSH_TX) {
@@ -1357,6 +1442,8 @@ static void bsc_dispatch_cli_func(
     uint16_t pdu_len;
     BSC_WEBSOCKET_RET wret;
     uint8_t *p;
+    uint8_t *pdu;
+    size_t entry_len;
     size_t i;
     bool all_socket_disconnected = true;
     bool failed = false;
@@ -1448,11 +1535,10 @@ static void bsc_dispatch_cli_func(
         p = c->tx_buf;
 
         while (c->tx_buf_size > 0) {
-            memcpy(&pdu_len, p, sizeof(pdu_len));
+            pdu = bsc_tx_buf_entry(p, &pdu_len, &entry_len);
             DEBUG_PRINTF(
                 "bsc_dispatch_cli_func() sending pdu of %d bytes\n", pdu_len);
-            wret = bws_cli_dispatch_send(
-                c->wh, &p[sizeof(pdu_len) + BSC_CONF_TX_PRE], pdu_len);
+            wret = bws_cli_dispatch_send(c->wh, pdu, pdu_len);
             if (wret != BSC_WEBSOCKET_SUCCESS) {
                 DEBUG_PRINTF(
                     "bsc_dispatch_cli_func() pdu send failed, err = %d, start "
@@ -1466,10 +1552,15 @@ static void bsc_dispatch_cli_func(
                 failed = true;
                 break;
             } else {
-                c->tx_buf_size -= pdu_len + sizeof(pdu_len) + BSC_CONF_TX_PRE;
-                p += pdu_len + sizeof(pdu_len) + BSC_CONF_TX_PRE;
+                bsc_tx_buf_entry_release(p);
+                c->tx_buf_size -= entry_len;
+                p += entry_len;
             }
         }
+        if (c->tx_buf_size > 0 && p != c->tx_buf) {
+            /* keep the unsent entries at the front of tx_buf */
+            memmove(c->tx_buf, p, c->tx_buf_size);
+        }
         if (!failed) {
             if (c->state == BSC_SOCK_STATE_ERROR_FLUSH_TX) {
                 bsc_cli_process_error(c, c->reason);
@@ -1553,6 +1644,7 @@ BSC_SC_RET bsc_init_ctx(
     ctx->sock_num = sockets_num;
 
     for (i = 0; i < sockets_num; i++) {
+        ctx->sock[i].tx_buf_size = 0;
         bsc_set_socket_idle(&ctx->sock[i]);
     }
 
@@ -1753,6 +1845,7 @@ BSC_SC_RET bsc_send(BSC_SOCKET *c, uint8_t *pdu, size_t pdu_len)
             ret = BSC_SC_INVALID_OPERATION;
         } else {
             if (TX_BUF_BYTES_AVAIL(c) < pdu_len) {
+                c->tx_dropped++;
                 ret = BSC_SC_NO_RESOURCES;
             } else {
                 memcpy(TX_BUF_PTR(c), pdu, pdu_len);
@@ -1772,6 +1865,93 @@ BSC_SC_RET bsc_send(BSC_SOCKET *c, uint8_t *pdu, size_t pdu_len)
     return ret;
 }
 
+/**
+ * @brief Copy a PDU into a shared buffer which can be queued to many sockets
+ * @param pdu - pointer to the PDU
+ * @param pdu_len - PDU length
+ * @return shared PDU holding one reference for the caller, or NULL
+ */
+BSC_SHARED_PDU *bsc_shared_pdu_new(uint8_t *pdu, size_t pdu_len)
+{
+    BSC_SHARED_PDU *s = NULL;
+    int i;
+
+    if (!pdu || !pdu_len || pdu_len > BSC_PRE + BVLC_SC_NPDU_SIZE_CONF) {
+        return NULL;
+    }
+    bws_dispatch_lock();
+    for (i = 0; i < BSC_CONF_SHARED_PDU_NUM; i++) {
+        if (bsc_shared_pdu[i].refs == 0) {
+            s = &bsc_shared_pdu[i];
+            s->refs = 1;
+            s->pdu_len = (uint16_t)pdu_len;
+            memcpy(&s->buf[BSC_CONF_TX_PRE], pdu, pdu_len);
+            break;
+        }
+    }
+    bws_dispatch_unlock();
+    DEBUG_PRINTF("bsc_shared_pdu_new() <<< s = %p\n", s);
+    return s;
+}
+
+/**
+ * @brief Drop a reference to a shared PDU, freeing it with the last one
+ * @param s - pointer to the shared PDU
+ */
+void bsc_shared_pdu_release(BSC_SHARED_PDU *s)
+{
+    if (s) {
+        bws_dispatch_lock();
+        if (s->refs > 0) {
+            s->refs--;
+        }
+        bws_dispatch_unlock();
+    }
+}
+
+/**
+ * @brief Queue a shared BACnet Secure Connect PDU to a socket
+ * @param c - pointer to the socket
+ * @param s - pointer to the shared PDU
+ * @return BSC_SC_RET - status
+ */
+BSC_SC_RET bsc_send_shared(BSC_SOCKET *c, BSC_SHARED_PDU *s)
+{
+    BSC_SC_RET ret = BSC_SC_SUCCESS;
+    uint16_t entry;
+
+    DEBUG_PRINTF("bsc_send_shared() >>> c = %p, s = %p\n", c, s);
+
+    if (!c || !s) {
+        ret = BSC_SC_BAD_PARAM;
+    } else {
+        bws_dispatch_lock();
+
+        if (c->ctx->state != BSC_CTX_STATE_INITIALIZED ||
+            c->state != BSC_SOCK_STATE_CONNECTED) {
+            ret = BSC_SC_INVALID_OPERATION;
+        } else if (c->ctx->cfg->type != BSC_SOCKET_CTX_ACCEPTOR) {
+            /* client frames are masked in place, which would change
+               the pdu for every other socket that shares it */
+            ret = BSC_SC_INVALID_OPERATION;
+        } else if ((sizeof(c->tx_buf) - c->tx_buf_size) < sizeof(entry)) {
+            c->tx_dropped++;
+            ret = BSC_SC_NO_RESOURCES;
+        } else {
+            entry = (uint16_t)(BSC_TX_SHARED_FLAG | (s - &bsc_shared_pdu[0]));
+            memcpy(&c->tx_buf[c->tx_buf_size], &entry, sizeof(entry));
+            c->tx_buf_size += sizeof(entry);
+            s->refs++;
+            bws_srv_send(c->ctx->sh, c->wh);
+        }
+
+        bws_dispatch_unlock();
+    }
+
+    DEBUG_PRINTF("bsc_send_shared() <<< ret = %d\n", ret);
+    return ret;
+}
+
 /**
  * @brief Get the next message ID
  * @return uint16_t - message ID
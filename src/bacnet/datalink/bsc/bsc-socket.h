@@ -45,6 +45,9 @@ typedef struct BSC_SocketContextFuncs BSC_SOCKET_CTX_FUNCS;
 struct BSC_ContextCFG;
 typedef struct BSC_ContextCFG BSC_CONTEXT_CFG;
 
+struct BSC_Shared_PDU;
+typedef struct BSC_Shared_PDU BSC_SHARED_PDU;
+
 typedef enum {
     BSC_SOCKET_CTX_INITIATOR = 1,
     BSC_SOCKET_CTX_ACCEPTOR = 2
@@ -104,6 +107,8 @@ struct BSC_Socket {
 
     uint8_t tx_buf[BSC_TX_BUFFER_SIZE];
     size_t tx_buf_size;
+    /* PDUs dropped because tx_buf was full */
+    uint32_t tx_dropped;
 };
 
 struct BSC_ContextCFG {
@@ -278,6 +283,45 @@ void bsc_disconnect(BSC_SOCKET *c);
 BACNET_STACK_EXPORT
 BSC_SC_RET bsc_send(BSC_SOCKET *c, uint8_t *pdu, size_t pdu_len);
 
+/**
+ * @brief  bsc_shared_pdu_new() function copies a pdu into a shared
+ *         buffer which can be queued to many BACNet sockets using
+ *         bsc_send_shared() without copying the pdu again.
+ *         The caller owns one reference and must drop it using
+ *         bsc_shared_pdu_release() when it is done queueing.
+ *
+ * @param pdu - pointer to a data to send.
+ * @param pdu_len - size in bytes of data to send.
+ *
+ * @return shared pdu, or NULL if no shared buffer is free or
+ *         the pdu is too large.
+ */
+BACNET_STACK_EXPORT
+BSC_SHARED_PDU *bsc_shared_pdu_new(uint8_t *pdu, size_t pdu_len);
+
+BACNET_STACK_EXPORT
+void bsc_shared_pdu_release(BSC_SHARED_PDU *s);
+
+/**
+ * @brief  bsc_send_shared() function schedules transmitting of a
+ *         shared pdu to another BACNet socket. It behaves like bsc_send()
+ *         but queues a reference which needs only 2 bytes of the
+ *         socket TX buffer.
+ *         Only sockets of an acceptor context can send shared pdus,
+ *         because the frames of a websocket client are masked in place.
+ *         The BSC_CONF_TX_PRE bytes in front of the shared pdu are
+ *         rewritten with the websocket frame header on every send.
+ *
+ * @param c - BACNet socket descriptor initialized by bsc_accept().
+ * @param s - shared pdu returned by bsc_shared_pdu_new().
+ *
+ * @return error code from BSC_SC_RET enum, same as bsc_send().
+ *    BSC_SC_INVALID_OPERATION is also returned for a socket of an
+ *    initiator context.
+ */
+BACNET_STACK_EXPORT
+BSC_SC_RET bsc_send_shared(BSC_SOCKET *c, BSC_SHARED_PDU *s);
+
 BACNET_STACK_EXPORT
 uint16_t bsc_get_next_message_id(void);
 
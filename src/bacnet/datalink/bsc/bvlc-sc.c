@@ -2163,6 +2163,52 @@ bool bvlc_sc_decode_message(
     return true;
 }
 
+/**
+ * @brief Decode the BVLC-SC header in place, without copying any
+ *  field or payload out of the buffer. The header and the header
+ *  options are validated the same way as bvlc_sc_decode_message() does,
+ *  but header options are not decoded and function specific payloads
+ *  are not parsed. Intended for the receive path, which only needs to
+ *  locate the originating address and the NPDU of a message that was
+ *  already validated by the socket layer.
+ * @param buf - buffer with BACNet/SC message
+ * @param buf_len - length of the message
+ * @param view - filled with offsets of the fields inside buf
+ * @return true if the header was decoded, false otherwise
+ */
+bool bvlc_sc_decode_message_view(
+    uint8_t *buf, size_t buf_len, BVLC_SC_MESSAGE_VIEW *view)
+{
+    BVLC_SC_DECODED_HDR hdr;
+    uint16_t error_code;
+    uint16_t error_class;
+    const char *err_desc = NULL;
+
+    if (!buf || !buf_len || !view) {
+        return false;
+    }
+    memset(view, 0, sizeof(*view));
+    if (!bvlc_sc_decode_hdr(
+            buf, buf_len, &hdr, &error_code, &error_class, &err_desc)) {
+        return false;
+    }
+    view->bvlc_function = hdr.bvlc_function;
+    view->message_id = hdr.message_id;
+    if (hdr.origin) {
+        view->origin_offset = (size_t)((uint8_t *)hdr.origin - buf);
+    }
+    if (hdr.dest) {
+        view->dest_offset = (size_t)((uint8_t *)hdr.dest - buf);
+    }
+    if (hdr.payload) {
+        view->payload_offset = (size_t)(hdr.payload - buf);
+        view->payload_len = hdr.payload_len;
+    } else {
+        view->payload_offset = buf_len;
+    }
+    return true;
+}
+
 /**
  * @brief Function removes destination address of BACNet/SC message
  *                 and sets originating address instead of it.
@@ -152,6 +152,18 @@ typedef struct BVLC_SC_Decoded_Hdr {
     size_t payload_len;
 } BVLC_SC_DECODED_HDR;
 
+/* In-place view of a BVLC-SC message: offsets into the buffer that was
+   decoded, nothing is copied. Origin and dest offsets are 0 when the
+   corresponding address is absent (a VMAC can never start at offset 0). */
+typedef struct BVLC_SC_Message_View {
+    uint8_t bvlc_function;
+    uint16_t message_id;
+    size_t origin_offset;
+    size_t dest_offset;
+    size_t payload_offset;
+    size_t payload_len;
+} BVLC_SC_MESSAGE_VIEW;
+
 typedef struct BVLC_SC_Decoded_Result {
     uint8_t bvlc_function;
     uint8_t result;
@@ -392,6 +404,10 @@ bool bvlc_sc_decode_message(
     uint16_t *error_class,
     const char **err_desc);
 
+BACNET_STACK_EXPORT
+bool bvlc_sc_decode_message_view(
+    uint8_t *buf, size_t buf_len, BVLC_SC_MESSAGE_VIEW *view);
+
 BACNET_STACK_EXPORT
 void bvlc_sc_remove_dest_set_orig(
     uint8_t *pdu, size_t pdu_len, BACNET_SC_VMAC_ADDRESS *orig);
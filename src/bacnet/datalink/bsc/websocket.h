@@ -36,6 +36,21 @@
 
 /** @} */
 
+/**
+ * Number of service threads of each websocket server. A value above 1
+ * lets the port spread TLS handshakes and encryption of different
+ * connections over several cores, if it supports that.
+ * @{
+ */
+
+#ifndef BSC_CONF_WEBSOCKET_SERVER_THREADS_NUM
+#define BSC_WEBSOCKET_SERVER_THREADS_NUM 1
+#else
+#define BSC_WEBSOCKET_SERVER_THREADS_NUM BSC_CONF_WEBSOCKET_SERVER_THREADS_NUM
+#endif
+
+/** @} */
+
 /** @} */
 
 /**
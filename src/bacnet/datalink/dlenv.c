@@ -41,6 +41,12 @@ static uint16_t Datalink_Debug_Timer_Seconds;
 /* timer used to renew Foreign Device Registration */
 static uint16_t BBMD_Timer_Seconds;
 static uint16_t BBMD_TTL_Seconds = 60000;
+/* timer used to try again while a BBMD or BDT host name is still being
+   resolved in the background; kept apart from the renewal timer */
+static uint16_t BBMD_Resolve_Timer_Seconds;
+#ifndef DLENV_BBMD_RESOLVE_RETRY_SECONDS
+#define DLENV_BBMD_RESOLVE_RETRY_SECONDS 5
+#endif
 /* BBMD variables */
 static BACNET_IP_ADDRESS BBMD_Address;
 static bool BBMD_Address_Valid;
@@ -122,7 +128,11 @@ int dlenv_bbmd_result(void)
  * The Environment Variables depend on define of BACDL_BIP:
  *     - BACNET_BBMD_PORT - 0..65534, defaults to 47808
  *     - BACNET_BBMD_TIMETOLIVE - 0..65535 seconds, defaults to 60000
- *     - BACNET_BBMD_ADDRESS - dotted IPv4 address
+ *     - BACNET_BBMD_ADDRESS - dotted IPv4 address or host name
+ *
+ * Host names are resolved in the background; until an answer is cached
+ * the part that waits on the name is tried again every few seconds,
+ * without touching the timer that renews a registration.
  * @return Positive number (of bytes sent) on success,
  *         0 if no registration request is sent, or
  *         -1 if registration fails.
@@ -133,6 +143,7 @@ static int bbmd_register_as_foreign_device(void)
 #if defined(BACDL_BIP) && BBMD_CLIENT_ENABLED
     char *pEnv = NULL;
     long long_value = 0;
+    bool resolve_pending = false;
 #if BBMD_ENABLED
     bool bdt_entry_valid = false;
     uint16_t bdt_entry_port = 0;
@@ -162,7 +173,10 @@ static int bbmd_register_as_foreign_device(void)
     }
     pEnv = getenv("BACNET_BBMD_ADDRESS");
     if (pEnv) {
-        BBMD_Address_Valid = bip_get_addr_by_name(pEnv, &BBMD_Address);
+        BBMD_Address_Valid = bip_get_addr_by_name_async(pEnv, &BBMD_Address);
+        if (!BBMD_Address_Valid) {
+            resolve_pending = true;
+        }
     }
     if (BBMD_Address_Valid) {
         if (Datalink_Debug) {
@@ -194,8 +208,11 @@ static int bbmd_register_as_foreign_device(void)
                 bbmd_env, sizeof(bbmd_env), "BACNET_BDT_ADDR_%u", entry_number);
             pEnv = getenv(bbmd_env);
             if (pEnv) {
-                bdt_entry_valid =
-                    bip_get_addr_by_name(pEnv, &BBMD_Table_Entry.dest_address);
+                bdt_entry_valid = bip_get_addr_by_name_async(
+                    pEnv, &BBMD_Table_Entry.dest_address);
+                if (!bdt_entry_valid) {
+                    resolve_pending = true;
+                }
                 if (entry_number == 1) {
                     if (Datalink_Debug) {
                         fprintf(
@@ -264,6 +281,14 @@ static int bbmd_register_as_foreign_device(void)
         }
     }
 #endif
+    if (resolve_pending) {
+        if (Datalink_Debug) {
+            fprintf(stderr, "BBMD: waiting on host name resolution\n");
+        }
+        BBMD_Resolve_Timer_Seconds = DLENV_BBMD_RESOLVE_RETRY_SECONDS;
+    } else {
+        BBMD_Resolve_Timer_Seconds = 0;
+    }
 #endif
     BBMD_Result = retval;
 
@@ -824,6 +849,19 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
             BBMD_Timer_Seconds = (uint16_t)BBMD_TTL_Seconds;
         }
     }
+    if (BBMD_Resolve_Timer_Seconds) {
+        if (BBMD_Resolve_Timer_Seconds <= elapsed_seconds) {
+            BBMD_Resolve_Timer_Seconds = 0;
+        } else {
+            BBMD_Resolve_Timer_Seconds -= elapsed_seconds;
+        }
+        if ((BBMD_Resolve_Timer_Seconds == 0) &&
+            (Network_Port_Type(Network_Port_Instance) == PORT_TYPE_BIP)) {
+            /* a host name was pending, so nothing was registered yet
+               with that BBMD: this only retries what waits on a name */
+            bbmd_register_as_foreign_device();
+        }
+    }
     if (Network_Port_Type(Network_Port_Instance) == PORT_TYPE_MSTP) {
         Datalink_Debug_Timer_Seconds += elapsed_seconds;
         if (Datalink_Debug_Timer_Seconds >= 60) {
@@ -834,7 +872,8 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
                 fprintf(
                     stderr,
                     "MSTP: Frames Rx:%u/%u/%u Tx:%u PDU Rx:%u Tx:%u "
-                    "Lost:%u BadCRC:%u PFM:%u\n",
+                    "Lost:%u BadCRC:%u PFM:%u RP:%u "
+                    "Token:%u Rotation:%ums/%ums\n",
                     statistics.receive_valid_frame_counter,
                     statistics.receive_valid_frame_not_for_us_counter,
                     statistics.receive_invalid_frame_counter,
@@ -842,7 +881,11 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
                     statistics.receive_pdu_counter,
                     statistics.transmit_pdu_counter,
                     statistics.lost_token_counter, statistics.bad_crc_counter,
-                    statistics.poll_for_master_counter);
+                    statistics.poll_for_master_counter,
+                    statistics.reply_postponed_counter,
+                    statistics.token_received_counter,
+                    statistics.token_rotation_milliseconds,
+                    statistics.token_rotation_max_milliseconds);
 
                 fflush(stderr);
 #endif
@@ -264,11 +264,19 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     if (Ringbuf_Empty(&user->PDU_Queue)) {
         return 0;
     }
-    /* look at next PDU in queue without removing it */
-    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(&user->PDU_Queue);
-    /* is this the reply to the DER? */
-    matched = MSTP_Compare_Data_Expecting_Reply(
-        mstp_port, pkt->pdu, pkt->pdu_len, &pkt->address);
+    /* the reply may be queued behind other PDUs, so look at all of them
+       rather than postponing the reply because of the first one */
+    for (pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(&user->PDU_Queue);
+         pkt;
+         pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek_Next(
+             &user->PDU_Queue, (uint8_t *)pkt)) {
+        /* is this the reply to the DER? */
+        matched = MSTP_Compare_Data_Expecting_Reply(
+            mstp_port, pkt->pdu, pkt->pdu_len, &pkt->address);
+        if (matched) {
+            break;
+        }
+    }
     if (!matched) {
         return 0;
     }
@@ -278,7 +286,8 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
         pkt->frame_type, pkt->address.mac[0], mstp_port->This_Station,
         &pkt->pdu[0], pkt->pdu_len);
     user->Statistics.transmit_pdu_counter++;
-    (void)Ringbuf_Pop(&user->PDU_Queue, NULL);
+    /* remove the reply, keeping the order of the other PDUs */
+    (void)Ringbuf_Pop_Element(&user->PDU_Queue, (uint8_t *)pkt, NULL);
 
     return pdu_len;
 }
@@ -310,6 +319,29 @@ void MSTP_Send_Frame(
     }
     driver->send(buffer, nbytes);
     user->Statistics.transmit_frame_counter++;
+    if ((nbytes > 2) && (buffer[2] == FRAME_TYPE_REPLY_POSTPONED)) {
+        user->Statistics.reply_postponed_counter++;
+    }
+}
+
+/**
+ * @brief Track the time between tokens received by this node
+ * @param user - MS/TP user data for this port
+ */
+static void dlmstp_token_received(struct dlmstp_user_data_t *user)
+{
+    uint32_t now, milliseconds;
+
+    now = mstimer_now();
+    if (user->Statistics.token_received_counter > 0) {
+        milliseconds = now - user->Token_Received_Milliseconds;
+        user->Statistics.token_rotation_milliseconds = milliseconds;
+        if (milliseconds > user->Statistics.token_rotation_max_milliseconds) {
+            user->Statistics.token_rotation_max_milliseconds = milliseconds;
+        }
+    }
+    user->Token_Received_Milliseconds = now;
+    user->Statistics.token_received_counter++;
 }
 
 /**
@@ -446,6 +478,11 @@ uint16_t dlmstp_receive(
                     /* state changed while some states fast transition */
                     if (MSTP_Port->master_state == MSTP_MASTER_STATE_NO_TOKEN) {
                         user->Statistics.lost_token_counter++;
+                    } else if (
+                        (master_state == MSTP_MASTER_STATE_IDLE) &&
+                        (MSTP_Port->master_state ==
+                         MSTP_MASTER_STATE_USE_TOKEN)) {
+                        dlmstp_token_received(user);
                     }
                     master_state = MSTP_Port->master_state;
                 }
@@ -44,6 +44,13 @@ typedef struct dlmstp_statistics {
     uint32_t lost_token_counter;
     uint32_t bad_crc_counter;
     uint32_t poll_for_master_counter;
+    /* Reply Postponed frames sent because no reply was ready in time */
+    uint32_t reply_postponed_counter;
+    /* tokens received from the previous station */
+    uint32_t token_received_counter;
+    /* milliseconds between the last two tokens received, and the most */
+    uint32_t token_rotation_milliseconds;
+    uint32_t token_rotation_max_milliseconds;
 } DLMSTP_STATISTICS;
 
 #ifndef DLMSTP_MAX_INFO_FRAMES
@@ -107,6 +114,7 @@ struct dlmstp_user_data_t {
     dlmstp_hook_frame_rx_complete_cb Valid_Frame_Not_For_Us_Rx_Callback;
     dlmstp_hook_frame_rx_complete_cb Invalid_Frame_Rx_Callback;
     uint32_t Valid_Frame_Milliseconds;
+    uint32_t Token_Received_Milliseconds;
     /* the PDU Queue is made of Nmax_info_frames x dlmstp_packet's */
     RING_BUFFER PDU_Queue;
     struct dlmstp_packet PDU_Buffer[DLMSTP_MAX_INFO_FRAMES];
@@ -218,10 +218,9 @@ uint16_t MSTP_Create_Frame(
         if ((8 + data_len + 2) > buffer_size) {
             return 0;
         }
-        for (index = 8; index < (data_len + 8); index++, data++) {
-            buffer[index] = *data;
-            crc16 = CRC_Calc_Data(buffer[index], crc16);
-        }
+        memmove(&buffer[8], data, data_len);
+        crc16 = CRC_Calc_Data_Block(&buffer[8], data_len, crc16);
+        index = 8 + data_len;
         crc16 = ~crc16;
         buffer[index] = crc16 & 0xFF; /* LSB first */
         buffer[index + 1] = crc16 >> 8;
@@ -229,15 +228,11 @@ uint16_t MSTP_Create_Frame(
     buffer[0] = 0x55;
     buffer[1] = 0xFF;
     buffer[2] = frame_type;
-    crc8 = CRC_Calc_Header(buffer[2], crc8);
     buffer[3] = destination;
-    crc8 = CRC_Calc_Header(buffer[3], crc8);
     buffer[4] = source;
-    crc8 = CRC_Calc_Header(buffer[4], crc8);
     buffer[5] = data_len >> 8; /* MSB first */
-    crc8 = CRC_Calc_Header(buffer[5], crc8);
     buffer[6] = data_len & 0xFF;
-    crc8 = CRC_Calc_Header(buffer[6], crc8);
+    crc8 = CRC_Calc_Header_Block(&buffer[2], 5, crc8);
     buffer[7] = ~crc8;
     index = 8;
     if (data_len > 0) {
@@ -285,6 +280,24 @@ static bool MSTP_Frame_For_Us(struct mstp_port_struct_t *mstp_port)
     return false;
 }
 
+/**
+ * @brief Determine if the data CRC of the frame being received is
+ *  calculated over the input buffer as one block at the end of the frame,
+ *  rather than octet by octet. MSTP_DEFERRED_DATA_CRC must be enabled,
+ *  and every octet must fit in the input buffer.
+ * @param mstp_port MSTP port context data
+ * @return true if the data CRC is calculated at the end of the frame
+ */
+static bool mstp_data_crc_deferred(const struct mstp_port_struct_t *mstp_port)
+{
+#if MSTP_DEFERRED_DATA_CRC
+    return ((uint32_t)mstp_port->DataLength + 2) <= mstp_port->InputBufferSize;
+#else
+    (void)mstp_port;
+    return false;
+#endif
+}
+
 /**
  * @brief Finite State Machine for receiving an MSTP frame
  * @param mstp_port MSTP port context data
@@ -525,8 +538,10 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                 printf_receive_data("%02X ", mstp_port->DataRegister);
                 if (mstp_port->Index < mstp_port->DataLength) {
                     /* DataOctet */
-                    mstp_port->DataCRC = CRC_Calc_Data(
-                        mstp_port->DataRegister, mstp_port->DataCRC);
+                    if (!mstp_data_crc_deferred(mstp_port)) {
+                        mstp_port->DataCRC = CRC_Calc_Data(
+                            mstp_port->DataRegister, mstp_port->DataCRC);
+                    }
                     if (mstp_port->Index < mstp_port->InputBufferSize) {
                         mstp_port->InputBuffer[mstp_port->Index] =
                             mstp_port->DataRegister;
@@ -535,8 +550,10 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                     /* SKIP_DATA or DATA - no change in state */
                 } else if (mstp_port->Index == mstp_port->DataLength) {
                     /* CRC1 */
-                    mstp_port->DataCRC = CRC_Calc_Data(
-                        mstp_port->DataRegister, mstp_port->DataCRC);
+                    if (!mstp_data_crc_deferred(mstp_port)) {
+                        mstp_port->DataCRC = CRC_Calc_Data(
+                            mstp_port->DataRegister, mstp_port->DataCRC);
+                    }
                     mstp_port->DataCRCActualMSB = mstp_port->DataRegister;
                     if (mstp_port->Index < mstp_port->InputBufferSize) {
                         mstp_port->InputBuffer[mstp_port->Index] =
@@ -550,8 +567,10 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                         mstp_port->InputBuffer[mstp_port->Index] =
                             mstp_port->DataRegister;
                     }
-                    mstp_port->DataCRC = CRC_Calc_Data(
-                        mstp_port->DataRegister, mstp_port->DataCRC);
+                    if (!mstp_data_crc_deferred(mstp_port)) {
+                        mstp_port->DataCRC = CRC_Calc_Data(
+                            mstp_port->DataRegister, mstp_port->DataCRC);
+                    }
                     mstp_port->DataCRCActualLSB = mstp_port->DataRegister;
                     printf_receive_data(
                         "%s",
@@ -582,6 +601,11 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                         }
                     } else {
                         /* STATE DATA CRC - no need for new state */
+                        if (mstp_data_crc_deferred(mstp_port)) {
+                            mstp_port->DataCRC = CRC_Calc_Data_Block(
+                                mstp_port->InputBuffer,
+                                mstp_port->DataLength + 2, 0xFFFF);
+                        }
                         if (mstp_port->DataCRC == 0xF0B8) {
                             /* GoodCRC */
                             if (mstp_port->receive_state ==
@@ -825,6 +849,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                             /* SendNoWait */
                             mstp_port->master_state =
                                 MSTP_MASTER_STATE_DONE_WITH_TOKEN;
+                            transition_now = mstp_port->TokenBurstEnabled;
                         } else {
                             /* SendAndWait */
                             mstp_port->master_state =
@@ -840,6 +865,9 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                         /* SendNoWait */
                         mstp_port->master_state =
                             MSTP_MASTER_STATE_DONE_WITH_TOKEN;
+                        /* send the next queued frame without waiting
+                           for another pass of the state machine */
+                        transition_now = mstp_port->TokenBurstEnabled;
                         break;
                 }
             }
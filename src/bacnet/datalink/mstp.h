@@ -28,6 +28,22 @@
 /* size of the buffer used to send and validate a unique test request */
 #define MSTP_UUID_SIZE 16
 
+/* Set to 1 to calculate the data CRC of a received frame over the input
+   buffer as one block after its last octet, rather than one octet at a
+   time as each octet is received. The whole calculation then runs in the
+   call of MSTP_Receive_Frame_FSM() that receives the last octet, which on
+   a small target without CRC_USE_TABLE can take some milliseconds for a
+   long frame. Ports that run the receive FSM from an interrupt should
+   leave it 0. Frames that do not fit in the input buffer always use the
+   per-octet calculation. */
+#ifndef MSTP_DEFERRED_DATA_CRC
+#if defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
+#define MSTP_DEFERRED_DATA_CRC 1
+#else
+#define MSTP_DEFERRED_DATA_CRC 0
+#endif
+#endif
+
 struct mstp_port_struct_t {
     MSTP_RECEIVE_STATE receive_state;
     /* When a master node is powered up or reset, */
@@ -58,6 +74,10 @@ struct mstp_port_struct_t {
     unsigned SlaveNodeEnabled : 1;
     /* A Boolean flag set to TRUE if this node is using a ZeroConfig address */
     unsigned ZeroConfigEnabled : 1;
+    /* A Boolean flag set to TRUE if this node sends its information frames
+       back-to-back while it holds the token.  Only set this when
+       MSTP_Send_Frame() returns after the frame has left the wire. */
+    unsigned TokenBurstEnabled : 1;
     /* stores the latest received data */
     uint8_t DataRegister;
     /* Used to accumulate the CRC on the data field of a frame. */
@@ -6,12 +6,295 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <ctype.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/indtext.h"
 
+/* Lists registered with indtext_index_register() keep their number of
+   entries and, with more entries than INDTEXT_INDEX_MIN, are indexed by
+   string, case insensitive string, and index, so that lookups in large
+   lists such as the property identifiers do not scan them. The indexes
+   are open addressed hash tables taken from one static pool. Lists that
+   are not registered, or do not fit, are scanned as before. Set
+   INDTEXT_INDEX_POOL_SIZE to 0 to scan all lists. */
+#ifndef INDTEXT_INDEX_POOL_SIZE
+#if defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
+#define INDTEXT_INDEX_POOL_SIZE 16384
+#else
+#define INDTEXT_INDEX_POOL_SIZE 0
+#endif
+#endif
+/* number of lists that can be registered + 1, a power of two */
+#ifndef INDTEXT_INDEX_LISTS
+#define INDTEXT_INDEX_LISTS 128
+#endif
+#ifndef INDTEXT_INDEX_MIN
+#define INDTEXT_INDEX_MIN 16
+#endif
+
+#if INDTEXT_INDEX_POOL_SIZE
+#if (INDTEXT_INDEX_LISTS & (INDTEXT_INDEX_LISTS - 1)) != 0
+#error INDTEXT_INDEX_LISTS must be a power of two
+#endif
+struct indtext_index {
+    INDTEXT_DATA *data_list;
+    /* number of entries in the list */
+    unsigned count;
+    /* number of slots in each hash table, a power of two,
+       or 0 if the list is scanned */
+    unsigned size;
+    /* slots hold the list position + 1, or 0 if empty */
+    uint16_t *by_string;
+    uint16_t *by_istring;
+    uint16_t *by_index;
+};
+/* open addressed by the address of the list */
+static struct indtext_index Indtext_Index[INDTEXT_INDEX_LISTS];
+static unsigned Indtext_Index_Count;
+static uint16_t Indtext_Index_Pool[INDTEXT_INDEX_POOL_SIZE];
+static unsigned Indtext_Index_Pool_Used;
+
+static uint32_t indtext_hash_list(const INDTEXT_DATA *data_list)
+{
+    return (uint32_t)((uintptr_t)data_list / sizeof(INDTEXT_DATA)) *
+        2654435761UL;
+}
+
+static uint32_t indtext_hash_string(const char *name)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261UL;
+
+    while (*name) {
+        hash ^= *(const unsigned char *)name;
+        hash *= 16777619UL;
+        name++;
+    }
+
+    return hash;
+}
+
+static uint32_t indtext_hash_istring(const char *name)
+{
+    uint32_t hash = 2166136261UL;
+    int c;
+
+    while (*name) {
+        /* fold case the same way as bacnet_stricmp() */
+        c = *(const unsigned char *)name;
+        hash ^= (uint32_t)tolower(toupper(c));
+        hash *= 16777619UL;
+        name++;
+    }
+
+    return hash;
+}
+
+static uint32_t indtext_hash_index(unsigned index)
+{
+    return (uint32_t)index * 2654435761UL;
+}
+
+/**
+ * @brief Build the indexes of a list. When a string or an index is in the
+ *  list more than once, the first entry is kept, as a scan would find it.
+ * @param entry - the index to build
+ * @param data_list - list of strings and indices
+ * @param count - number of entries in the list
+ */
+static void indtext_index_build(
+    struct indtext_index *entry, INDTEXT_DATA *data_list, unsigned count)
+{
+    unsigned mask = entry->size - 1;
+    unsigned i, slot;
+    uint16_t pos;
+
+    for (i = 0; i < count; i++) {
+        slot = indtext_hash_string(data_list[i].pString) & mask;
+        while ((pos = entry->by_string[slot]) != 0) {
+            if (strcmp(data_list[pos - 1].pString, data_list[i].pString) ==
+                0) {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (pos == 0) {
+            entry->by_string[slot] = (uint16_t)(i + 1);
+        }
+        slot = indtext_hash_istring(data_list[i].pString) & mask;
+        while ((pos = entry->by_istring[slot]) != 0) {
+            if (bacnet_stricmp(
+                    data_list[pos - 1].pString, data_list[i].pString) == 0) {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (pos == 0) {
+            entry->by_istring[slot] = (uint16_t)(i + 1);
+        }
+        slot = indtext_hash_index(data_list[i].index) & mask;
+        while ((pos = entry->by_index[slot]) != 0) {
+            if (data_list[pos - 1].index == data_list[i].index) {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (pos == 0) {
+            entry->by_index[slot] = (uint16_t)(i + 1);
+        }
+    }
+}
+
+/**
+ * @brief Find the indexes of a registered list
+ * @param data_list - list of strings and indices
+ * @return the indexes, with no hash tables if the list is scanned, or
+ *  NULL if the list is not registered
+ */
+static const struct indtext_index *indtext_index(INDTEXT_DATA *data_list)
+{
+    unsigned mask = INDTEXT_INDEX_LISTS - 1;
+    unsigned slot = indtext_hash_list(data_list) & mask;
+
+    while (Indtext_Index[slot].data_list) {
+        if (Indtext_Index[slot].data_list == data_list) {
+            return &Indtext_Index[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Look up a string in the indexes of a list
+ * @param entry - the indexes of the list
+ * @param search_name - string to search for
+ * @param istring - true for a case insensitive search
+ * @return the list entry, or NULL if not found
+ */
+static INDTEXT_DATA *indtext_index_string(
+    const struct indtext_index *entry, const char *search_name, bool istring)
+{
+    unsigned mask = entry->size - 1;
+    unsigned slot;
+    const uint16_t *table;
+    uint16_t pos;
+    INDTEXT_DATA *data;
+
+    if (istring) {
+        table = entry->by_istring;
+        slot = indtext_hash_istring(search_name) & mask;
+    } else {
+        table = entry->by_string;
+        slot = indtext_hash_string(search_name) & mask;
+    }
+    while ((pos = table[slot]) != 0) {
+        data = &entry->data_list[pos - 1];
+        if (istring) {
+            if (bacnet_stricmp(data->pString, search_name) == 0) {
+                return data;
+            }
+        } else if (strcmp(data->pString, search_name) == 0) {
+            return data;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Look up an index in the indexes of a list
+ * @param entry - the indexes of the list
+ * @param index - index to search for
+ * @return the list entry, or NULL if not found
+ */
+static INDTEXT_DATA *
+indtext_index_index(const struct indtext_index *entry, unsigned index)
+{
+    unsigned mask = entry->size - 1;
+    unsigned slot = indtext_hash_index(index) & mask;
+    uint16_t pos;
+
+    while ((pos = entry->by_index[slot]) != 0) {
+        if (entry->data_list[pos - 1].index == index) {
+            return &entry->data_list[pos - 1];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Register a list, so that its number of entries is kept and,
+ *  when it is large, lookups in it use hash tables instead of a scan.
+ *  Lists are registered at initialization, before other threads make
+ *  lookups, since the registry is not locked. Lookups in a list before
+ *  it is registered scan it. A list must not change after it is
+ *  registered.
+ * @param data_list - list of strings and indices
+ * @return true if the list is registered, false if there is no room to
+ *  keep it or INDTEXT_INDEX_POOL_SIZE is 0, and the list is scanned
+ */
+bool indtext_index_register(INDTEXT_DATA *data_list)
+{
+#if INDTEXT_INDEX_POOL_SIZE
+    struct indtext_index *entry;
+    unsigned mask = INDTEXT_INDEX_LISTS - 1;
+    unsigned slot;
+    unsigned count = 0, size = 1;
+
+    if (!data_list) {
+        return false;
+    }
+    slot = indtext_hash_list(data_list) & mask;
+    while (Indtext_Index[slot].data_list) {
+        if (Indtext_Index[slot].data_list == data_list) {
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    /* keep an empty slot to end the probes */
+    if (Indtext_Index_Count >= (INDTEXT_INDEX_LISTS - 1)) {
+        return false;
+    }
+    while (data_list[count].pString) {
+        count++;
+    }
+    entry = &Indtext_Index[slot];
+    entry->count = count;
+    entry->size = 0;
+    if ((count > INDTEXT_INDEX_MIN) && (count < UINT16_MAX)) {
+        /* keep the tables at most half full */
+        while (size < (count * 2)) {
+            size <<= 1;
+        }
+        if ((Indtext_Index_Pool_Used + (size * 3)) <=
+            INDTEXT_INDEX_POOL_SIZE) {
+            entry->size = size;
+            entry->by_string = &Indtext_Index_Pool[Indtext_Index_Pool_Used];
+            entry->by_istring = entry->by_string + size;
+            entry->by_index = entry->by_istring + size;
+            Indtext_Index_Pool_Used += size * 3;
+            indtext_index_build(entry, data_list, count);
+        }
+    }
+    entry->data_list = data_list;
+    Indtext_Index_Count++;
+
+    return true;
+#else
+    (void)data_list;
+    return false;
+#endif
+}
+
 /**
  * @brief Search a list of strings to find a matching string
  * @param data_list - list of strings and indices
@@ -25,8 +308,23 @@ bool indtext_by_string(
     bool found = false;
     unsigned index = 0;
 
+#if INDTEXT_INDEX_POOL_SIZE
+    const struct indtext_index *entry;
+#endif
+
     if (data_list && search_name) {
-        while (data_list->pString) {
+#if INDTEXT_INDEX_POOL_SIZE
+        entry = indtext_index(data_list);
+        if (entry && entry->size) {
+            data_list = indtext_index_string(entry, search_name, false);
+            if (data_list) {
+                index = data_list->index;
+                found = true;
+            }
+            data_list = NULL;
+        }
+#endif
+        while (data_list && data_list->pString) {
             if (strcmp(data_list->pString, search_name) == 0) {
                 index = data_list->index;
                 found = true;
@@ -56,8 +354,23 @@ bool indtext_by_istring(
     bool found = false;
     unsigned index = 0;
 
+#if INDTEXT_INDEX_POOL_SIZE
+    const struct indtext_index *entry;
+#endif
+
     if (data_list && search_name) {
-        while (data_list->pString) {
+#if INDTEXT_INDEX_POOL_SIZE
+        entry = indtext_index(data_list);
+        if (entry && entry->size) {
+            data_list = indtext_index_string(entry, search_name, true);
+            if (data_list) {
+                index = data_list->index;
+                found = true;
+            }
+            data_list = NULL;
+        }
+#endif
+        while (data_list && data_list->pString) {
             if (bacnet_stricmp(data_list->pString, search_name) == 0) {
                 index = data_list->index;
                 found = true;
@@ -124,9 +437,22 @@ const char *indtext_by_index_default(
     INDTEXT_DATA *data_list, unsigned index, const char *default_string)
 {
     const char *pString = NULL;
+#if INDTEXT_INDEX_POOL_SIZE
+    const struct indtext_index *entry;
+#endif
 
     if (data_list) {
-        while (data_list->pString) {
+#if INDTEXT_INDEX_POOL_SIZE
+        entry = indtext_index(data_list);
+        if (entry && entry->size) {
+            data_list = indtext_index_index(entry, index);
+            if (data_list) {
+                pString = data_list->pString;
+            }
+            data_list = NULL;
+        }
+#endif
+        while (data_list && data_list->pString) {
             if (data_list->index == index) {
                 pString = data_list->pString;
                 break;
@@ -181,8 +507,17 @@ const char *indtext_by_index(INDTEXT_DATA *data_list, unsigned index)
 unsigned indtext_count(INDTEXT_DATA *data_list)
 {
     unsigned count = 0; /* return value */
+#if INDTEXT_INDEX_POOL_SIZE
+    const struct indtext_index *entry;
+#endif
 
     if (data_list) {
+#if INDTEXT_INDEX_POOL_SIZE
+        entry = indtext_index(data_list);
+        if (entry) {
+            return entry->count;
+        }
+#endif
         while (data_list->pString) {
             count++;
             data_list++;
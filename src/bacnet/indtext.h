@@ -70,6 +70,11 @@ const char *indtext_by_index_split_default(
 BACNET_STACK_EXPORT
 unsigned indtext_count(INDTEXT_DATA *data_list);
 
+/* keeps the number of elements of the list and indexes large lists;
+   call at initialization, and do not change the list after */
+BACNET_STACK_EXPORT
+bool indtext_index_register(INDTEXT_DATA *data_list);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -7,6 +7,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -277,6 +278,157 @@ int bacnet_npdu_encode_pdu(
     return pdu_len;
 }
 
+/**
+ * @brief Determine if two routing addresses encode the same NPDU
+ *  DNET/DLEN/DADR or SNET/SLEN/SADR fields
+ * @param address1 [in] routing address, or NULL
+ * @param address2 [in] routing address, or NULL
+ * @param net_len_required [in] true if the fields are only present when
+ *  both the network number and the address length are non-zero,
+ *  as for the source address
+ * @return true if the addresses encode the same fields
+ */
+static bool npdu_header_address_same(
+    const BACNET_ADDRESS *address1,
+    const BACNET_ADDRESS *address2,
+    bool net_len_required)
+{
+    bool present1 = false, present2 = false;
+    uint8_t i = 0;
+
+    if (address1 && address1->net) {
+        present1 = net_len_required ? (address1->len > 0) : true;
+    }
+    if (address2 && address2->net) {
+        present2 = net_len_required ? (address2->len > 0) : true;
+    }
+    if (present1 != present2) {
+        return false;
+    }
+    if (!present1) {
+        return true;
+    }
+    if ((address1->net != address2->net) || (address1->len != address2->len) ||
+        (address1->len > MAX_MAC_LEN)) {
+        return false;
+    }
+    for (i = 0; i < address1->len; i++) {
+        if (address1->adr[i] != address2->adr[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determine if the encoded NPDU header was encoded from values
+ *  that encode the same bytes
+ * @param header [in] encoded NPDU header
+ * @param dest [in] routing destination, or NULL
+ * @param src [in] routing source, or NULL
+ * @param npdu_data [in] NPCI to encode
+ * @return true if the encoded NPDU header can be used as is
+ */
+static bool npdu_header_same(
+    const BACNET_NPDU_HEADER *header,
+    const BACNET_ADDRESS *dest,
+    const BACNET_ADDRESS *src,
+    const BACNET_NPDU_DATA *npdu_data)
+{
+    const BACNET_NPDU_DATA *data = &header->npdu_data;
+
+    if ((header->pdu_len == 0) ||
+        (data->protocol_version != npdu_data->protocol_version) ||
+        (data->network_layer_message != npdu_data->network_layer_message) ||
+        (data->data_expecting_reply != npdu_data->data_expecting_reply) ||
+        ((data->priority & 0x03) != (npdu_data->priority & 0x03))) {
+        return false;
+    }
+    if (!npdu_header_address_same(&header->dest, dest, false) ||
+        !npdu_header_address_same(&header->src, src, true)) {
+        return false;
+    }
+    if (dest && dest->net && (data->hop_count != npdu_data->hop_count)) {
+        return false;
+    }
+    if (npdu_data->network_layer_message) {
+        if (data->network_message_type != npdu_data->network_message_type) {
+            return false;
+        }
+        if ((npdu_data->network_message_type >= 0x80) &&
+            (data->vendor_id != npdu_data->vendor_id)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Initialize an encoded NPDU header, so that nothing is encoded
+ * @param header [out] encoded NPDU header
+ */
+void npdu_header_init(BACNET_NPDU_HEADER *header)
+{
+    if (header) {
+        header->pdu_len = 0;
+    }
+}
+
+/**
+ * @brief Encode the NPDU portion of a message to be sent, copying the
+ *  bytes of the encoded NPDU header when the destination, source and
+ *  NPCI encode the same bytes as last time, and otherwise encoding
+ *  and keeping them in the NPDU header.
+ * @param header [in,out] encoded NPDU header
+ * @param pdu [out] Buffer which will hold the encoded NPDU header bytes,
+ *  which must be at least MAX_NPDU bytes, or NULL for the length
+ * @param dest [in] The routing destination information, see npdu_encode_pdu()
+ * @param src  [in] The routing source information, see npdu_encode_pdu()
+ * @param npdu_data [in] The structure which describes how the NCPI and other
+ *  NPDU bytes should be encoded.
+ * @return the number of bytes which were encoded into the NPDU section,
+ *  or 0 if there were problems with the data or encoding.
+ */
+int npdu_header_encode(
+    BACNET_NPDU_HEADER *header,
+    uint8_t *pdu,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    const BACNET_NPDU_DATA *npdu_data)
+{
+    int len = 0;
+
+    if (!header || !npdu_data) {
+        return npdu_encode_pdu(pdu, dest, src, npdu_data);
+    }
+    if (!npdu_header_same(header, dest, src, npdu_data)) {
+        len = npdu_encode_pdu(header->pdu, dest, src, npdu_data);
+        if ((len <= 0) || (len > (int)sizeof(header->pdu))) {
+            header->pdu_len = 0;
+            return npdu_encode_pdu(pdu, dest, src, npdu_data);
+        }
+        header->pdu_len = (uint8_t)len;
+        if (dest) {
+            memcpy(&header->dest, dest, sizeof(header->dest));
+        } else {
+            memset(&header->dest, 0, sizeof(header->dest));
+        }
+        if (src) {
+            memcpy(&header->src, src, sizeof(header->src));
+        } else {
+            memset(&header->src, 0, sizeof(header->src));
+        }
+        npdu_copy_data(&header->npdu_data, npdu_data);
+    }
+    if (pdu) {
+        memcpy(pdu, header->pdu, header->pdu_len);
+    }
+
+    return header->pdu_len;
+}
+
 /* Configure the NPDU portion of the packet for an APDU */
 /* This function does not handle the network messages, just APDUs. */
 /* From BACnet 5.1:
@@ -441,6 +593,31 @@ int bacnet_npdu_decode(
     uint8_t dlen = 0;
     uint8_t mac_octet = 0;
 
+    if (npdu && npdu_data && (pdu_len >= 2) &&
+        ((npdu[1] & (BIT(7) | BIT(5) | BIT(3))) == 0)) {
+        /* fast path for the most common case: a local APDU that is
+           neither routed nor a network layer message */
+        npdu_data->protocol_version = npdu[0];
+        npdu_data->network_layer_message = false;
+        npdu_data->data_expecting_reply = (npdu[1] & BIT(2)) ? true : false;
+        npdu_data->priority = (BACNET_MESSAGE_PRIORITY)(npdu[1] & 0x03);
+        npdu_data->hop_count = 0;
+        npdu_data->network_message_type = NETWORK_MESSAGE_INVALID;
+        if (dest) {
+            dest->net = 0;
+            dest->len = 0;
+            memset(dest->adr, 0, sizeof(dest->adr));
+        }
+        if (src) {
+            /* keep BACNET_BROADCAST_NETWORK, see below */
+            if (src->net != BACNET_BROADCAST_NETWORK) {
+                src->net = 0;
+            }
+            src->len = 0;
+            memset(src->adr, 0, sizeof(src->adr));
+        }
+        return 2;
+    }
     if (npdu && npdu_data && (pdu_len >= 2)) {
         /* Protocol Version */
         npdu_data->protocol_version = npdu[0];
@@ -54,6 +54,20 @@ typedef struct router_port_t {
     struct router_port_t *next; /**< Point to next in linked list */
 } BACNET_ROUTER_PORT;
 
+/**
+ * An encoded NPDU header, kept with the destination, source and NPCI it
+ * was encoded from, so that messages sent again with the same values,
+ * such as segments and retries, copy the header instead of encoding it.
+ */
+typedef struct bacnet_npdu_header_t {
+    BACNET_ADDRESS dest;
+    BACNET_ADDRESS src;
+    BACNET_NPDU_DATA npdu_data;
+    uint8_t pdu[MAX_NPDU];
+    /* number of encoded bytes, or 0 if nothing is encoded */
+    uint8_t pdu_len;
+} BACNET_NPDU_HEADER;
+
 #define NETWORK_NUMBER_LEARNED 0
 #define NETWORK_NUMBER_CONFIGURED 1
 
@@ -79,6 +93,16 @@ int bacnet_npdu_encode_pdu(
     BACNET_ADDRESS *src,
     const BACNET_NPDU_DATA *npdu_data);
 
+BACNET_STACK_EXPORT
+void npdu_header_init(BACNET_NPDU_HEADER *header);
+BACNET_STACK_EXPORT
+int npdu_header_encode(
+    BACNET_NPDU_HEADER *header,
+    uint8_t *pdu,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    const BACNET_NPDU_DATA *npdu_data);
+
 BACNET_STACK_EXPORT
 void npdu_encode_npdu_data(
     BACNET_NPDU_DATA *npdu,
@@ -1662,6 +1662,88 @@ static void testCharacterStringContextDecodes(void)
     zassert_equal(strcmp(in.value, out.value), 0, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, testCharacterStringViewDecodes)
+#else
+static void testCharacterStringViewDecodes(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU];
+    int inLen;
+    int outLen;
+    BACNET_CHARACTER_STRING in;
+    BACNET_CHARACTER_STRING_VIEW view;
+    BACNET_CHARACTER_STRING_VIEW out;
+    BACNET_OCTET_STRING octets;
+    BACNET_OCTET_STRING_VIEW octets_view;
+
+    characterstring_init_ansi(&in, "This is a test");
+    characterstring_view_from_string(&view, &in);
+    /* views encode the same as strings */
+    inLen = encode_application_character_string(apdu, &in);
+    zassert_equal(
+        encode_application_character_string_view(NULL, &view), inLen, NULL);
+    outLen = bacnet_character_string_view_application_decode(
+        apdu, inLen, &out);
+    zassert_equal(inLen, outLen, NULL);
+    /* the view points into the APDU */
+    zassert_true((const uint8_t *)out.value > apdu, NULL);
+    zassert_true((const uint8_t *)out.value < &apdu[inLen], NULL);
+    zassert_true(characterstring_view_string_same(&out, &in), NULL);
+    outLen = bacnet_character_string_view_application_decode(
+        apdu, inLen - 1, &out);
+    zassert_equal(outLen, BACNET_STATUS_ERROR, NULL);
+    outLen = bacnet_character_string_view_context_decode(
+        apdu, inLen, 1, &out);
+    zassert_equal(outLen, 0, NULL);
+    inLen = encode_context_character_string_view(apdu, 3, &view);
+    outLen = bacnet_character_string_view_context_decode(
+        apdu, inLen, 3, &out);
+    zassert_equal(inLen, outLen, NULL);
+    zassert_true(characterstring_view_same(&out, &view), NULL);
+    /* octet strings */
+    octetstring_init(&octets, (const uint8_t *)"1234", 4);
+    inLen = encode_application_octet_string(apdu, &octets);
+    outLen = bacnet_octet_string_view_application_decode(
+        apdu, inLen, &octets_view);
+    zassert_equal(inLen, outLen, NULL);
+    zassert_equal(octets_view.length, 4, NULL);
+    zassert_equal(memcmp(octets_view.value, "1234", 4), 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, testBACnetEnclosedDataLength)
+#else
+static void testBACnetEnclosedDataLength(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU];
+    BACNET_CHARACTER_STRING name;
+    int apdu_len = 0, len;
+    int inner_len;
+
+    characterstring_init_ansi(&name, "This is a test");
+    /* [3 [20 name 1.0 ]20 true [4 ]4 ]3 null */
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 3);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 20);
+    inner_len = encode_application_character_string(&apdu[apdu_len], &name);
+    inner_len += encode_application_real(&apdu[apdu_len + inner_len], 1.0f);
+    apdu_len += inner_len;
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 20);
+    apdu_len += encode_application_boolean(&apdu[apdu_len], true);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 3);
+    apdu_len += encode_application_null(&apdu[apdu_len]);
+
+    len = bacnet_enclosed_data_length(apdu, apdu_len);
+    zassert_equal(len, apdu_len - 3, NULL);
+    len = bacnet_enclosed_data_length(&apdu[1], apdu_len - 1);
+    zassert_equal(len, inner_len, NULL);
+    len = bacnet_enclosed_data_length(apdu, apdu_len - 2);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(bacdcode_tests, testBitStringContextDecodes)
 #else
@@ -2029,6 +2111,8 @@ void test_main(void)
         ztest_unit_test(testFloatContextDecodes),
         ztest_unit_test(testDoubleContextDecodes),
         ztest_unit_test(testObjectIDContextDecodes),
+        ztest_unit_test(testCharacterStringViewDecodes),
+        ztest_unit_test(testBACnetEnclosedDataLength),
         ztest_unit_test(testBitStringContextDecodes),
         ztest_unit_test(testTimeContextDecodes),
         ztest_unit_test(testDateContextDecodes),
@@ -179,6 +179,68 @@ static void testCharacterString(void)
     zassert_equal(strncmp(value, test_append_string, strlen(value)), 0, NULL);
 }
 
+/**
+ * @brief Test the character string view API
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacstr_tests, testCharacterStringView)
+#else
+static void testCharacterStringView(void)
+#endif
+{
+    BACNET_CHARACTER_STRING bacnet_string;
+    BACNET_CHARACTER_STRING_VIEW view, view2;
+    const char *value = "Patricia and the Kids";
+    char buffer[8] = "Patrick";
+    bool status = false;
+
+    status = characterstring_view_init(NULL, CHARACTER_ANSI_X34, value, 1);
+    zassert_false(status, NULL);
+    status = characterstring_view_init(&view, CHARACTER_ANSI_X34, NULL, 1);
+    zassert_false(status, NULL);
+    /* views do not copy */
+    status = characterstring_view_init(&view, CHARACTER_ANSI_X34, buffer, 5);
+    zassert_true(status, NULL);
+    zassert_equal(view.value, buffer, NULL);
+    zassert_equal(view.length, 5, NULL);
+    zassert_true(characterstring_view_ansi_same(&view, "Patri"), NULL);
+    zassert_false(characterstring_view_ansi_same(&view, "Patrick"), NULL);
+    buffer[0] = 'M';
+    zassert_true(characterstring_view_ansi_same(&view, "Matri"), NULL);
+    /* copy into a string and compare */
+    status = characterstring_view_init_ansi(&view, value);
+    zassert_true(status, NULL);
+    status = characterstring_view_copy(&bacnet_string, &view);
+    zassert_true(status, NULL);
+    zassert_true(characterstring_ansi_same(&bacnet_string, value), NULL);
+    zassert_true(characterstring_view_string_same(&view, &bacnet_string), NULL);
+    status = characterstring_view_from_string(&view2, &bacnet_string);
+    zassert_true(status, NULL);
+    zassert_true(characterstring_view_same(&view, &view2), NULL);
+    /* the encoding is part of the value */
+    view2.encoding = CHARACTER_UCS2;
+    zassert_false(characterstring_view_same(&view, &view2), NULL);
+    zassert_true(characterstring_view_printable(&view), NULL);
+    status = characterstring_view_init(&view2, CHARACTER_ANSI_X34, "\t", 1);
+    zassert_true(status, NULL);
+    zassert_false(characterstring_view_printable(&view2), NULL);
+    /* empty views */
+    status = characterstring_view_init_ansi(&view, NULL);
+    zassert_true(status, NULL);
+    zassert_true(characterstring_view_ansi_same(&view, ""), NULL);
+    status = characterstring_view_copy(&bacnet_string, &view);
+    zassert_true(status, NULL);
+    zassert_equal(characterstring_length(&bacnet_string), 0, NULL);
+    zassert_equal(characterstring_value(&bacnet_string)[0], 0, NULL);
+    /* longer than a string can hold */
+    status = characterstring_view_init(
+        &view, CHARACTER_ANSI_X34, value,
+        characterstring_capacity(&bacnet_string) + 1);
+    zassert_true(status, NULL);
+    status = characterstring_view_copy(&bacnet_string, &view);
+    zassert_false(status, NULL);
+}
+
 /**
  * @brief Test encode/decode API for octet strings
  */
@@ -300,6 +362,41 @@ static void testOctetString(void)
     status = octetstring_init_ascii_hex(NULL, NULL);
     zassert_false(status, NULL);
 }
+/**
+ * @brief Test the octet string view API
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacstr_tests, testOctetStringView)
+#else
+static void testOctetStringView(void)
+#endif
+{
+    BACNET_OCTET_STRING bacnet_string;
+    BACNET_OCTET_STRING_VIEW view, view2;
+    const uint8_t value[] = { 1, 2, 3, 4, 5 };
+    bool status = false;
+
+    status = octetstring_view_init(NULL, value, sizeof(value));
+    zassert_false(status, NULL);
+    status = octetstring_view_init(&view, NULL, 1);
+    zassert_false(status, NULL);
+    status = octetstring_view_init(&view, value, sizeof(value));
+    zassert_true(status, NULL);
+    zassert_equal(view.value, value, NULL);
+    status = octetstring_view_copy(&bacnet_string, &view);
+    zassert_true(status, NULL);
+    zassert_equal(octetstring_length(&bacnet_string), sizeof(value), NULL);
+    status = octetstring_view_from_string(&view2, &bacnet_string);
+    zassert_true(status, NULL);
+    zassert_true(octetstring_view_same(&view, &view2), NULL);
+    view2.length--;
+    zassert_false(octetstring_view_same(&view, &view2), NULL);
+    status = octetstring_view_init(&view, NULL, 0);
+    zassert_true(status, NULL);
+    status = octetstring_view_copy(&bacnet_string, &view);
+    zassert_true(status, NULL);
+    zassert_equal(octetstring_length(&bacnet_string), 0, NULL);
+}
 /**
  * @}
  */
@@ -311,7 +408,9 @@ void test_main(void)
 {
     ztest_test_suite(
         bacstr_tests, ztest_unit_test(testBitString),
-        ztest_unit_test(testCharacterString), ztest_unit_test(testOctetString));
+        ztest_unit_test(testCharacterString),
+        ztest_unit_test(testCharacterStringView),
+        ztest_unit_test(testOctetString), ztest_unit_test(testOctetStringView));
 
     ztest_run_test_suite(bacstr_tests);
 }
@@ -323,8 +323,66 @@ static void test_BBMD_Result(void)
     }
 }
 
+/**
+ * @brief Test the VMAC table lookups in both directions
+ */
+static void test_VMAC_Index(void)
+{
+    struct vmac_data vmac = { 0 };
+    struct vmac_data *found = NULL;
+    uint32_t device_id = 0;
+    uint32_t i = 0;
+    const uint32_t count = 1000;
+
+    VMAC_Init();
+    for (i = 0; i < count; i++) {
+        vmac.mac_len = 18;
+        memset(vmac.mac, 0, sizeof(vmac.mac));
+        encode_unsigned32(&vmac.mac[12], i * 7);
+        encode_unsigned16(&vmac.mac[16], 0xBAC0);
+        assert(VMAC_Add(i, &vmac));
+    }
+    assert(VMAC_Count() == count);
+    /* duplicate device ID is not added */
+    assert(!VMAC_Add(5, &vmac));
+    for (i = 0; i < count; i++) {
+        memset(vmac.mac, 0, sizeof(vmac.mac));
+        encode_unsigned32(&vmac.mac[12], i * 7);
+        encode_unsigned16(&vmac.mac[16], 0xBAC0);
+        assert(VMAC_Find_By_Data(&vmac, &device_id));
+        assert(device_id == i);
+        found = VMAC_Find_By_Key(i);
+        assert(found != NULL);
+        assert(VMAC_Match(found, &vmac));
+    }
+    /* the MAC index follows an update */
+    memset(vmac.mac, 0, sizeof(vmac.mac));
+    encode_unsigned32(&vmac.mac[12], 3 * 7);
+    encode_unsigned16(&vmac.mac[16], 0xBAC0);
+    vmac.mac[0] = 0xFE;
+    assert(VMAC_Update(3, &vmac));
+    assert(VMAC_Find_By_Data(&vmac, &device_id));
+    assert(device_id == 3);
+    vmac.mac[0] = 0;
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    assert(!VMAC_Update(count, &vmac));
+    /* deleted entries are gone from both indexes */
+    memset(vmac.mac, 0, sizeof(vmac.mac));
+    encode_unsigned32(&vmac.mac[12], 4 * 7);
+    encode_unsigned16(&vmac.mac[16], 0xBAC0);
+    assert(VMAC_Delete(4));
+    assert(VMAC_Find_By_Key(4) == NULL);
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    assert(VMAC_Find_By_Key(5) != NULL);
+    assert(VMAC_Count() == (count - 1));
+    VMAC_Cleanup();
+    assert(VMAC_Count() == 0);
+    assert(VMAC_Find_By_Key(5) == NULL);
+}
+
 int main(void)
 {
+    test_VMAC_Index();
     test_BBMD_Result();
     test_Execute_Virtual_Address_Resolution();
     test_Initiate_Original_Broadcast_NPDU();
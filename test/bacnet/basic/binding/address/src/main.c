@@ -197,6 +197,141 @@ static void testAddress(void)
         zassert_equal(count, (MAX_ADDRESS_CACHE - i - 1), NULL);
     }
 }
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressTimeToLive)
+#else
+static void testAddressTimeToLive(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 }, test_address = { 0 };
+    uint32_t device_id = 1234, test_device_id = 0, device_ttl = 0;
+    unsigned max_apdu = 480, test_max_apdu = 0;
+
+    address_init();
+    set_address(1, &src);
+    address_add(device_id, max_apdu, &src);
+    address_set_device_TTL(device_id, 100, false);
+    zassert_true(
+        address_device_get_by_index(
+            0, &test_device_id, &device_ttl, &test_max_apdu, &test_address),
+        NULL);
+    zassert_equal(device_ttl, 100, NULL);
+    /* expires only once the elapsed time exceeds the TTL */
+    address_cache_timer(60);
+    address_cache_timer(40);
+    zassert_true(
+        address_device_get_by_index(
+            0, &test_device_id, &device_ttl, &test_max_apdu, &test_address),
+        NULL);
+    zassert_equal(device_ttl, 0, NULL);
+    address_cache_timer(1);
+    zassert_false(address_get_device_id(&src, &test_device_id), NULL);
+    zassert_equal(address_count(), 0, NULL);
+    /* static entries never expire, even after many laps of the wheel */
+    address_add(device_id, max_apdu, &src);
+    address_set_device_TTL(device_id, 0, true);
+    address_cache_timer(UINT16_MAX);
+    address_cache_timer(UINT16_MAX);
+    zassert_true(address_get_device_id(&src, &test_device_id), NULL);
+    zassert_equal(test_device_id, device_id, NULL);
+    /* a long elapsed time removes entries from every slot */
+    address_set_device_TTL(device_id, 1000, false);
+    address_cache_timer(999);
+    zassert_true(address_get_device_id(&src, &test_device_id), NULL);
+    address_cache_timer(UINT16_MAX);
+    zassert_false(address_get_device_id(&src, &test_device_id), NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressTimerWheel)
+#else
+static void testAddressTimerWheel(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 };
+    unsigned max_apdu = 480;
+    unsigned i, elapsed, count, entries;
+
+    /* times to live in the one-second slots, in the slots of a lap, and
+       on the overflow list of a wheel of ADDRESS_CACHE_WHEEL_SIZE */
+    entries = MAX_ADDRESS_CACHE;
+    if (entries > 200) {
+        entries = 200;
+    }
+    address_init();
+    /* start part way into a lap */
+    address_cache_timer(3);
+    for (i = 0; i < entries; i++) {
+        set_address(i, &src);
+        address_add(i + 1, max_apdu, &src);
+        address_set_device_TTL(i + 1, (i * 37) % 200, false);
+    }
+    zassert_equal(address_count(), entries, NULL);
+    /* each entry expires once the elapsed time exceeds its TTL */
+    for (elapsed = 1; elapsed <= 201; elapsed++) {
+        address_cache_timer(1);
+        count = 0;
+        for (i = 0; i < entries; i++) {
+            if (((i * 37) % 200) >= elapsed) {
+                count++;
+            }
+        }
+        zassert_equal(address_count(), count, NULL);
+    }
+    zassert_equal(address_count(), 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressEviction)
+#else
+static void testAddressEviction(void)
+#endif
+{
+    unsigned i;
+    BACNET_ADDRESS src = { 0 }, test_address = { 0 };
+    uint32_t test_device_id = 0;
+    unsigned max_apdu = 480, test_max_apdu = 0;
+
+    address_init();
+    for (i = 0; i < MAX_ADDRESS_CACHE; i++) {
+        set_address(i, &src);
+        address_add(i + 1, max_apdu, &src);
+    }
+    /* use the first device so that the second is least recently used */
+    zassert_true(address_get_by_device(1, &test_max_apdu, &test_address), NULL);
+    set_address(MAX_ADDRESS_CACHE, &src);
+    address_add(MAX_ADDRESS_CACHE + 1, max_apdu, &src);
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE, NULL);
+    zassert_true(address_get_by_device(1, &test_max_apdu, &test_address), NULL);
+    zassert_false(
+        address_get_by_device(2, &test_max_apdu, &test_address), NULL);
+    zassert_true(address_get_device_id(&src, &test_device_id), NULL);
+    zassert_equal(test_device_id, MAX_ADDRESS_CACHE + 1, NULL);
+    /* protected entries are not evicted while others are available */
+    address_protected_entry_index_set(3);
+    zassert_true(address_get_by_device(4, &test_max_apdu, &test_address), NULL);
+    set_address(MAX_ADDRESS_CACHE + 1, &src);
+    address_add(MAX_ADDRESS_CACHE + 2, max_apdu, &src);
+    zassert_true(address_get_by_device(1, &test_max_apdu, &test_address), NULL);
+    zassert_true(address_get_by_device(3, &test_max_apdu, &test_address), NULL);
+    zassert_false(
+        address_get_by_device(5, &test_max_apdu, &test_address), NULL);
+    /* static entries are never evicted */
+    address_init();
+    for (i = 0; i < MAX_ADDRESS_CACHE; i++) {
+        set_address(i, &src);
+        address_add(i + 1, max_apdu, &src);
+        address_set_device_TTL(i + 1, 0, true);
+    }
+    set_address(MAX_ADDRESS_CACHE, &src);
+    address_add(MAX_ADDRESS_CACHE + 1, max_apdu, &src);
+    zassert_false(
+        address_get_by_device(
+            MAX_ADDRESS_CACHE + 1, &test_max_apdu, &test_address),
+        NULL);
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE, NULL);
+}
 /**
  * @}
  */
@@ -209,11 +344,18 @@ void test_main(void)
 #ifdef BACNET_ADDRESS_CACHE_FILE
     ztest_test_suite(
         address_tests, ztest_unit_test(testAddressFile),
-        ztest_unit_test(testAddress));
+        ztest_unit_test(testAddress),
+        ztest_unit_test(testAddressTimeToLive),
+        ztest_unit_test(testAddressTimerWheel),
+        ztest_unit_test(testAddressEviction));
 
     ztest_run_test_suite(address_tests);
 #else
-    ztest_test_suite(address_tests, ztest_unit_test(testAddress));
+    ztest_test_suite(
+        address_tests, ztest_unit_test(testAddress),
+        ztest_unit_test(testAddressTimeToLive),
+        ztest_unit_test(testAddressTimerWheel),
+        ztest_unit_test(testAddressEviction));
 
     ztest_run_test_suite(address_tests);
 #endif
@@ -0,0 +1,446 @@
+/**
+ * @file
+ * @brief test the receive filter of the BACnet NPDU handler
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/iam.h>
+#include <bacnet/npdu.h>
+#include <bacnet/timesync.h>
+#include <bacnet/whohas.h>
+#include <bacnet/whois.h>
+#include <bacnet/basic/npdu/h_npdu.h>
+#include <bacnet/basic/service/h_apdu.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_DEVICE_INSTANCE 1234
+
+/* services that were dispatched and would answer */
+static unsigned Test_Response_Count;
+/* network layer messages sent */
+static unsigned Test_Send_Count;
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return TEST_DEVICE_INSTANCE;
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(BACNET_ADDRESS));
+}
+
+void bip_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    memset(dest, 0, sizeof(BACNET_ADDRESS));
+    dest->net = BACNET_BROADCAST_NETWORK;
+}
+
+int bip_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+    Test_Send_Count++;
+    return (int)pdu_len;
+}
+
+bool dcc_communication_disabled(void)
+{
+    return false;
+}
+
+bool dcc_communication_initiation_disabled(void)
+{
+    return false;
+}
+
+void tsm_free_invoke_id(uint8_t invokeID)
+{
+    (void)invokeID;
+}
+
+static bool test_range_includes(int32_t low_limit, int32_t high_limit)
+{
+    if ((low_limit == -1) && (high_limit == -1)) {
+        return true;
+    }
+
+    return (TEST_DEVICE_INSTANCE >= low_limit) &&
+        (TEST_DEVICE_INSTANCE <= high_limit);
+}
+
+static void test_handler_who_is(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    int32_t low_limit = -1;
+    int32_t high_limit = -1;
+    int len;
+
+    (void)src;
+    len = whois_decode_service_request(
+        service_request, service_len, &low_limit, &high_limit);
+    if ((len >= 0) && test_range_includes(low_limit, high_limit)) {
+        Test_Response_Count++;
+    }
+}
+
+static void test_handler_who_has(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    BACNET_WHO_HAS_DATA data = { 0 };
+    int len;
+
+    (void)src;
+    len = whohas_decode_service_request(service_request, service_len, &data);
+    if ((len > 0) && test_range_includes(data.low_limit, data.high_limit)) {
+        Test_Response_Count++;
+    }
+}
+
+static void test_handler_i_am(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    Test_Response_Count++;
+}
+
+static void test_handler_read_property(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Test_Response_Count++;
+}
+
+/**
+ * @brief Enable or disable every receive filter rule
+ * @param enable - true to enable the rules
+ */
+static void test_filter_rules_enable(bool enable)
+{
+    unsigned rule;
+
+    for (rule = NPDU_FILTER_NONE + 1; rule < NPDU_FILTER_MAX; rule++) {
+        npdu_filter_rule_enable((BACNET_NPDU_FILTER_RULE)rule, enable);
+    }
+}
+
+/**
+ * @brief Handle a PDU with the filter, and again with the full decode only,
+ *  and check that both have the same outcome
+ * @param pdu - the NPDU and APDU
+ * @param pdu_len - number of bytes in the PDU
+ * @param rule - the rule that is expected to drop the PDU, or
+ *  NPDU_FILTER_NONE
+ * @return number of services that were dispatched and would answer
+ */
+static unsigned
+test_npdu_filter(uint8_t *pdu, uint16_t pdu_len, BACNET_NPDU_FILTER_RULE rule)
+{
+    BACNET_ADDRESS src = { 0 };
+    unsigned response_count;
+    unsigned send_count;
+
+    test_filter_rules_enable(true);
+    zassert_equal(npdu_filter_classify(pdu, pdu_len), rule, NULL);
+    npdu_filter_count_reset();
+    Test_Response_Count = 0;
+    Test_Send_Count = 0;
+    npdu_handler(&src, pdu, pdu_len);
+    if (rule != NPDU_FILTER_NONE) {
+        zassert_equal(npdu_filter_count(rule), 1, NULL);
+    }
+    response_count = Test_Response_Count;
+    send_count = Test_Send_Count;
+    /* the old path: decode everything, and let the handlers discard */
+    test_filter_rules_enable(false);
+    zassert_equal(npdu_filter_classify(pdu, pdu_len), NPDU_FILTER_NONE, NULL);
+    Test_Response_Count = 0;
+    Test_Send_Count = 0;
+    npdu_handler(&src, pdu, pdu_len);
+    zassert_equal(Test_Response_Count, response_count, NULL);
+    zassert_equal(Test_Send_Count, send_count, NULL);
+    test_filter_rules_enable(true);
+
+    return response_count;
+}
+
+/**
+ * @brief Encode an NPDU header for an APDU
+ * @param pdu - buffer for the NPDU
+ * @param dnet - destination network, or 0 for a local message
+ * @return number of bytes encoded
+ */
+static int test_npdu_encode(uint8_t *pdu, uint16_t dnet)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+
+    dest.net = dnet;
+    if ((dnet != 0) && (dnet != BACNET_BROADCAST_NETWORK)) {
+        dest.len = 1;
+        dest.adr[0] = 7;
+    }
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+
+    return npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+}
+
+/**
+ * @brief Encode a ReadProperty request of the Device object name
+ * @param apdu - buffer for the APDU
+ * @return number of bytes encoded
+ */
+static int test_read_property_encode(uint8_t *apdu)
+{
+    int len = 0;
+
+    apdu[len++] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+    apdu[len++] = encode_max_segs_max_apdu(0, MAX_APDU);
+    apdu[len++] = 1;
+    apdu[len++] = SERVICE_CONFIRMED_READ_PROPERTY;
+    len += encode_context_object_id(
+        &apdu[len], 0, OBJECT_DEVICE, TEST_DEVICE_INSTANCE);
+    len += encode_context_enumerated(&apdu[len], 1, PROP_OBJECT_NAME);
+
+    return len;
+}
+
+static void test_setup(void)
+{
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_WHO_IS, test_handler_who_is);
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_WHO_HAS, test_handler_who_has);
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, test_handler_i_am);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, test_handler_read_property);
+    npdu_filter_unconfirmed_handled_set(apdu_unconfirmed_service_handled);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_npdu_tests, test_npdu_filter_dnet)
+#else
+static void test_npdu_filter_dnet(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    test_setup();
+    /* local and global broadcast messages are for us */
+    len = test_npdu_encode(pdu, 0);
+    len += iam_encode_apdu(&pdu[len], 5, MAX_APDU, SEGMENTATION_NONE, 0);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 1, NULL);
+    len = test_npdu_encode(pdu, BACNET_BROADCAST_NETWORK);
+    len += whois_encode_apdu(&pdu[len], -1, -1);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 1, NULL);
+    /* messages for another network are for a router */
+    len = test_npdu_encode(pdu, 5);
+    len += whois_encode_apdu(&pdu[len], -1, -1);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_DNET), 0, NULL);
+    dest.net = 5;
+    dest.len = 1;
+    dest.adr[0] = 7;
+    npdu_encode_npdu_network(
+        &npdu_data, NETWORK_MESSAGE_WHAT_IS_NETWORK_NUMBER, false,
+        MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_DNET), 0, NULL);
+    /* network layer messages for us are always decoded */
+    npdu_network_number_set(9);
+    len = npdu_encode_pdu(pdu, NULL, NULL, &npdu_data);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 0, NULL);
+    zassert_equal(Test_Send_Count, 1, NULL);
+    npdu_network_number_set(0);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_npdu_tests, test_npdu_filter_confirmed_broadcast)
+#else
+static void test_npdu_filter_confirmed_broadcast(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    int len;
+
+    test_setup();
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+    len += test_read_property_encode(&pdu[len]);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 1, NULL);
+    /* 5.4.5.1 - IDLE: ConfirmedBroadcastReceived */
+    dest.net = BACNET_BROADCAST_NETWORK;
+    len = npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+    len += test_read_property_encode(&pdu[len]);
+    zassert_equal(
+        test_npdu_filter(pdu, len, NPDU_FILTER_CONFIRMED_BROADCAST), 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_npdu_tests, test_npdu_filter_unhandled)
+#else
+static void test_npdu_filter_unhandled(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_DATE bdate = { 0 };
+    BACNET_TIME btime = { 0 };
+    int len;
+
+    test_setup();
+    datetime_set_date(&bdate, 2026, 10, 18);
+    datetime_set_time(&btime, 12, 0, 0, 0);
+    len = test_npdu_encode(pdu, 0);
+    len += timesync_encode_apdu(&pdu[len], &bdate, &btime);
+    zassert_equal(
+        test_npdu_filter(pdu, len, NPDU_FILTER_UNCONFIRMED_UNHANDLED), 0,
+        NULL);
+    /* without a function telling the handled services, the rule is not
+       used even when it is enabled */
+    npdu_filter_unconfirmed_handled_set(NULL);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 0, NULL);
+    npdu_filter_unconfirmed_handled_set(apdu_unconfirmed_service_handled);
+    /* an unconfirmed request without a service choice */
+    len = test_npdu_encode(pdu, 0);
+    pdu[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_npdu_tests, test_npdu_filter_range)
+#else
+static void test_npdu_filter_range(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_WHO_HAS_DATA data = { 0 };
+    int len;
+
+    test_setup();
+    len = test_npdu_encode(pdu, 0);
+    len += whois_encode_apdu(
+        &pdu[len], TEST_DEVICE_INSTANCE, TEST_DEVICE_INSTANCE);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 1, NULL);
+    len = test_npdu_encode(pdu, 0);
+    len += whois_encode_apdu(&pdu[len], 0, TEST_DEVICE_INSTANCE - 1);
+    zassert_equal(
+        test_npdu_filter(pdu, len, NPDU_FILTER_WHO_IS_RANGE), 0, NULL);
+    len = test_npdu_encode(pdu, 0);
+    len += whois_encode_apdu(
+        &pdu[len], TEST_DEVICE_INSTANCE + 1, BACNET_MAX_INSTANCE);
+    zassert_equal(
+        test_npdu_filter(pdu, len, NPDU_FILTER_WHO_IS_RANGE), 0, NULL);
+    /* a malformed range is left to the service decoder */
+    len = test_npdu_encode(pdu, 0);
+    len += whois_encode_apdu(&pdu[len], 0, TEST_DEVICE_INSTANCE - 1);
+    zassert_equal(test_npdu_filter(pdu, len - 1, NPDU_FILTER_NONE), 0, NULL);
+    /* Who-Has */
+    data.low_limit = 0;
+    data.high_limit = TEST_DEVICE_INSTANCE;
+    data.is_object_name = false;
+    data.object.identifier.type = OBJECT_ANALOG_INPUT;
+    data.object.identifier.instance = 1;
+    len = test_npdu_encode(pdu, 0);
+    len += whohas_encode_apdu(&pdu[len], &data);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 1, NULL);
+    data.high_limit = TEST_DEVICE_INSTANCE - 1;
+    len = test_npdu_encode(pdu, 0);
+    len += whohas_encode_apdu(&pdu[len], &data);
+    zassert_equal(
+        test_npdu_filter(pdu, len, NPDU_FILTER_WHO_HAS_RANGE), 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_npdu_tests, test_npdu_filter_malformed)
+#else
+static void test_npdu_filter_malformed(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int apdu_len;
+    int len;
+
+    test_setup();
+    apdu_len = whois_encode_apdu(apdu, -1, -1);
+    /* another protocol version */
+    len = test_npdu_encode(pdu, 0);
+    memcpy(&pdu[len], apdu, apdu_len);
+    pdu[0] = BACNET_PROTOCOL_VERSION + 1;
+    zassert_equal(
+        test_npdu_filter(pdu, len + apdu_len, NPDU_FILTER_NONE), 0, NULL);
+    /* truncated headers */
+    len = test_npdu_encode(pdu, 5);
+    memcpy(&pdu[len], apdu, apdu_len);
+    zassert_equal(test_npdu_filter(pdu, 1, NPDU_FILTER_NONE), 0, NULL);
+    zassert_equal(test_npdu_filter(pdu, 4, NPDU_FILTER_NONE), 0, NULL);
+    zassert_equal(test_npdu_filter(pdu, 5, NPDU_FILTER_DNET), 0, NULL);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_DNET), 0, NULL);
+    len = test_npdu_encode(pdu, BACNET_BROADCAST_NETWORK);
+    memcpy(&pdu[len], apdu, apdu_len);
+    zassert_equal(test_npdu_filter(pdu, len, NPDU_FILTER_NONE), 0, NULL);
+    zassert_equal(test_npdu_filter(pdu, len - 1, NPDU_FILTER_NONE), 0, NULL);
+    zassert_equal(
+        test_npdu_filter(pdu, len + apdu_len, NPDU_FILTER_NONE), 1, NULL);
+    /* a DLEN or SLEN beyond the end of the PDU */
+    pdu[4] = 200;
+    zassert_equal(
+        test_npdu_filter(pdu, len + apdu_len, NPDU_FILTER_NONE), 0, NULL);
+    len = test_npdu_encode(pdu, 5);
+    memcpy(&pdu[len], apdu, apdu_len);
+    pdu[4] = 200;
+    zassert_equal(
+        test_npdu_filter(pdu, len + apdu_len, NPDU_FILTER_DNET), 0, NULL);
+    pdu[0] = BACNET_PROTOCOL_VERSION;
+    pdu[1] = BIT(3);
+    pdu[2] = 0;
+    pdu[3] = 5;
+    pdu[4] = 200;
+    memcpy(&pdu[5], apdu, apdu_len);
+    zassert_equal(
+        test_npdu_filter(pdu, 5 + apdu_len, NPDU_FILTER_NONE), 0, NULL);
+    zassert_equal(test_npdu_filter(pdu, 4, NPDU_FILTER_NONE), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_npdu_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        h_npdu_tests, ztest_unit_test(test_npdu_filter_dnet),
+        ztest_unit_test(test_npdu_filter_confirmed_broadcast),
+        ztest_unit_test(test_npdu_filter_unhandled),
+        ztest_unit_test(test_npdu_filter_range),
+        ztest_unit_test(test_npdu_filter_malformed));
+
+    ztest_run_test_suite(h_npdu_tests);
+}
+#endif
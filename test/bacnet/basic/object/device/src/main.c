@@ -7,6 +7,7 @@
  */
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/ai.h>
 #include <bacnet/bactext.h>
 
 /**
@@ -114,6 +115,199 @@ static void test_Device_Data_Sharing(void)
     }
 }
 
+/**
+ * @brief Test the encoded property value cache of ReadProperty
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDevicePropertyCache)
+#else
+static void testDevicePropertyCache(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    BACNET_CHARACTER_STRING test_char_string = { 0 };
+    int len = 0, test_len = 0;
+
+    Device_Init(NULL);
+    zassert_true(
+        Device_Property_Cacheable(OBJECT_DEVICE, PROP_OBJECT_NAME), NULL);
+    zassert_true(
+        Device_Property_Cacheable(OBJECT_DEVICE, PROP_MODEL_NAME), NULL);
+    zassert_true(
+        Device_Property_Cacheable(OBJECT_ANALOG_INPUT, PROP_PROPERTY_LIST),
+        NULL);
+    zassert_false(
+        Device_Property_Cacheable(OBJECT_DEVICE, PROP_LOCAL_TIME), NULL);
+    /* changed by the object *_Set functions without WriteProperty */
+    zassert_false(
+        Device_Property_Cacheable(OBJECT_ANALOG_INPUT, PROP_OBJECT_NAME),
+        NULL);
+    zassert_false(
+        Device_Property_Cacheable(OBJECT_ANALOG_INPUT, PROP_DESCRIPTION),
+        NULL);
+    zassert_false(
+        Device_Property_Cacheable(OBJECT_ANALOG_INPUT, PROP_UNITS), NULL);
+    zassert_false(
+        Device_Property_Cacheable(OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE),
+        NULL);
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    rpdata.object_type = OBJECT_DEVICE;
+    rpdata.object_instance = Device_Object_Instance_Number();
+    rpdata.object_property = PROP_MODEL_NAME;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    Device_Set_Model_Name("Cached", 6);
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    /* cached value */
+    memset(apdu, 0, sizeof(apdu));
+    test_len = Device_Read_Property(&rpdata);
+    zassert_equal(len, test_len, NULL);
+    test_len = bacnet_character_string_application_decode(
+        apdu, len, &char_string);
+    zassert_equal(len, test_len, NULL);
+    zassert_true(characterstring_ansi_same(&char_string, "Cached"), NULL);
+    /* setter forgets the cached value */
+    Device_Set_Model_Name("Changed", 7);
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    test_len = bacnet_character_string_application_decode(
+        apdu, len, &char_string);
+    zassert_equal(len, test_len, NULL);
+    zassert_true(characterstring_ansi_same(&char_string, "Changed"), NULL);
+    /* renaming the device forgets all the cached values */
+    rpdata.object_property = PROP_OBJECT_NAME;
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    characterstring_init_ansi(&test_char_string, "Renamed");
+    zassert_true(Device_Set_Object_Name(&test_char_string), NULL);
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    test_len = bacnet_character_string_application_decode(
+        apdu, len, &char_string);
+    zassert_equal(len, test_len, NULL);
+    zassert_true(characterstring_same(&char_string, &test_char_string), NULL);
+    /* explicit invalidation */
+    Device_Property_Cache_Invalidate(
+        OBJECT_DEVICE, Device_Object_Instance_Number(), PROP_ALL);
+    len = Device_Read_Property(&rpdata);
+    zassert_equal(len, test_len, NULL);
+    /* an object renamed by its setter is read with its new name */
+    Analog_Input_Create(1);
+    rpdata.object_type = OBJECT_ANALOG_INPUT;
+    rpdata.object_instance = 1;
+    zassert_true(Analog_Input_Name_Set(1, "Before"), NULL);
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    zassert_true(Analog_Input_Name_Set(1, "After"), NULL);
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    test_len = bacnet_character_string_application_decode(
+        apdu, len, &char_string);
+    zassert_equal(len, test_len, NULL);
+    zassert_true(characterstring_ansi_same(&char_string, "After"), NULL);
+    Analog_Input_Delete(1);
+    Device_Property_Cache_Clear();
+}
+
+static unsigned Store_Count;
+static unsigned Commit_Count;
+static unsigned Commit_Values;
+
+static bool test_write_property_store(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    (void)wp_data;
+    Store_Count++;
+
+    return true;
+}
+
+static void test_write_property_commit(unsigned count)
+{
+    Commit_Count++;
+    Commit_Values += count;
+}
+
+static bool test_write_property_string(
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    BACNET_PROPERTY_ID object_property,
+    const char *value)
+{
+    BACNET_CHARACTER_STRING char_string = { 0 };
+
+    wp_data->object_type = OBJECT_DEVICE;
+    wp_data->object_instance = Device_Object_Instance_Number();
+    wp_data->object_property = object_property;
+    wp_data->array_index = BACNET_ARRAY_ALL;
+    wp_data->priority = BACNET_NO_PRIORITY;
+    characterstring_init_ansi(&char_string, value);
+    wp_data->application_data_len = encode_application_character_string(
+        wp_data->application_data, &char_string);
+
+    return Device_Write_Property(wp_data);
+}
+
+/**
+ * @brief Test the WriteProperty batch used by WritePropertyMultiple
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceWritePropertyBatch)
+#else
+static void testDeviceWritePropertyBatch(void)
+#endif
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint32_t revision = 0;
+    unsigned i = 0;
+
+    Device_Init(NULL);
+    Device_Write_Property_Store_Callback_Set(test_write_property_store);
+    Device_Write_Property_Commit_Callback_Set(test_write_property_commit);
+    /* a single write is stored and committed right away */
+    Store_Count = Commit_Count = Commit_Values = 0;
+    revision = Device_Database_Revision();
+    zassert_true(
+        test_write_property_string(&wp_data, PROP_OBJECT_NAME, "Single"),
+        NULL);
+    zassert_equal(Device_Database_Revision(), revision + 1, NULL);
+    zassert_equal(Store_Count, 1, NULL);
+    zassert_equal(Commit_Count, 1, NULL);
+    zassert_equal(Commit_Values, 1, NULL);
+    /* a batch defers the side effects until the end */
+    Store_Count = Commit_Count = Commit_Values = 0;
+    revision = Device_Database_Revision();
+    Device_Write_Property_Batch_Begin();
+    zassert_true(
+        test_write_property_string(&wp_data, PROP_OBJECT_NAME, "Batch1"),
+        NULL);
+    zassert_true(
+        test_write_property_string(&wp_data, PROP_OBJECT_NAME, "Batch2"),
+        NULL);
+    zassert_true(
+        test_write_property_string(&wp_data, PROP_LOCATION, "Here"), NULL);
+    zassert_equal(Device_Database_Revision(), revision, NULL);
+    zassert_equal(Store_Count, 0, NULL);
+    /* values are stored once they were all applied, no more than written */
+    for (i = 0; i < 4; i++) {
+        zassert_true(Device_Write_Property_Batch_Store(&wp_data), NULL);
+    }
+    zassert_equal(Store_Count, 3, NULL);
+    zassert_equal(Commit_Count, 0, NULL);
+    zassert_equal(Device_Write_Property_Batch_End(), 3, NULL);
+    zassert_equal(Device_Database_Revision(), revision + 1, NULL);
+    zassert_equal(Commit_Count, 1, NULL);
+    zassert_equal(Commit_Values, 3, NULL);
+    /* an empty batch has no side effects */
+    Device_Write_Property_Batch_Begin();
+    zassert_equal(Device_Write_Property_Batch_End(), 0, NULL);
+    zassert_equal(Device_Database_Revision(), revision + 1, NULL);
+    zassert_equal(Commit_Count, 1, NULL);
+    Device_Write_Property_Store_Callback_Set(NULL);
+    Device_Write_Property_Commit_Callback_Set(NULL);
+}
+
 /**
  * @brief Test basic API
  */
@@ -228,7 +422,9 @@ void test_main(void)
 {
     ztest_test_suite(
         device_tests, ztest_unit_test(testDevice),
-        ztest_unit_test(test_Device_Data_Sharing));
+        ztest_unit_test(test_Device_Data_Sharing),
+        ztest_unit_test(testDevicePropertyCache),
+        ztest_unit_test(testDeviceWritePropertyBatch));
 
     ztest_run_test_suite(device_tests);
 }
@@ -0,0 +1,262 @@
+/**
+ * @file
+ * @brief test the lookup of the routed Devices of a gateway
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/wp.h>
+#include <bacnet/basic/object/device.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_GATEWAY_INSTANCE 100
+#define TEST_DNET 4321
+
+static const int Test_DNET_List[] = { TEST_DNET, -1 };
+
+int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    (void)rpdata;
+    return BACNET_STATUS_ERROR;
+}
+
+bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    (void)wp_data;
+    return false;
+}
+
+void Device_Property_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+}
+
+int bacapp_decode_application_data(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    (void)apdu;
+    (void)apdu_size;
+    (void)value;
+    return BACNET_STATUS_ERROR;
+}
+
+bool write_property_type_valid(
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t expected_tag)
+{
+    (void)wp_data;
+    (void)value;
+    (void)expected_tag;
+    return false;
+}
+
+bool write_property_string_valid(
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    size_t len_max)
+{
+    (void)wp_data;
+    (void)value;
+    (void)len_max;
+    return false;
+}
+
+/**
+ * @brief Get the address of a routed Device on the virtual network
+ * @param address - the address
+ * @param mac - the MAC address of the Device
+ */
+static void test_gw_address(BACNET_ADDRESS *address, uint8_t mac)
+{
+    memset(address, 0, sizeof(BACNET_ADDRESS));
+    address->net = TEST_DNET;
+    address->len = 1;
+    address->adr[0] = mac;
+}
+
+/**
+ * @brief Find a routed Device by its MAC address on the virtual network
+ * @param mac - the MAC address of the Device
+ * @return the instance of the Device, or BACNET_MAX_INSTANCE + 1 if
+ *  no Device has the MAC address
+ */
+static uint32_t test_gw_address_find(uint8_t mac)
+{
+    BACNET_ADDRESS dest;
+    int cursor = 0;
+
+    test_gw_address(&dest, mac);
+    if (!Routed_Device_GetNext(&dest, Test_DNET_List, &cursor)) {
+        return BACNET_MAX_INSTANCE + 1;
+    }
+    zassert_equal(cursor, -1, NULL);
+
+    return Routed_Device_Object_Instance_Number();
+}
+
+/**
+ * @brief Add the gateway and the routed Devices until the table is full.
+ *  Routed Device n has the instance 100 + n and the MAC address n.
+ */
+static void test_gw_setup(void)
+{
+    BACNET_ADDRESS address;
+    uint16_t idx;
+    unsigned i;
+
+    Routed_Device_Cleanup();
+    for (i = 0; i < MAX_NUM_DEVICES; i++) {
+        idx = Add_Routed_Device(TEST_GATEWAY_INSTANCE + i, NULL, NULL);
+        zassert_equal(idx, i, NULL);
+        if (i > 0) {
+            test_gw_address(&address, i);
+            zassert_true(Routed_Device_Address_Set(idx, &address), NULL);
+        }
+    }
+    zassert_equal(Routed_Device_Count(), MAX_NUM_DEVICES, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(gw_device_tests, test_gw_device_add)
+#else
+static void test_gw_device_add(void)
+#endif
+{
+    unsigned i;
+
+    test_gw_setup();
+    /* the table is full */
+    zassert_equal(Add_Routed_Device(999, NULL, NULL), UINT16_MAX, NULL);
+    zassert_equal(Routed_Device_Count(), MAX_NUM_DEVICES, NULL);
+    /* every Device is found, including the ones sharing a bucket */
+    for (i = 0; i < MAX_NUM_DEVICES; i++) {
+        zassert_true(
+            Routed_Device_Valid_Object_Instance_Number(
+                TEST_GATEWAY_INSTANCE + i),
+            NULL);
+        zassert_equal(
+            Routed_Device_Object_Instance_Number(), TEST_GATEWAY_INSTANCE + i,
+            NULL);
+        if (i > 0) {
+            zassert_equal(
+                test_gw_address_find(i), TEST_GATEWAY_INSTANCE + i, NULL);
+        }
+    }
+    Routed_Device_Cleanup();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(gw_device_tests, test_gw_device_miss)
+#else
+static void test_gw_device_miss(void)
+#endif
+{
+    test_gw_setup();
+    zassert_false(Routed_Device_Valid_Object_Instance_Number(999), NULL);
+    zassert_false(
+        Routed_Device_Valid_Object_Instance_Number(
+            TEST_GATEWAY_INSTANCE + MAX_NUM_DEVICES),
+        NULL);
+    zassert_equal(test_gw_address_find(0), BACNET_MAX_INSTANCE + 1, NULL);
+    zassert_equal(
+        test_gw_address_find(MAX_NUM_DEVICES), BACNET_MAX_INSTANCE + 1, NULL);
+    zassert_equal(test_gw_address_find(0xFF), BACNET_MAX_INSTANCE + 1, NULL);
+    Routed_Device_Cleanup();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(gw_device_tests, test_gw_device_rename)
+#else
+static void test_gw_device_rename(void)
+#endif
+{
+    BACNET_ADDRESS address;
+    unsigned i;
+
+    test_gw_setup();
+    /* a new instance is found, and the old one is not */
+    zassert_not_null(Get_Routed_Device_Object(3), NULL);
+    zassert_true(Routed_Device_Set_Object_Instance_Number(200), NULL);
+    zassert_true(Routed_Device_Valid_Object_Instance_Number(200), NULL);
+    zassert_false(
+        Routed_Device_Valid_Object_Instance_Number(TEST_GATEWAY_INSTANCE + 3),
+        NULL);
+    zassert_equal(test_gw_address_find(3), 200, NULL);
+    /* a new address is found, and the old one is not */
+    test_gw_address(&address, 0x33);
+    zassert_true(Routed_Device_Address_Set(3, &address), NULL);
+    zassert_equal(test_gw_address_find(0x33), 200, NULL);
+    zassert_equal(test_gw_address_find(3), BACNET_MAX_INSTANCE + 1, NULL);
+    zassert_false(Routed_Device_Address_Set(MAX_NUM_DEVICES, &address), NULL);
+    /* the other Devices are still found */
+    for (i = 1; i < MAX_NUM_DEVICES; i++) {
+        if (i == 3) {
+            continue;
+        }
+        zassert_true(
+            Routed_Device_Valid_Object_Instance_Number(
+                TEST_GATEWAY_INSTANCE + i),
+            NULL);
+        zassert_equal(
+            test_gw_address_find(i), TEST_GATEWAY_INSTANCE + i, NULL);
+    }
+    Routed_Device_Cleanup();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(gw_device_tests, test_gw_device_remove)
+#else
+static void test_gw_device_remove(void)
+#endif
+{
+    test_gw_setup();
+    Routed_Device_Cleanup();
+    zassert_equal(Routed_Device_Count(), 0, NULL);
+    zassert_false(
+        Routed_Device_Valid_Object_Instance_Number(TEST_GATEWAY_INSTANCE),
+        NULL);
+    zassert_equal(test_gw_address_find(1), BACNET_MAX_INSTANCE + 1, NULL);
+    /* the Devices of the old table are not found in the new one */
+    zassert_equal(
+        Add_Routed_Device(TEST_GATEWAY_INSTANCE, NULL, NULL), 0, NULL);
+    zassert_true(
+        Routed_Device_Valid_Object_Instance_Number(TEST_GATEWAY_INSTANCE),
+        NULL);
+    zassert_false(
+        Routed_Device_Valid_Object_Instance_Number(TEST_GATEWAY_INSTANCE + 1),
+        NULL);
+    zassert_equal(test_gw_address_find(1), BACNET_MAX_INSTANCE + 1, NULL);
+    Routed_Device_Cleanup();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(gw_device_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        gw_device_tests, ztest_unit_test(test_gw_device_add),
+        ztest_unit_test(test_gw_device_miss),
+        ztest_unit_test(test_gw_device_rename),
+        ztest_unit_test(test_gw_device_remove));
+
+    ztest_run_test_suite(gw_device_tests);
+}
+#endif
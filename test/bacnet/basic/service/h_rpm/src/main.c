@@ -0,0 +1,441 @@
+/**
+ * @file
+ * @brief test the ReadPropertyMultiple service handler
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/abort.h>
+#include <bacnet/npdu.h>
+#include <bacnet/rp.h>
+#include <bacnet/rpm.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/tsm/tsm.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_DEVICE_INSTANCE 1234
+#define TEST_INVOKE_ID 42
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+/* the object name of every object */
+static char Test_Object_Name[MAX_CHARACTER_STRING_BYTES];
+/* the number of property values that were read */
+static unsigned Test_Read_Count;
+/* a property value was read past the end of the transmit buffer */
+static bool Test_Read_Overflow;
+/* the PDU that was sent */
+static uint8_t Test_PDU[MAX_PDU];
+static unsigned Test_PDU_Len;
+/* the length of the segmented reply that was handed to the TSM */
+static uint32_t Test_Segmented_Len;
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return TEST_DEVICE_INSTANCE;
+}
+
+uint32_t Network_Port_Index_To_Instance(unsigned index)
+{
+    (void)index;
+    return 1;
+}
+
+bool Device_Valid_Object_Id(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return ((object_type == OBJECT_ANALOG_INPUT) &&
+            ((object_instance == 1) || (object_instance == 2))) ||
+        ((object_type == OBJECT_BINARY_INPUT) && (object_instance == 1));
+}
+
+void Device_Objects_Property_List(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    struct special_property_list_t *pPropertyList)
+{
+    static const int required[] = { PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
+                                    PROP_OBJECT_TYPE, PROP_PRESENT_VALUE,
+                                    -1 };
+    static const int optional[] = { PROP_DESCRIPTION, -1 };
+    static const int proprietary[] = { -1 };
+
+    (void)object_instance;
+    pPropertyList->Required.pList = required;
+    pPropertyList->Required.count = 4;
+    pPropertyList->Optional.pList = optional;
+    pPropertyList->Optional.count = 1;
+    if (object_type == OBJECT_BINARY_INPUT) {
+        /* no optional properties */
+        pPropertyList->Optional.pList = proprietary;
+        pPropertyList->Optional.count = 0;
+    }
+    pPropertyList->Proprietary.pList = proprietary;
+    pPropertyList->Proprietary.count = 0;
+}
+
+bool read_property_bacnet_array_valid(BACNET_READ_PROPERTY_DATA *data)
+{
+    /* none of the test properties is an array */
+    if (data->array_index != BACNET_ARRAY_ALL) {
+        data->error_class = ERROR_CLASS_PROPERTY;
+        data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Encode the value of a test object property
+ * @param apdu - buffer for the value, or NULL for its length
+ * @param object_type - object type
+ * @param object_instance - object instance
+ * @param object_property - property
+ * @return the length of the value, or BACNET_STATUS_ERROR for an
+ *  unknown property
+ */
+static int test_rpm_value_encode(
+    uint8_t *apdu,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    BACNET_CHARACTER_STRING char_string;
+
+    switch (object_property) {
+        case PROP_OBJECT_IDENTIFIER:
+            return encode_application_object_id(
+                apdu, object_type, object_instance);
+        case PROP_OBJECT_NAME:
+            characterstring_init_ansi(&char_string, Test_Object_Name);
+            return encode_application_character_string(apdu, &char_string);
+        case PROP_OBJECT_TYPE:
+            return encode_application_enumerated(apdu, object_type);
+        case PROP_PRESENT_VALUE:
+            if (object_type == OBJECT_BINARY_INPUT) {
+                return encode_application_enumerated(apdu, BINARY_ACTIVE);
+            }
+            return encode_application_real(apdu, (float)object_instance);
+        case PROP_DESCRIPTION:
+            characterstring_init_ansi(&char_string, "Test");
+            return encode_application_character_string(apdu, &char_string);
+        default:
+            break;
+    }
+
+    return BACNET_STATUS_ERROR;
+}
+
+/* like some object property encoders, this does not keep within the
+   application_data_len that it is given */
+int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    int len;
+
+    len = test_rpm_value_encode(
+        NULL, rpdata->object_type, rpdata->object_instance,
+        rpdata->object_property);
+    if (len < 0) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+        return len;
+    }
+    Test_Read_Count++;
+    if ((rpdata->application_data >= &Handler_Transmit_Buffer[0]) &&
+        (rpdata->application_data <
+         &Handler_Transmit_Buffer[sizeof(Handler_Transmit_Buffer)]) &&
+        ((rpdata->application_data + len) >
+         &Handler_Transmit_Buffer[sizeof(Handler_Transmit_Buffer)])) {
+        Test_Read_Overflow = true;
+        return len;
+    }
+
+    return test_rpm_value_encode(
+        rpdata->application_data, rpdata->object_type,
+        rpdata->object_instance, rpdata->object_property);
+}
+
+void apdu_init_fixed_header(
+    BACNET_APDU_FIXED_HEADER *fixed_pdu_header,
+    uint8_t pdu_type,
+    uint8_t invoke_id,
+    uint8_t service,
+    int max_apdu)
+{
+    (void)fixed_pdu_header;
+    (void)pdu_type;
+    (void)invoke_id;
+    (void)service;
+    (void)max_apdu;
+}
+
+int tsm_set_complexack_transaction(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    BACNET_APDU_FIXED_HEADER *apdu_fixed_header,
+    BACNET_CONFIRMED_SERVICE_DATA *confirmed_service_data,
+    uint8_t *pdu,
+    uint32_t pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)apdu_fixed_header;
+    (void)confirmed_service_data;
+    (void)pdu;
+    Test_Segmented_Len = pdu_len;
+
+    return 1;
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(BACNET_ADDRESS));
+}
+
+int bip_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    zassert_true(pdu_len <= sizeof(Test_PDU), NULL);
+    memcpy(Test_PDU, pdu, pdu_len);
+    Test_PDU_Len = pdu_len;
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Handle a ReadPropertyMultiple request
+ * @param service_request - the service request
+ * @param service_len - the length of the service request
+ * @param max_resp - the largest response that the client accepts
+ * @param segmented_response_accepted - true if the client accepts a
+ *  segmented response
+ * @return the APDU of the reply, or NULL if the reply was handed to the
+ *  TSM to be segmented
+ */
+static const uint8_t *test_rpm_handle(
+    uint8_t *service_request,
+    uint16_t service_len,
+    int max_resp,
+    bool segmented_response_accepted)
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    service_data.invoke_id = TEST_INVOKE_ID;
+    service_data.max_resp = max_resp;
+    service_data.segmented_response_accepted = segmented_response_accepted;
+    Test_Read_Count = 0;
+    Test_Read_Overflow = false;
+    Test_PDU_Len = 0;
+    Test_Segmented_Len = 0;
+    handler_read_property_multiple(
+        service_request, service_len, &src, &service_data);
+    if (Test_PDU_Len == 0) {
+        zassert_true(Test_Segmented_Len > 0, NULL);
+        return NULL;
+    }
+    len = bacnet_npdu_decode(Test_PDU, Test_PDU_Len, &dest, &src, &npdu_data);
+    zassert_true(len > 0, NULL);
+
+    return &Test_PDU[len];
+}
+
+/**
+ * @brief Check that the reply is an abort of the request
+ * @param apdu - the APDU of the reply
+ * @param reason - the abort reason
+ */
+static void test_rpm_abort(const uint8_t *apdu, BACNET_ABORT_REASON reason)
+{
+    zassert_equal(apdu[0], PDU_TYPE_ABORT | 1, NULL);
+    zassert_equal(apdu[1], TEST_INVOKE_ID, NULL);
+    zassert_equal(apdu[2], reason, NULL);
+}
+
+/**
+ * @brief Encode a request for the object name of an Analog Input many
+ *  times, and the ack that is expected for it
+ * @param request - the request
+ * @param expected - the ack, or NULL
+ * @param names - the number of times the object name is read
+ * @param expected_len - the length of the ack
+ * @return the length of the request
+ */
+static uint16_t test_rpm_names_encode(
+    uint8_t *request, uint8_t *expected, unsigned names, int *expected_len)
+{
+    BACNET_RPM_DATA rpmdata = { 0 };
+    uint16_t request_len;
+    int apdu_len, value_len;
+    unsigned i;
+
+    rpmdata.object_type = OBJECT_ANALOG_INPUT;
+    rpmdata.object_instance = 1;
+    request_len = rpm_encode_apdu_object_begin(
+        request, rpmdata.object_type, rpmdata.object_instance);
+    apdu_len = rpm_ack_encode_apdu_init(expected, TEST_INVOKE_ID);
+    apdu_len += rpm_ack_encode_apdu_object_begin(
+        expected ? &expected[apdu_len] : NULL, &rpmdata);
+    for (i = 0; i < names; i++) {
+        request_len += rpm_encode_apdu_object_property(
+            &request[request_len], PROP_OBJECT_NAME, BACNET_ARRAY_ALL);
+        apdu_len += rpm_ack_encode_apdu_object_property(
+            expected ? &expected[apdu_len] : NULL, PROP_OBJECT_NAME,
+            BACNET_ARRAY_ALL);
+        value_len = test_rpm_value_encode(
+            expected ? &expected[apdu_len + 1] : NULL, rpmdata.object_type,
+            rpmdata.object_instance, PROP_OBJECT_NAME);
+        apdu_len += rpm_ack_encode_apdu_object_property_value(
+            expected ? &expected[apdu_len] : NULL,
+            expected ? &expected[apdu_len + 1] : NULL, value_len);
+    }
+    request_len += rpm_encode_apdu_object_end(&request[request_len]);
+    apdu_len += rpm_ack_encode_apdu_object_end(
+        expected ? &expected[apdu_len] : NULL);
+    *expected_len = apdu_len;
+
+    return request_len;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_rpm_tests, test_rpm_long_name)
+#else
+static void test_rpm_long_name(void)
+#endif
+{
+    uint8_t request[MAX_APDU];
+    uint8_t expected[MAX_APDU];
+    const uint8_t *apdu;
+    uint16_t request_len;
+    int expected_len = 0;
+    unsigned names;
+
+    memset(Test_Object_Name, 'A', 400);
+    Test_Object_Name[400] = 0;
+    /* three long names fit in one APDU */
+    request_len = test_rpm_names_encode(request, expected, 3, &expected_len);
+    apdu = test_rpm_handle(request, request_len, MAX_APDU, false);
+    zassert_false(Test_Read_Overflow, NULL);
+    zassert_equal(Test_Read_Count, 3, NULL);
+    zassert_equal(Test_PDU_Len - (apdu - Test_PDU), expected_len, NULL);
+    zassert_equal(memcmp(apdu, expected, expected_len), 0, NULL);
+    /* more long names than the transmit buffer holds: the last one that
+       is read starts near the end of the buffer */
+    names = 1;
+    do {
+        names++;
+        request_len = test_rpm_names_encode(
+            request, NULL, names, &expected_len);
+    } while (expected_len <= (MAX_PDU - MAX_NPDU));
+    apdu = test_rpm_handle(request, request_len, MAX_APDU, true);
+    zassert_false(Test_Read_Overflow, NULL);
+    zassert_equal(Test_Read_Count, names, NULL);
+    zassert_equal(Test_Segmented_Len, 0, NULL);
+    test_rpm_abort(apdu, ABORT_REASON_BUFFER_OVERFLOW);
+    Test_Object_Name[0] = 0;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_rpm_tests, test_rpm_all)
+#else
+static void test_rpm_all(void)
+#endif
+{
+    static const BACNET_OBJECT_TYPE object_type[] = {
+        OBJECT_ANALOG_INPUT, OBJECT_ANALOG_INPUT, OBJECT_BINARY_INPUT
+    };
+    static const uint32_t object_instance[] = { 1, 2, 1 };
+    static const BACNET_PROPERTY_ID property[] = {
+        PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME, PROP_OBJECT_TYPE,
+        PROP_PRESENT_VALUE, PROP_DESCRIPTION
+    };
+    BACNET_RPM_DATA rpmdata = { 0 };
+    uint8_t request[MAX_APDU];
+    uint8_t expected[MAX_APDU];
+    const uint8_t *apdu;
+    uint16_t request_len = 0;
+    int expected_len, value_len;
+    unsigned i, j, properties, reads = 0;
+
+    strcpy(Test_Object_Name, "Test");
+    /* every property of several objects of two object types */
+    expected_len = rpm_ack_encode_apdu_init(expected, TEST_INVOKE_ID);
+    for (i = 0; i < ARRAY_SIZE(object_type); i++) {
+        rpmdata.object_type = object_type[i];
+        rpmdata.object_instance = object_instance[i];
+        request_len += rpm_encode_apdu_object_begin(
+            &request[request_len], rpmdata.object_type,
+            rpmdata.object_instance);
+        request_len += rpm_encode_apdu_object_property(
+            &request[request_len], PROP_ALL, BACNET_ARRAY_ALL);
+        request_len += rpm_encode_apdu_object_end(&request[request_len]);
+        expected_len += rpm_ack_encode_apdu_object_begin(
+            &expected[expected_len], &rpmdata);
+        properties = ARRAY_SIZE(property);
+        if (rpmdata.object_type == OBJECT_BINARY_INPUT) {
+            /* no optional properties */
+            properties--;
+        }
+        for (j = 0; j < properties; j++) {
+            expected_len += rpm_ack_encode_apdu_object_property(
+                &expected[expected_len], property[j], BACNET_ARRAY_ALL);
+            value_len = test_rpm_value_encode(
+                &expected[expected_len + 1], rpmdata.object_type,
+                rpmdata.object_instance, property[j]);
+            expected_len += rpm_ack_encode_apdu_object_property_value(
+                &expected[expected_len], &expected[expected_len + 1],
+                value_len);
+            reads++;
+        }
+        expected_len +=
+            rpm_ack_encode_apdu_object_end(&expected[expected_len]);
+    }
+    apdu = test_rpm_handle(request, request_len, MAX_APDU, false);
+    zassert_equal(Test_Read_Count, reads, NULL);
+    zassert_equal(Test_PDU_Len - (apdu - Test_PDU), expected_len, NULL);
+    zassert_equal(memcmp(apdu, expected, expected_len), 0, NULL);
+    /* the results do not fit once they are read */
+    apdu = test_rpm_handle(request, request_len, expected_len - 1, false);
+    zassert_equal(Test_Read_Count, reads, NULL);
+    test_rpm_abort(apdu, ABORT_REASON_SEGMENTATION_NOT_SUPPORTED);
+    /* the results can never fit, so none of them is read */
+    apdu = test_rpm_handle(request, request_len, 20, false);
+    zassert_equal(Test_Read_Count, 0, NULL);
+    test_rpm_abort(apdu, ABORT_REASON_SEGMENTATION_NOT_SUPPORTED);
+    /* unless the client accepts a segmented response */
+    apdu = test_rpm_handle(request, request_len, 20, true);
+    zassert_is_null(apdu, NULL);
+    zassert_equal(Test_Read_Count, reads, NULL);
+    zassert_equal(Test_Segmented_Len, expected_len - 3, NULL);
+    Test_Object_Name[0] = 0;
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_rpm_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        h_rpm_tests, ztest_unit_test(test_rpm_long_name),
+        ztest_unit_test(test_rpm_all));
+
+    ztest_run_test_suite(h_rpm_tests);
+}
+#endif
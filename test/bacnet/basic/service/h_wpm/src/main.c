@@ -0,0 +1,275 @@
+/**
+ * @file
+ * @brief test the WritePropertyMultiple service handler
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/npdu.h>
+#include <bacnet/wp.h>
+#include <bacnet/wpm.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/services.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_INVOKE_ID 42
+/* more writes than the handler stores at a time */
+#define TEST_OBJECTS 3
+#define TEST_PROPERTIES 3
+#define TEST_WRITES (TEST_OBJECTS * TEST_PROPERTIES)
+
+/* a write that was applied or stored */
+struct test_write {
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_UNSIGNED_INTEGER value;
+};
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+/* the writes in the order that they were applied, and stored */
+static struct test_write Test_Applied[TEST_WRITES];
+static unsigned Test_Applied_Count;
+static struct test_write Test_Stored[TEST_WRITES];
+static unsigned Test_Stored_Count;
+/* the number of writes applied when each value was stored */
+static unsigned Test_Stored_Applied[TEST_WRITES];
+/* the instance of the object whose writes fail, or 0 */
+static uint32_t Test_Write_Fail_Instance;
+static bool Test_Batch;
+/* the PDU that was sent */
+static uint8_t Test_PDU[MAX_PDU];
+static unsigned Test_PDU_Len;
+
+bool write_property_bacnet_array_valid(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    (void)wp_data;
+    return true;
+}
+
+/**
+ * @brief Decode the value of a test write
+ * @param wp_data - the write
+ * @param write - the decoded write
+ */
+static void test_wpm_write_decode(
+    const BACNET_WRITE_PROPERTY_DATA *wp_data, struct test_write *write)
+{
+    int len;
+
+    write->object_instance = wp_data->object_instance;
+    write->object_property = wp_data->object_property;
+    len = bacnet_unsigned_application_decode(
+        wp_data->application_data, wp_data->application_data_len,
+        &write->value);
+    zassert_equal(len, wp_data->application_data_len, NULL);
+}
+
+bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    zassert_true(Test_Batch, NULL);
+    if (wp_data->object_instance == Test_Write_Fail_Instance) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    }
+    zassert_true(Test_Applied_Count < TEST_WRITES, NULL);
+    test_wpm_write_decode(wp_data, &Test_Applied[Test_Applied_Count]);
+    Test_Applied_Count++;
+
+    return true;
+}
+
+void Device_Write_Property_Batch_Begin(void)
+{
+    zassert_false(Test_Batch, NULL);
+    Test_Batch = true;
+}
+
+bool Device_Write_Property_Batch_Store(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    zassert_true(Test_Batch, NULL);
+    zassert_true(Test_Stored_Count < TEST_WRITES, NULL);
+    test_wpm_write_decode(wp_data, &Test_Stored[Test_Stored_Count]);
+    Test_Stored_Applied[Test_Stored_Count] = Test_Applied_Count;
+    Test_Stored_Count++;
+
+    return true;
+}
+
+unsigned Device_Write_Property_Batch_End(void)
+{
+    zassert_true(Test_Batch, NULL);
+    Test_Batch = false;
+
+    return Test_Applied_Count;
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(BACNET_ADDRESS));
+}
+
+int bip_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    zassert_true(pdu_len <= sizeof(Test_PDU), NULL);
+    memcpy(Test_PDU, pdu, pdu_len);
+    Test_PDU_Len = pdu_len;
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Encode a request that writes every property of some objects.
+ *  Object n is the Analog Value with the instance n + 1.
+ * @param request - the request
+ * @param objects - the number of objects
+ * @return the length of the request
+ */
+static uint16_t test_wpm_request_encode(uint8_t *request, unsigned objects)
+{
+    static const BACNET_PROPERTY_ID property[TEST_PROPERTIES] = {
+        PROP_PRESENT_VALUE, PROP_TIME_DELAY, PROP_NOTIFICATION_CLASS
+    };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint16_t request_len = 0;
+    unsigned i, j;
+
+    for (i = 0; i < objects; i++) {
+        request_len += wpm_encode_apdu_object_begin(
+            &request[request_len], OBJECT_ANALOG_VALUE, i + 1);
+        for (j = 0; j < TEST_PROPERTIES; j++) {
+            wp_data.object_property = property[j];
+            wp_data.array_index = BACNET_ARRAY_ALL;
+            wp_data.priority = BACNET_NO_PRIORITY;
+            wp_data.application_data_len = encode_application_unsigned(
+                wp_data.application_data, i * TEST_PROPERTIES + j);
+            request_len += wpm_encode_apdu_object_property(
+                &request[request_len], &wp_data);
+        }
+        request_len += wpm_encode_apdu_object_end(&request[request_len]);
+    }
+
+    return request_len;
+}
+
+/**
+ * @brief Handle a WritePropertyMultiple request
+ * @param request - the request
+ * @param request_len - the length of the request
+ * @return the APDU of the reply
+ */
+static const uint8_t *test_wpm_handle(uint8_t *request, uint16_t request_len)
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    service_data.invoke_id = TEST_INVOKE_ID;
+    Test_Applied_Count = 0;
+    Test_Stored_Count = 0;
+    Test_PDU_Len = 0;
+    handler_write_property_multiple(
+        request, request_len, &src, &service_data);
+    zassert_false(Test_Batch, NULL);
+    zassert_true(Test_PDU_Len > 0, NULL);
+    len = bacnet_npdu_decode(Test_PDU, Test_PDU_Len, &dest, &src, &npdu_data);
+    zassert_true(len > 0, NULL);
+
+    return &Test_PDU[len];
+}
+
+/**
+ * @brief Check that every applied write was stored once, in the same
+ *  order, after it was applied
+ */
+static void test_wpm_stored(void)
+{
+    unsigned i;
+
+    zassert_equal(Test_Stored_Count, Test_Applied_Count, NULL);
+    for (i = 0; i < Test_Stored_Count; i++) {
+        zassert_equal(
+            Test_Stored[i].object_instance, Test_Applied[i].object_instance,
+            NULL);
+        zassert_equal(
+            Test_Stored[i].object_property, Test_Applied[i].object_property,
+            NULL);
+        zassert_equal(Test_Stored[i].value, Test_Applied[i].value, NULL);
+        zassert_true(Test_Stored_Applied[i] > i, NULL);
+    }
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_wpm_tests, test_wpm_store)
+#else
+static void test_wpm_store(void)
+#endif
+{
+    uint8_t request[MAX_APDU];
+    const uint8_t *apdu;
+    uint16_t request_len, offset;
+    unsigned i;
+
+    request_len = test_wpm_request_encode(request, TEST_OBJECTS);
+    /* every write is applied, then stored */
+    Test_Write_Fail_Instance = 0;
+    apdu = test_wpm_handle(request, request_len);
+    zassert_equal(apdu[0], PDU_TYPE_SIMPLE_ACK, NULL);
+    zassert_equal(apdu[1], TEST_INVOKE_ID, NULL);
+    zassert_equal(Test_Applied_Count, TEST_WRITES, NULL);
+    for (i = 0; i < TEST_WRITES; i++) {
+        zassert_equal(Test_Applied[i].value, i, NULL);
+    }
+    test_wpm_stored();
+    /* the values are stored WPM_STORE_SIZE at a time */
+    zassert_equal(Test_Stored_Applied[0], WPM_STORE_SIZE + 1, NULL);
+    /* a failed write ends the request, and the writes before it stay
+       applied and are stored */
+    Test_Write_Fail_Instance = TEST_OBJECTS;
+    apdu = test_wpm_handle(request, request_len);
+    zassert_equal(apdu[0], PDU_TYPE_ERROR, NULL);
+    zassert_equal(apdu[1], TEST_INVOKE_ID, NULL);
+    zassert_equal(
+        Test_Applied_Count, (TEST_OBJECTS - 1) * TEST_PROPERTIES, NULL);
+    test_wpm_stored();
+    /* a request with a malformed last object applies nothing */
+    Test_Write_Fail_Instance = 0;
+    offset = test_wpm_request_encode(request, TEST_OBJECTS - 1);
+    request_len = test_wpm_request_encode(request, TEST_OBJECTS);
+    /* the object identifier and opening tag, then the context tag 0 of
+       the first property identifier, which becomes context tag 1 */
+    offset += 6;
+    zassert_equal(request[offset], 0x09, NULL);
+    request[offset] = 0x19;
+    apdu = test_wpm_handle(request, request_len);
+    zassert_equal(apdu[0], PDU_TYPE_REJECT, NULL);
+    zassert_equal(Test_Applied_Count, 0, NULL);
+    zassert_equal(Test_Stored_Count, 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_wpm_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(h_wpm_tests, ztest_unit_test(test_wpm_store));
+
+    ztest_run_test_suite(h_wpm_tests);
+}
+#endif
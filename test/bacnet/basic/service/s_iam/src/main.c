@@ -0,0 +1,280 @@
+/**
+ * @file
+ * @brief test the schedule of the I-Am replies to Who-Is
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/iam.h>
+#include <bacnet/npdu.h>
+#include <bacnet/basic/service/s_iam.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_WINDOW_MS 100
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+/* the device that the handlers are visiting */
+static uint32_t Test_Device_Instance = 1234;
+/* the I-Am that were sent */
+static unsigned Test_Send_Count;
+static uint32_t Test_Send_Device_Instance;
+static BACNET_ADDRESS Test_Send_Dest;
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return Test_Device_Instance;
+}
+
+int Device_Segmentation_Supported(void)
+{
+    return SEGMENTATION_NONE;
+}
+
+uint16_t Device_Vendor_Identifier(void)
+{
+    return BACNET_VENDOR_ID;
+}
+
+bool dcc_communication_initiation_disabled(void)
+{
+    return false;
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(BACNET_ADDRESS));
+}
+
+void bip_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    memset(dest, 0, sizeof(BACNET_ADDRESS));
+    dest->net = BACNET_BROADCAST_NETWORK;
+}
+
+int bip_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_NPDU_DATA npdu = { 0 };
+    int len;
+
+    (void)npdu_data;
+    len = bacnet_npdu_decode(pdu, pdu_len, &npdu_dest, &npdu_src, &npdu);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pdu[len], PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(pdu[len + 1], SERVICE_UNCONFIRMED_I_AM, NULL);
+    zassert_true(
+        iam_decode_service_request(
+            &pdu[len + 2], &Test_Send_Device_Instance, NULL, NULL, NULL) > 0,
+        NULL);
+    bacnet_address_copy(&Test_Send_Dest, dest);
+    Test_Send_Count++;
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Send every scheduled reply, and reset the configuration
+ */
+static void test_iam_reset(void)
+{
+    Send_I_Am_Rate_Set(0, 1);
+    while (Send_I_Am_Pending()) {
+        Send_I_Am_Timer(TEST_WINDOW_MS);
+    }
+    Send_I_Am_Window_Set(0);
+    Test_Send_Count = 0;
+}
+
+/**
+ * @brief Get an address for a unicast reply
+ * @param src - the address
+ * @param mac - the last octet of the address
+ */
+static void test_iam_address(BACNET_ADDRESS *src, uint8_t mac)
+{
+    memset(src, 0, sizeof(BACNET_ADDRESS));
+    src->mac_len = 6;
+    src->mac[0] = 192;
+    src->mac[1] = 168;
+    src->mac[3] = mac;
+    src->mac[4] = 0xBA;
+    src->mac[5] = 0xC0;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(s_iam_tests, test_iam_window)
+#else
+static void test_iam_window(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    unsigned elapsed = 0;
+    unsigned i;
+
+    test_iam_reset();
+    /* without a window, replies are sent immediately */
+    test_iam_address(&src, 1);
+    Send_I_Am_Reply(&src);
+    zassert_equal(Test_Send_Count, 1, NULL);
+    zassert_equal(Send_I_Am_Pending(), 0, NULL);
+    zassert_true(bacnet_address_same(&Test_Send_Dest, &src), NULL);
+    Send_I_Am_Reply(NULL);
+    zassert_equal(Test_Send_Count, 2, NULL);
+    zassert_equal(Test_Send_Dest.net, BACNET_BROADCAST_NETWORK, NULL);
+    /* with a window, every reply goes out within it */
+    Test_Send_Count = 0;
+    Send_I_Am_Window_Set(TEST_WINDOW_MS);
+    zassert_equal(Send_I_Am_Window(), TEST_WINDOW_MS, NULL);
+    for (i = 0; i < 16; i++) {
+        test_iam_address(&src, i);
+        Send_I_Am_Reply(&src);
+    }
+    zassert_equal(Test_Send_Count, 0, NULL);
+    zassert_equal(Send_I_Am_Pending(), 16, NULL);
+    while (Send_I_Am_Pending()) {
+        Send_I_Am_Timer(1);
+        elapsed++;
+        zassert_true(elapsed <= TEST_WINDOW_MS, NULL);
+        zassert_equal(Send_I_Am_Pending() + Test_Send_Count, 16, NULL);
+    }
+    zassert_equal(Test_Send_Count, 16, NULL);
+    zassert_equal(Test_Send_Device_Instance, Test_Device_Instance, NULL);
+    test_iam_reset();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(s_iam_tests, test_iam_coalesce)
+#else
+static void test_iam_coalesce(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    uint32_t coalesced;
+    unsigned i;
+
+    test_iam_reset();
+    Send_I_Am_Window_Set(TEST_WINDOW_MS);
+    coalesced = Send_I_Am_Coalesced();
+    /* the same device and destination get a single reply */
+    test_iam_address(&src, 1);
+    Send_I_Am_Reply(&src);
+    Send_I_Am_Reply(&src);
+    Send_I_Am_Reply(NULL);
+    Send_I_Am_Reply(NULL);
+    zassert_equal(Send_I_Am_Pending(), 2, NULL);
+    zassert_equal(Send_I_Am_Coalesced() - coalesced, 2, NULL);
+    /* the virtual devices of a gateway each get their own reply,
+       including the ones that share a chain of the schedule */
+    for (i = 1; i <= 2 * BACNET_IAM_SCHEDULE_BUCKETS; i++) {
+        Test_Device_Instance = 1234 + i;
+        Send_I_Am_Reply(NULL);
+        Send_I_Am_Reply(NULL);
+    }
+    zassert_equal(
+        Send_I_Am_Pending(), 2 + 2 * BACNET_IAM_SCHEDULE_BUCKETS, NULL);
+    zassert_equal(
+        Send_I_Am_Coalesced() - coalesced, 2 + 2 * BACNET_IAM_SCHEDULE_BUCKETS,
+        NULL);
+    Send_I_Am_Timer(TEST_WINDOW_MS);
+    zassert_equal(Send_I_Am_Pending(), 0, NULL);
+    zassert_equal(Test_Send_Count, 2 + 2 * BACNET_IAM_SCHEDULE_BUCKETS, NULL);
+    /* once sent, the next Who-Is is answered again */
+    Test_Device_Instance = 1234;
+    Send_I_Am_Reply(&src);
+    zassert_equal(Send_I_Am_Pending(), 1, NULL);
+    test_iam_reset();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(s_iam_tests, test_iam_rate)
+#else
+static void test_iam_rate(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    unsigned i;
+
+    test_iam_reset();
+    Send_I_Am_Window_Set(1);
+    /* 10 replies per second, 2 back to back */
+    Send_I_Am_Rate_Set(10, 2);
+    for (i = 0; i < 8; i++) {
+        test_iam_address(&src, i);
+        Send_I_Am_Reply(&src);
+    }
+    Send_I_Am_Timer(0);
+    zassert_equal(Test_Send_Count, 2, NULL);
+    /* one token every 100 ms */
+    Send_I_Am_Timer(99);
+    zassert_equal(Test_Send_Count, 2, NULL);
+    Send_I_Am_Timer(1);
+    zassert_equal(Test_Send_Count, 3, NULL);
+    /* the bucket holds no more than the burst */
+    Send_I_Am_Timer(1000);
+    zassert_equal(Test_Send_Count, 5, NULL);
+    Send_I_Am_Timer(300);
+    zassert_equal(Test_Send_Count, 7, NULL);
+    zassert_equal(Send_I_Am_Pending(), 1, NULL);
+    Send_I_Am_Timer(100);
+    zassert_equal(Test_Send_Count, 8, NULL);
+    zassert_equal(Send_I_Am_Pending(), 0, NULL);
+    test_iam_reset();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(s_iam_tests, test_iam_full)
+#else
+static void test_iam_full(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    uint32_t dropped;
+    unsigned i;
+
+    test_iam_reset();
+    Send_I_Am_Window_Set(TEST_WINDOW_MS);
+    dropped = Send_I_Am_Dropped();
+    for (i = 0; i < BACNET_IAM_SCHEDULE_SIZE + 2; i++) {
+        test_iam_address(&src, i);
+        Send_I_Am_Reply(&src);
+    }
+    zassert_equal(Send_I_Am_Pending(), BACNET_IAM_SCHEDULE_SIZE, NULL);
+    zassert_equal(Send_I_Am_Dropped() - dropped, 2, NULL);
+    /* the entries that were sent are used again */
+    Send_I_Am_Timer(TEST_WINDOW_MS);
+    zassert_equal(Test_Send_Count, BACNET_IAM_SCHEDULE_SIZE, NULL);
+    for (i = 0; i < BACNET_IAM_SCHEDULE_SIZE; i++) {
+        test_iam_address(&src, i);
+        Send_I_Am_Reply(&src);
+    }
+    zassert_equal(Send_I_Am_Pending(), BACNET_IAM_SCHEDULE_SIZE, NULL);
+    zassert_equal(Send_I_Am_Dropped() - dropped, 2, NULL);
+    test_iam_reset();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(s_iam_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        s_iam_tests, ztest_unit_test(test_iam_window),
+        ztest_unit_test(test_iam_coalesce), ztest_unit_test(test_iam_rate),
+        ztest_unit_test(test_iam_full));
+
+    ztest_run_test_suite(s_iam_tests);
+}
+#endif
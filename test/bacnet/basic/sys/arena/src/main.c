@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief test memory arena API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/arena.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test an arena using only a fixed buffer
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(arena_tests, testArenaBuffer)
+#else
+static void testArenaBuffer(void)
+#endif
+{
+    MEMORY_ARENA arena;
+    uint8_t buffer[64];
+    uint8_t *data1, *data2, *data3;
+    unsigned i;
+
+    arena_init(&arena, NULL, 0, 0);
+    zassert_true(arena_empty(&arena), NULL);
+    zassert_equal(arena_alloc(&arena, 1), NULL, NULL);
+
+    memset(buffer, 0xff, sizeof(buffer));
+    arena_init(&arena, buffer, sizeof(buffer), 0);
+    zassert_true(arena_empty(&arena), NULL);
+    zassert_equal(arena_alloc(&arena, 0), NULL, NULL);
+    data1 = arena_alloc(&arena, 3);
+    zassert_not_null(data1, NULL);
+    zassert_true(data1 >= buffer, NULL);
+    zassert_equal((uintptr_t)data1 % ARENA_ALIGNMENT, 0, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_equal(data1[i], 0, NULL);
+    }
+    data2 = arena_alloc(&arena, 5);
+    zassert_not_null(data2, NULL);
+    zassert_equal((uintptr_t)data2 % ARENA_ALIGNMENT, 0, NULL);
+    /* in order, next to each other */
+    zassert_true(data2 > data1, NULL);
+    zassert_true((data2 - data1) <= (3 + ARENA_ALIGNMENT), NULL);
+    zassert_equal(arena_count(&arena), 8, NULL);
+    zassert_false(arena_empty(&arena), NULL);
+    /* no room and no blocks */
+    zassert_equal(arena_alloc(&arena, sizeof(buffer)), NULL, NULL);
+    /* reset */
+    arena_reset(&arena);
+    zassert_true(arena_empty(&arena), NULL);
+    data3 = arena_alloc(&arena, 3);
+    zassert_equal(data3, data1, NULL);
+    arena_free(&arena);
+}
+
+/**
+ * @brief Test an arena that allocates blocks on demand
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(arena_tests, testArenaBlocks)
+#else
+static void testArenaBlocks(void)
+#endif
+{
+    MEMORY_ARENA arena;
+    uint8_t buffer[16];
+    uint8_t *data[8];
+    uint8_t *big, *test_big;
+    unsigned i;
+
+    arena_init(&arena, buffer, sizeof(buffer), 32);
+    for (i = 0; i < 8; i++) {
+        data[i] = arena_alloc(&arena, 12);
+        zassert_not_null(data[i], NULL);
+        zassert_equal((uintptr_t)data[i] % ARENA_ALIGNMENT, 0, NULL);
+        memset(data[i], (int)i, 12);
+    }
+    for (i = 0; i < 8; i++) {
+        zassert_equal(data[i][0], i, NULL);
+        zassert_equal(data[i][11], i, NULL);
+    }
+    zassert_equal(arena_count(&arena), 8 * 12, NULL);
+    /* larger than a block */
+    big = arena_alloc(&arena, 100);
+    zassert_not_null(big, NULL);
+    memset(big, 0xaa, 100);
+    /* the blocks are kept and used again after a reset */
+    arena_reset(&arena);
+    zassert_true(arena_empty(&arena), NULL);
+    for (i = 0; i < 8; i++) {
+        zassert_equal(arena_alloc(&arena, 12), data[i], NULL);
+        zassert_equal(data[i][0], 0, NULL);
+    }
+    test_big = arena_alloc(&arena, 100);
+    zassert_equal(test_big, big, NULL);
+    zassert_equal(test_big[99], 0, NULL);
+    arena_free(&arena);
+    zassert_true(arena_empty(&arena), NULL);
+    zassert_not_null(arena_alloc(&arena, 12), NULL);
+    zassert_equal(arena_count(&arena), 12, NULL);
+    arena_free(&arena);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(arena_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        arena_tests, ztest_unit_test(testArenaBuffer),
+        ztest_unit_test(testArenaBlocks));
+
+    ztest_run_test_suite(arena_tests);
+}
+#endif
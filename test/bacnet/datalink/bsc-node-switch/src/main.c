@@ -0,0 +1,427 @@
+/**
+ * @file
+ * @brief test BACnet/SC node switch auto connection to busy peers
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/datalink/bsc/bvlc-sc.h>
+#include <bacnet/datalink/bsc/bsc-socket.h>
+#include <bacnet/datalink/bsc/bsc-util.h>
+#include <bacnet/datalink/bsc/bsc-node.h>
+#include <bacnet/datalink/bsc/bsc-node-switch.h>
+#include <bacnet/datalink/bsc/websocket.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_RECONNECT_TIMEOUT_S 10
+#define TEST_RESOLUTION_TIMEOUT_S 5
+
+/* test stub data */
+static unsigned long Test_Now = 1000;
+static BSC_SOCKET_CTX_FUNCS *Test_Initiator_Funcs;
+static BSC_SOCKET *Test_Connect_Socket;
+static unsigned Test_Connect_Count;
+static unsigned Test_Hub_Send_Count;
+static unsigned Test_Direct_Send_Count;
+static unsigned Test_Resolution_Count;
+static BSC_ADDRESS_RESOLUTION Test_Resolution;
+static bool Test_Resolution_Known;
+static uint8_t Test_Global_Buf[BSC_PRE + 1500];
+/* the node switch needs a node as its user argument */
+static int Test_Node;
+
+/* test stub functions */
+unsigned long mstimer_now(void)
+{
+    return Test_Now;
+}
+
+void bws_dispatch_lock(void)
+{
+}
+
+void bws_dispatch_unlock(void)
+{
+}
+
+void bsc_init_ctx_cfg(
+    BSC_SOCKET_CTX_TYPE type,
+    BSC_CONTEXT_CFG *cfg,
+    BSC_WEBSOCKET_PROTOCOL proto,
+    uint16_t port,
+    char *iface,
+    uint8_t *ca_cert_chain,
+    size_t ca_cert_chain_size,
+    uint8_t *cert_chain,
+    size_t cert_chain_size,
+    uint8_t *key,
+    size_t key_size,
+    BACNET_SC_UUID *local_uuid,
+    BACNET_SC_VMAC_ADDRESS *local_vmac,
+    uint16_t max_local_bvlc_len,
+    uint16_t max_local_ndpu_len,
+    unsigned int connect_timeout_s,
+    unsigned int heartbeat_timeout_s,
+    unsigned int disconnect_timeout_s)
+{
+    (void)iface;
+    (void)ca_cert_chain;
+    (void)ca_cert_chain_size;
+    (void)cert_chain;
+    (void)cert_chain_size;
+    (void)key;
+    (void)key_size;
+    (void)local_uuid;
+    (void)max_local_bvlc_len;
+    (void)max_local_ndpu_len;
+    (void)connect_timeout_s;
+    (void)heartbeat_timeout_s;
+    (void)disconnect_timeout_s;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->type = type;
+    cfg->proto = proto;
+    cfg->port = port;
+    memcpy(&cfg->local_vmac, local_vmac, sizeof(cfg->local_vmac));
+}
+
+BSC_SC_RET bsc_init_ctx(
+    BSC_SOCKET_CTX *ctx,
+    BSC_CONTEXT_CFG *cfg,
+    BSC_SOCKET_CTX_FUNCS *funcs,
+    BSC_SOCKET *sockets,
+    size_t sockets_num,
+    void *user_arg)
+{
+    size_t i;
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->state = BSC_CTX_STATE_INITIALIZED;
+    ctx->sock = sockets;
+    ctx->sock_num = sockets_num;
+    ctx->funcs = funcs;
+    ctx->cfg = cfg;
+    ctx->user_arg = user_arg;
+    for (i = 0; i < sockets_num; i++) {
+        memset(&sockets[i], 0, sizeof(sockets[i]));
+        sockets[i].ctx = ctx;
+    }
+    if (cfg->type == BSC_SOCKET_CTX_INITIATOR) {
+        Test_Initiator_Funcs = funcs;
+    }
+
+    return BSC_SC_SUCCESS;
+}
+
+void bsc_deinit_ctx(BSC_SOCKET_CTX *ctx)
+{
+    ctx->state = BSC_CTX_STATE_IDLE;
+    ctx->funcs->context_event(ctx, BSC_CTX_DEINITIALIZED);
+}
+
+BSC_SC_RET bsc_connect(BSC_SOCKET_CTX *ctx, BSC_SOCKET *c, char *url)
+{
+    (void)ctx;
+    (void)url;
+    Test_Connect_Count++;
+    Test_Connect_Socket = c;
+    c->state = BSC_SOCK_STATE_AWAITING_WEBSOCKET;
+
+    return BSC_SC_SUCCESS;
+}
+
+void bsc_disconnect(BSC_SOCKET *c)
+{
+    c->state = BSC_SOCK_STATE_DISCONNECTING;
+}
+
+BSC_SC_RET bsc_send(BSC_SOCKET *c, uint8_t *pdu, size_t pdu_len)
+{
+    (void)c;
+    (void)pdu;
+    (void)pdu_len;
+    Test_Direct_Send_Count++;
+
+    return BSC_SC_SUCCESS;
+}
+
+bool bsc_socket_get_peer_addr(BSC_SOCKET *c, BACNET_HOST_N_PORT_DATA *data)
+{
+    (void)c;
+    (void)data;
+
+    return false;
+}
+
+uint8_t *bsc_socket_get_global_buf(void)
+{
+    return Test_Global_Buf;
+}
+
+size_t bsc_socket_get_global_buf_size(void)
+{
+    return sizeof(Test_Global_Buf);
+}
+
+BSC_ADDRESS_RESOLUTION *
+bsc_node_get_address_resolution(void *node, BACNET_SC_VMAC_ADDRESS *vmac)
+{
+    (void)node;
+    (void)vmac;
+
+    return Test_Resolution_Known ? &Test_Resolution : NULL;
+}
+
+BSC_SC_RET
+bsc_node_send_address_resolution(void *node, BACNET_SC_VMAC_ADDRESS *dest)
+{
+    (void)node;
+    (void)dest;
+    Test_Resolution_Count++;
+
+    return BSC_SC_SUCCESS;
+}
+
+BSC_SC_RET
+bsc_node_hub_connector_send(void *user_arg, uint8_t *pdu, size_t pdu_len)
+{
+    (void)user_arg;
+    (void)pdu;
+    (void)pdu_len;
+    Test_Hub_Send_Count++;
+
+    return BSC_SC_SUCCESS;
+}
+
+void bsc_node_store_failed_request_info(
+    BSC_NODE *node,
+    BACNET_HOST_N_PORT_DATA *peer,
+    BACNET_SC_VMAC_ADDRESS *vmac,
+    BACNET_SC_UUID *uuid,
+    BACNET_ERROR_CODE error,
+    const char *error_desc)
+{
+    (void)node;
+    (void)peer;
+    (void)vmac;
+    (void)uuid;
+    (void)error;
+    (void)error_desc;
+}
+
+BACNET_SC_DIRECT_CONNECTION_STATUS *bsc_node_find_direct_status_for_vmac(
+    BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
+{
+    (void)node;
+    (void)vmac;
+
+    return NULL;
+}
+
+char *bsc_vmac_to_string(BACNET_SC_VMAC_ADDRESS *vmac)
+{
+    (void)vmac;
+
+    return "vmac";
+}
+
+char *bsc_uuid_to_string(BACNET_SC_UUID *uuid)
+{
+    (void)uuid;
+
+    return "uuid";
+}
+
+void bsc_copy_str(char *dst, const char *src, size_t dst_len)
+{
+    if (dst_len > 0) {
+        strncpy(dst, src, dst_len - 1);
+        dst[dst_len - 1] = 0;
+    }
+}
+
+void bsc_set_timestamp(BACNET_DATE_TIME *timestamp)
+{
+    memset(timestamp, 0, sizeof(*timestamp));
+}
+
+static void test_node_switch_event(
+    BSC_NODE_SWITCH_EVENT ev,
+    BSC_NODE_SWITCH_HANDLE h,
+    void *user_arg,
+    BACNET_SC_VMAC_ADDRESS *dest,
+    uint8_t *pdu,
+    size_t pdu_len,
+    BVLC_SC_DECODED_MESSAGE *decoded_pdu)
+{
+    (void)ev;
+    (void)h;
+    (void)user_arg;
+    (void)dest;
+    (void)pdu;
+    (void)pdu_len;
+    (void)decoded_pdu;
+}
+
+/**
+ * @brief Send a unicast PDU through the node switch
+ * @param h - node switch handle
+ * @param dest - VMAC address of the peer
+ * @return result of bsc_node_switch_send()
+ */
+static BSC_SC_RET
+test_node_switch_send(BSC_NODE_SWITCH_HANDLE h, BACNET_SC_VMAC_ADDRESS *dest)
+{
+    static uint8_t buf[BSC_PRE + 64];
+    uint8_t npdu[4] = { 0x01, 0x00, 0x10, 0x08 };
+    size_t len;
+
+    len = bvlc_sc_encode_encapsulated_npdu(
+        &buf[BSC_PRE], sizeof(buf) - BSC_PRE, 1, NULL, dest, npdu,
+        sizeof(npdu));
+    zassert_true(len > 0, NULL);
+
+    return bsc_node_switch_send(h, &buf[BSC_PRE], len);
+}
+
+/**
+ * @brief Start an initiator only node switch
+ * @return node switch handle
+ */
+static BSC_NODE_SWITCH_HANDLE test_node_switch_start(void)
+{
+    BSC_NODE_SWITCH_HANDLE h = NULL;
+    BACNET_SC_UUID uuid = { 0 };
+    BACNET_SC_VMAC_ADDRESS vmac = { { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15 } };
+    BSC_SC_RET ret;
+
+    ret = bsc_node_switch_start(
+        NULL, 0, NULL, 0, NULL, 0, 0, NULL, &uuid, &vmac, 1500, 1500, 10, 10,
+        10, TEST_RECONNECT_TIMEOUT_S, TEST_RESOLUTION_TIMEOUT_S, false, true,
+        test_node_switch_event, &Test_Node, &h);
+    zassert_equal(ret, BSC_SC_SUCCESS, NULL);
+    zassert_not_null(h, NULL);
+    zassert_not_null(Test_Initiator_Funcs, NULL);
+    Test_Connect_Socket = NULL;
+    Test_Connect_Count = 0;
+    Test_Hub_Send_Count = 0;
+    Test_Direct_Send_Count = 0;
+    Test_Resolution_Count = 0;
+
+    return h;
+}
+
+/**
+ * @brief Stop the node switch and drop its initiator sockets
+ * @param h - node switch handle
+ */
+static void test_node_switch_stop(BSC_NODE_SWITCH_HANDLE h)
+{
+    bsc_node_switch_stop(h);
+    zassert_true(bsc_node_switch_stopped(h), NULL);
+}
+
+/**
+ * @brief Test that a busy peer gets a direct connection, and that a
+ *  peer which refuses it is not tried again before the reconnect timeout
+ */
+static void test_node_switch_auto_connect_failed(void)
+{
+    BSC_NODE_SWITCH_HANDLE h;
+    BACNET_SC_VMAC_ADDRESS dest = { { 0x20, 0x21, 0x22, 0x23, 0x24, 0x25 } };
+    unsigned i;
+
+    h = test_node_switch_start();
+    Test_Resolution_Known = true;
+    Test_Resolution.used = true;
+    memcpy(&Test_Resolution.vmac, &dest, sizeof(dest));
+    strcpy((char *)Test_Resolution.utf8_urls[0], "wss://peer:4443");
+    Test_Resolution.urls_num = 1;
+    /* below the threshold, the traffic goes through the hub */
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD - 1; i++) {
+        zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    }
+    zassert_equal(Test_Connect_Count, 0, NULL);
+    zassert_equal(
+        Test_Hub_Send_Count, BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD - 1,
+        NULL);
+    /* at the threshold, a direct connection is opened */
+    zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    zassert_equal(Test_Connect_Count, 1, NULL);
+    zassert_not_null(Test_Connect_Socket, NULL);
+    /* the peer refuses the connection */
+    Test_Initiator_Funcs->socket_event(
+        Test_Connect_Socket, BSC_SOCKET_EVENT_DISCONNECTED,
+        ERROR_CODE_TLS_ERROR, NULL, NULL, 0, NULL);
+    /* no new attempt on every PDU */
+    for (i = 0; i < 4 * BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD; i++) {
+        zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    }
+    zassert_equal(Test_Connect_Count, 1, NULL);
+    zassert_equal(
+        Test_Hub_Send_Count, 5 * BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD,
+        NULL);
+    /* after the reconnect timeout, the busy peer is tried again */
+    Test_Now += TEST_RECONNECT_TIMEOUT_S * 1000;
+    zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    zassert_equal(Test_Connect_Count, 2, NULL);
+    /* once connected, the traffic goes direct */
+    Test_Connect_Socket->state = BSC_SOCK_STATE_CONNECTED;
+    memcpy(&Test_Connect_Socket->vmac, &dest, sizeof(dest));
+    Test_Initiator_Funcs->socket_event(
+        Test_Connect_Socket, BSC_SOCKET_EVENT_CONNECTED, ERROR_CODE_SUCCESS,
+        NULL, NULL, 0, NULL);
+    zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    zassert_equal(Test_Direct_Send_Count, 1, NULL);
+    zassert_equal(Test_Connect_Count, 2, NULL);
+    test_node_switch_stop(h);
+}
+
+/**
+ * @brief Test that a busy peer whose address cannot be resolved is not
+ *  asked again before the reconnect timeout
+ */
+static void test_node_switch_auto_connect_unresolved(void)
+{
+    BSC_NODE_SWITCH_HANDLE h;
+    BACNET_SC_VMAC_ADDRESS dest = { { 0x30, 0x31, 0x32, 0x33, 0x34, 0x35 } };
+    unsigned i;
+
+    h = test_node_switch_start();
+    Test_Resolution_Known = false;
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD; i++) {
+        zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    }
+    zassert_equal(Test_Resolution_Count, 1, NULL);
+    zassert_equal(Test_Connect_Count, 0, NULL);
+    /* no address resolution ack arrives */
+    Test_Now += TEST_RESOLUTION_TIMEOUT_S * 1000;
+    bsc_node_switch_maintenance_timer(1);
+    for (i = 0; i < 4 * BSC_CONF_NODE_SWITCH_AUTO_CONNECT_THRESHOLD; i++) {
+        zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    }
+    zassert_equal(Test_Resolution_Count, 1, NULL);
+    /* after the reconnect timeout, the busy peer is tried again */
+    Test_Now += TEST_RECONNECT_TIMEOUT_S * 1000;
+    zassert_equal(test_node_switch_send(h, &dest), BSC_SC_SUCCESS, NULL);
+    zassert_equal(Test_Resolution_Count, 2, NULL);
+    zassert_equal(Test_Connect_Count, 0, NULL);
+    test_node_switch_stop(h);
+}
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+    ztest_test_suite(
+        bsc_node_switch_tests,
+        ztest_unit_test(test_node_switch_auto_connect_failed),
+        ztest_unit_test(test_node_switch_auto_connect_unresolved));
+
+    ztest_run_test_suite(bsc_node_switch_tests);
+}
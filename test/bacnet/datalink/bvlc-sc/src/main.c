@@ -4551,6 +4551,79 @@ static void test_BROADCAST(void)
     zassert_equal(ret, true, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bvlc_sc_tests, test_MESSAGE_VIEW)
+#else
+static void test_MESSAGE_VIEW(void)
+#endif
+{
+    uint8_t buf[256];
+    uint8_t npdu[64];
+    size_t len;
+    BVLC_SC_MESSAGE_VIEW view;
+    BVLC_SC_DECODED_MESSAGE message;
+    uint16_t error_code;
+    uint16_t error_class;
+    const char *err_desc = NULL;
+    BACNET_SC_VMAC_ADDRESS origin;
+    BACNET_SC_VMAC_ADDRESS dest;
+    bool ret;
+
+    memset(&origin.address, 0x63, BVLC_SC_VMAC_SIZE);
+    memset(&dest.address, 0x24, BVLC_SC_VMAC_SIZE);
+    memset(npdu, 0x99, sizeof(npdu));
+
+    /* origin and dest absent */
+    len = bvlc_sc_encode_encapsulated_npdu(
+        buf, sizeof(buf), 0x1789, NULL, NULL, npdu, sizeof(npdu));
+    zassert_not_equal(len, 0, NULL);
+    ret = bvlc_sc_decode_message_view(buf, len, &view);
+    zassert_equal(ret, true, NULL);
+    zassert_equal(view.bvlc_function, BVLC_SC_ENCAPSULATED_NPDU, NULL);
+    zassert_equal(view.message_id, 0x1789, NULL);
+    zassert_equal(view.origin_offset, 0, NULL);
+    zassert_equal(view.dest_offset, 0, NULL);
+    zassert_equal(view.payload_len, sizeof(npdu), NULL);
+    zassert_equal(view.payload_offset + view.payload_len, len, NULL);
+    zassert_equal(
+        memcmp(&buf[view.payload_offset], npdu, sizeof(npdu)), 0, NULL);
+
+    /* offsets must point to the same data as the full decoder */
+    len = bvlc_sc_encode_encapsulated_npdu(
+        buf, sizeof(buf), 0x1789, &origin, &dest, npdu, sizeof(npdu));
+    zassert_not_equal(len, 0, NULL);
+    ret = bvlc_sc_decode_message_view(buf, len, &view);
+    zassert_equal(ret, true, NULL);
+    ret = bvlc_sc_decode_message(
+        buf, len, &message, &error_code, &error_class, &err_desc);
+    zassert_equal(ret, true, NULL);
+    zassert_equal(
+        &buf[view.origin_offset], (uint8_t *)message.hdr.origin, NULL);
+    zassert_equal(&buf[view.dest_offset], (uint8_t *)message.hdr.dest, NULL);
+    zassert_equal(&buf[view.payload_offset], message.hdr.payload, NULL);
+    zassert_equal(view.payload_len, message.hdr.payload_len, NULL);
+
+    /* message without payload */
+    len = bvlc_sc_encode_heartbeat_request(buf, sizeof(buf), 0xF00D);
+    zassert_not_equal(len, 0, NULL);
+    ret = bvlc_sc_decode_message_view(buf, len, &view);
+    zassert_equal(ret, true, NULL);
+    zassert_equal(view.bvlc_function, BVLC_SC_HEARTBEAT_REQUEST, NULL);
+    zassert_equal(view.payload_len, 0, NULL);
+
+    /* truncated header */
+    len = bvlc_sc_encode_encapsulated_npdu(
+        buf, sizeof(buf), 0x1789, &origin, &dest, npdu, sizeof(npdu));
+    ret = bvlc_sc_decode_message_view(buf, 3, &view);
+    zassert_equal(ret, false, NULL);
+    ret = bvlc_sc_decode_message_view(buf, 4 + BVLC_SC_VMAC_SIZE + 1, &view);
+    zassert_equal(ret, false, NULL);
+    ret = bvlc_sc_decode_message_view(NULL, len, &view);
+    zassert_equal(ret, false, NULL);
+    ret = bvlc_sc_decode_message_view(buf, len, NULL);
+    zassert_equal(ret, false, NULL);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST_SUITE(bvlc_sc_tests, NULL, NULL, NULL, NULL, NULL);
 #else
@@ -4573,7 +4646,8 @@ void test_main(void)
         ztest_unit_test(test_BAD_HEADER_OPTIONS),
         ztest_unit_test(test_BAD_ENCODE_PARAMS),
         ztest_unit_test(test_BAD_DECODE_PARAMS),
-        ztest_unit_test(test_BROADCAST));
+        ztest_unit_test(test_BROADCAST),
+        ztest_unit_test(test_MESSAGE_VIEW));
 
     ztest_run_test_suite(bvlc_sc_tests);
 }
@@ -8,6 +8,7 @@
 #include <zephyr/ztest.h>
 #include <stdlib.h>
 #include <bacnet/datalink/cobs.h>
+#include <bacnet/datalink/mstpdef.h>
 #include <bacnet/basic/sys/bytes.h>
 
 /**
@@ -49,6 +50,39 @@ static void test_COBS_Encode_Decode(void)
     zassert_true(
         test_buffer_length == sizeof(buffer), "COBS encode/decode length fail");
 }
+
+/**
+ * @brief Test the CRC32K block calculation against the octet calculation
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, test_COBS_CRC32K_Block)
+#else
+static void test_COBS_CRC32K_Block(void)
+#endif
+{
+    uint8_t buffer[300] = { 0 };
+    uint32_t crc32K, test_crc32K;
+    unsigned i, length;
+
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)rand();
+    }
+    for (length = 0; length <= sizeof(buffer); length++) {
+        crc32K = CRC32K_INITIAL_VALUE;
+        for (i = 0; i < length; i++) {
+            crc32K = cobs_crc32k(buffer[i], crc32K);
+        }
+        test_crc32K =
+            cobs_crc32k_block(buffer, length, CRC32K_INITIAL_VALUE);
+        zassert_equal(crc32K, test_crc32K, "length=%u", length);
+    }
+    /* split blocks accumulate the same as one block */
+    crc32K = cobs_crc32k_block(buffer, 13, CRC32K_INITIAL_VALUE);
+    crc32K = cobs_crc32k_block(&buffer[13], sizeof(buffer) - 13, crc32K);
+    test_crc32K =
+        cobs_crc32k_block(buffer, sizeof(buffer), CRC32K_INITIAL_VALUE);
+    zassert_equal(crc32K, test_crc32K, NULL);
+}
 /**
  * @}
  */
@@ -58,7 +92,9 @@ ZTEST_SUITE(cobs_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(cobs_tests, ztest_unit_test(test_COBS_Encode_Decode));
+    ztest_test_suite(
+        cobs_tests, ztest_unit_test(test_COBS_Encode_Decode),
+        ztest_unit_test(test_COBS_CRC32K_Block));
 
     ztest_run_test_suite(cobs_tests);
 }
@@ -14,6 +14,35 @@
  * @{
  */
 
+/**
+ * @brief Bitwise CRC8 copied from the BACnet standard, to check the
+ *  table driven calculations against
+ */
+static uint8_t crc8_bitwise(uint8_t dataValue, uint8_t crcValue)
+{
+    uint16_t crc;
+
+    crc = crcValue ^ dataValue;
+    crc = crc ^ (crc << 1) ^ (crc << 2) ^ (crc << 3) ^ (crc << 4) ^ (crc << 5) ^
+        (crc << 6) ^ (crc << 7);
+
+    return (crc & 0xfe) ^ ((crc >> 8) & 1);
+}
+
+/**
+ * @brief Bitwise CRC16 copied from the BACnet standard, to check the
+ *  table driven calculations against
+ */
+static uint16_t crc16_bitwise(uint8_t dataValue, uint16_t crcValue)
+{
+    uint16_t crcLow;
+
+    crcLow = (crcValue & 0xff) ^ dataValue;
+
+    return (crcValue >> 8) ^ (crcLow << 8) ^ (crcLow << 3) ^ (crcLow << 12) ^
+        (crcLow >> 4) ^ (crcLow & 0x0f) ^ ((crcLow & 0x0f) << 7);
+}
+
 /**
  * @brief Test CRC8 from Annex G 1.0 of BACnet Standard
  */
@@ -73,6 +102,55 @@ static void testCRC16(void)
     zassert_equal(crc, 0xF0B8, NULL);
 }
 
+/**
+ * @brief Test the CRC8 and CRC16 octet and block calculations against
+ *  the bitwise calculations
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(crc_tests, testCRCBlock)
+#else
+static void testCRCBlock(void)
+#endif
+{
+    uint8_t buffer[300] = { 0 };
+    uint16_t crc16, test_crc16;
+    uint8_t crc8, test_crc8;
+    unsigned i, j, length;
+
+    for (i = 0; i < 256; i++) {
+        for (j = 0; j < 256; j += 51) {
+            zassert_equal(
+                CRC_Calc_Header(i, j), crc8_bitwise(i, j), "i=%u j=%u", i, j);
+            zassert_equal(
+                CRC_Calc_Data(i, j | (j << 8)),
+                crc16_bitwise(i, j | (j << 8)), "i=%u j=%u", i, j);
+        }
+    }
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)((i * 7919) >> 3);
+    }
+    for (length = 0; length <= sizeof(buffer); length++) {
+        crc16 = 0xFFFF;
+        crc8 = 0xFF;
+        for (i = 0; i < length; i++) {
+            crc16 = crc16_bitwise(buffer[i], crc16);
+            crc8 = crc8_bitwise(buffer[i], crc8);
+        }
+        test_crc16 = CRC_Calc_Data_Block(buffer, length, 0xFFFF);
+        zassert_equal(crc16, test_crc16, "length=%u", length);
+        test_crc8 = CRC_Calc_Header_Block(buffer, length, 0xFF);
+        zassert_equal(crc8, test_crc8, "length=%u", length);
+    }
+    /* Annex G 2.0 example, including the appended ones complement CRC */
+    buffer[0] = 0x01;
+    buffer[1] = 0x22;
+    buffer[2] = 0x30;
+    buffer[3] = 0x10;
+    buffer[4] = 0xBD;
+    zassert_equal(CRC_Calc_Data_Block(buffer, 3, 0xFFFF), 0x42EF, NULL);
+    zassert_equal(CRC_Calc_Data_Block(buffer, 5, 0xFFFF), 0xF0B8, NULL);
+}
+
 /**
  * @brief "Test" to create/log generated CRC8 table
  */
@@ -139,6 +217,7 @@ void test_main(void)
 {
     ztest_test_suite(
         crc_tests, ztest_unit_test(testCRC8), ztest_unit_test(testCRC16),
+        ztest_unit_test(testCRCBlock),
         ztest_unit_test(testCRC8CreateTable),
         ztest_unit_test(testCRC16CreateTable));
 
@@ -0,0 +1,482 @@
+/**
+ * @file
+ * @brief test BACnet/IP foreign device registration timers of dlenv
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/bbmd/h_bbmd.h>
+#include <bacnet/basic/object/netport.h>
+#include <bacnet/basic/service/h_apdu.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/datalink/bip.h>
+#include <bacnet/datalink/bvlc.h>
+#include <bacnet/datalink/dlenv.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_TTL_SECONDS 60
+#define TEST_RETRY_SECONDS 5
+#define TEST_BDT_SIZE 4
+
+/* the stub resolver has an answer for the host name */
+static bool Test_Resolved;
+static unsigned Test_Register_Count;
+static unsigned Test_Resolve_Count;
+static uint8_t Test_Port_Type;
+static BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY Test_BDT[TEST_BDT_SIZE];
+
+bool bip_init(char *ifname)
+{
+    (void)ifname;
+    return true;
+}
+
+void bip_debug_enable(void)
+{
+}
+
+bool bip_get_addr(BACNET_IP_ADDRESS *addr)
+{
+    return bvlc_address_set(addr, 192, 168, 0, 1);
+}
+
+bool bip_get_addr_by_name(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    (void)host_name;
+    (void)addr;
+    return false;
+}
+
+bool bip_get_addr_by_name_async(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    Test_Resolve_Count++;
+    if (strcmp(host_name, "bbmd.example.com") == 0) {
+        if (Test_Resolved) {
+            return bvlc_address_set(addr, 10, 0, 0, 1);
+        }
+        return false;
+    }
+
+    return bvlc_address_from_ascii(addr, host_name);
+}
+
+uint16_t bip_get_port(void)
+{
+    return 0xBAC0;
+}
+
+void bip_set_port(uint16_t port)
+{
+    (void)port;
+}
+
+uint8_t bip_get_subnet_prefix(void)
+{
+    return 24;
+}
+
+int bip_set_broadcast_binding(const char *ip4_broadcast)
+{
+    (void)ip4_broadcast;
+    return 0;
+}
+
+int bvlc_register_with_bbmd(
+    const BACNET_IP_ADDRESS *address, uint16_t time_to_live_seconds)
+{
+    (void)address;
+    (void)time_to_live_seconds;
+    Test_Register_Count++;
+    return 10;
+}
+
+uint16_t bvlc_get_last_result(void)
+{
+    return 0;
+}
+
+void bvlc_debug_enable(void)
+{
+}
+
+bool bvlc_bbmd_accept_fd_registrations(void)
+{
+    return false;
+}
+
+void bvlc_bbmd_accept_fd_registrations_set(bool flag)
+{
+    (void)flag;
+}
+
+void bvlc_set_global_address_for_nat(const BACNET_IP_ADDRESS *addr)
+{
+    (void)addr;
+}
+
+BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY *bvlc_bdt_list(void)
+{
+    return Test_BDT;
+}
+
+BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *bvlc_fdt_list(void)
+{
+    return NULL;
+}
+
+void apdu_timeout_set(uint16_t value)
+{
+    (void)value;
+}
+
+void apdu_retries_set(uint8_t value)
+{
+    (void)value;
+}
+
+void tsm_invokeID_set(uint8_t invokeID)
+{
+    (void)invokeID;
+}
+
+uint8_t Network_Port_Type(uint32_t object_instance)
+{
+    (void)object_instance;
+    return Test_Port_Type;
+}
+
+bool Network_Port_Type_Set(uint32_t object_instance, uint8_t value)
+{
+    (void)object_instance;
+    Test_Port_Type = value;
+    return true;
+}
+
+bool Network_Port_Object_Instance_Number_Set(
+    unsigned index, uint32_t object_instance)
+{
+    (void)index;
+    (void)object_instance;
+    return true;
+}
+
+bool Network_Port_Name_Set(uint32_t object_instance, const char *new_name)
+{
+    (void)object_instance;
+    (void)new_name;
+    return true;
+}
+
+bool Network_Port_MAC_Address_Set(
+    uint32_t object_instance, const uint8_t *mac_src, uint8_t mac_len)
+{
+    (void)object_instance;
+    (void)mac_src;
+    (void)mac_len;
+    return true;
+}
+
+bool Network_Port_MSTP_Max_Master_Set(uint32_t object_instance, uint8_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_MSTP_Max_Info_Frames_Set(
+    uint32_t object_instance, uint8_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_BIP_Port_Set(uint32_t object_instance, uint16_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_IP_Address_Set(
+    uint32_t object_instance, uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+    (void)object_instance;
+    (void)a;
+    (void)b;
+    (void)c;
+    (void)d;
+    return true;
+}
+
+bool Network_Port_IP_Subnet_Prefix_Set(uint32_t object_instance, uint8_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_Link_Speed_Set(uint32_t object_instance, float value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_BIP6_Port_Set(uint32_t object_instance, uint16_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_IPv6_Address_Set(
+    uint32_t object_instance, const uint8_t *ip_address)
+{
+    (void)object_instance;
+    (void)ip_address;
+    return true;
+}
+
+bool Network_Port_IPv6_Multicast_Address_Set(
+    uint32_t object_instance, const uint8_t *ip_address)
+{
+    (void)object_instance;
+    (void)ip_address;
+    return true;
+}
+
+bool Network_Port_IPv6_Subnet_Prefix_Set(
+    uint32_t object_instance, uint8_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_BBMD_BD_Table_Set(uint32_t object_instance, void *bdt_head)
+{
+    (void)object_instance;
+    (void)bdt_head;
+    return true;
+}
+
+bool Network_Port_BBMD_FD_Table_Set(uint32_t object_instance, void *fdt_head)
+{
+    (void)object_instance;
+    (void)fdt_head;
+    return true;
+}
+
+bool Network_Port_Remote_BBMD_IP_Address_Set(
+    uint32_t object_instance, uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+    (void)object_instance;
+    (void)a;
+    (void)b;
+    (void)c;
+    (void)d;
+    return true;
+}
+
+bool Network_Port_Remote_BBMD_BIP_Port_Set(
+    uint32_t object_instance, uint16_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_Remote_BBMD_BIP_Lifetime_Set(
+    uint32_t object_instance, uint16_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_BBMD_Accept_FD_Registrations(uint32_t object_instance)
+{
+    (void)object_instance;
+    return false;
+}
+
+bool Network_Port_BBMD_Accept_FD_Registrations_Set(
+    uint32_t object_instance, bool value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_Reliability_Set(
+    uint32_t object_instance, BACNET_RELIABILITY value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_Out_Of_Service_Set(uint32_t instance, bool oos_flag)
+{
+    (void)instance;
+    (void)oos_flag;
+    return true;
+}
+
+bool Network_Port_Quality_Set(
+    uint32_t object_instance, BACNET_PORT_QUALITY value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_APDU_Length_Set(uint32_t object_instance, uint16_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_Network_Number_Set(uint32_t object_instance, uint16_t value)
+{
+    (void)object_instance;
+    (void)value;
+    return true;
+}
+
+bool Network_Port_Changes_Pending_Set(uint32_t instance, bool flag)
+{
+    (void)instance;
+    (void)flag;
+    return true;
+}
+
+void Network_Port_Changes_Pending_Activate_Callback_Set(
+    uint32_t instance, bacnet_network_port_activate_changes callback)
+{
+    (void)instance;
+    (void)callback;
+}
+
+void Network_Port_Changes_Pending_Discard_Callback_Set(
+    uint32_t instance, bacnet_network_port_discard_changes callback)
+{
+    (void)instance;
+    (void)callback;
+}
+
+/**
+ * @brief Start the datalink with the given BBMD and BDT host names
+ * @param bbmd_name - BACNET_BBMD_ADDRESS, or NULL
+ * @param bdt_name - BACNET_BDT_ADDR_2, or NULL
+ */
+static void test_dlenv_start(const char *bbmd_name, const char *bdt_name)
+{
+    Test_Resolved = false;
+    Test_Register_Count = 0;
+    Test_Resolve_Count = 0;
+    bvlc_broadcast_distribution_table_link_array(Test_BDT, TEST_BDT_SIZE);
+    bvlc_broadcast_distribution_table_valid_clear(Test_BDT);
+    unsetenv("BACNET_BBMD_ADDRESS");
+    unsetenv("BACNET_BDT_ADDR_2");
+    setenv("BACNET_BBMD_TIMETOLIVE", "60", 1);
+    if (bbmd_name) {
+        setenv("BACNET_BBMD_ADDRESS", bbmd_name, 1);
+    }
+    if (bdt_name) {
+        setenv("BACNET_BDT_ADDR_2", bdt_name, 1);
+    }
+    dlenv_init();
+}
+
+/**
+ * @brief Run the maintenance timer one second at a time
+ * @param seconds - number of seconds to run
+ */
+static void test_dlenv_run(unsigned seconds)
+{
+    while (seconds) {
+        dlenv_maintenance_timer(1);
+        seconds--;
+    }
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlenv_tests, test_dlenv_bdt_name_pending)
+#else
+static void test_dlenv_bdt_name_pending(void)
+#endif
+{
+    unsigned count;
+
+    /* a BDT host name that is pending is looked up again, without
+       a registration */
+    test_dlenv_start(NULL, "bbmd.example.com");
+    zassert_equal(Test_Register_Count, 0, NULL);
+    zassert_true(Test_BDT[0].valid, NULL);
+    zassert_false(Test_BDT[1].valid, NULL);
+    count = Test_Resolve_Count;
+    test_dlenv_run(TEST_RETRY_SECONDS);
+    zassert_true(Test_Resolve_Count > count, NULL);
+    zassert_false(Test_BDT[1].valid, NULL);
+    Test_Resolved = true;
+    test_dlenv_run(TEST_RETRY_SECONDS);
+    zassert_true(Test_BDT[1].valid, NULL);
+    zassert_false(Test_BDT[2].valid, NULL);
+    /* once resolved, no more lookups are made */
+    count = Test_Resolve_Count;
+    test_dlenv_run(TEST_TTL_SECONDS);
+    zassert_equal(Test_Resolve_Count, count, NULL);
+    zassert_equal(Test_Register_Count, 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlenv_tests, test_dlenv_bbmd_name_pending)
+#else
+static void test_dlenv_bbmd_name_pending(void)
+#endif
+{
+    test_dlenv_start("bbmd.example.com", NULL);
+    zassert_equal(Test_Register_Count, 0, NULL);
+    /* the host name is looked up again after the retry delay */
+    test_dlenv_run(TEST_RETRY_SECONDS - 1);
+    zassert_equal(Test_Resolve_Count, 1, NULL);
+    test_dlenv_run(1);
+    zassert_equal(Test_Resolve_Count, 2, NULL);
+    zassert_equal(Test_Register_Count, 0, NULL);
+    /* once resolved, the device registers with the BBMD */
+    Test_Resolved = true;
+    test_dlenv_run(TEST_RETRY_SECONDS);
+    zassert_equal(Test_Register_Count, 1, NULL);
+    /* and renews the registration only after the time-to-live */
+    test_dlenv_run(TEST_TTL_SECONDS - 1);
+    zassert_equal(Test_Register_Count, 1, NULL);
+    test_dlenv_run(1);
+    zassert_equal(Test_Register_Count, 2, NULL);
+    test_dlenv_run(TEST_TTL_SECONDS - 1);
+    zassert_equal(Test_Register_Count, 2, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(dlenv_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        dlenv_tests, ztest_unit_test(test_dlenv_bdt_name_pending),
+        ztest_unit_test(test_dlenv_bbmd_name_pending));
+
+    ztest_run_test_suite(dlenv_tests);
+}
+#endif
@@ -48,6 +48,14 @@ static void test_MSTP_Datalink(void)
     uint16_t test_length;
     uint8_t test_data[10] = { PDU_TYPE_ABORT, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
     BACNET_NPDU_DATA test_npdu_data = { 0 };
+    uint8_t test_frame[8] = { 0x55, 0xFF, 0, 5, 10, 0, 0, 0 };
+    /* ReadProperty request, invoke-id 1, and two candidate replies */
+    uint8_t test_request[6] = { 0x01, 0x04, PDU_TYPE_CONFIRMED_SERVICE_REQUEST,
+                                0x05, 0x01, SERVICE_CONFIRMED_READ_PROPERTY };
+    uint8_t test_other[5] = { 0x01, 0x00, PDU_TYPE_SIMPLE_ACK, 0x09,
+                              SERVICE_CONFIRMED_WRITE_PROPERTY };
+    uint8_t test_reply[5] = { 0x01, 0x00, PDU_TYPE_COMPLEX_ACK, 0x01,
+                              SERVICE_CONFIRMED_READ_PROPERTY };
 
     /* error handling before port is initialized */
     test_length = dlmstp_send_pdu(NULL, NULL, 0, 0);
@@ -225,6 +233,51 @@ static void test_MSTP_Datalink(void)
     zassert_equal(
         test_length, sizeof(test_data) + DLMSTP_HEADER_MAX,
         "MSTP_Get_Send() length=%d", test_length);
+    /* Reply Postponed frames are counted */
+    test_frame[2] = FRAME_TYPE_REPLY_POSTPONED;
+    ztest_expect_data(MSTP_RS485_Send, payload, test_frame);
+    MSTP_Send_Frame(&MSTP_Port, test_frame, sizeof(test_frame));
+    zassert_equal(MSTP_User.Statistics.reply_postponed_counter, 1, NULL);
+    /* a reply queued behind another PDU is found and sent */
+    memcpy(MSTP_Port.InputBuffer, test_request, sizeof(test_request));
+    MSTP_Port.DataLength = sizeof(test_request);
+    MSTP_Port.SourceAddress = 5;
+    dlmstp_fill_bacnet_address(&test_address, 5);
+    test_npdu_data.data_expecting_reply = false;
+    test_length = dlmstp_send_pdu(
+        &test_address, &test_npdu_data, test_other, sizeof(test_other));
+    zassert_equal(test_length, sizeof(test_other), NULL);
+    test_length = dlmstp_send_pdu(
+        &test_address, &test_npdu_data, test_reply, sizeof(test_reply));
+    zassert_equal(test_length, sizeof(test_reply), NULL);
+    ztest_expect_value(MSTP_Create_Frame, buffer, &MSTP_Port.OutputBuffer[0]);
+    ztest_expect_value(
+        MSTP_Create_Frame, buffer_len, MSTP_Port.OutputBufferSize);
+    ztest_expect_value(
+        MSTP_Create_Frame, frame_type,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY);
+    ztest_expect_value(MSTP_Create_Frame, destination, 5);
+    ztest_expect_value(MSTP_Create_Frame, source, MSTP_Port.This_Station);
+    ztest_expect_data(MSTP_Create_Frame, data, test_reply);
+    ztest_returns_value(
+        MSTP_Create_Frame, sizeof(test_reply) + DLMSTP_HEADER_MAX);
+    test_length = MSTP_Get_Reply(&MSTP_Port, 0);
+    zassert_equal(test_length, sizeof(test_reply) + DLMSTP_HEADER_MAX, NULL);
+    /* the other PDU stays queued */
+    zassert_equal(Ringbuf_Count(&MSTP_User.PDU_Queue), 1, NULL);
+    ztest_expect_value(MSTP_Create_Frame, buffer, &MSTP_Port.OutputBuffer[0]);
+    ztest_expect_value(
+        MSTP_Create_Frame, buffer_len, MSTP_Port.OutputBufferSize);
+    ztest_expect_value(
+        MSTP_Create_Frame, frame_type,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY);
+    ztest_expect_value(MSTP_Create_Frame, destination, 5);
+    ztest_expect_value(MSTP_Create_Frame, source, MSTP_Port.This_Station);
+    ztest_expect_data(MSTP_Create_Frame, data, test_other);
+    ztest_returns_value(
+        MSTP_Create_Frame, sizeof(test_other) + DLMSTP_HEADER_MAX);
+    test_length = MSTP_Get_Send(&MSTP_Port, 0);
+    zassert_equal(test_length, sizeof(test_other) + DLMSTP_HEADER_MAX, NULL);
 }
 /**
  * @}
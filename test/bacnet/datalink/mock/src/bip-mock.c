@@ -109,6 +109,13 @@ bool bip_get_addr_by_name(const char *host_name, BACNET_IP_ADDRESS *addr)
     return ztest_get_return_value();
 }
 
+bool bip_get_addr_by_name_async(const char *host_name, BACNET_IP_ADDRESS *addr)
+{
+    ztest_check_expected_value(host_name);
+    ztest_check_expected_value(addr);
+    return ztest_get_return_value();
+}
+
 void bip_get_broadcast_address(BACNET_ADDRESS *dest)
 {
     ztest_copy_return_data(dest, sizeof(BACNET_ADDRESS));
@@ -114,6 +114,22 @@ int bip6_send_mpdu(
     return ztest_get_return_value();
 }
 
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+
+    for (i = 0; i < dest_count; i++) {
+        if (bip6_send_mpdu(&dest[i], mtu, mtu_len) < 0) {
+            return -1;
+        }
+    }
+    return (int)dest_count;
+}
+
 bool bip6_send_pdu_queue_empty(void)
 {
     return ztest_get_return_value();
@@ -104,12 +104,25 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
  * @param timeout milliseconds to wait for a packet to send
  * @return amount of PDU data
  */
+/* frames queued for the MS/TP state machine to send */
+static unsigned Test_Send_Queue_Count;
+static uint8_t Test_Send_Queue_Frame_Type;
+static uint8_t Test_Send_Queue_Destination;
+
 uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 {
-    (void)mstp_port;
+    uint8_t data[8] = { 0x01, 0x00, 0x10, 0x08 };
+
     (void)timeout;
+    if (Test_Send_Queue_Count == 0) {
+        return 0;
+    }
+    Test_Send_Queue_Count--;
 
-    return 0;
+    return MSTP_Create_Frame(
+        mstp_port->OutputBuffer, mstp_port->OutputBufferSize,
+        Test_Send_Queue_Frame_Type, Test_Send_Queue_Destination,
+        mstp_port->This_Station, data, sizeof(data));
 }
 
 /**
@@ -201,11 +214,21 @@ void Baud_Rate_Set(uint32_t baud)
  * @param buffer pointer to the frame data
  * @param nbytes number of bytes to send
  */
+/* the frames sent by the MS/TP state machine */
+static unsigned Test_Sent_Frame_Count;
+static uint8_t Test_Sent_Frame_Type[8];
+
 void MSTP_Send_Frame(
     struct mstp_port_struct_t *mstp_port,
     const uint8_t *buffer,
     uint16_t nbytes)
 {
+    if (buffer && (nbytes > 2)) {
+        if (Test_Sent_Frame_Count < sizeof(Test_Sent_Frame_Type)) {
+            Test_Sent_Frame_Type[Test_Sent_Frame_Count] = buffer[2];
+        }
+        Test_Sent_Frame_Count++;
+    }
     if (mstp_port && mstp_port->OutputBuffer && buffer && (nbytes > 0) &&
         (nbytes <= mstp_port->OutputBufferSize)) {
         memcpy(mstp_port->OutputBuffer, buffer, nbytes);
@@ -570,6 +593,21 @@ static void testReceiveNodeFSM(void)
     zassert_true(mstp_port.ReceivedInvalidFrame == false, NULL);
     zassert_true(mstp_port.ReceivedValidFrame == true, NULL);
     zassert_true(mstp_port.receive_state == MSTP_RECEIVE_STATE_IDLE, NULL);
+    /* BadCRC in data check */
+    mstp_port.ReceivedInvalidFrame = false;
+    mstp_port.ReceivedValidFrame = false;
+    /* make one data octet bad */
+    buffer[8 + sizeof(data_proprietary) / 2] ^= 0x01;
+    Load_Input_Buffer(buffer, len);
+    RS485_Check_UART_Data(&mstp_port);
+    MSTP_Receive_Frame_FSM(&mstp_port);
+    while (mstp_port.receive_state != MSTP_RECEIVE_STATE_IDLE) {
+        RS485_Check_UART_Data(&mstp_port);
+        MSTP_Receive_Frame_FSM(&mstp_port);
+    }
+    zassert_true(mstp_port.ReceivedInvalidFrame == true, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame == false, NULL);
+    zassert_true(mstp_port.receive_state == MSTP_RECEIVE_STATE_IDLE, NULL);
     /* Extended-Data-Expecting-Reply */
     zassert_true(Nmin_COBS_length_BACnet <= sizeof(data), NULL);
     mstp_port.ReceivedInvalidFrame = false;
@@ -646,6 +684,154 @@ static void testMasterNodeFSM(void)
     /* FIXME: write a unit test for the Master Node State Machine */
 }
 
+/**
+ * @brief Set up a master node that holds the token, with frames queued
+ * @param mstp_port port specific context data
+ * @param burst true if the node sends its frames back-to-back
+ * @param frames number of frames queued to send
+ * @param frame_type type of the queued frames
+ * @param destination destination of the queued frames
+ */
+static void testMasterNodeFSM_UseToken_Init(
+    struct mstp_port_struct_t *mstp_port,
+    bool burst,
+    unsigned frames,
+    uint8_t frame_type,
+    uint8_t destination)
+{
+    memset(mstp_port, 0, sizeof(*mstp_port));
+    mstp_port->InputBuffer = &RxBuffer[0];
+    mstp_port->InputBufferSize = sizeof(RxBuffer);
+    mstp_port->OutputBuffer = &TxBuffer[0];
+    mstp_port->OutputBufferSize = sizeof(TxBuffer);
+    mstp_port->Nmax_info_frames = 3;
+    mstp_port->Nmax_master = 127;
+    mstp_port->Tframe_abort = DEFAULT_Tframe_abort;
+    mstp_port->Treply_delay = DEFAULT_Treply_delay;
+    mstp_port->Treply_timeout = DEFAULT_Treply_timeout;
+    mstp_port->Tusage_timeout = DEFAULT_Tusage_timeout;
+    mstp_port->SilenceTimer = Timer_Silence;
+    mstp_port->SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port->This_Station = 5;
+    MSTP_Init(mstp_port);
+    mstp_port->TokenBurstEnabled = burst;
+    /* holds the token, with a known successor */
+    mstp_port->Next_Station = 6;
+    mstp_port->SoleMaster = false;
+    mstp_port->TokenCount = 0;
+    mstp_port->FrameCount = 0;
+    mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
+    SilenceTime = 0;
+    Test_Send_Queue_Count = frames;
+    Test_Send_Queue_Frame_Type = frame_type;
+    Test_Send_Queue_Destination = destination;
+    Test_Sent_Frame_Count = 0;
+    memset(Test_Sent_Frame_Type, 0, sizeof(Test_Sent_Frame_Type));
+}
+
+/**
+ * @brief Run the master node state machine until it waits
+ * @param mstp_port port specific context data
+ * @return number of passes of the state machine
+ */
+static unsigned testMasterNodeFSM_Run(struct mstp_port_struct_t *mstp_port)
+{
+    unsigned passes = 0;
+
+    while (MSTP_Master_Node_FSM(mstp_port)) {
+        passes++;
+        zassert_true(passes < 32, NULL);
+    }
+
+    return passes + 1;
+}
+
+static void testMasterNodeFSM_TokenBurst(void)
+{
+    struct mstp_port_struct_t MSTP_Port;
+    bool transition_now;
+    unsigned passes;
+
+    /* no burst: one information frame per pass of the state machine */
+    testMasterNodeFSM_UseToken_Init(
+        &MSTP_Port, false, 3, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 7);
+    transition_now = MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_false(transition_now, NULL);
+    zassert_equal(
+        MSTP_Port.master_state, MSTP_MASTER_STATE_DONE_WITH_TOKEN, NULL);
+    zassert_equal(Test_Sent_Frame_Count, 1, NULL);
+    zassert_equal(MSTP_Port.FrameCount, 1, NULL);
+    /* each further pass sends the next frame, and then waits */
+    passes = testMasterNodeFSM_Run(&MSTP_Port);
+    zassert_equal(passes, 2, NULL);
+    zassert_equal(
+        MSTP_Port.master_state, MSTP_MASTER_STATE_DONE_WITH_TOKEN, NULL);
+    zassert_equal(Test_Sent_Frame_Count, 2, NULL);
+    (void)testMasterNodeFSM_Run(&MSTP_Port);
+    zassert_equal(Test_Sent_Frame_Count, 3, NULL);
+    (void)testMasterNodeFSM_Run(&MSTP_Port);
+    /* Nmax_info_frames sent, then the token is passed */
+    zassert_equal(Test_Sent_Frame_Count, 4, NULL);
+    zassert_equal(
+        Test_Sent_Frame_Type[2], FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        NULL);
+    zassert_equal(Test_Sent_Frame_Type[3], FRAME_TYPE_TOKEN, NULL);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+    zassert_equal(Test_Send_Queue_Count, 0, NULL);
+
+    /* burst: the queued frames and the token go out in one run */
+    testMasterNodeFSM_UseToken_Init(
+        &MSTP_Port, true, 3, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 7);
+    transition_now = MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_true(transition_now, NULL);
+    zassert_equal(
+        MSTP_Port.master_state, MSTP_MASTER_STATE_DONE_WITH_TOKEN, NULL);
+    (void)testMasterNodeFSM_Run(&MSTP_Port);
+    zassert_equal(Test_Sent_Frame_Count, 4, NULL);
+    zassert_equal(
+        Test_Sent_Frame_Type[0], FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        NULL);
+    zassert_equal(
+        Test_Sent_Frame_Type[2], FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        NULL);
+    zassert_equal(Test_Sent_Frame_Type[3], FRAME_TYPE_TOKEN, NULL);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+    zassert_equal(Test_Send_Queue_Count, 0, NULL);
+
+    /* burst: no more than Nmax_info_frames per token */
+    testMasterNodeFSM_UseToken_Init(
+        &MSTP_Port, true, 5, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 7);
+    (void)testMasterNodeFSM_Run(&MSTP_Port);
+    zassert_equal(Test_Sent_Frame_Count, 4, NULL);
+    zassert_equal(Test_Sent_Frame_Type[3], FRAME_TYPE_TOKEN, NULL);
+    zassert_equal(Test_Send_Queue_Count, 2, NULL);
+
+    /* burst: a broadcast expecting a reply is sent without waiting */
+    testMasterNodeFSM_UseToken_Init(
+        &MSTP_Port, true, 2, FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY,
+        MSTP_BROADCAST_ADDRESS);
+    (void)testMasterNodeFSM_Run(&MSTP_Port);
+    zassert_equal(Test_Sent_Frame_Count, 3, NULL);
+    zassert_equal(Test_Sent_Frame_Type[2], FRAME_TYPE_TOKEN, NULL);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+
+    /* burst: a frame expecting a reply still waits for the reply */
+    testMasterNodeFSM_UseToken_Init(
+        &MSTP_Port, true, 2, FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, 7);
+    (void)testMasterNodeFSM_Run(&MSTP_Port);
+    zassert_equal(Test_Sent_Frame_Count, 1, NULL);
+    zassert_equal(
+        MSTP_Port.master_state, MSTP_MASTER_STATE_WAIT_FOR_REPLY, NULL);
+
+    /* burst: nothing to send passes the token */
+    testMasterNodeFSM_UseToken_Init(
+        &MSTP_Port, true, 0, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 7);
+    (void)testMasterNodeFSM_Run(&MSTP_Port);
+    zassert_equal(Test_Sent_Frame_Count, 1, NULL);
+    zassert_equal(Test_Sent_Frame_Type[0], FRAME_TYPE_TOKEN, NULL);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+}
+
 static void testSlaveNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
@@ -1367,7 +1553,9 @@ void test_main(void)
 {
     ztest_test_suite(
         crc_tests, ztest_unit_test(testReceiveNodeFSM),
-        ztest_unit_test(testMasterNodeFSM), ztest_unit_test(testSlaveNodeFSM),
+        ztest_unit_test(testMasterNodeFSM),
+        ztest_unit_test(testMasterNodeFSM_TokenBurst),
+        ztest_unit_test(testSlaveNodeFSM),
         ztest_unit_test(testZeroConfigNodeFSM),
         ztest_unit_test(testAutoBaudNodeFSM));
 
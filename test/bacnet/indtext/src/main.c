@@ -58,6 +58,117 @@ static void testIndexText(void)
     zassert_equal(
         index, indtext_by_istring_default(data_list, "ANNA", index), NULL);
 }
+/* larger than the lists that are scanned, with repeated strings and
+   indices where the first entry shall be found */
+static INDTEXT_DATA large_list[] = {
+    { 0, "zero" },      { 1, "one" },       { 2, "two" },
+    { 3, "three" },     { 4, "four" },      { 5, "five" },
+    { 6, "six" },       { 7, "seven" },     { 8, "eight" },
+    { 9, "nine" },      { 10, "ten" },      { 11, "eleven" },
+    { 12, "twelve" },   { 13, "thirteen" }, { 14, "fourteen" },
+    { 15, "fifteen" },  { 16, "sixteen" },  { 17, "seventeen" },
+    { 18, "eighteen" }, { 19, "nineteen" }, { 1000, "thousand" },
+    { 20, "one" },      { 1, "uno" },       { 21, "ONE" },
+    { 0, NULL }
+};
+
+/**
+ * @brief Check the lookups in the large list
+ */
+static void testIndexTextLargeLookup(void)
+{
+    unsigned i;
+    unsigned index = 0;
+    const char *pString;
+
+    for (i = 0; i < 20; i++) {
+        pString = indtext_by_index(large_list, i);
+        zassert_not_null(pString, NULL);
+        zassert_true(indtext_by_string(large_list, pString, &index), NULL);
+        zassert_equal(index, i, NULL);
+    }
+    zassert_equal(indtext_count(large_list), 24, NULL);
+    zassert_true(indtext_by_string(large_list, "thousand", &index), NULL);
+    zassert_equal(index, 1000, NULL);
+    zassert_equal(
+        strcmp(indtext_by_index(large_list, 1000), "thousand"), 0, NULL);
+    zassert_is_null(indtext_by_index(large_list, 999), NULL);
+    zassert_false(indtext_by_string(large_list, "hundred", NULL), NULL);
+    /* the first entry wins, as in a scan */
+    zassert_equal(strcmp(indtext_by_index(large_list, 1), "one"), 0, NULL);
+    zassert_true(indtext_by_string(large_list, "one", &index), NULL);
+    zassert_equal(index, 1, NULL);
+    zassert_true(indtext_by_string(large_list, "ONE", &index), NULL);
+    zassert_equal(index, 21, NULL);
+    zassert_true(indtext_by_istring(large_list, "oNe", &index), NULL);
+    zassert_equal(index, 1, NULL);
+    zassert_true(indtext_by_istring(large_list, "THOUSAND", &index), NULL);
+    zassert_equal(index, 1000, NULL);
+    zassert_false(indtext_by_istring(large_list, "thousands", NULL), NULL);
+    zassert_equal(
+        indtext_by_istring_default(large_list, "none", 77), 77, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(indtext_tests, testIndexTextLarge)
+#else
+static void testIndexTextLarge(void)
+#endif
+{
+    /* scanned, then with the hash tables of the registered list */
+    testIndexTextLargeLookup();
+    zassert_true(indtext_index_register(large_list), NULL);
+    zassert_true(indtext_index_register(large_list), NULL);
+    testIndexTextLargeLookup();
+    zassert_false(indtext_index_register(NULL), NULL);
+}
+/* more lists than INDTEXT_INDEX_LISTS registers */
+static INDTEXT_DATA small_lists[6][3] = {
+    { { 0, "alpha" }, { 10, "one" }, { 0, NULL } },
+    { { 1, "bravo" }, { 11, "one" }, { 0, NULL } },
+    { { 2, "charlie" }, { 12, "one" }, { 0, NULL } },
+    { { 3, "delta" }, { 13, "one" }, { 0, NULL } },
+    { { 4, "echo" }, { 14, "one" }, { 0, NULL } },
+    { { 5, "foxtrot" }, { 15, "one" }, { 0, NULL } },
+};
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(indtext_tests, testIndexTextLists)
+#else
+static void testIndexTextLists(void)
+#endif
+{
+    unsigned i, pass, registered = 0;
+    unsigned index = 0;
+
+    /* the lists that are registered and the ones that did not fit give
+       the same answers as before they were registered */
+    for (pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            for (i = 0; i < 6; i++) {
+                if (indtext_index_register(small_lists[i])) {
+                    registered++;
+                }
+            }
+            zassert_true(registered > 0, NULL);
+            zassert_true(registered < 6, NULL);
+        }
+        for (i = 0; i < 6; i++) {
+            zassert_equal(indtext_count(small_lists[i]), 2, NULL);
+            zassert_true(
+                indtext_by_string(small_lists[i], "one", &index), NULL);
+            zassert_equal(index, 10 + i, NULL);
+            zassert_true(
+                indtext_by_istring(small_lists[i], "ONE", &index), NULL);
+            zassert_equal(index, 10 + i, NULL);
+            zassert_equal(
+                strcmp(indtext_by_index(small_lists[i], i),
+                    small_lists[i][0].pString),
+                0, NULL);
+            zassert_is_null(indtext_by_index(small_lists[i], 99), NULL);
+        }
+    }
+}
 /**
  * @}
  */
@@ -67,7 +178,10 @@ ZTEST_SUITE(indtext_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(indtext_tests, ztest_unit_test(testIndexText));
+    ztest_test_suite(
+        indtext_tests, ztest_unit_test(testIndexText),
+        ztest_unit_test(testIndexTextLarge),
+        ztest_unit_test(testIndexTextLists));
 
     ztest_run_test_suite(indtext_tests);
 }
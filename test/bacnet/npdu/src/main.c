@@ -199,6 +199,100 @@ static void testNPDU1(void)
     zassert_equal(npdu_dest.mac_len, src.mac_len, NULL);
     zassert_equal(npdu_src.mac_len, dest.mac_len, NULL);
 }
+
+/**
+ * @brief Test the encoded NPDU header, and the local NPDU decoding
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(npdu_tests, testNPDUHeader)
+#else
+static void testNPDUHeader(void)
+#endif
+{
+    uint8_t pdu[MAX_NPDU] = { 0 };
+    uint8_t test_pdu[MAX_NPDU] = { 0 };
+    BACNET_NPDU_HEADER header = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_NPDU_DATA test_npdu_data = { 0 };
+    int len = 0, test_len = 0;
+
+    npdu_header_init(&header);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_URGENT);
+    /* local */
+    len = npdu_header_encode(&header, pdu, &dest, &src, &npdu_data);
+    zassert_equal(len, 2, NULL);
+    test_len = npdu_encode_pdu(test_pdu, &dest, &src, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(pdu, test_pdu, len, NULL);
+    /* encoded once, copied after that */
+    memset(pdu, 0, sizeof(pdu));
+    test_len = npdu_header_encode(&header, pdu, &dest, &src, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(pdu, test_pdu, len, NULL);
+    test_len = npdu_header_encode(&header, NULL, &dest, NULL, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    /* the local fast path decodes the same as a routed message */
+    npdu_dest.net = 1;
+    npdu_dest.len = 1;
+    test_len = bacnet_npdu_decode(
+        pdu, len, &npdu_dest, &npdu_src, &test_npdu_data);
+    zassert_equal(test_len, 2, NULL);
+    zassert_equal(npdu_dest.net, 0, NULL);
+    zassert_equal(npdu_dest.len, 0, NULL);
+    zassert_equal(npdu_src.net, 0, NULL);
+    zassert_true(test_npdu_data.data_expecting_reply, NULL);
+    zassert_false(test_npdu_data.network_layer_message, NULL);
+    zassert_equal(test_npdu_data.priority, MESSAGE_PRIORITY_URGENT, NULL);
+    zassert_equal(test_npdu_data.hop_count, 0, NULL);
+    zassert_equal(
+        test_npdu_data.network_message_type, NETWORK_MESSAGE_INVALID, NULL);
+    npdu_src.net = BACNET_BROADCAST_NETWORK;
+    test_len = bacnet_npdu_decode(
+        pdu, len, &npdu_dest, &npdu_src, &test_npdu_data);
+    zassert_equal(npdu_src.net, BACNET_BROADCAST_NETWORK, NULL);
+    /* a change of destination, source, or NPCI encodes again */
+    dest.net = 2;
+    dest.len = 1;
+    dest.adr[0] = 0x12;
+    src.net = 3;
+    src.len = 2;
+    src.adr[0] = 0x34;
+    src.adr[1] = 0x56;
+    len = npdu_header_encode(&header, pdu, &dest, &src, &npdu_data);
+    test_len = npdu_encode_pdu(test_pdu, &dest, &src, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(pdu, test_pdu, len, NULL);
+    dest.adr[0] = 0x13;
+    len = npdu_header_encode(&header, pdu, &dest, &src, &npdu_data);
+    test_len = npdu_encode_pdu(test_pdu, &dest, &src, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(pdu, test_pdu, len, NULL);
+    npdu_data.hop_count = 10;
+    len = npdu_header_encode(&header, pdu, &dest, &src, &npdu_data);
+    test_len = npdu_encode_pdu(test_pdu, &dest, &src, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(pdu, test_pdu, len, NULL);
+    npdu_data.priority = MESSAGE_PRIORITY_NORMAL;
+    len = npdu_header_encode(&header, pdu, &dest, NULL, &npdu_data);
+    test_len = npdu_encode_pdu(test_pdu, &dest, NULL, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(pdu, test_pdu, len, NULL);
+    /* a routed message takes the full decoding */
+    test_len = bacnet_npdu_decode(
+        pdu, len, &npdu_dest, &npdu_src, &test_npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_equal(npdu_dest.net, 2, NULL);
+    zassert_equal(npdu_dest.adr[0], 0x13, NULL);
+    zassert_equal(test_npdu_data.hop_count, 10, NULL);
+    /* no header */
+    len = npdu_header_encode(NULL, pdu, &dest, &src, &npdu_data);
+    test_len = npdu_encode_pdu(test_pdu, &dest, &src, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+}
 /**
  * @}
  */
@@ -210,7 +304,7 @@ void test_main(void)
 {
     ztest_test_suite(
         npdu_tests, ztest_unit_test(testNPDU1), ztest_unit_test(testNPDU2),
-        ztest_unit_test(test_NPDU_Network));
+        ztest_unit_test(test_NPDU_Network), ztest_unit_test(testNPDUHeader));
 
     ztest_run_test_suite(npdu_tests);
 }
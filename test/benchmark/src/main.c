@@ -0,0 +1,811 @@
+/**
+ * @file
+ * @brief Benchmarks of the codec hot paths, reporting the time and the
+ *  number of bytes of each operation, as text or as JSON that can be
+ *  compared with the results of an earlier release.
+ *
+ * Every benchmark uses a corpus that is encoded at startup from fixed
+ * values, so that the same build always measures the same bytes.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/npdu.h"
+#include "bacnet/rpm.h"
+#include "bacnet/version.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/datalink/bsc/bvlc-sc.h"
+#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/mstpdef.h"
+
+/* default minimum time, in milliseconds, to run each benchmark */
+#define BENCHMARK_TIME_MS 200
+/* percent slower than the baseline that is reported as a regression */
+#define BENCHMARK_THRESHOLD 10.0
+
+/* number of entries in each corpus */
+#define CORPUS_SIZE 16
+
+struct benchmark_corpus {
+    uint8_t data[CORPUS_SIZE][MAX_PDU];
+    uint16_t len[CORPUS_SIZE];
+    unsigned count;
+};
+
+struct benchmark_result {
+    unsigned long operations;
+    double ns_per_op;
+    double bytes_per_op;
+};
+
+/**
+ * @brief Runs the operation once over the corpus
+ * @param bytes [out] number of bytes encoded or decoded
+ * @return number of operations
+ */
+typedef unsigned (*benchmark_function)(size_t *bytes);
+
+struct benchmark {
+    const char *name;
+    void (*setup)(void);
+    benchmark_function run;
+};
+
+/* results that are kept, so that the benchmarked code is not removed */
+static volatile long Benchmark_Sink;
+
+static BACNET_APPLICATION_DATA_VALUE Value_Corpus[CORPUS_SIZE];
+static unsigned Value_Corpus_Count;
+static struct benchmark_corpus Application_Corpus;
+static struct benchmark_corpus RPM_Corpus;
+static struct benchmark_corpus NPDU_Local_Corpus;
+static struct benchmark_corpus NPDU_Routed_Corpus;
+static struct benchmark_corpus BVLC_Corpus;
+static struct benchmark_corpus BVLC_SC_Corpus;
+static struct benchmark_corpus MSTP_Corpus;
+
+static uint8_t Encode_Buffer[MAX_PDU];
+static BACNET_APPLICATION_DATA_VALUE Decode_Value;
+
+/**
+ * @brief Get the monotonic time
+ * @return time in nanoseconds
+ */
+static uint64_t benchmark_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Add an entry to a corpus
+ * @param corpus [in,out] corpus
+ * @param data [in] entry
+ * @param len [in] size of the entry in bytes
+ */
+static void corpus_add(
+    struct benchmark_corpus *corpus, const uint8_t *data, int len)
+{
+    if ((corpus->count < CORPUS_SIZE) && (len > 0) && (len <= MAX_PDU)) {
+        memcpy(corpus->data[corpus->count], data, (size_t)len);
+        corpus->len[corpus->count] = (uint16_t)len;
+        corpus->count++;
+    }
+}
+
+/**
+ * @brief Create the application values that are encoded and decoded
+ */
+static void value_corpus_setup(void)
+{
+    static const char *strings[] = { "", "Zone Temperature",
+                                     "Supply Air Static Pressure Setpoint" };
+    BACNET_APPLICATION_DATA_VALUE *value;
+    unsigned i;
+
+    if (Value_Corpus_Count) {
+        return;
+    }
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_NULL;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value->type.Boolean = true;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value->type.Unsigned_Int = 42;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value->type.Unsigned_Int = 4194303;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_SIGNED_INT;
+    value->type.Signed_Int = -1234;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_REAL;
+    value->type.Real = 21.5f;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_DOUBLE;
+    value->type.Double = 1234567.891;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value->type.Enumerated = 3;
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_OCTET_STRING;
+    octetstring_init(&value->type.Octet_String, (uint8_t *)"\x01\x02\x03", 3);
+    for (i = 0; i < sizeof(strings) / sizeof(strings[0]); i++) {
+        value = &Value_Corpus[Value_Corpus_Count++];
+        value->tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+        characterstring_init_ansi(&value->type.Character_String, strings[i]);
+    }
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value->type.Bit_String);
+    bitstring_set_bit(&value->type.Bit_String, 0, true);
+    bitstring_set_bit(&value->type.Bit_String, 3, true);
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_DATE;
+    datetime_set_date(&value->type.Date, 2026, 1, 15);
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_TIME;
+    datetime_set_time(&value->type.Time, 13, 45, 30, 0);
+    value = &Value_Corpus[Value_Corpus_Count++];
+    value->tag = BACNET_APPLICATION_TAG_OBJECT_ID;
+    value->type.Object_Id.type = OBJECT_ANALOG_INPUT;
+    value->type.Object_Id.instance = 1234;
+}
+
+/**
+ * @brief Create the encoded application values to decode
+ */
+static void application_setup(void)
+{
+    unsigned i;
+    int len;
+
+    value_corpus_setup();
+    for (i = 0; i < Value_Corpus_Count; i++) {
+        len = bacapp_encode_application_data(Encode_Buffer, &Value_Corpus[i]);
+        corpus_add(&Application_Corpus, Encode_Buffer, len);
+    }
+}
+
+static unsigned application_encode(size_t *bytes)
+{
+    unsigned i;
+    int len;
+
+    for (i = 0; i < Value_Corpus_Count; i++) {
+        len = bacapp_encode_application_data(Encode_Buffer, &Value_Corpus[i]);
+        if (len > 0) {
+            *bytes += (size_t)len;
+        }
+        Benchmark_Sink += Encode_Buffer[0];
+    }
+
+    return Value_Corpus_Count;
+}
+
+static unsigned application_decode(size_t *bytes)
+{
+    unsigned i;
+    int len;
+
+    for (i = 0; i < Application_Corpus.count; i++) {
+        len = bacapp_decode_application_data(
+            Application_Corpus.data[i], Application_Corpus.len[i],
+            &Decode_Value);
+        if (len > 0) {
+            *bytes += (size_t)len;
+        }
+        Benchmark_Sink += Decode_Value.tag;
+    }
+
+    return Application_Corpus.count;
+}
+
+/**
+ * @brief Create the encoded ReadPropertyMultiple property references
+ */
+static void rpm_setup(void)
+{
+    static const BACNET_PROPERTY_ID properties[] = {
+        PROP_PRESENT_VALUE, PROP_OBJECT_NAME, PROP_STATUS_FLAGS,
+        PROP_PRIORITY_ARRAY, PROP_ALL, PROP_DESCRIPTION
+    };
+    uint8_t apdu[16];
+    unsigned i;
+    int len;
+
+    /* each reference is followed by the closing tag of the list */
+    for (i = 0; i < sizeof(properties) / sizeof(properties[0]); i++) {
+        len = encode_context_enumerated(&apdu[0], 0, properties[i]);
+        encode_closing_tag(&apdu[len], 1);
+        corpus_add(&RPM_Corpus, apdu, len + 1);
+        /* with an array index */
+        len += encode_context_unsigned(&apdu[len], 1, i + 1);
+        encode_closing_tag(&apdu[len], 1);
+        corpus_add(&RPM_Corpus, apdu, len + 1);
+    }
+}
+
+static unsigned rpm_decode(size_t *bytes)
+{
+    BACNET_RPM_DATA rpmdata;
+    unsigned i;
+    int len;
+
+    for (i = 0; i < RPM_Corpus.count; i++) {
+        len = rpm_decode_object_property(
+            RPM_Corpus.data[i], RPM_Corpus.len[i], &rpmdata);
+        if (len > 0) {
+            *bytes += (size_t)len;
+        }
+        Benchmark_Sink += rpmdata.object_property;
+    }
+
+    return RPM_Corpus.count;
+}
+
+/**
+ * @brief Create the encoded NPDU headers of local and routed messages
+ */
+static void npdu_setup(void)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t pdu[MAX_NPDU];
+    int len;
+
+    if (NPDU_Local_Corpus.count) {
+        return;
+    }
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, &dest, &src, &npdu_data);
+    corpus_add(&NPDU_Local_Corpus, pdu, len);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_URGENT);
+    len = npdu_encode_pdu(pdu, &dest, &src, &npdu_data);
+    corpus_add(&NPDU_Local_Corpus, pdu, len);
+    /* routed to and from remote MS/TP and BACnet/IP networks */
+    dest.net = 2001;
+    dest.len = 1;
+    dest.adr[0] = 0x7f;
+    src.net = 1;
+    src.len = 6;
+    memcpy(src.adr, "\xc0\xa8\x00\x01\xba\xc0", 6);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, &dest, &src, &npdu_data);
+    corpus_add(&NPDU_Routed_Corpus, pdu, len);
+    dest.net = BACNET_BROADCAST_NETWORK;
+    dest.len = 0;
+    len = npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+    corpus_add(&NPDU_Routed_Corpus, pdu, len);
+}
+
+static unsigned npdu_decode_corpus(
+    const struct benchmark_corpus *corpus, size_t *bytes)
+{
+    BACNET_ADDRESS dest;
+    BACNET_ADDRESS src;
+    BACNET_NPDU_DATA npdu_data;
+    unsigned i;
+    int len;
+
+    for (i = 0; i < corpus->count; i++) {
+        src.net = 0;
+        len = bacnet_npdu_decode(
+            corpus->data[i], corpus->len[i], &dest, &src, &npdu_data);
+        if (len > 0) {
+            *bytes += (size_t)len;
+        }
+        Benchmark_Sink += npdu_data.priority + dest.net;
+    }
+
+    return corpus->count;
+}
+
+static unsigned npdu_decode_local(size_t *bytes)
+{
+    return npdu_decode_corpus(&NPDU_Local_Corpus, bytes);
+}
+
+static unsigned npdu_decode_routed(size_t *bytes)
+{
+    return npdu_decode_corpus(&NPDU_Routed_Corpus, bytes);
+}
+
+/**
+ * @brief Create a NPDU carrying a ReadProperty request
+ * @param pdu [out] buffer for the NPDU
+ * @param size [in] number of NPDU bytes
+ * @return number of bytes in the NPDU
+ */
+static uint16_t npdu_payload(uint8_t *pdu, uint16_t size)
+{
+    uint16_t i;
+
+    /* version, control, and the rest is a repeatable pattern */
+    pdu[0] = BACNET_PROTOCOL_VERSION;
+    pdu[1] = 0x04;
+    for (i = 2; i < size; i++) {
+        pdu[i] = (uint8_t)(i * 7);
+    }
+
+    return size;
+}
+
+/**
+ * @brief Create the BACnet/IP BVLC messages
+ */
+static void bvlc_setup(void)
+{
+    static const uint16_t sizes[] = { 16, 64, 480 };
+    BACNET_IP_ADDRESS address = { 0 };
+    uint8_t npdu[MAX_NPDU + MAX_APDU];
+    uint8_t pdu[MAX_PDU];
+    uint16_t npdu_len;
+    unsigned i;
+    int len;
+
+    address.address[0] = 192;
+    address.address[1] = 168;
+    address.address[3] = 10;
+    address.port = 0xBAC0;
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        npdu_len = npdu_payload(npdu, sizes[i]);
+        len = bvlc_encode_original_unicast(pdu, sizeof(pdu), npdu, npdu_len);
+        corpus_add(&BVLC_Corpus, pdu, len);
+        len = bvlc_encode_forwarded_npdu(
+            pdu, sizeof(pdu), &address, npdu, npdu_len);
+        corpus_add(&BVLC_Corpus, pdu, len);
+    }
+}
+
+static unsigned bvlc_decode(size_t *bytes)
+{
+    static uint8_t npdu[MAX_PDU];
+    BACNET_IP_ADDRESS address;
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    uint16_t npdu_len = 0;
+    const uint8_t *pdu;
+    uint16_t pdu_len;
+    unsigned i;
+    int offset, len;
+
+    for (i = 0; i < BVLC_Corpus.count; i++) {
+        pdu = BVLC_Corpus.data[i];
+        pdu_len = BVLC_Corpus.len[i];
+        offset = bvlc_decode_header(
+            pdu, pdu_len, &message_type, &message_length);
+        if (offset <= 0) {
+            continue;
+        }
+        len = 0;
+        if (message_type == BVLC_ORIGINAL_UNICAST_NPDU) {
+            len = bvlc_decode_original_unicast(
+                &pdu[offset], message_length - offset, npdu, sizeof(npdu),
+                &npdu_len);
+        } else if (message_type == BVLC_FORWARDED_NPDU) {
+            len = bvlc_decode_forwarded_npdu(
+                &pdu[offset], message_length - offset, &address, npdu,
+                sizeof(npdu), &npdu_len);
+        }
+        if (len > 0) {
+            *bytes += (size_t)(offset + len);
+        }
+        Benchmark_Sink += npdu_len;
+    }
+
+    return BVLC_Corpus.count;
+}
+
+/**
+ * @brief Create the BACnet/SC BVLC messages
+ */
+static void bvlc_sc_setup(void)
+{
+    static const uint16_t sizes[] = { 16, 64, 480 };
+    BACNET_SC_VMAC_ADDRESS origin = { { 0x02, 0x11, 0x22, 0x33, 0x44, 0x55 } };
+    BACNET_SC_VMAC_ADDRESS dest = { { 0x02, 0x66, 0x77, 0x88, 0x99, 0xaa } };
+    uint8_t npdu[MAX_NPDU + MAX_APDU];
+    uint8_t pdu[MAX_PDU];
+    uint16_t npdu_len;
+    unsigned i;
+    size_t len;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        npdu_len = npdu_payload(npdu, sizes[i]);
+        len = bvlc_sc_encode_encapsulated_npdu(
+            pdu, sizeof(pdu), (uint16_t)i, &origin, &dest, npdu, npdu_len);
+        corpus_add(&BVLC_SC_Corpus, pdu, (int)len);
+        len = bvlc_sc_encode_encapsulated_npdu(
+            pdu, sizeof(pdu), (uint16_t)i, NULL, NULL, npdu, npdu_len);
+        corpus_add(&BVLC_SC_Corpus, pdu, (int)len);
+    }
+    len = bvlc_sc_encode_heartbeat_request(pdu, sizeof(pdu), 1);
+    corpus_add(&BVLC_SC_Corpus, pdu, (int)len);
+}
+
+static unsigned bvlc_sc_decode(size_t *bytes)
+{
+    static BVLC_SC_DECODED_MESSAGE message;
+    static uint8_t pdu[MAX_PDU];
+    uint16_t error_code = 0;
+    uint16_t error_class = 0;
+    const char *err_desc = NULL;
+    unsigned i;
+
+    for (i = 0; i < BVLC_SC_Corpus.count; i++) {
+        /* the decoder works in place on a buffer it may change */
+        memcpy(pdu, BVLC_SC_Corpus.data[i], BVLC_SC_Corpus.len[i]);
+        if (bvlc_sc_decode_message(
+                pdu, BVLC_SC_Corpus.len[i], &message, &error_code,
+                &error_class, &err_desc)) {
+            *bytes += BVLC_SC_Corpus.len[i];
+            Benchmark_Sink += message.hdr.bvlc_function;
+        }
+    }
+
+    return BVLC_SC_Corpus.count;
+}
+
+/* MS/TP port for the receive frame state machine */
+static struct mstp_port_struct_t MSTP_Port;
+static uint8_t MSTP_Input_Buffer[DLMSTP_MPDU_MAX];
+static uint8_t MSTP_Output_Buffer[DLMSTP_MPDU_MAX];
+#define MSTP_THIS_STATION 1
+
+static uint32_t mstp_silence_timer(void *pArg)
+{
+    (void)pArg;
+    return 0;
+}
+
+static void mstp_silence_timer_reset(void *pArg)
+{
+    (void)pArg;
+}
+
+uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
+{
+    return mstp_port->DataLength;
+}
+
+uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    (void)mstp_port;
+    (void)timeout;
+    return 0;
+}
+
+uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    (void)mstp_port;
+    (void)timeout;
+    return 0;
+}
+
+void MSTP_Send_Frame(
+    struct mstp_port_struct_t *mstp_port,
+    const uint8_t *buffer,
+    uint16_t nbytes)
+{
+    (void)mstp_port;
+    (void)buffer;
+    (void)nbytes;
+}
+
+/**
+ * @brief Create the MS/TP frames, and the port that receives them
+ */
+static void mstp_setup(void)
+{
+    static const uint16_t sizes[] = { 16, 64, 480 };
+    uint8_t npdu[MAX_NPDU + MAX_APDU];
+    uint8_t frame[DLMSTP_MPDU_MAX];
+    uint16_t npdu_len;
+    unsigned i;
+    uint16_t len;
+
+    MSTP_Port.InputBuffer = MSTP_Input_Buffer;
+    MSTP_Port.InputBufferSize = sizeof(MSTP_Input_Buffer);
+    MSTP_Port.OutputBuffer = MSTP_Output_Buffer;
+    MSTP_Port.OutputBufferSize = sizeof(MSTP_Output_Buffer);
+    MSTP_Port.SilenceTimer = mstp_silence_timer;
+    MSTP_Port.SilenceTimerReset = mstp_silence_timer_reset;
+    MSTP_Port.This_Station = MSTP_THIS_STATION;
+    MSTP_Port.Nmax_info_frames = 1;
+    MSTP_Port.Nmax_master = 127;
+    MSTP_Init(&MSTP_Port);
+    len = MSTP_Create_Frame(
+        frame, sizeof(frame), FRAME_TYPE_TOKEN, MSTP_THIS_STATION, 2, NULL, 0);
+    corpus_add(&MSTP_Corpus, frame, len);
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        npdu_len = npdu_payload(npdu, sizes[i]);
+        len = MSTP_Create_Frame(
+            frame, sizeof(frame), FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY,
+            MSTP_THIS_STATION, 2, npdu, npdu_len);
+        corpus_add(&MSTP_Corpus, frame, len);
+    }
+}
+
+static unsigned mstp_receive(size_t *bytes)
+{
+    unsigned i;
+    uint16_t j;
+
+    for (i = 0; i < MSTP_Corpus.count; i++) {
+        for (j = 0; j < MSTP_Corpus.len[i]; j++) {
+            MSTP_Port.DataRegister = MSTP_Corpus.data[i][j];
+            MSTP_Port.DataAvailable = true;
+            MSTP_Receive_Frame_FSM(&MSTP_Port);
+        }
+        if (MSTP_Port.ReceivedValidFrame) {
+            MSTP_Port.ReceivedValidFrame = false;
+            *bytes += MSTP_Corpus.len[i];
+            Benchmark_Sink += MSTP_Port.FrameType;
+        }
+    }
+
+    return MSTP_Corpus.count;
+}
+
+static const struct benchmark Benchmarks[] = {
+    { "bacapp_encode_application_data", value_corpus_setup,
+      application_encode },
+    { "bacapp_decode_application_data", application_setup,
+      application_decode },
+    { "rpm_decode_object_property", rpm_setup, rpm_decode },
+    { "bacnet_npdu_decode_local", npdu_setup, npdu_decode_local },
+    { "bacnet_npdu_decode_routed", npdu_setup, npdu_decode_routed },
+    { "bvlc_decode", bvlc_setup, bvlc_decode },
+    { "bvlc_sc_decode_message", bvlc_sc_setup, bvlc_sc_decode },
+    { "mstp_receive_frame_fsm", mstp_setup, mstp_receive },
+};
+
+/**
+ * @brief Run a benchmark for at least the given time
+ * @param bench [in] benchmark
+ * @param time_ms [in] minimum time to run, in milliseconds
+ * @param result [out] result of the benchmark
+ */
+static void benchmark_run(
+    const struct benchmark *bench,
+    unsigned long time_ms,
+    struct benchmark_result *result)
+{
+    uint64_t start, elapsed = 0;
+    unsigned long iterations = 1, i;
+    unsigned long ops = 0;
+    size_t bytes = 0;
+
+    /* warm up once, then double the iterations until long enough */
+    (void)bench->run(&bytes);
+    for (;;) {
+        ops = 0;
+        bytes = 0;
+        start = benchmark_time_ns();
+        for (i = 0; i < iterations; i++) {
+            ops += bench->run(&bytes);
+        }
+        elapsed = benchmark_time_ns() - start;
+        if ((elapsed >= (uint64_t)time_ms * 1000000ULL) ||
+            (iterations >= (1UL << 30))) {
+            break;
+        }
+        iterations *= 2;
+    }
+    result->operations = ops;
+    result->ns_per_op = ops ? ((double)elapsed / (double)ops) : 0.0;
+    result->bytes_per_op = ops ? ((double)bytes / (double)ops) : 0.0;
+}
+
+/**
+ * @brief Find the time of a benchmark in the JSON results of an earlier run
+ * @param baseline [in] contents of the JSON results, or NULL
+ * @param name [in] benchmark name
+ * @param ns_per_op [out] time of the benchmark in the earlier run
+ * @return true if the benchmark was found
+ */
+static bool baseline_ns_per_op(
+    const char *baseline, const char *name, double *ns_per_op)
+{
+    char key[128];
+    const char *entry;
+
+    if (!baseline) {
+        return false;
+    }
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+    entry = strstr(baseline, key);
+    if (!entry) {
+        return false;
+    }
+    entry = strstr(entry, "\"ns_per_op\": ");
+    if (!entry) {
+        return false;
+    }
+    *ns_per_op = strtod(entry + strlen("\"ns_per_op\": "), NULL);
+
+    return (*ns_per_op > 0.0);
+}
+
+/**
+ * @brief Read a whole file
+ * @param filename [in] name of the file
+ * @return the contents of the file, to be freed, or NULL
+ */
+static char *file_read(const char *filename)
+{
+    FILE *file;
+    char *contents = NULL;
+    long size;
+
+    file = fopen(filename, "rb");
+    if (!file) {
+        return NULL;
+    }
+    if ((fseek(file, 0, SEEK_END) == 0) && ((size = ftell(file)) >= 0) &&
+        (fseek(file, 0, SEEK_SET) == 0)) {
+        contents = malloc((size_t)size + 1);
+        if (contents) {
+            size = (long)fread(contents, 1, (size_t)size, file);
+            contents[size] = 0;
+        }
+    }
+    fclose(file);
+
+    return contents;
+}
+
+static void print_usage(const char *filename)
+{
+    printf(
+        "Usage: %s [--filter name][--time ms][--json file]\n"
+        "       [--baseline file][--threshold percent]\n",
+        filename);
+    printf(
+        "Measure the time and the bytes of each operation of the codec\n"
+        "hot paths, using a corpus encoded from fixed values.\n"
+        "--filter name\n"
+        "  run only the benchmarks whose name contains the text.\n"
+        "--time ms\n"
+        "  minimum time to run each benchmark. Default is %u.\n"
+        "--json file\n"
+        "  write the results as JSON to the file, or - for stdout.\n"
+        "--baseline file\n"
+        "  compare with the JSON results of an earlier run, and exit\n"
+        "  with an error when a benchmark is slower than the threshold.\n"
+        "--threshold percent\n"
+        "  percent slower than the baseline that is a regression.\n"
+        "  Default is %.0f.\n",
+        BENCHMARK_TIME_MS, BENCHMARK_THRESHOLD);
+}
+
+int main(int argc, char *argv[])
+{
+    struct benchmark_result results[sizeof(Benchmarks) / sizeof(Benchmarks[0])];
+    bool selected[sizeof(Benchmarks) / sizeof(Benchmarks[0])];
+    const unsigned count = sizeof(Benchmarks) / sizeof(Benchmarks[0]);
+    const char *filter = NULL;
+    const char *json_filename = NULL;
+    const char *baseline_filename = NULL;
+    char *baseline = NULL;
+    unsigned long time_ms = BENCHMARK_TIME_MS;
+    double threshold = BENCHMARK_THRESHOLD;
+    double baseline_ns = 0.0, change = 0.0;
+    unsigned regressions = 0;
+    FILE *json = NULL;
+    FILE *report = stdout;
+    bool first = true;
+    unsigned i;
+    int argi;
+
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if ((strcmp(argv[argi], "--filter") == 0) && (argi + 1 < argc)) {
+            filter = argv[++argi];
+        } else if ((strcmp(argv[argi], "--time") == 0) && (argi + 1 < argc)) {
+            time_ms = strtoul(argv[++argi], NULL, 0);
+        } else if ((strcmp(argv[argi], "--json") == 0) && (argi + 1 < argc)) {
+            json_filename = argv[++argi];
+        } else if (
+            (strcmp(argv[argi], "--baseline") == 0) && (argi + 1 < argc)) {
+            baseline_filename = argv[++argi];
+        } else if (
+            (strcmp(argv[argi], "--threshold") == 0) && (argi + 1 < argc)) {
+            threshold = strtod(argv[++argi], NULL);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (json_filename && (strcmp(json_filename, "-") == 0)) {
+        /* keep stdout for the JSON results */
+        report = stderr;
+    }
+    if (baseline_filename) {
+        baseline = file_read(baseline_filename);
+        if (!baseline) {
+            fprintf(stderr, "Unable to read %s\n", baseline_filename);
+            return 1;
+        }
+    }
+    fprintf(
+        report, "%-34s %12s %12s %14s\n", "benchmark", "ns/op", "bytes/op",
+        "operations");
+    for (i = 0; i < count; i++) {
+        selected[i] = !filter || strstr(Benchmarks[i].name, filter);
+        if (!selected[i]) {
+            continue;
+        }
+        if (Benchmarks[i].setup) {
+            Benchmarks[i].setup();
+        }
+        benchmark_run(&Benchmarks[i], time_ms, &results[i]);
+        fprintf(
+            report, "%-34s %12.1f %12.1f %14lu", Benchmarks[i].name,
+            results[i].ns_per_op, results[i].bytes_per_op,
+            results[i].operations);
+        if (baseline_ns_per_op(baseline, Benchmarks[i].name, &baseline_ns)) {
+            change = ((results[i].ns_per_op - baseline_ns) * 100.0) /
+                baseline_ns;
+            fprintf(report, " %+7.1f%%", change);
+            if (change > threshold) {
+                fprintf(report, " REGRESSION");
+                regressions++;
+            }
+        }
+        fprintf(report, "\n");
+    }
+    free(baseline);
+    if (json_filename) {
+        if (strcmp(json_filename, "-") == 0) {
+            json = stdout;
+        } else {
+            json = fopen(json_filename, "w");
+        }
+        if (!json) {
+            fprintf(stderr, "Unable to write %s\n", json_filename);
+            return 1;
+        }
+        /* one benchmark per line, so that results are easy to compare */
+        fprintf(json, "{\n  \"version\": \"%s\",\n", BACNET_VERSION_TEXT);
+        fprintf(json, "  \"benchmarks\": [");
+        for (i = 0; i < count; i++) {
+            if (!selected[i]) {
+                continue;
+            }
+            fprintf(json,
+                "%s\n    {\"name\": \"%s\", \"operations\": %lu, "
+                "\"ns_per_op\": %.3f, \"bytes_per_op\": %.3f}",
+                first ? "" : ",", Benchmarks[i].name, results[i].operations,
+                results[i].ns_per_op, results[i].bytes_per_op);
+            first = false;
+        }
+        fprintf(json, "\n  ]\n}\n");
+        if (json != stdout) {
+            fclose(json);
+        }
+    }
+
+    return regressions ? 1 : 0;
+}